@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <vector>
 
 #include "common/fs/file.h"
@@ -13,6 +14,7 @@
 #ifdef _WIN32
 #include <io.h>
 #include <share.h>
+#include <windows.h>
 #else
 #include <unistd.h>
 #endif
@@ -318,6 +320,92 @@ size_t IOFile::WriteString(std::span<const char> string) const {
     return WriteSpan(string);
 }
 
+size_t IOFile::ReadAt(std::span<u8> data, u64 offset) const {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    size_t total_read = 0;
+    while (total_read < data.size()) {
+        const u64 position = offset + total_read;
+#ifdef _WIN32
+        const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        const DWORD chunk_size =
+            static_cast<DWORD>(std::min<size_t>(data.size() - total_read, 1ULL << 30));
+        DWORD num_read = 0;
+        if (!ReadFile(handle, data.data() + total_read, chunk_size, &num_read, &overlapped) ||
+            num_read == 0) {
+            // Reading beyond the end-of-file fails with ERROR_HANDLE_EOF
+            break;
+        }
+#else
+        const ssize_t num_read = pread(fileno(file), data.data() + total_read,
+                                       data.size() - total_read, static_cast<off_t>(position));
+        if (num_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (num_read < 0) {
+            const auto ec = std::error_code{errno, std::generic_category()};
+            LOG_ERROR(Common_Filesystem,
+                      "Failed to read the file at path={}, offset={}, ec_message={}",
+                      PathToUTF8String(file_path), position, ec.message());
+            break;
+        }
+        if (num_read == 0) {
+            break;
+        }
+#endif
+        total_read += static_cast<size_t>(num_read);
+    }
+    return total_read;
+}
+
+size_t IOFile::WriteAt(std::span<const u8> data, u64 offset) const {
+    if (!IsOpen()) {
+        return 0;
+    }
+
+    size_t total_written = 0;
+    while (total_written < data.size()) {
+        const u64 position = offset + total_written;
+#ifdef _WIN32
+        const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fileno(file)));
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        const DWORD chunk_size =
+            static_cast<DWORD>(std::min<size_t>(data.size() - total_written, 1ULL << 30));
+        DWORD num_written = 0;
+        if (!WriteFile(handle, data.data() + total_written, chunk_size, &num_written,
+                       &overlapped) ||
+            num_written == 0) {
+            LOG_ERROR(Common_Filesystem, "Failed to write the file at path={}, offset={}",
+                      PathToUTF8String(file_path), position);
+            break;
+        }
+#else
+        const ssize_t num_written = pwrite(fileno(file), data.data() + total_written,
+                                           data.size() - total_written,
+                                           static_cast<off_t>(position));
+        if (num_written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (num_written <= 0) {
+            const auto ec = std::error_code{errno, std::generic_category()};
+            LOG_ERROR(Common_Filesystem,
+                      "Failed to write the file at path={}, offset={}, ec_message={}",
+                      PathToUTF8String(file_path), position, ec.message());
+            break;
+        }
+#endif
+        total_written += static_cast<size_t>(num_written);
+    }
+    return total_written;
+}
+
 bool IOFile::Flush() const {
     if (!IsOpen()) {
         return false;
@@ -313,6 +313,41 @@ public:
         return std::fwrite(data.data(), sizeof(T), data.size(), file);
     }
 
+    /**
+     * Reads data from a given offset of a file.
+     * Unlike ReadSpan, this function reads from an explicit offset instead of the file pointer, so
+     * it can be called from multiple threads at once. The file pointer is left in an unspecified
+     * position. Data written with WriteSpan has to be flushed before it can be read.
+     *
+     * Failures occur when:
+     * - The file is not open
+     * - The opened file lacks read permissions
+     * - Attempting to read beyond the end-of-file
+     *
+     * @param data Span of data to read into
+     * @param offset Offset from the start of the file
+     *
+     * @returns Count of bytes successfully read.
+     */
+    [[nodiscard]] size_t ReadAt(std::span<u8> data, u64 offset) const;
+
+    /**
+     * Writes data to a given offset of a file.
+     * Unlike WriteSpan, this function writes to an explicit offset instead of the file pointer, so
+     * it can be called from multiple threads at once. The file pointer is left in an unspecified
+     * position.
+     *
+     * Failures occur when:
+     * - The file is not open
+     * - The opened file lacks write permissions
+     *
+     * @param data Span of data to write
+     * @param offset Offset from the start of the file
+     *
+     * @returns Count of bytes successfully written.
+     */
+    [[nodiscard]] size_t WriteAt(std::span<const u8> data, u64 offset) const;
+
     /**
      * Reads a T object from a file sequentially.
      * This function reads from the current position of the file pointer and
@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/common_types.h"
+
+namespace Common::FS {
+
+/**
+ * Read-only memory mapping of a whole file.
+ *
+ * The mapping stays valid until the object is closed or destroyed, even if the file is
+ * modified or removed in the meantime on platforms that allow it.
+ */
+class MappedFile {
+public:
+    MappedFile();
+
+    /**
+     * Maps the file at path.
+     *
+     * @param path Filesystem path
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Maps the file at path, unmapping the previously mapped file if any.
+     * If the file is empty, the mapping is open but its contents are empty.
+     *
+     * @param path Filesystem path
+     */
+    void Open(const std::filesystem::path& path);
+
+    /// Unmaps the file if it is mapped.
+    void Close();
+
+    /**
+     * Checks whether a file is mapped.
+     *
+     * @returns True if a file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool IsOpen() const {
+        return is_open;
+    }
+
+    /**
+     * Gets the contents of the mapped file.
+     *
+     * @returns A span over the mapped file, empty if no file is mapped.
+     */
+    [[nodiscard]] std::span<const u8> Data() const {
+        return {data, size};
+    }
+
+    /**
+     * Gets the size of the mapped file.
+     *
+     * @returns The size of the mapped file in bytes, 0 if no file is mapped.
+     */
+    [[nodiscard]] size_t Size() const {
+        return size;
+    }
+
+private:
+    const u8* data = nullptr;
+    size_t size = 0;
+    bool is_open = false;
+};
+
+} // namespace Common::FS
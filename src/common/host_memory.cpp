@@ -14,6 +14,8 @@
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #endif
+#include <fstream>
+#include <string>
 #include <boost/icl/interval_set.hpp>
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -199,6 +201,12 @@ public:
         UNREACHABLE();
     }
 
+    bool EnableHugePages() {
+        // Large pages can't be used with placeholders, and require the lock pages privilege.
+        LOG_INFO(HW_Memory, "Huge pages are not supported on this platform");
+        return false;
+    }
+
     const size_t backing_size; ///< Size of the backing memory in bytes
     const size_t virtual_size; ///< Size of the virtual address placeholder in bytes
 
@@ -511,6 +519,10 @@ public:
         void* ret = mmap(virtual_base + virtual_offset, length, flags, MAP_SHARED | MAP_FIXED, fd,
                          host_offset);
         ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", strerror(errno));
+
+        if (huge_pages) {
+            AdviseHugePages(virtual_base + virtual_offset, host_offset, length);
+        }
     }
 
     void Unmap(size_t virtual_offset, size_t length) {
@@ -566,6 +578,28 @@ public:
         virtual_base = nullptr;
     }
 
+    bool EnableHugePages() {
+#ifdef __linux__
+        // Guest memory is mapped in 4 KiB pages at arbitrary offsets of the backing file, which
+        // hugetlbfs can't do. Transparent huge pages of the file can, the kernel uses small pages
+        // wherever a huge page doesn't fit or can't be allocated.
+        if (!IsShmemHugePageEnabled()) {
+            LOG_INFO(HW_Memory, "Huge pages for shared memory are disabled on this host");
+            return false;
+        }
+        if (madvise(backing_base, backing_size, MADV_HUGEPAGE) != 0) {
+            LOG_WARNING(HW_Memory, "Huge pages are unavailable, madvise failed: {}",
+                        strerror(errno));
+            return false;
+        }
+        huge_pages = true;
+        return true;
+#else
+        LOG_INFO(HW_Memory, "Huge pages are not supported on this platform");
+        return false;
+#endif
+    }
+
     const size_t backing_size; ///< Size of the backing memory in bytes
     const size_t virtual_size; ///< Size of the virtual address placeholder in bytes
 
@@ -592,6 +626,38 @@ private:
         }
     }
 
+#ifdef __linux__
+    /// Returns true when the host allows transparent huge pages for shared memory
+    static bool IsShmemHugePageEnabled() {
+        // The active policy is in brackets, e.g. "always within_size [advise] never deny force"
+        std::ifstream file{"/sys/kernel/mm/transparent_hugepage/shmem_enabled"};
+        std::string policy;
+        if (!std::getline(file, policy)) {
+            return false;
+        }
+        return policy.find("[never]") == std::string::npos &&
+               policy.find("[deny]") == std::string::npos;
+    }
+#endif
+
+    void AdviseHugePages(u8* address, size_t host_offset, size_t length) {
+#ifdef __linux__
+        // A huge page of the backing file can only be mapped by a single page table entry when
+        // the mapping preserves its alignment, and only for the huge pages fully inside the range.
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+        if ((begin - host_offset) % HugePageSize != 0) {
+            return;
+        }
+        const uintptr_t huge_begin = AlignUp(begin, HugePageSize);
+        const uintptr_t huge_end = AlignDown(begin + length, HugePageSize);
+        if (huge_begin >= huge_end) {
+            return;
+        }
+        // Failing here only means small pages are used for the range
+        madvise(reinterpret_cast<void*>(huge_begin), huge_end - huge_begin, MADV_HUGEPAGE);
+#endif
+    }
+
     void AdjustMap(size_t* virtual_offset, size_t* length) {
         if (virtual_base != nullptr) {
             return;
@@ -615,6 +681,7 @@ private:
 
     int fd{-1}; // memfd file descriptor, -1 is the error value of memfd_create
     FreeRegionManager free_manager{};
+    bool huge_pages{};
 };
 
 #else // ^^^ Linux ^^^ vvv Generic vvv
@@ -639,13 +706,17 @@ public:
 
     void EnableDirectMappedAddress() {}
 
+    bool EnableHugePages() {
+        return false;
+    }
+
     u8* backing_base{nullptr};
     u8* virtual_base{nullptr};
 };
 
 #endif // ^^^ Generic ^^^
 
-HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
+HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_, bool use_huge_pages_)
     : backing_size(backing_size_), virtual_size(virtual_size_) {
     try {
         // Try to allocate a fastmem arena.
@@ -663,6 +734,10 @@ HostMemory::HostMemory(size_t backing_size_, size_t virtual_size_)
             virtual_base_offset = virtual_base - impl->virtual_base;
         }
 
+        if (use_huge_pages_) {
+            huge_pages = impl->EnableHugePages();
+        }
+
     } catch (const std::bad_alloc&) {
         LOG_CRITICAL(HW_Memory,
                      "Fastmem unavailable, falling back to VirtualBuffer for memory allocation");
@@ -24,7 +24,12 @@ DECLARE_ENUM_FLAG_OPERATORS(MemoryPermission)
  */
 class HostMemory {
 public:
-    explicit HostMemory(size_t backing_size_, size_t virtual_size_);
+    /**
+     * @param use_huge_pages_ Back the memory with transparent 2 MiB huge pages where mappings are
+     *                        suitably aligned. Falls back to small pages when the host can't
+     *                        provide them.
+     */
+    explicit HostMemory(size_t backing_size_, size_t virtual_size_, bool use_huge_pages_ = false);
     ~HostMemory();
 
     /**
@@ -69,6 +74,11 @@ public:
         return address >= virtual_base && address < virtual_base + virtual_size;
     }
 
+    /// Returns true when huge pages were requested and the host supports them
+    [[nodiscard]] bool UsesHugePages() const noexcept {
+        return huge_pages;
+    }
+
 private:
     size_t backing_size{};
     size_t virtual_size{};
@@ -79,6 +89,7 @@ private:
     u8* backing_base{};
     u8* virtual_base{};
     size_t virtual_base_offset{};
+    bool huge_pages{};
 
     // Fallback if fastmem is not supported on this platform
     std::unique_ptr<Common::VirtualBuffer<u8>> fallback_buffer;
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2019 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
 #include "common/page_table.h"
 #include "common/scope_exit.h"
 
@@ -47,12 +49,30 @@ bool PageTable::ContinueTraversal(TraversalEntry* out_entry, TraversalContext* c
     return true;
 }
 
+std::size_t PageTable::GetContiguousSize(Common::ProcessAddress address,
+                                         std::size_t size) const {
+    std::size_t page = address / page_size;
+    const uintptr_t raw = pointers[page].Raw();
+    const u64 backing = backing_addr[page];
+
+    // Memory pages store the host pointer and the physical address relative to the address of
+    // the page, so pages are contiguous when they store the same values as the first one
+    std::size_t contiguous_size = page_size - (address & (page_size - 1));
+    while (contiguous_size < size) {
+        ++page;
+        if (pointers[page].Raw() != raw || backing_addr[page] != backing) {
+            break;
+        }
+        contiguous_size += page_size;
+    }
+    return std::min(contiguous_size, size);
+}
+
 void PageTable::Resize(std::size_t address_space_width_in_bits, std::size_t page_size_in_bits) {
     const std::size_t num_page_table_entries{1ULL
                                              << (address_space_width_in_bits - page_size_in_bits)};
     pointers.resize(num_page_table_entries);
     backing_addr.resize(num_page_table_entries);
-    blocks.resize(num_page_table_entries);
     current_address_space_width_in_bits = address_space_width_in_bits;
     page_size = 1ULL << page_size_in_bits;
 }
@@ -118,6 +118,15 @@ struct PageTable {
         return current_address_space_width_in_bits;
     }
 
+    /**
+     * Returns how many bytes starting at an address, up to size, are in pages of the same type
+     * backed by contiguous memory, so that they can be accessed as a single block.
+     *
+     * @param address The address where the block starts.
+     * @param size    The maximum size of the block, the block has to be in the address space.
+     */
+    std::size_t GetContiguousSize(Common::ProcessAddress address, std::size_t size) const;
+
     bool GetPhysicalAddress(Common::PhysicalAddress* out_phys_addr,
                             Common::ProcessAddress virt_addr) const {
         if (virt_addr > (1ULL << this->GetAddressSpaceBits())) {
@@ -133,7 +142,6 @@ struct PageTable {
      * corresponding attribute element is of type `Memory`.
      */
     VirtualBuffer<PageInfo> pointers;
-    VirtualBuffer<u64> blocks;
 
     VirtualBuffer<u64> backing_addr;
 
@@ -251,6 +251,7 @@ struct Values {
                                               Category::CpuDebug};
     Setting<bool> cpuopt_ignore_memory_aborts{linkage, true, "cpuopt_ignore_memory_aborts",
                                               Category::CpuDebug};
+    Setting<bool> use_huge_pages{linkage, false, "use_huge_pages", Category::CpuDebug};
 
     SwitchableSetting<bool> cpuopt_unsafe_unfuse_fma{linkage, true, "cpuopt_unsafe_unfuse_fma",
                                                      Category::CpuUnsafe};
@@ -571,6 +572,8 @@ struct Values {
                                         Category::DataStorage};
     Setting<std::string> gamecard_path{linkage, std::string(), "gamecard_path",
                                        Category::DataStorage};
+    Setting<bool> verify_nca_integrity{linkage, false, "verify_nca_integrity",
+                                       Category::DataStorage};
 
     // Debugging
     bool record_frame_times;
@@ -584,6 +587,14 @@ struct Values {
         false};
     Setting<bool> dump_macros{
         linkage, false, "dump_macros", Category::DebuggingGraphics, Specialization::Default, false};
+    Setting<bool> profile_macros{linkage, false, "profile_macros", Category::DebuggingGraphics,
+                                 Specialization::Default, false};
+    Setting<s32> pushbuffer_capture_start_frame{linkage, 0, "pushbuffer_capture_start_frame",
+                                                Category::DebuggingGraphics,
+                                                Specialization::Default, false};
+    Setting<s32> pushbuffer_capture_frames{linkage, 0, "pushbuffer_capture_frames",
+                                           Category::DebuggingGraphics, Specialization::Default,
+                                           false};
     Setting<bool> enable_fs_access_log{linkage, false, "enable_fs_access_log", Category::Debugging};
     Setting<bool> reporting_services{
         linkage, false, "reporting_services", Category::Debugging, Specialization::Default, false};
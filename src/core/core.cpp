@@ -8,6 +8,7 @@
 
 #include "audio_core/audio_core.h"
 #include "common/fs/fs.h"
+#include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
@@ -20,6 +21,8 @@
 #include "core/debugger/debugger.h"
 #include "core/device_memory.h"
 #include "core/file_sys/fs_filesystem.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache_storage.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/romfs_factory.h"
@@ -41,6 +44,7 @@
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/glue/glue_manager.h"
 #include "core/hle/service/glue/time/static.h"
+#include "core/hle/service/ipc_profiler.h"
 #include "core/hle/service/psc/time/static.h"
 #include "core/hle/service/psc/time/steady_clock.h"
 #include "core/hle/service/psc/time/system_clock.h"
@@ -70,6 +74,37 @@ MICROPROFILE_DEFINE(ARM_CPU3, "ARM", "CPU 3", MP_RGB(255, 64, 64));
 
 namespace Core {
 
+namespace {
+
+/// Whether the game file is read as is, rather than being a container of encrypted content
+bool IsUnencryptedGameFile(const std::string& path) {
+    switch (Loader::GuessFromFilename(std::string(Common::FS::GetFilename(path)))) {
+    case Loader::FileType::NRO:
+    case Loader::FileType::NSO:
+    case Loader::FileType::KIP:
+    case Loader::FileType::DeconstructedRomDirectory:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Unencrypted game files are mapped when possible to let reads copy straight from the mapping
+// instead of going through a system call each. Containers (NCA, NSP, XCI) are read through the
+// decryption layers anyway, and mapping them would turn host I/O errors into SIGBUS and keep the
+// files locked on Windows.
+FileSys::VirtualFile OpenGameFile(const FileSys::VirtualFilesystem& vfs, const std::string& path) {
+    if (const auto real_vfs = std::dynamic_pointer_cast<FileSys::RealVfsFilesystem>(vfs);
+        real_vfs != nullptr && IsUnencryptedGameFile(path)) {
+        if (auto file = real_vfs->OpenMappedFile(path); file != nullptr) {
+            return file;
+        }
+    }
+    return vfs->OpenFile(path, FileSys::OpenMode::Read);
+}
+
+} // Anonymous namespace
+
 FileSys::VirtualFile GetGameFileFromPath(const FileSys::VirtualFilesystem& vfs,
                                          const std::string& path) {
     // To account for split 00+01+etc files.
@@ -103,10 +138,10 @@ FileSys::VirtualFile GetGameFileFromPath(const FileSys::VirtualFilesystem& vfs,
     }
 
     if (Common::FS::IsDir(path)) {
-        return vfs->OpenFile(path + "/main", FileSys::OpenMode::Read);
+        return OpenGameFile(vfs, path + "/main");
     }
 
-    return vfs->OpenFile(path, FileSys::OpenMode::Read);
+    return OpenGameFile(vfs, path);
 }
 
 struct System::Impl {
@@ -270,12 +305,20 @@ struct System::Impl {
         cpu_manager.Initialize();
     }
 
-    SystemResultStatus SetupForApplicationProcess(System& system, Frontend::EmuWindow& emu_window) {
+    SystemResultStatus InitializeGPU(System& system, Frontend::EmuWindow& emu_window) {
         host1x_core = std::make_unique<Tegra::Host1x::Host1x>(system);
         gpu_core = VideoCore::CreateGPU(emu_window, system);
         if (!gpu_core) {
             return SystemResultStatus::ErrorVideoCore;
         }
+        return SystemResultStatus::Success;
+    }
+
+    SystemResultStatus SetupForApplicationProcess(System& system, Frontend::EmuWindow& emu_window) {
+        if (const SystemResultStatus result = InitializeGPU(system, emu_window);
+            result != SystemResultStatus::Success) {
+            return result;
+        }
 
         audio_core = std::make_unique<AudioCore::AudioCore>(system);
 
@@ -416,6 +459,8 @@ struct System::Impl {
         cheat_engine.reset();
         core_timing.ClearPendingEvents();
         app_loader.reset();
+        FileSys::DecryptedBlockCache::Instance().Clear();
+        FileSys::VerifiedBlockBitmap::ClearShared();
         audio_core.reset();
         gpu_core.reset();
         host1x_core.reset();
@@ -490,6 +535,8 @@ struct System::Impl {
     bool nvdec_active{};
 
     Reporter reporter;
+    /// Declared before the services, which keep pointers to the statistics of their commands
+    Service::IpcProfiler ipc_profiler;
     std::unique_ptr<Memory::CheatEngine> cheat_engine;
     std::unique_ptr<Tools::Freezer> memory_freezer;
     std::array<u8, 0x20> build_id{};
@@ -613,6 +660,15 @@ SystemResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::stri
     return impl->Load(*this, emu_window, filepath, params);
 }
 
+SystemResultStatus System::InitializeGPU(Frontend::EmuWindow& emu_window) {
+    const SystemResultStatus result = impl->InitializeGPU(*this, emu_window);
+    if (result == SystemResultStatus::Success) {
+        // The GPU only processes command lists while the system is powered on
+        impl->is_powered_on = true;
+    }
+    return result;
+}
+
 bool System::IsPoweredOn() const {
     return impl->is_powered_on.load(std::memory_order::relaxed);
 }
@@ -849,6 +905,14 @@ const Reporter& System::GetReporter() const {
     return impl->reporter;
 }
 
+Service::IpcProfiler& System::GetIpcProfiler() {
+    return impl->ipc_profiler;
+}
+
+const Service::IpcProfiler& System::GetIpcProfiler() const {
+    return impl->ipc_profiler;
+}
+
 Service::Glue::ARPManager& System::GetARPManager() {
     return impl->arp_manager;
 }
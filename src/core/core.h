@@ -72,6 +72,7 @@ namespace Glue {
 class ARPManager;
 }
 
+class IpcProfiler;
 class ServerManager;
 
 namespace SM {
@@ -210,6 +211,14 @@ public:
                                           const std::string& filepath,
                                           Service::AM::FrontendAppletParameters& params);
 
+    /**
+     * Sets up the GPU without loading an application, to drive it directly, as when replaying
+     * pushbuffer captures.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @returns SystemResultStatus code, indicating if the operation succeeded.
+     */
+    [[nodiscard]] SystemResultStatus InitializeGPU(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -368,6 +377,10 @@ public:
 
     [[nodiscard]] const Reporter& GetReporter() const;
 
+    /// Gets the call statistics of the HLE service commands
+    [[nodiscard]] Service::IpcProfiler& GetIpcProfiler();
+    [[nodiscard]] const Service::IpcProfiler& GetIpcProfiler() const;
+
     [[nodiscard]] Service::Glue::ARPManager& GetARPManager();
     [[nodiscard]] const Service::Glue::ARPManager& GetARPManager() const;
 
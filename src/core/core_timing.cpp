@@ -2,9 +2,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
 #include <mutex>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include "common/windows/timer_resolution.h"
@@ -31,23 +36,200 @@ struct CoreTiming::Event {
     u64 fifo_order;
     std::weak_ptr<EventType> type;
     s64 reschedule_time;
-    heap_t::handle_type handle{};
+    size_t sequence_number;
+    Event* next{};
 
     // Sort by time, unless the times are the same, in which case sort by
     // the order added to the queue
     friend bool operator>(const Event& left, const Event& right) {
         return std::tie(left.time, left.fifo_order) > std::tie(right.time, right.fifo_order);
     }
+};
+
+/**
+ * Hierarchical timing wheel with ticks of 1024ns. Each level has 64 slots, spanning 64 slots of
+ * the level below. An event is placed in the level of the most significant 6-bit digit in which
+ * its tick differs from the current tick, so the events of a level always expire before the ones
+ * of the levels above it. When the slot of a level above 0 expires, its events are placed again
+ * in the levels below. Events of the current tick are kept in a heap, in order of expiration.
+ */
+class CoreTiming::EventWheel {
+public:
+    EventWheel() = default;
+
+    ~EventWheel() {
+        Clear();
+    }
+
+    EventWheel(const EventWheel&) = delete;
+    EventWheel& operator=(const EventWheel&) = delete;
+
+    void Insert(Event* evt) {
+        const u64 tick = ToTick(evt->time);
+        if (tick <= current_tick) {
+            ready.push_back(evt);
+            std::ranges::push_heap(ready, std::greater<>{}, Dereference);
+            return;
+        }
+        const size_t level = (std::bit_width(tick ^ current_tick) - 1) / LEVEL_BITS;
+        const size_t slot = (tick >> (level * LEVEL_BITS)) & SLOT_MASK;
+        evt->next = slots[level][slot];
+        slots[level][slot] = evt;
+        occupied[level] |= u64{1} << slot;
+    }
+
+    /// Advances the wheel to the tick of time, making the events of the elapsed ticks ready
+    void Expire(s64 time) {
+        const u64 tick = ToTick(time);
+        for (auto position = NextSlot(); position && position->tick <= tick;
+             position = NextSlot()) {
+            current_tick = position->tick;
+            occupied[position->level] &= ~(u64{1} << position->slot);
+            Event* evt = std::exchange(slots[position->level][position->slot], nullptr);
+            while (evt) {
+                Event* const next = std::exchange(evt->next, nullptr);
+                Insert(evt);
+                evt = next;
+            }
+        }
+        current_tick = std::max(current_tick, tick);
+    }
 
-    friend bool operator<(const Event& left, const Event& right) {
-        return std::tie(left.time, left.fifo_order) < std::tie(right.time, right.fifo_order);
+    /// Returns the earliest ready event if it is due at time
+    [[nodiscard]] Event* PopReady(s64 time) {
+        if (ready.empty() || ready.front()->time > time) {
+            return nullptr;
+        }
+        std::ranges::pop_heap(ready, std::greater<>{}, Dereference);
+        Event* const evt = ready.back();
+        ready.pop_back();
+        return evt;
+    }
+
+    /// Returns the time at which the wheel has to be advanced again, if there are events left
+    [[nodiscard]] std::optional<s64> NextTime() const {
+        std::optional<s64> next_time;
+        if (const auto position = NextSlot(); position && position->level == 0) {
+            for (const Event* evt = slots[0][position->slot]; evt; evt = evt->next) {
+                next_time = std::min(next_time.value_or(evt->time), evt->time);
+            }
+        } else if (position) {
+            // Events of the levels above have to be placed in the levels below first
+            next_time = static_cast<s64>(position->tick << TICK_BITS);
+        }
+        if (!ready.empty()) {
+            next_time = std::min(next_time.value_or(ready.front()->time), ready.front()->time);
+        }
+        return next_time;
+    }
+
+    /// Frees the events matching the predicate, returning how many there were
+    template <typename Predicate>
+    size_t EraseIf(Predicate&& predicate) {
+        const auto erase = [&predicate](Event* evt) {
+            if (!predicate(*evt)) {
+                return false;
+            }
+            delete evt;
+            return true;
+        };
+        size_t num_events = std::erase_if(ready, erase);
+        if (num_events != 0) {
+            std::ranges::make_heap(ready, std::greater<>{}, Dereference);
+        }
+        for (size_t level = 0; level < NUM_LEVELS; ++level) {
+            for (u64 mask = occupied[level]; mask != 0; mask &= mask - 1) {
+                const size_t slot = std::countr_zero(mask);
+                for (Event** link = &slots[level][slot]; *link;) {
+                    Event* const evt = *link;
+                    Event* const next = evt->next;
+                    if (erase(evt)) {
+                        *link = next;
+                        ++num_events;
+                    } else {
+                        link = &evt->next;
+                    }
+                }
+                if (!slots[level][slot]) {
+                    occupied[level] &= ~(u64{1} << slot);
+                }
+            }
+        }
+        return num_events;
+    }
+
+    /// Frees all events, returning how many there were
+    size_t Clear() {
+        size_t num_events = ready.size();
+        for (Event* const evt : ready) {
+            delete evt;
+        }
+        ready.clear();
+        for (size_t level = 0; level < NUM_LEVELS; ++level) {
+            for (Event*& head : slots[level]) {
+                for (Event* evt = std::exchange(head, nullptr); evt;) {
+                    Event* const next = evt->next;
+                    delete evt;
+                    evt = next;
+                    ++num_events;
+                }
+            }
+            occupied[level] = 0;
+        }
+        return num_events;
+    }
+
+private:
+    struct SlotPosition {
+        u64 tick;
+        size_t level;
+        size_t slot;
+    };
+
+    static constexpr size_t TICK_BITS = 10;
+    static constexpr size_t LEVEL_BITS = 6;
+    static constexpr size_t SLOT_MASK = (size_t{1} << LEVEL_BITS) - 1;
+    static constexpr size_t NUM_LEVELS = (64 - TICK_BITS + LEVEL_BITS - 1) / LEVEL_BITS;
+
+    [[nodiscard]] static u64 ToTick(s64 time) {
+        return time > 0 ? static_cast<u64>(time) >> TICK_BITS : 0;
+    }
+
+    [[nodiscard]] static const Event& Dereference(const Event* evt) {
+        return *evt;
+    }
+
+    [[nodiscard]] std::optional<SlotPosition> NextSlot() const {
+        for (size_t level = 0; level < NUM_LEVELS; ++level) {
+            if (occupied[level] == 0) {
+                continue;
+            }
+            // Events are placed after the current slot of their level, which is found first
+            const size_t shift = level * LEVEL_BITS;
+            const size_t current_slot = (current_tick >> shift) & SLOT_MASK;
+            const size_t slot = current_slot + std::countr_zero(occupied[level] >> current_slot);
+            const u64 level_start = current_tick & ~((u64{1} << (shift + LEVEL_BITS)) - 1);
+            return SlotPosition{
+                .tick = level_start + (u64{slot} << shift),
+                .level = level,
+                .slot = slot,
+            };
+        }
+        return std::nullopt;
     }
+
+    u64 current_tick = 0;
+    std::array<u64, NUM_LEVELS> occupied{};
+    std::array<std::array<Event*, SLOT_MASK + 1>, NUM_LEVELS> slots{};
+    std::vector<Event*> ready;
 };
 
-CoreTiming::CoreTiming() : clock{Common::CreateOptimalClock()} {}
+CoreTiming::CoreTiming()
+    : clock{Common::CreateOptimalClock()}, event_wheel{std::make_unique<EventWheel>()} {}
 
 CoreTiming::~CoreTiming() {
     Reset();
+    ClearPendingEvents();
 }
 
 void CoreTiming::ThreadEntry(CoreTiming& instance) {
@@ -72,8 +254,9 @@ void CoreTiming::Initialize(std::function<void()>&& on_thread_init_) {
 }
 
 void CoreTiming::ClearPendingEvents() {
-    std::scoped_lock lock{advance_lock, basic_lock};
-    event_queue.clear();
+    std::scoped_lock lock{advance_lock};
+    CollectScheduledEvents();
+    num_pending_events -= event_wheel->Clear();
     event.Set();
 }
 
@@ -111,62 +294,39 @@ bool CoreTiming::IsRunning() const {
 }
 
 bool CoreTiming::HasPendingEvents() const {
-    std::scoped_lock lock{basic_lock};
-    return !(wait_set && event_queue.empty());
+    return !(wait_set && num_pending_events == 0);
 }
 
 void CoreTiming::ScheduleEvent(std::chrono::nanoseconds ns_into_future,
                                const std::shared_ptr<EventType>& event_type, bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
-
-        auto h{event_queue.emplace(Event{next_time.count(), event_fifo_id++, event_type, 0})};
-        (*h).handle = h;
-    }
-
-    event.Set();
+    const auto next_time{absolute_time ? ns_into_future : GetGlobalTimeNs() + ns_into_future};
+    PushEvent(new Event{next_time.count(), event_fifo_id++, event_type, 0,
+                        event_type->sequence_number});
 }
 
 void CoreTiming::ScheduleLoopingEvent(std::chrono::nanoseconds start_time,
                                       std::chrono::nanoseconds resched_time,
                                       const std::shared_ptr<EventType>& event_type,
                                       bool absolute_time) {
-    {
-        std::scoped_lock scope{basic_lock};
-        const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
-
-        auto h{event_queue.emplace(
-            Event{next_time.count(), event_fifo_id++, event_type, resched_time.count()})};
-        (*h).handle = h;
-    }
-
-    event.Set();
+    const auto next_time{absolute_time ? start_time : GetGlobalTimeNs() + start_time};
+    PushEvent(new Event{next_time.count(), event_fifo_id++, event_type, resched_time.count(),
+                        event_type->sequence_number});
 }
 
 void CoreTiming::UnscheduleEvent(const std::shared_ptr<EventType>& event_type,
                                  UnscheduleEventType type) {
-    {
-        std::scoped_lock lk{basic_lock};
-
-        std::vector<heap_t::handle_type> to_remove;
-        for (auto itr = event_queue.begin(); itr != event_queue.end(); itr++) {
-            const Event& e = *itr;
-            if (e.type.lock().get() == event_type.get()) {
-                to_remove.push_back(itr->handle);
-            }
-        }
-
-        for (auto& h : to_remove) {
-            event_queue.erase(h);
-        }
-
-        event_type->sequence_number++;
-    }
+    // The scheduled events are discarded when they expire, or by the next call that holds the
+    // advance lock, so that they don't count as pending until then
+    event_type->sequence_number++;
+    has_unscheduled_events = true;
 
     // Force any in-progress events to finish
     if (type == UnscheduleEventType::Wait) {
         std::scoped_lock lk{advance_lock};
+        if (DiscardUnscheduledEvents()) {
+            // The timer thread may be waiting for one of them
+            event.Set();
+        }
     }
 }
 
@@ -197,63 +357,97 @@ u64 CoreTiming::GetGPUTicks() const {
     return Common::WallClock::CPUTickToGPUTick(cpu_ticks);
 }
 
-std::optional<s64> CoreTiming::Advance() {
-    std::scoped_lock lock{advance_lock, basic_lock};
-    global_timer = GetGlobalTimeNs().count();
-
-    while (!event_queue.empty() && event_queue.top().time <= global_timer) {
-        const Event& evt = event_queue.top();
-
-        if (const auto event_type{evt.type.lock()}) {
-            const auto evt_time = evt.time;
-            const auto evt_sequence_num = event_type->sequence_number;
-
-            if (evt.reschedule_time == 0) {
-                event_queue.pop();
-
-                basic_lock.unlock();
-
-                event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time});
+void CoreTiming::PushEvent(Event* evt) {
+    ++num_pending_events;
+    evt->next = scheduled_events.load(std::memory_order_relaxed);
+    while (!scheduled_events.compare_exchange_weak(evt->next, evt)) {
+    }
+    // The timer thread collects the event by itself if it wakes up before the event is due
+    if (evt->time < wakeup_time) {
+        event.Set();
+    }
+}
 
-                basic_lock.lock();
-            } else {
-                basic_lock.unlock();
+void CoreTiming::CollectScheduledEvents() {
+    Event* evt = scheduled_events.exchange(nullptr);
+    while (evt) {
+        Event* const next = std::exchange(evt->next, nullptr);
+        event_wheel->Insert(evt);
+        evt = next;
+    }
+}
 
-                const auto new_schedule_time{event_type->callback(
-                    evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time})};
+bool CoreTiming::DiscardUnscheduledEvents() {
+    if (!has_unscheduled_events.exchange(false)) {
+        return false;
+    }
+    CollectScheduledEvents();
+    const size_t num_events = event_wheel->EraseIf([](const Event& evt) {
+        const auto event_type{evt.type.lock()};
+        return !event_type || evt.sequence_number != event_type->sequence_number;
+    });
+    num_pending_events -= num_events;
+    return num_events != 0;
+}
 
-                basic_lock.lock();
+void CoreTiming::FreeEvent(Event* evt) {
+    delete evt;
+    --num_pending_events;
+}
 
-                if (evt_sequence_num != event_type->sequence_number) {
-                    // Heap handle is invalidated after external modification.
-                    continue;
-                }
+std::optional<s64> CoreTiming::Advance() {
+    std::scoped_lock lock{advance_lock};
+    // Events scheduled while advancing may be missed by the wait time computed below, so any
+    // event wakes up the timer thread until the new wait time is known
+    wakeup_time = std::numeric_limits<s64>::max();
+    global_timer = GetGlobalTimeNs().count();
 
-                const auto next_schedule_time{new_schedule_time.has_value()
-                                                  ? new_schedule_time.value().count()
-                                                  : evt.reschedule_time};
+    while (true) {
+        CollectScheduledEvents();
+        event_wheel->Expire(global_timer);
+        Event* const evt = event_wheel->PopReady(global_timer);
+        if (!evt) {
+            break;
+        }
 
-                // If this event was scheduled into a pause, its time now is going to be way
-                // behind. Re-set this event to continue from the end of the pause.
-                auto next_time{evt.time + next_schedule_time};
-                if (evt.time < pause_end_time) {
-                    next_time = pause_end_time + next_schedule_time;
-                }
+        const auto event_type{evt->type.lock()};
+        if (!event_type || evt->sequence_number != event_type->sequence_number) {
+            // The event was unscheduled
+            FreeEvent(evt);
+            continue;
+        }
 
-                event_queue.update(evt.handle, Event{next_time, event_fifo_id++, evt.type,
-                                                     next_schedule_time, evt.handle});
+        const auto evt_time = evt->time;
+        const auto new_schedule_time{event_type->callback(
+            evt_time, std::chrono::nanoseconds{GetGlobalTimeNs().count() - evt_time})};
+
+        if (evt->reschedule_time == 0 || evt->sequence_number != event_type->sequence_number) {
+            FreeEvent(evt);
+        } else {
+            const auto next_schedule_time{new_schedule_time.has_value()
+                                              ? new_schedule_time.value().count()
+                                              : evt->reschedule_time};
+
+            // If this event was scheduled into a pause, its time now is going to be way
+            // behind. Re-set this event to continue from the end of the pause.
+            auto next_time{evt->time + next_schedule_time};
+            if (evt->time < pause_end_time) {
+                next_time = pause_end_time + next_schedule_time;
             }
+
+            evt->time = next_time;
+            evt->fifo_order = event_fifo_id++;
+            evt->reschedule_time = next_schedule_time;
+            event_wheel->Insert(evt);
         }
 
         global_timer = GetGlobalTimeNs().count();
     }
 
-    if (!event_queue.empty()) {
-        return event_queue.top().time;
-    } else {
-        return std::nullopt;
-    }
+    DiscardUnscheduledEvents();
+    const auto next_time = event_wheel->NextTime();
+    wakeup_time = next_time.value_or(std::numeric_limits<s64>::max());
+    return next_time;
 }
 
 void CoreTiming::ThreadLoop() {
@@ -12,8 +12,6 @@
 #include <string>
 #include <thread>
 
-#include <boost/heap/fibonacci_heap.hpp>
-
 #include "common/common_types.h"
 #include "common/thread.h"
 #include "common/wall_clock.h"
@@ -34,8 +32,8 @@ struct EventType {
     /// A pointer to the name of the event.
     const std::string name;
     /// A monotonic sequence number, incremented when this event is
-    /// changed externally.
-    size_t sequence_number;
+    /// changed externally. Scheduled events of an older sequence number are discarded.
+    std::atomic<size_t> sequence_number;
 };
 
 enum class UnscheduleEventType {
@@ -50,6 +48,9 @@ enum class UnscheduleEventType {
  * To schedule an event, you first have to register its type. This is where you pass in the
  * callback. You then schedule events using the type ID you get back.
  *
+ * Events can be scheduled and unscheduled from any thread without blocking: they are pushed to a
+ * lock-free list, which is collected into a timing wheel by the thread advancing the timing.
+ *
  * The s64 ns_late that the callbacks get is how many ns late it was.
  * So to schedule a new event on a regular basis:
  * inside callback:
@@ -140,12 +141,25 @@ public:
 
 private:
     struct Event;
+    class EventWheel;
 
     static void ThreadEntry(CoreTiming& instance);
     void ThreadLoop();
 
     void Reset();
 
+    /// Adds an event to the scheduled events, and wakes up the timer thread if it is needed sooner
+    void PushEvent(Event* evt);
+
+    /// Moves the events scheduled since the last call to the wheel
+    void CollectScheduledEvents();
+
+    /// Frees the unscheduled events if any event type was unscheduled since the last call, must
+    /// be called with advance_lock held. Returns true if any event was freed.
+    bool DiscardUnscheduledEvents();
+
+    void FreeEvent(Event* evt);
+
     std::unique_ptr<Common::WallClock> clock;
 
     s64 global_timer = 0;
@@ -154,15 +168,19 @@ private:
     s64 timer_resolution_ns;
 #endif
 
-    using heap_t =
-        boost::heap::fibonacci_heap<CoreTiming::Event, boost::heap::compare<std::greater<>>>;
-
-    heap_t event_queue;
-    u64 event_fifo_id = 0;
+    /// Events scheduled since the last time the timing was advanced, most recent first
+    std::atomic<Event*> scheduled_events{};
+    /// Pending events, only accessed with advance_lock held
+    std::unique_ptr<EventWheel> event_wheel;
+    std::atomic<u64> event_fifo_id = 0;
+    std::atomic<size_t> num_pending_events = 0;
+    /// Set when an event type is unscheduled, while its events may still be pending
+    std::atomic<bool> has_unscheduled_events{};
+    /// Time at which the timer thread advances the timing without being woken up
+    std::atomic<s64> wakeup_time = 0;
 
     Common::Event event{};
     Common::Event pause_event{};
-    mutable std::mutex basic_lock;
     std::mutex advance_lock;
     std::unique_ptr<std::jthread> timer_thread;
     std::atomic<bool> paused{};
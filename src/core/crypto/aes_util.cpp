@@ -1,13 +1,38 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
 #include <mbedtls/cipher.h>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#define HAS_HARDWARE_AES
+#endif
+
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/swap.h"
 #include "core/crypto/aes_util.h"
 #include "core/crypto/key_manager.h"
 
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AES __attribute__((target("aes,sse4.1")))
+#else
+#define TARGET_AES
+#endif
+
 namespace Core::Crypto {
 namespace {
 using NintendoTweak = std::array<u8, 16>;
@@ -20,6 +45,186 @@ NintendoTweak CalculateNintendoTweak(std::size_t sector_id) {
     }
     return out;
 }
+
+constexpr std::size_t AesBlockSize = 0x10;
+constexpr std::size_t AesRounds = 10;
+
+/// Number of blocks in flight at once, enough to hide the latency of the AES instructions
+constexpr std::size_t PipelinedBlocks = 8;
+
+/// Number of blocks whose counters or tweaks are generated at once
+constexpr std::size_t BlocksPerChunk = 64;
+
+using AesBlock = std::array<u8, AesBlockSize>;
+using AesRoundKeyArray = std::array<AesBlock, AesRounds + 1>;
+
+/// Expanded AES-128 key, with the round keys of the equivalent inverse cipher for decryption
+struct AesRoundKeys {
+    AesRoundKeyArray encrypt;
+    AesRoundKeyArray decrypt;
+};
+
+enum class CryptMode {
+    Ctr,        ///< dest = Encrypt(mask) ^ src
+    XtsEncrypt, ///< dest = Encrypt(src ^ mask) ^ mask
+    XtsDecrypt, ///< dest = Decrypt(src ^ mask) ^ mask
+};
+
+#if defined(ARCHITECTURE_x86_64)
+bool IsAesAccelerated() {
+    const auto& caps = Common::GetCPUCaps();
+    return caps.aes && caps.sse4_1;
+}
+
+TARGET_AES u32 SubWord(u32 word) {
+    // With all columns equal ShiftRows does nothing, leaving SubBytes of the word in each column.
+    const __m128i block = _mm_set1_epi32(static_cast<int>(word));
+    return static_cast<u32>(_mm_cvtsi128_si32(_mm_aesenclast_si128(block, _mm_setzero_si128())));
+}
+
+TARGET_AES AesBlock InvMixColumns(const AesBlock& block) {
+    AesBlock result;
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block.data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result.data()), _mm_aesimc_si128(value));
+    return result;
+}
+
+TARGET_AES __m128i LoadBlock(const u8* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+template <CryptMode mode>
+TARGET_AES __m128i FirstRound(__m128i key, const u8* src, const u8* mask) {
+    if constexpr (mode == CryptMode::Ctr) {
+        return _mm_xor_si128(LoadBlock(mask), key);
+    } else {
+        return _mm_xor_si128(_mm_xor_si128(LoadBlock(src), LoadBlock(mask)), key);
+    }
+}
+
+template <CryptMode mode>
+TARGET_AES __m128i MiddleRound(__m128i block, __m128i key) {
+    if constexpr (mode == CryptMode::XtsDecrypt) {
+        return _mm_aesdec_si128(block, key);
+    } else {
+        return _mm_aesenc_si128(block, key);
+    }
+}
+
+template <CryptMode mode>
+TARGET_AES void LastRound(__m128i block, __m128i key, const u8* src, const u8* mask, u8* dest) {
+    if constexpr (mode == CryptMode::XtsDecrypt) {
+        block = _mm_aesdeclast_si128(block, key);
+    } else {
+        block = _mm_aesenclast_si128(block, key);
+    }
+    const __m128i post = LoadBlock(mode == CryptMode::Ctr ? src : mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_xor_si128(block, post));
+}
+
+/// Transcodes one block per index, interleaving their rounds. The blocks are expanded from a
+/// parameter pack rather than looped over so that they stay in registers.
+template <CryptMode mode, std::size_t... I>
+TARGET_AES void CryptPipelined(const __m128i* keys, const u8* src, const u8* mask, u8* dest,
+                               std::index_sequence<I...>) {
+    __m128i blocks[] = {
+        FirstRound<mode>(keys[0], src + I * AesBlockSize, mask + I * AesBlockSize)...};
+    for (std::size_t round = 1; round < AesRounds; ++round) {
+        ((blocks[I] = MiddleRound<mode>(blocks[I], keys[round])), ...);
+    }
+    (LastRound<mode>(blocks[I], keys[AesRounds], src + I * AesBlockSize,
+                     mask + I * AesBlockSize, dest + I * AesBlockSize),
+     ...);
+}
+
+template <CryptMode mode>
+TARGET_AES void CryptBlocks(const AesRoundKeyArray& round_keys, const u8* src, const u8* mask,
+                            u8* dest, std::size_t num_blocks) {
+    __m128i keys[AesRounds + 1];
+    for (std::size_t round = 0; round <= AesRounds; ++round) {
+        keys[round] = LoadBlock(round_keys[round].data());
+    }
+
+    std::size_t offset = 0;
+    for (; num_blocks >= PipelinedBlocks; num_blocks -= PipelinedBlocks) {
+        CryptPipelined<mode>(keys, src + offset, mask + offset, dest + offset,
+                             std::make_index_sequence<PipelinedBlocks>{});
+        offset += PipelinedBlocks * AesBlockSize;
+    }
+    for (; num_blocks > 0; --num_blocks) {
+        CryptPipelined<mode>(keys, src + offset, mask + offset, dest + offset,
+                             std::make_index_sequence<1>{});
+        offset += AesBlockSize;
+    }
+}
+#endif
+
+#if defined(HAS_HARDWARE_AES)
+void ExpandKey(AesRoundKeys& keys, const u8* key) {
+    std::array<u32, 4 * (AesRounds + 1)> words;
+    std::memcpy(words.data(), key, AesBlockSize);
+
+    u32 rcon = 1;
+    for (std::size_t i = 4; i < words.size(); ++i) {
+        u32 temp = words[i - 1];
+        if (i % 4 == 0) {
+            // Words are little endian, so RotWord is a right rotation and Rcon is the low byte.
+            temp = SubWord(std::rotr(temp, 8)) ^ rcon;
+            rcon = (rcon << 1) ^ ((rcon >> 7) * 0x11B);
+        }
+        words[i] = words[i - 4] ^ temp;
+    }
+    std::memcpy(keys.encrypt.data(), words.data(), sizeof(keys.encrypt));
+
+    keys.decrypt[0] = keys.encrypt[AesRounds];
+    for (std::size_t round = 1; round < AesRounds; ++round) {
+        keys.decrypt[round] = InvMixColumns(keys.encrypt[AesRounds - round]);
+    }
+    keys.decrypt[AesRounds] = keys.encrypt[0];
+}
+
+/// Writes the blocks of a 128-bit big endian counter to out, advancing it past them
+void GenerateCounters(AesBlock& counter, u8* out, std::size_t num_blocks) {
+    u64 high;
+    u64 low;
+    std::memcpy(&high, counter.data(), sizeof(high));
+    std::memcpy(&low, counter.data() + sizeof(high), sizeof(low));
+    high = Common::swap64(high);
+    low = Common::swap64(low);
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        const u64 high_be = Common::swap64(high);
+        const u64 low_be = Common::swap64(low);
+        std::memcpy(out + block * AesBlockSize, &high_be, sizeof(high_be));
+        std::memcpy(out + block * AesBlockSize + sizeof(high_be), &low_be, sizeof(low_be));
+        if (++low == 0) {
+            ++high;
+        }
+    }
+    high = Common::swap64(high);
+    low = Common::swap64(low);
+    std::memcpy(counter.data(), &high, sizeof(high));
+    std::memcpy(counter.data() + sizeof(high), &low, sizeof(low));
+}
+
+/// Writes the XTS tweaks of consecutive blocks to out, advancing tweak past them
+void GenerateTweaks(AesBlock& tweak, u8* out, std::size_t num_blocks) {
+    u64 low;
+    u64 high;
+    std::memcpy(&low, tweak.data(), sizeof(low));
+    std::memcpy(&high, tweak.data() + sizeof(low), sizeof(high));
+    for (std::size_t block = 0; block < num_blocks; ++block) {
+        std::memcpy(out + block * AesBlockSize, &low, sizeof(low));
+        std::memcpy(out + block * AesBlockSize + sizeof(low), &high, sizeof(high));
+
+        // Multiply by x in GF(2^128), the tweak being a little endian number.
+        const u64 carry = high >> 63;
+        high = (high << 1) | (low >> 63);
+        low = (low << 1) ^ (carry * 0x87);
+    }
+    std::memcpy(tweak.data(), &low, sizeof(low));
+    std::memcpy(tweak.data() + sizeof(low), &high, sizeof(high));
+}
+#endif
 } // Anonymous namespace
 
 static_assert(static_cast<std::size_t>(Mode::CTR) ==
@@ -36,8 +241,65 @@ static_assert(static_cast<std::size_t>(Mode::XTS) ==
 struct CipherContext {
     mbedtls_cipher_context_t encryption_context;
     mbedtls_cipher_context_t decryption_context;
+
+    // CTR and XTS are done with the CPU's AES instructions instead of mbedtls when available.
+    Mode mode;
+    bool accelerated;
+    AesRoundKeys data_keys;
+    AesRoundKeys tweak_keys;
+    AesBlock iv;
 };
 
+#if defined(HAS_HARDWARE_AES)
+namespace {
+void TranscodeCtr(CipherContext& ctx, const u8* src, std::size_t size, u8* dest) {
+    std::array<u8, BlocksPerChunk * AesBlockSize> counters;
+    const std::size_t num_blocks = size / AesBlockSize;
+    for (std::size_t block = 0; block < num_blocks; block += BlocksPerChunk) {
+        const std::size_t chunk_blocks = std::min(BlocksPerChunk, num_blocks - block);
+        const std::size_t offset = block * AesBlockSize;
+        GenerateCounters(ctx.iv, counters.data(), chunk_blocks);
+        CryptBlocks<CryptMode::Ctr>(ctx.data_keys.encrypt, src + offset, counters.data(),
+                                    dest + offset, chunk_blocks);
+    }
+
+    // Like mbedtls, the counter of a trailing partial block is used up.
+    const std::size_t remaining = size % AesBlockSize;
+    if (remaining != 0) {
+        const std::size_t offset = size - remaining;
+        AesBlock block{};
+        std::memcpy(block.data(), src + offset, remaining);
+        GenerateCounters(ctx.iv, counters.data(), 1);
+        CryptBlocks<CryptMode::Ctr>(ctx.data_keys.encrypt, block.data(), counters.data(),
+                                    block.data(), 1);
+        std::memcpy(dest + offset, block.data(), remaining);
+    }
+}
+
+void TranscodeXts(CipherContext& ctx, const u8* src, std::size_t size, u8* dest, Op op) {
+    static constexpr AesBlock zero_block{};
+    AesBlock tweak;
+    CryptBlocks<CryptMode::XtsEncrypt>(ctx.tweak_keys.encrypt, ctx.iv.data(), zero_block.data(),
+                                       tweak.data(), 1);
+
+    std::array<u8, BlocksPerChunk * AesBlockSize> tweaks;
+    const std::size_t num_blocks = size / AesBlockSize;
+    for (std::size_t block = 0; block < num_blocks; block += BlocksPerChunk) {
+        const std::size_t chunk_blocks = std::min(BlocksPerChunk, num_blocks - block);
+        const std::size_t offset = block * AesBlockSize;
+        GenerateTweaks(tweak, tweaks.data(), chunk_blocks);
+        if (op == Op::Encrypt) {
+            CryptBlocks<CryptMode::XtsEncrypt>(ctx.data_keys.encrypt, src + offset, tweaks.data(),
+                                               dest + offset, chunk_blocks);
+        } else {
+            CryptBlocks<CryptMode::XtsDecrypt>(ctx.data_keys.decrypt, src + offset, tweaks.data(),
+                                               dest + offset, chunk_blocks);
+        }
+    }
+}
+} // Anonymous namespace
+#endif
+
 template <typename Key, std::size_t KeySize>
 Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     : ctx(std::make_unique<CipherContext>()) {
@@ -57,6 +319,23 @@ Crypto::AESCipher<Key, KeySize>::AESCipher(Key key, Mode mode)
     ASSERT(
         !mbedtls_cipher_setkey(&ctx->decryption_context, key.data(), KeySize * 8, MBEDTLS_DECRYPT));
     //"Failed to set key on mbedtls ciphers.");
+
+    ctx->mode = mode;
+    ctx->accelerated = false;
+    ctx->iv = {};
+#if defined(HAS_HARDWARE_AES)
+    // AES-128-CTR takes a 128-bit key and AES-128-XTS a 128-bit data key followed by the tweak key.
+    if (IsAesAccelerated()) {
+        if (mode == Mode::CTR && KeySize == 0x10) {
+            ExpandKey(ctx->data_keys, key.data());
+            ctx->accelerated = true;
+        } else if (mode == Mode::XTS && KeySize == 0x20) {
+            ExpandKey(ctx->data_keys, key.data());
+            ExpandKey(ctx->tweak_keys, key.data() + 0x10);
+            ctx->accelerated = true;
+        }
+    }
+#endif
 }
 
 template <typename Key, std::size_t KeySize>
@@ -67,6 +346,24 @@ AESCipher<Key, KeySize>::~AESCipher() {
 
 template <typename Key, std::size_t KeySize>
 void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* dest, Op op) const {
+    if (size == 0) {
+        return;
+    }
+
+#if defined(HAS_HARDWARE_AES)
+    if (ctx->accelerated) {
+        if (ctx->mode == Mode::CTR) {
+            TranscodeCtr(*ctx, src, size, dest);
+            return;
+        }
+        // Sizes that need ciphertext stealing are left to mbedtls.
+        if (size % AesBlockSize == 0) {
+            TranscodeXts(*ctx, src, size, dest, op);
+            return;
+        }
+    }
+#endif
+
     auto* const context = op == Op::Encrypt ? &ctx->encryption_context : &ctx->decryption_context;
 
     mbedtls_cipher_reset(context);
@@ -88,7 +385,19 @@ void AESCipher<Key, KeySize>::Transcode(const u8* src, std::size_t size, u8* des
             return;
         }
 
-        for (std::size_t offset = 0; offset < size; offset += block_size) {
+        std::size_t offset = 0;
+        if (mbedtls_cipher_get_cipher_mode(context) == MBEDTLS_MODE_CTR) {
+            // CTR is a stream mode, so all whole blocks can be done at once. A trailing partial
+            // block is left to the loop, as mbedtls doesn't transcode those in place.
+            offset = size - size % block_size;
+            mbedtls_cipher_update(context, src, offset, dest, &written);
+            if (written != offset) {
+                LOG_WARNING(Crypto, "Not all data was decrypted requested={:016X}, actual={:016X}.",
+                            offset, written);
+            }
+        }
+
+        for (; offset < size; offset += block_size) {
             auto length = std::min<std::size_t>(block_size, size - offset);
             mbedtls_cipher_update(context, src + offset, length, dest + offset, &written);
             if (written != length) {
@@ -122,6 +431,7 @@ void AESCipher<Key, KeySize>::SetIV(std::span<const u8> data) {
     ASSERT_MSG((mbedtls_cipher_set_iv(&ctx->encryption_context, data.data(), data.size()) ||
                 mbedtls_cipher_set_iv(&ctx->decryption_context, data.data(), data.size())) == 0,
                "Failed to set IV on mbedtls ciphers.");
+    std::memcpy(ctx->iv.data(), data.data(), std::min(data.size(), ctx->iv.size()));
 }
 
 template class AESCipher<Key128>;
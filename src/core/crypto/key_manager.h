@@ -15,6 +15,7 @@
 #include "common/common_funcs.h"
 #include "common/common_types.h"
 #include "core/crypto/partition_data_manager.h"
+#include "core/crypto/sha_util.h"
 
 namespace Common::FS {
 class IOFile;
@@ -32,7 +33,6 @@ namespace Core::Crypto {
 
 using Key128 = std::array<u8, 0x10>;
 using Key256 = std::array<u8, 0x20>;
-using SHA256Hash = std::array<u8, 0x20>;
 
 enum class SignatureType {
     RSA_4096_SHA1 = 0x10000,
@@ -1,4 +1,231 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-namespace Crypto {} // namespace Crypto
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <mbedtls/sha256.h>
+
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#define HAS_HARDWARE_SHA256
+#endif
+
+#include "common/swap.h"
+#include "core/crypto/sha_util.h"
+
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SHA __attribute__((target("sha,sse4.1")))
+#else
+#define TARGET_SHA
+#endif
+
+namespace Core::Crypto {
+namespace {
+constexpr std::size_t BlockSize = 64;
+
+using State = std::array<u32, 8>;
+
+constexpr State InitialState{
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19,
+};
+
+[[maybe_unused]] constexpr std::array<u32, 64> RoundConstants{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+#if defined(ARCHITECTURE_x86_64)
+bool IsAccelerated() {
+    const auto& caps = Common::GetCPUCaps();
+    return caps.sha && caps.sse4_1;
+}
+
+TARGET_SHA __m128i LoadConstants(std::size_t group) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(RoundConstants.data() + group * 4));
+}
+
+/// Computes the message words of a group of four rounds from those of the previous four groups
+TARGET_SHA __m128i ScheduleMessage(__m128i w0, __m128i w1, __m128i w2, __m128i w3) {
+    const __m128i sum = _mm_add_epi32(_mm_sha256msg1_epu32(w0, w1), _mm_alignr_epi8(w3, w2, 4));
+    return _mm_sha256msg2_epu32(sum, w3);
+}
+
+TARGET_SHA void DoRounds(__m128i& abef, __m128i& cdgh, __m128i message, std::size_t group) {
+    __m128i words = _mm_add_epi32(message, LoadConstants(group));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+    words = _mm_shuffle_epi32(words, 0x0E);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, words);
+}
+
+TARGET_SHA void ProcessBlocks(State& state, const u8* data, std::size_t num_blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0C0D0E0F08090A0BULL, 0x0405060700010203ULL);
+
+    // The round instructions keep the state as ABEF and CDGH.
+    const __m128i abcd = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data()));
+    const __m128i efgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state.data() + 4));
+    const __m128i dcba = _mm_shuffle_epi32(abcd, 0xB1);
+    const __m128i hgfe = _mm_shuffle_epi32(efgh, 0x1B);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xF0);
+
+    for (; num_blocks > 0; --num_blocks, data += BlockSize) {
+        const __m128i abef_save = abef;
+        const __m128i cdgh_save = cdgh;
+
+        __m128i w[4];
+        for (std::size_t i = 0; i < 4; ++i) {
+            const auto* const words = reinterpret_cast<const __m128i*>(data + i * 16);
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(words), byte_swap);
+        }
+        for (std::size_t group = 0; group < 16; group += 4) {
+            if (group != 0) {
+                w[0] = ScheduleMessage(w[0], w[1], w[2], w[3]);
+            }
+            DoRounds(abef, cdgh, w[0], group);
+            if (group != 0) {
+                w[1] = ScheduleMessage(w[1], w[2], w[3], w[0]);
+            }
+            DoRounds(abef, cdgh, w[1], group + 1);
+            if (group != 0) {
+                w[2] = ScheduleMessage(w[2], w[3], w[0], w[1]);
+            }
+            DoRounds(abef, cdgh, w[2], group + 2);
+            if (group != 0) {
+                w[3] = ScheduleMessage(w[3], w[0], w[1], w[2]);
+            }
+            DoRounds(abef, cdgh, w[3], group + 3);
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data()), _mm_blend_epi16(feba, dchg, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state.data() + 4),
+                     _mm_alignr_epi8(dchg, feba, 8));
+}
+#else
+bool IsAccelerated() {
+    return false;
+}
+
+void ProcessBlocks(State&, const u8*, std::size_t) {}
+#endif
+} // Anonymous namespace
+
+struct SHA256Context::Impl {
+    bool accelerated;
+
+    // Used without SHA extensions
+    mbedtls_sha256_context mbedtls_context;
+
+    // Used with SHA extensions
+    State state;
+    std::array<u8, BlockSize> buffer;
+    std::size_t buffered_size;
+    u64 total_size;
+};
+
+SHA256Context::SHA256Context() : impl{std::make_unique<Impl>()} {
+    impl->accelerated = IsAccelerated();
+    if (!impl->accelerated) {
+        mbedtls_sha256_init(&impl->mbedtls_context);
+        mbedtls_sha256_starts_ret(&impl->mbedtls_context, 0);
+        return;
+    }
+    impl->state = InitialState;
+    impl->buffered_size = 0;
+    impl->total_size = 0;
+}
+
+SHA256Context::~SHA256Context() {
+    if (!impl->accelerated) {
+        mbedtls_sha256_free(&impl->mbedtls_context);
+    }
+}
+
+void SHA256Context::Update(std::span<const u8> data) {
+    if (!impl->accelerated) {
+        mbedtls_sha256_update_ret(&impl->mbedtls_context, data.data(), data.size());
+        return;
+    }
+    if (data.empty()) {
+        return;
+    }
+    impl->total_size += data.size();
+
+    // Complete the buffered block first.
+    if (impl->buffered_size != 0) {
+        const std::size_t copy_size = std::min(BlockSize - impl->buffered_size, data.size());
+        std::memcpy(impl->buffer.data() + impl->buffered_size, data.data(), copy_size);
+        impl->buffered_size += copy_size;
+        data = data.subspan(copy_size);
+        if (impl->buffered_size < BlockSize) {
+            return;
+        }
+        ProcessBlocks(impl->state, impl->buffer.data(), 1);
+        impl->buffered_size = 0;
+    }
+
+    const std::size_t num_blocks = data.size() / BlockSize;
+    ProcessBlocks(impl->state, data.data(), num_blocks);
+    data = data.subspan(num_blocks * BlockSize);
+
+    std::memcpy(impl->buffer.data(), data.data(), data.size());
+    impl->buffered_size = data.size();
+}
+
+SHA256Hash SHA256Context::Finish() {
+    SHA256Hash hash;
+    if (!impl->accelerated) {
+        mbedtls_sha256_finish_ret(&impl->mbedtls_context, hash.data());
+        return hash;
+    }
+
+    // Pad with a one bit, zeros and the big endian length in bits.
+    const u64 total_bits = Common::swap64(impl->total_size * 8);
+    std::array<u8, BlockSize * 2> padding{};
+    const std::size_t padded_size = impl->buffered_size < BlockSize - sizeof(total_bits)
+                                        ? BlockSize
+                                        : BlockSize * 2;
+    std::memcpy(padding.data(), impl->buffer.data(), impl->buffered_size);
+    padding[impl->buffered_size] = 0x80;
+    std::memcpy(padding.data() + padded_size - sizeof(total_bits), &total_bits,
+                sizeof(total_bits));
+    ProcessBlocks(impl->state, padding.data(), padded_size / BlockSize);
+
+    for (std::size_t i = 0; i < impl->state.size(); ++i) {
+        const u32 word = Common::swap32(impl->state[i]);
+        std::memcpy(hash.data() + i * sizeof(word), &word, sizeof(word));
+    }
+    return hash;
+}
+
+SHA256Hash CalculateSHA256(std::span<const u8> data) {
+    SHA256Context context;
+    context.Update(data);
+    return context.Finish();
+}
+
+bool IsSHA256Accelerated() {
+    return IsAccelerated();
+}
+
+} // namespace Core::Crypto
@@ -3,17 +3,35 @@
 
 #pragma once
 
-#include "common/assert.h"
-#include "core/file_sys/vfs.h"
-#include "key_manager.h"
-#include "mbedtls/cipher.h"
+#include <array>
+#include <memory>
+#include <span>
+#include "common/common_types.h"
 
-namespace Crypto {
-typedef std::array<u8, 0x20> SHA256Hash;
+namespace Core::Crypto {
 
-inline SHA256Hash operator"" _HASH(const char* data, size_t len) {
-    if (len != 0x40)
-        return {};
-}
+using SHA256Hash = std::array<u8, 0x20>;
 
-} // namespace Crypto
+/// Incrementally computes a SHA-256 hash, using the CPU's SHA extensions when available.
+class SHA256Context {
+public:
+    SHA256Context();
+    ~SHA256Context();
+
+    void Update(std::span<const u8> data);
+
+    /// Returns the hash of all data passed to Update, after which the context must not be used.
+    SHA256Hash Finish();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+/// Computes the SHA-256 hash of data
+SHA256Hash CalculateSHA256(std::span<const u8> data);
+
+/// Whether hashes are computed with the CPU's SHA extensions rather than in software
+bool IsSHA256Accelerated();
+
+} // namespace Core::Crypto
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache_storage.h"
+#include "core/file_sys/fssystem/fssystem_pooled_buffer.h"
+
+namespace FileSys {
+namespace {
+size_t GetMaxBlocks(size_t capacity) {
+    return std::max<size_t>(capacity / DecryptedBlockCache::BlockSize, 1);
+}
+
+/// Small caches get fewer shards, so that each shard holds at least one block
+size_t GetNumShards(size_t capacity) {
+    return std::min(GetMaxBlocks(capacity), DecryptedBlockCache::MaxShards);
+}
+} // Anonymous namespace
+
+size_t DecryptedBlockCache::KeyHash::operator()(const Key& key) const noexcept {
+    // The section id is a SHA-256 hash, so any part of it is as good as a hash of the whole.
+    u64 id;
+    std::memcpy(&id, key.section_id.data(), sizeof(id));
+    return static_cast<size_t>(id ^ (static_cast<u64>(key.offset) * 0x9E3779B97F4A7C15ULL));
+}
+
+DecryptedBlockCache::DecryptedBlockCache(size_t capacity)
+    : max_blocks_per_shard{GetMaxBlocks(capacity) / GetNumShards(capacity)},
+      shards(GetNumShards(capacity)) {}
+
+DecryptedBlockCache::~DecryptedBlockCache() = default;
+
+DecryptedBlockCache& DecryptedBlockCache::Instance() {
+    static DecryptedBlockCache cache;
+    return cache;
+}
+
+DecryptedBlockCache::Shard& DecryptedBlockCache::GetShard(const Key& key) {
+    // The low bits of the hash select the bucket in the shard's map, so pick the shard by the high
+    // ones, where the offset of the block is mixed in.
+    const u64 hash = KeyHash{}(key);
+    return shards[(hash >> 32) % shards.size()];
+}
+
+bool DecryptedBlockCache::Read(const Key& key, u8* buffer, size_t size, size_t offset_in_block) {
+    Shard& shard = GetShard(key);
+    std::scoped_lock lk{shard.mutex};
+
+    const auto it = shard.lookup.find(key);
+    if (it == shard.lookup.end()) {
+        return false;
+    }
+    const Block& block = *it->second;
+    if (offset_in_block + size > block.data.size()) {
+        return false;
+    }
+
+    std::memcpy(buffer, block.data.data() + offset_in_block, size);
+    shard.blocks.splice(shard.blocks.begin(), shard.blocks, it->second);
+    return true;
+}
+
+void DecryptedBlockCache::Insert(const Key& key, const u8* data, size_t size) {
+    ASSERT(size <= BlockSize);
+    Shard& shard = GetShard(key);
+    std::scoped_lock lk{shard.mutex};
+
+    BlockList& blocks = shard.blocks;
+    if (const auto it = shard.lookup.find(key); it != shard.lookup.end()) {
+        it->second->data.assign(data, data + size);
+        blocks.splice(blocks.begin(), blocks, it->second);
+        return;
+    }
+
+    // Reuse the least recently used block once the shard is full, to keep its allocation.
+    if (blocks.size() >= max_blocks_per_shard) {
+        shard.lookup.erase(blocks.back().key);
+        blocks.splice(blocks.begin(), blocks, std::prev(blocks.end()));
+    } else {
+        blocks.emplace_front();
+    }
+
+    Block& block = blocks.front();
+    block.key = key;
+    block.data.assign(data, data + size);
+    shard.lookup.emplace(key, blocks.begin());
+}
+
+void DecryptedBlockCache::Clear() {
+    for (Shard& shard : shards) {
+        std::scoped_lock lk{shard.mutex};
+        shard.lookup.clear();
+        shard.blocks.clear();
+    }
+}
+
+size_t DecryptedBlockCache::GetNumBlocks() const {
+    size_t num_blocks = 0;
+    for (const Shard& shard : shards) {
+        std::scoped_lock lk{shard.mutex};
+        num_blocks += shard.blocks.size();
+    }
+    return num_blocks;
+}
+
+DecryptedBlockCacheStorage::DecryptedBlockCacheStorage(
+    VirtualFile base, const DecryptedBlockCache::SectionId& section_id, DecryptedBlockCache& cache)
+    : m_base_storage(std::move(base)), m_section_id(section_id), m_cache(cache),
+      m_size(m_base_storage->GetSize()) {}
+
+size_t DecryptedBlockCacheStorage::Read(u8* buffer, size_t size, size_t offset) const {
+    constexpr size_t BlockSize = DecryptedBlockCache::BlockSize;
+
+    // Allow zero-size reads, and clamp reads to the end of the storage.
+    if (size == 0 || offset >= m_size) {
+        return 0;
+    }
+    size = std::min(size, m_size - offset);
+
+    // Ensure buffer is valid.
+    ASSERT(buffer != nullptr);
+
+    PooledBuffer pooled_buffer;
+    u8* work_buffer = nullptr;
+    size_t processed_size = 0;
+    while (processed_size < size) {
+        const size_t cur_offset = offset + processed_size;
+        const size_t block_offset = Common::AlignDown(cur_offset, BlockSize);
+        const size_t offset_in_block = cur_offset - block_offset;
+        const size_t block_size = std::min(BlockSize, m_size - block_offset);
+        const size_t cur_size = std::min(size - processed_size, block_size - offset_in_block);
+        const DecryptedBlockCache::Key key{
+            .section_id = m_section_id,
+            .offset = static_cast<s64>(block_offset),
+        };
+        u8* const dst = buffer + processed_size;
+
+        if (m_cache.Read(key, dst, cur_size, offset_in_block)) {
+            processed_size += cur_size;
+            continue;
+        }
+
+        // Decrypt whole blocks straight into the buffer, partial ones into a work buffer.
+        const bool whole_block = offset_in_block == 0 && cur_size == block_size;
+        if (!whole_block && work_buffer == nullptr) {
+            pooled_buffer.Allocate(BlockSize, BlockSize);
+            ASSERT(pooled_buffer.GetSize() >= BlockSize);
+            work_buffer = reinterpret_cast<u8*>(pooled_buffer.GetBuffer());
+        }
+        u8* const block = whole_block ? dst : work_buffer;
+
+        const size_t read_size = m_base_storage->Read(block, block_size, block_offset);
+        if (read_size != block_size) {
+            // Don't cache blocks that couldn't be read entirely.
+            const size_t available =
+                read_size > offset_in_block ? std::min(cur_size, read_size - offset_in_block) : 0;
+            if (!whole_block && available != 0) {
+                std::memcpy(dst, block + offset_in_block, available);
+            }
+            return processed_size + available;
+        }
+
+        m_cache.Insert(key, block, block_size);
+        if (!whole_block) {
+            std::memcpy(dst, block + offset_in_block, cur_size);
+        }
+        processed_size += cur_size;
+    }
+
+    return processed_size;
+}
+
+size_t DecryptedBlockCacheStorage::GetSize() const {
+    return m_size;
+}
+
+} // namespace FileSys
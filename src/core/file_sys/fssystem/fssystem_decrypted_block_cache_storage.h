@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "core/file_sys/fssystem/fs_i_storage.h"
+
+namespace FileSys {
+
+/**
+ * Bounded least recently used cache of decrypted NCA section data, shared by all open NCAs.
+ * Blocks are keyed by an id of the section's content and their offset in the section, so that a
+ * section opened again, e.g. by another process or after a title restart, finds its blocks too.
+ * The cache is split into shards by key hash, each with its own lock and LRU order, so that reads
+ * from several threads don't all wait on the same lock.
+ */
+class DecryptedBlockCache {
+    SUYU_NON_COPYABLE(DecryptedBlockCache);
+    SUYU_NON_MOVEABLE(DecryptedBlockCache);
+
+public:
+    static constexpr size_t BlockSize = 0x1000;
+    static constexpr size_t DefaultCapacity = 64 * 1024 * 1024;
+    static constexpr size_t MaxShards = 16;
+
+    using SectionId = std::array<u8, 0x20>;
+
+    struct Key {
+        SectionId section_id;
+        s64 offset;
+
+        bool operator==(const Key&) const = default;
+    };
+
+public:
+    explicit DecryptedBlockCache(size_t capacity = DefaultCapacity);
+    ~DecryptedBlockCache();
+
+    /// Returns the cache used for NCAs opened by the emulated filesystem
+    static DecryptedBlockCache& Instance();
+
+    /**
+     * Copies part of a cached block into buffer and marks the block as most recently used.
+     * Returns false without copying if the block isn't cached or shorter than the part.
+     */
+    bool Read(const Key& key, u8* buffer, size_t size, size_t offset_in_block);
+
+    /// Inserts a block of at most BlockSize bytes, evicting the least recently used ones if full
+    void Insert(const Key& key, const u8* data, size_t size);
+
+    /// Drops all cached blocks
+    void Clear();
+
+    [[nodiscard]] size_t GetNumBlocks() const;
+
+private:
+    struct Block {
+        Key key;
+        std::vector<u8> data;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept;
+    };
+
+    using BlockList = std::list<Block>;
+
+    struct Shard {
+        BlockList blocks; ///< Most recently used first
+        std::unordered_map<Key, BlockList::iterator, KeyHash> lookup;
+        mutable std::mutex mutex;
+    };
+
+    Shard& GetShard(const Key& key);
+
+    const size_t max_blocks_per_shard;
+    std::vector<Shard> shards;
+};
+
+/// Serves reads of a decrypted storage from a DecryptedBlockCache, filling it on misses
+class DecryptedBlockCacheStorage : public IReadOnlyStorage {
+    SUYU_NON_COPYABLE(DecryptedBlockCacheStorage);
+    SUYU_NON_MOVEABLE(DecryptedBlockCacheStorage);
+
+public:
+    DecryptedBlockCacheStorage(VirtualFile base, const DecryptedBlockCache::SectionId& section_id,
+                               DecryptedBlockCache& cache);
+
+    virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
+    virtual size_t GetSize() const override;
+
+private:
+    VirtualFile m_base_storage;
+    DecryptedBlockCache::SectionId m_section_id;
+    DecryptedBlockCache& m_cache;
+    size_t m_size;
+};
+
+} // namespace FileSys
@@ -16,18 +16,37 @@ HierarchicalIntegrityVerificationStorage::HierarchicalIntegrityVerificationStora
 Result HierarchicalIntegrityVerificationStorage::Initialize(
     const HierarchicalIntegrityVerificationInformation& info,
     HierarchicalStorageInformation storage, int max_data_cache_entries, int max_hash_cache_entries,
-    s8 buffer_level) {
+    s8 buffer_level, bool verify_data, VirtualFile verified_source) {
     // Validate preconditions.
     ASSERT(IntegrityMinLayerCount <= info.max_layers && info.max_layers <= IntegrityMaxLayerCount);
 
     // Set member variables.
     m_max_layers = info.max_layers;
 
+    // Get the verified block bitmaps of the levels, shared by the storages of this hash tree opened
+    // on the same source file. Without a source, they are private to this storage.
+    std::array<std::shared_ptr<VerifiedBlockBitmap>, MaxLayers - 1> verified_blocks{};
+    if (verify_data) {
+        VerifiedBlockBitmap::MasterHash master_hash{};
+        storage[HierarchicalStorageInformation::MasterStorage]->Read(master_hash.data(),
+                                                                     master_hash.size(), 0);
+        for (s32 level = 0; level < m_max_layers - 1; ++level) {
+            const s64 num_blocks = Common::DivideUp(info.info[level].size.Get(),
+                                                    static_cast<s64>(1)
+                                                        << info.info[level].block_order);
+            verified_blocks[level] =
+                verified_source != nullptr
+                    ? VerifiedBlockBitmap::GetShared(verified_source, master_hash, level,
+                                                     static_cast<size_t>(num_blocks))
+                    : std::make_shared<VerifiedBlockBitmap>(static_cast<size_t>(num_blocks));
+        }
+    }
+
     // Initialize the top level verification storage.
     m_verify_storages[0]->Initialize(storage[HierarchicalStorageInformation::MasterStorage],
                                      storage[HierarchicalStorageInformation::Layer1Storage],
                                      static_cast<s64>(1) << info.info[0].block_order, HashSize,
-                                     false);
+                                     false, verified_blocks[0]);
 
     // Ensure we don't leak state if further initialization goes wrong.
     ON_RESULT_FAILURE {
@@ -59,7 +78,8 @@ Result HierarchicalIntegrityVerificationStorage::Initialize(
         m_verify_storages[level + 1]->Initialize(
             std::move(buffer_storage), storage[level + 2],
             static_cast<s64>(1) << info.info[level + 1].block_order,
-            static_cast<s64>(1) << info.info[level].block_order, false);
+            static_cast<s64>(1) << info.info[level].block_order, false,
+            verified_blocks[level + 1]);
 
         // Initialize the buffer storage.
         m_buffer_storages[level + 1] = m_verify_storages[level + 1];
@@ -75,7 +95,8 @@ Result HierarchicalIntegrityVerificationStorage::Initialize(
         m_verify_storages[level + 1]->Initialize(
             std::move(buffer_storage), storage[level + 2],
             static_cast<s64>(1) << info.info[level + 1].block_order,
-            static_cast<s64>(1) << info.info[level].block_order, true);
+            static_cast<s64>(1) << info.info[level].block_order, true,
+            verified_blocks[level + 1]);
 
         // Initialize the buffer storage.
         m_buffer_storages[level + 1] = m_verify_storages[level + 1];
@@ -115,7 +115,8 @@ public:
 
     Result Initialize(const HierarchicalIntegrityVerificationInformation& info,
                       HierarchicalStorageInformation storage, int max_data_cache_entries,
-                      int max_hash_cache_entries, s8 buffer_level);
+                      int max_hash_cache_entries, s8 buffer_level, bool verify_data = false,
+                      VirtualFile verified_source = nullptr);
     void Finalize();
 
     virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
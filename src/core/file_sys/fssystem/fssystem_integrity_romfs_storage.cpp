@@ -8,7 +8,8 @@ namespace FileSys {
 Result IntegrityRomFsStorage::Initialize(
     HierarchicalIntegrityVerificationInformation level_hash_info, Hash master_hash,
     HierarchicalIntegrityVerificationStorage::HierarchicalStorageInformation storage_info,
-    int max_data_cache_entries, int max_hash_cache_entries, s8 buffer_level) {
+    int max_data_cache_entries, int max_hash_cache_entries, s8 buffer_level, bool verify_data,
+    VirtualFile verified_source) {
     // Set master hash.
     m_master_hash = master_hash;
     m_master_hash_storage = std::make_shared<ArrayVfsFile<sizeof(Hash)>>(m_master_hash.value);
@@ -20,7 +21,8 @@ Result IntegrityRomFsStorage::Initialize(
 
     // Initialize our integrity storage.
     R_RETURN(m_integrity_storage.Initialize(level_hash_info, storage_info, max_data_cache_entries,
-                                            max_hash_cache_entries, buffer_level));
+                                            max_hash_cache_entries, buffer_level, verify_data,
+                                            std::move(verified_source)));
 }
 
 void IntegrityRomFsStorage::Finalize() {
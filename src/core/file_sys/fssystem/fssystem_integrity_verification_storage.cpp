@@ -1,18 +1,76 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <bit>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
 #include "common/alignment.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "core/crypto/sha_util.h"
 #include "core/file_sys/fssystem/fssystem_integrity_verification_storage.h"
+#include "core/file_sys/fssystem/fssystem_pooled_buffer.h"
 
 namespace FileSys {
 
+namespace {
+
+// Reads with fewer unverified bytes than this are hashed on the reading thread.
+constexpr size_t ParallelHashMinSize = 1_MiB;
+
+Common::ThreadWorker& GetHashWorkers() {
+    // Leave half of the host threads to the emulated cores and the GPU.
+    static Common::ThreadWorker workers(std::max(std::thread::hardware_concurrency() / 2, 1U),
+                                        "IntegrityHasher");
+    return workers;
+}
+
+/// Calls func for each index below count, on the hash workers and the calling thread
+template <typename Func>
+void ParallelFor(size_t count, const Func& func) {
+    auto& workers = GetHashWorkers();
+    const size_t num_tasks = std::min(count - 1, workers.NumWorkers());
+
+    std::atomic<size_t> next_index{0};
+    const auto run = [&] {
+        for (size_t index = next_index++; index < count; index = next_index++) {
+            func(index);
+        }
+    };
+
+    // The tasks reference this frame, so wait for all of them even if the work ran out.
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t pending_tasks = num_tasks;
+    for (size_t task = 0; task < num_tasks; ++task) {
+        workers.QueueWork([&] {
+            run();
+            std::scoped_lock lk{mutex};
+            if (--pending_tasks == 0) {
+                finished.notify_all();
+            }
+        });
+    }
+    run();
+
+    std::unique_lock lk{mutex};
+    finished.wait(lk, [&] { return pending_tasks == 0; });
+}
+
+} // Anonymous namespace
+
 constexpr inline u32 ILog2(u32 val) {
     ASSERT(val > 0);
     return static_cast<u32>((sizeof(u32) * 8) - 1 - std::countl_zero<u32>(val));
 }
 
 void IntegrityVerificationStorage::Initialize(VirtualFile hs, VirtualFile ds, s64 verif_block_size,
-                                              s64 upper_layer_verif_block_size, bool is_real_data) {
+                                              s64 upper_layer_verif_block_size, bool is_real_data,
+                                              std::shared_ptr<VerifiedBlockBitmap> verif_blocks) {
     // Validate preconditions.
     ASSERT(verif_block_size >= HashSize);
 
@@ -40,11 +98,20 @@ void IntegrityVerificationStorage::Initialize(VirtualFile hs, VirtualFile ds, s6
 
     // Set data.
     m_is_real_data = is_real_data;
+
+    // Set the verified blocks, if the data is to be verified.
+    if (verif_blocks != nullptr) {
+        ASSERT(verif_blocks->GetNumBlocks() >=
+               static_cast<size_t>(Common::DivideUp(m_data_storage->GetSize(),
+                                                    m_verification_block_size)));
+    }
+    m_verified_blocks = std::move(verif_blocks);
 }
 
 void IntegrityVerificationStorage::Finalize() {
     m_hash_storage = VirtualFile();
     m_data_storage = VirtualFile();
+    m_verified_blocks.reset();
 }
 
 size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset) const {
@@ -81,7 +148,103 @@ size_t IntegrityVerificationStorage::Read(u8* buffer, size_t size, size_t offset
     }
 
     // Perform the read.
-    return m_data_storage->Read(buffer, read_size, offset);
+    const size_t read = m_data_storage->Read(buffer, read_size, offset);
+    if (m_verified_blocks == nullptr || read == 0) {
+        return read;
+    }
+
+    // Verify the blocks read, including the cleared padding if the whole range was read.
+    const size_t verified = this->VerifyBlocks(buffer, read == read_size ? size : read, offset);
+    return std::min(read, verified);
+}
+
+size_t IntegrityVerificationStorage::VerifyBlocks(u8* buffer, size_t size, size_t offset) const {
+    const size_t block_size = static_cast<size_t>(m_verification_block_size);
+    const size_t data_size = m_data_storage->GetSize();
+
+    // Determine the range of blocks that still need verification.
+    size_t begin_block = offset >> m_verification_block_order;
+    size_t end_block = ((offset + size - 1) >> m_verification_block_order) + 1;
+    while (begin_block < end_block && m_verified_blocks->IsVerified(begin_block)) {
+        ++begin_block;
+    }
+    while (end_block > begin_block && m_verified_blocks->IsVerified(end_block - 1)) {
+        --end_block;
+    }
+    if (begin_block == end_block) {
+        return size;
+    }
+
+    // Read the hashes of the blocks, which verifies them against the upper layer.
+    const size_t num_blocks = end_block - begin_block;
+    std::vector<BlockHash> hashes(num_blocks);
+    const size_t hashes_read =
+        m_hash_storage->Read(reinterpret_cast<u8*>(hashes.data()), num_blocks * HashSize,
+                             begin_block * HashSize) /
+        HashSize;
+
+    // Blocks entirely within the buffer are hashed in place, edge blocks are read again whole.
+    std::vector<u8> valid(num_blocks);
+    std::vector<size_t> inner_blocks;
+    PooledBuffer pooled_buffer;
+    u8* work_buffer = nullptr;
+    for (size_t i = 0; i < hashes_read; ++i) {
+        const size_t block = begin_block + i;
+        const size_t block_offset = block * block_size;
+        if (m_verified_blocks->IsVerified(block)) {
+            valid[i] = 1;
+        } else if (block_offset >= offset && block_offset + block_size <= offset + size) {
+            inner_blocks.push_back(i);
+        } else {
+            if (work_buffer == nullptr) {
+                pooled_buffer.Allocate(block_size, block_size);
+                ASSERT(pooled_buffer.GetSize() >= block_size);
+                work_buffer = reinterpret_cast<u8*>(pooled_buffer.GetBuffer());
+            }
+            const size_t read_size = std::min(block_size, data_size - block_offset);
+            std::memset(work_buffer + read_size, 0, block_size - read_size);
+            valid[i] = m_data_storage->Read(work_buffer, read_size, block_offset) == read_size &&
+                       this->VerifyBlock(work_buffer, hashes[i]);
+        }
+    }
+
+    const auto verify_inner_block = [&](size_t index) {
+        const size_t i = inner_blocks[index];
+        const u8* const data = buffer + (begin_block + i) * block_size - offset;
+        valid[i] = this->VerifyBlock(data, hashes[i]);
+    };
+    if (inner_blocks.size() > 1 && inner_blocks.size() * block_size >= ParallelHashMinSize) {
+        ParallelFor(inner_blocks.size(), verify_inner_block);
+    } else {
+        for (size_t index = 0; index < inner_blocks.size(); ++index) {
+            verify_inner_block(index);
+        }
+    }
+
+    // Mark the valid blocks, and stop at the first corrupted one.
+    for (size_t i = 0; i < num_blocks; ++i) {
+        if (valid[i]) {
+            m_verified_blocks->SetVerified(begin_block + i);
+            continue;
+        }
+
+        const size_t block_offset = (begin_block + i) * block_size;
+        LOG_ERROR(Service_FS, "Integrity verification failed for block at offset {:#X}",
+                  block_offset);
+
+        // Don't hand out any corrupted data.
+        const size_t valid_size = block_offset > offset ? block_offset - offset : 0;
+        std::memset(buffer + valid_size, 0, size - valid_size);
+        return valid_size;
+    }
+
+    return size;
+}
+
+bool IntegrityVerificationStorage::VerifyBlock(const u8* data, const BlockHash& hash) const {
+    const auto calculated = Core::Crypto::CalculateSHA256(
+        {data, static_cast<size_t>(m_verification_block_size)});
+    return std::memcmp(calculated.data(), hash.hash.data(), HashSize) == 0;
 }
 
 size_t IntegrityVerificationStorage::GetSize() const {
@@ -3,10 +3,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include "core/file_sys/fssystem/fs_i_storage.h"
 #include "core/file_sys/fssystem/fs_types.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
 
 namespace FileSys {
 
@@ -31,7 +35,8 @@ public:
     }
 
     void Initialize(VirtualFile hs, VirtualFile ds, s64 verif_block_size,
-                    s64 upper_layer_verif_block_size, bool is_real_data);
+                    s64 upper_layer_verif_block_size, bool is_real_data,
+                    std::shared_ptr<VerifiedBlockBitmap> verif_blocks = nullptr);
     void Finalize();
 
     virtual size_t Read(u8* buffer, size_t size, size_t offset) const override;
@@ -42,6 +47,9 @@ public:
     }
 
 private:
+    size_t VerifyBlocks(u8* buffer, size_t size, size_t offset) const;
+    bool VerifyBlock(const u8* data, const BlockHash& hash) const;
+
     static void SetValidationBit(BlockHash* hash) {
         ASSERT(hash != nullptr);
         hash->hash[HashSize - 1] |= 0x80;
@@ -60,6 +68,7 @@ private:
     s64 m_upper_layer_verification_block_size;
     s64 m_upper_layer_verification_block_order;
     bool m_is_real_data;
+    std::shared_ptr<VerifiedBlockBitmap> m_verified_blocks;
 };
 
 } // namespace FileSys
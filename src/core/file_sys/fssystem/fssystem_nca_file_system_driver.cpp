@@ -1,11 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2023 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <mbedtls/sha256.h>
+
+#include "common/settings.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_counter_extended_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
 #include "core/file_sys/fssystem/fssystem_aes_xts_storage.h"
 #include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
 #include "core/file_sys/fssystem/fssystem_compressed_storage.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache_storage.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_integrity_verification_storage.h"
 #include "core/file_sys/fssystem/fssystem_hierarchical_sha256_storage.h"
 #include "core/file_sys/fssystem/fssystem_indirect_storage.h"
@@ -226,6 +230,12 @@ Result NcaFileSystemDriver::OpenStorageImpl(VirtualFile* out, NcaFsHeaderReader*
         }
     }
 
+    // Serve decrypted data that is read again from the block cache.
+    if (out_header_reader->GetEncryptionType() != NcaFsHeader::EncryptionType::None) {
+        R_TRY(this->CreateDecryptedBlockCacheStorage(std::addressof(storage), std::move(storage),
+                                                     *out_header_reader));
+    }
+
     // Process indirect layer.
     if (patch_info.HasIndirectTable()) {
         // Create the indirect meta storage.
@@ -389,6 +399,12 @@ Result NcaFileSystemDriver::OpenIndirectableStorageAsOriginal(
         R_THROW(ResultInvalidNcaFsHeaderEncryptionType);
     }
 
+    // Serve decrypted data that is read again from the block cache.
+    if (header_reader->GetEncryptionType() != NcaFsHeader::EncryptionType::None) {
+        R_TRY(this->CreateDecryptedBlockCacheStorage(std::addressof(storage), std::move(storage),
+                                                     *header_reader));
+    }
+
     // Set output storage.
     *out = std::move(storage);
     R_SUCCEED();
@@ -481,6 +497,44 @@ Result NcaFileSystemDriver::CreateAesXtsStorage(VirtualFile* out, VirtualFile ba
     R_SUCCEED();
 }
 
+Result NcaFileSystemDriver::CreateDecryptedBlockCacheStorage(
+    VirtualFile* out, VirtualFile base_storage, const NcaFsHeaderReader& header_reader) {
+    // Check pre-conditions.
+    ASSERT(out != nullptr);
+    ASSERT(base_storage != nullptr);
+
+    // Identify the section by its header hash and the keys it is decrypted with, so that blocks
+    // decrypted with a wrong key are not served once the right one is available.
+    const Hash& header_hash = m_reader->GetFsHeaderHash(header_reader.GetFsIndex());
+    std::array<u8, Hash::Size + AesXtsStorage::KeySize> id_source{};
+    std::memcpy(id_source.data(), header_hash.value.data(), Hash::Size);
+    u8* const key_dst = id_source.data() + Hash::Size;
+    if (header_reader.GetEncryptionType() == NcaFsHeader::EncryptionType::AesXts) {
+        std::memcpy(key_dst, m_reader->GetDecryptionKey(NcaHeader::DecryptionKey_AesXts1),
+                    AesXtsStorage::KeySize / 2);
+        std::memcpy(key_dst + AesXtsStorage::KeySize / 2,
+                    m_reader->GetDecryptionKey(NcaHeader::DecryptionKey_AesXts2),
+                    AesXtsStorage::KeySize / 2);
+    } else if (m_reader->HasExternalDecryptionKey()) {
+        std::memcpy(key_dst, m_reader->GetExternalDecryptionKey(), AesCtrStorage::KeySize);
+    } else {
+        std::memcpy(key_dst, m_reader->GetDecryptionKey(NcaHeader::DecryptionKey_AesCtr),
+                    AesCtrStorage::KeySize);
+    }
+
+    DecryptedBlockCache::SectionId section_id{};
+    mbedtls_sha256_ret(id_source.data(), id_source.size(), section_id.data(), 0);
+
+    // Create the cache storage.
+    auto cache_storage = std::make_shared<DecryptedBlockCacheStorage>(
+        std::move(base_storage), section_id, DecryptedBlockCache::Instance());
+    R_UNLESS(cache_storage != nullptr, ResultAllocationMemoryFailedAllocateShared);
+
+    // Set the out storage.
+    *out = std::move(cache_storage);
+    R_SUCCEED();
+}
+
 Result NcaFileSystemDriver::CreateSparseStorageMetaStorage(VirtualFile* out,
                                                            VirtualFile base_storage, s64 offset,
                                                            const NcaAesCtrUpperIv& upper_iv,
@@ -1261,7 +1315,9 @@ Result NcaFileSystemDriver::CreateIntegrityVerificationStorageImpl(
     // Initialize the integrity storage.
     R_TRY(integrity_storage->Initialize(level_hash_info, meta_info.master_hash, storage_info,
                                         max_data_cache_entries, max_hash_cache_entries,
-                                        buffer_level));
+                                        buffer_level,
+                                        Settings::values.verify_nca_integrity.GetValue(),
+                                        m_reader->GetSharedBodyStorage()));
 
     // Set the output.
     *out = std::move(integrity_storage);
@@ -284,6 +284,8 @@ private:
                                const NcaAesCtrUpperIv& upper_iv,
                                AlignmentStorageRequirement alignment_storage_requirement);
     Result CreateAesXtsStorage(VirtualFile* out, VirtualFile base_storage, s64 offset);
+    Result CreateDecryptedBlockCacheStorage(VirtualFile* out, VirtualFile base_storage,
+                                            const NcaFsHeaderReader& header_reader);
 
     Result CreateSparseStorageMetaStorage(VirtualFile* out, VirtualFile base_storage, s64 offset,
                                           const NcaAesCtrUpperIv& upper_iv,
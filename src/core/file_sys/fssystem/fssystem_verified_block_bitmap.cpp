@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <bit>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "common/alignment.h"
+#include "core/file_sys/fssystem/fssystem_verified_block_bitmap.h"
+
+namespace FileSys {
+
+namespace {
+
+using BitmapKey = std::tuple<const VfsFile*, VerifiedBlockBitmap::MasterHash, s32, size_t>;
+
+struct SharedBitmap {
+    std::weak_ptr<VfsFile> source;
+    std::weak_ptr<VerifiedBlockBitmap> bitmap;
+};
+
+std::mutex g_shared_bitmaps_mutex;
+std::map<BitmapKey, SharedBitmap> g_shared_bitmaps;
+
+} // Anonymous namespace
+
+VerifiedBlockBitmap::VerifiedBlockBitmap(size_t num_blocks)
+    : m_words(std::make_unique<std::atomic<u64>[]>(Common::DivideUp(num_blocks, size_t{64}))),
+      m_num_blocks(num_blocks) {}
+
+std::shared_ptr<VerifiedBlockBitmap> VerifiedBlockBitmap::GetShared(const VirtualFile& source,
+                                                                    const MasterHash& master_hash,
+                                                                    s32 level, size_t num_blocks) {
+    std::scoped_lock lk{g_shared_bitmaps_mutex};
+
+    // Forget the bitmaps no longer in use, and those of destroyed files, whose address may be
+    // reused by another file.
+    std::erase_if(g_shared_bitmaps, [](const auto& entry) {
+        return entry.second.source.expired() || entry.second.bitmap.expired();
+    });
+
+    auto& entry = g_shared_bitmaps[BitmapKey{source.get(), master_hash, level, num_blocks}];
+    if (auto bitmap = entry.bitmap.lock()) {
+        return bitmap;
+    }
+    auto bitmap = std::make_shared<VerifiedBlockBitmap>(num_blocks);
+    entry = SharedBitmap{source, bitmap};
+    return bitmap;
+}
+
+void VerifiedBlockBitmap::ClearShared() {
+    std::scoped_lock lk{g_shared_bitmaps_mutex};
+    g_shared_bitmaps.clear();
+}
+
+size_t VerifiedBlockBitmap::GetNumVerified() const {
+    size_t count = 0;
+    for (size_t i = 0; i < Common::DivideUp(m_num_blocks, size_t{64}); ++i) {
+        count += std::popcount(m_words[i].load(std::memory_order_acquire));
+    }
+    return count;
+}
+
+} // namespace FileSys
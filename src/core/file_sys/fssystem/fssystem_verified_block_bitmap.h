@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+#include "core/file_sys/vfs/vfs_types.h"
+
+namespace FileSys {
+
+/**
+ * Bitmap of the blocks of an integrity verification level whose hash was checked.
+ * Blocks are only ever marked, so it can be read and updated by concurrent readers without a lock.
+ */
+class VerifiedBlockBitmap {
+    SUYU_NON_COPYABLE(VerifiedBlockBitmap);
+    SUYU_NON_MOVEABLE(VerifiedBlockBitmap);
+
+public:
+    using MasterHash = std::array<u8, 0x20>;
+
+public:
+    explicit VerifiedBlockBitmap(size_t num_blocks);
+
+    /**
+     * Returns the bitmap of a level of the hash tree with the given master hash, read from the
+     * given file. It is shared by the storages opened on the same file and tree while any of them
+     * is alive, so that reopening a NCA section doesn't verify its blocks again.
+     */
+    static std::shared_ptr<VerifiedBlockBitmap> GetShared(const VirtualFile& source,
+                                                          const MasterHash& master_hash, s32 level,
+                                                          size_t num_blocks);
+
+    /// Forgets the bitmaps returned by GetShared, so that later storages verify their blocks again
+    static void ClearShared();
+
+    bool IsVerified(size_t block) const {
+        return (m_words[block / 64].load(std::memory_order_acquire) & (1ULL << (block % 64))) != 0;
+    }
+
+    void SetVerified(size_t block) {
+        m_words[block / 64].fetch_or(1ULL << (block % 64), std::memory_order_release);
+    }
+
+    size_t GetNumBlocks() const {
+        return m_num_blocks;
+    }
+
+    [[nodiscard]] size_t GetNumVerified() const;
+
+private:
+    std::unique_ptr<std::atomic<u64>[]> m_words;
+    size_t m_num_blocks;
+};
+
+} // namespace FileSys
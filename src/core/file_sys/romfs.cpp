@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <memory>
+#include <span>
+#include <vector>
 
 #include "common/assert.h"
 #include "common/common_types.h"
@@ -58,16 +60,30 @@ static_assert(sizeof(FileEntry) == 0x20, "FileEntry has incorrect size.");
 struct RomFSTraversalContext {
     RomFSHeader header;
     VirtualFile file;
-    std::vector<u8> directory_meta;
-    std::vector<u8> file_meta;
+    std::span<const u8> directory_meta;
+    std::span<const u8> file_meta;
+    // Copies of the tables, for files that can't hand out a span of their mapping
+    std::vector<u8> directory_meta_buffer;
+    std::vector<u8> file_meta_buffer;
 };
 
+/// Returns the table in place from the mapping of the file, or reads it into buffer otherwise
+std::span<const u8> GetTable(const VirtualFile& file, const TableLocation& location,
+                             std::vector<u8>& buffer) {
+    const std::span<const u8> span = file->GetMappedSpan(location.size, location.offset);
+    if (span.size() == location.size) {
+        return span;
+    }
+    buffer = file->ReadBytes(location.size, location.offset);
+    return buffer;
+}
+
 template <typename EntryType, auto Member>
 std::pair<EntryType, std::string> GetEntry(const RomFSTraversalContext& ctx, size_t offset) {
     const size_t entry_end = offset + sizeof(EntryType);
-    const std::vector<u8>& vec = ctx.*Member;
-    const size_t size = vec.size();
-    const u8* data = vec.data();
+    const std::span<const u8> table = ctx.*Member;
+    const size_t size = table.size();
+    const u8* data = table.data();
     EntryType entry{};
 
     if (entry_end > size) {
@@ -142,9 +158,8 @@ VirtualDir ExtractRomFS(VirtualFile file) {
     }
 
     ctx.file = file;
-    ctx.directory_meta =
-        file->ReadBytes(ctx.header.directory_meta.size, ctx.header.directory_meta.offset);
-    ctx.file_meta = file->ReadBytes(ctx.header.file_meta.size, ctx.header.file_meta.offset);
+    ctx.directory_meta = GetTable(file, ctx.header.directory_meta, ctx.directory_meta_buffer);
+    ctx.file_meta = GetTable(file, ctx.header.file_meta, ctx.file_meta_buffer);
 
     ProcessDirectory(ctx, 0, root_container);
 
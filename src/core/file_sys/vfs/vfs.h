@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -110,6 +111,11 @@ public:
     // into file. Returns number of bytes successfully written.
     virtual std::size_t Write(const u8* data, std::size_t length, std::size_t offset = 0) = 0;
 
+    // Returns a span over up to length bytes of the file starting at offset, which stays valid for
+    // the lifetime of the file, to read without copying. Returns an empty span if the file isn't
+    // backed by addressable memory, in which case the data has to be read with Read.
+    virtual std::span<const u8> GetMappedSpan(std::size_t length, std::size_t offset = 0) const;
+
     // Reads exactly one byte at the offset provided, returning std::nullopt on error.
     virtual std::optional<u8> ReadByte(std::size_t offset = 0) const;
     // Reads size bytes starting at offset in file into a vector.
@@ -181,6 +181,30 @@ std::size_t ConcatenatedVfsFile::Read(u8* data, std::size_t length, std::size_t
     return cur_offset - offset;
 }
 
+std::span<const u8> ConcatenatedVfsFile::GetMappedSpan(std::size_t length,
+                                                       std::size_t offset) const {
+    const ConcatenationEntry key{
+        .offset = offset,
+        .file = nullptr,
+    };
+
+    const u64 size = GetSize();
+    if (offset >= size) {
+        return {};
+    }
+
+    // Only ranges within a single file can be mapped, a read across files needs to copy.
+    const auto it =
+        std::prev(std::upper_bound(concatenation_map.begin(), concatenation_map.end(), key));
+    const u64 file_seek = offset - it->offset;
+    const u64 read_size = std::min<u64>(length, size - offset);
+    if (file_seek + read_size > it->file->GetSize()) {
+        return {};
+    }
+
+    return it->file->GetMappedSpan(read_size, file_seek);
+}
+
 std::size_t ConcatenatedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
     return 0;
 }
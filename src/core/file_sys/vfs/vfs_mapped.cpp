@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "core/file_sys/vfs/vfs_mapped.h"
+
+namespace FileSys {
+
+MappedVfsFile::MappedVfsFile(Common::FS::MappedFile mapping_, std::string name_,
+                             VirtualDir parent_)
+    : mapping(std::move(mapping_)), name(std::move(name_)), parent(std::move(parent_)) {}
+
+MappedVfsFile::~MappedVfsFile() = default;
+
+std::string MappedVfsFile::GetName() const {
+    return name;
+}
+
+std::size_t MappedVfsFile::GetSize() const {
+    return mapping.Size();
+}
+
+bool MappedVfsFile::Resize(std::size_t new_size) {
+    return false;
+}
+
+VirtualDir MappedVfsFile::GetContainingDirectory() const {
+    return parent;
+}
+
+bool MappedVfsFile::IsWritable() const {
+    return false;
+}
+
+bool MappedVfsFile::IsReadable() const {
+    return true;
+}
+
+std::size_t MappedVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
+    const std::span<const u8> span = GetMappedSpan(length, offset);
+    if (!span.empty()) {
+        std::memcpy(data, span.data(), span.size());
+    }
+    return span.size();
+}
+
+std::size_t MappedVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
+    return 0;
+}
+
+std::span<const u8> MappedVfsFile::GetMappedSpan(std::size_t length, std::size_t offset) const {
+    if (offset >= mapping.Size()) {
+        return {};
+    }
+    return mapping.Data().subspan(offset, std::min(length, mapping.Size() - offset));
+}
+
+bool MappedVfsFile::Rename(std::string_view name_) {
+    return false;
+}
+
+} // namespace FileSys
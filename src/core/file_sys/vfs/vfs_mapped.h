@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+
+#include "common/fs/mapped_file.h"
+#include "core/file_sys/vfs/vfs.h"
+
+namespace FileSys {
+
+// A read-only implementation of VfsFile backed by a memory mapped host file. Reads copy straight
+// from the mapping without a system call, and GetMappedSpan hands out the mapping itself.
+// The host file must not be truncated while it is mapped.
+class MappedVfsFile : public VfsFile {
+public:
+    explicit MappedVfsFile(Common::FS::MappedFile mapping_, std::string name_ = "",
+                           VirtualDir parent_ = nullptr);
+    ~MappedVfsFile() override;
+
+    std::string GetName() const override;
+    std::size_t GetSize() const override;
+    bool Resize(std::size_t new_size) override;
+    VirtualDir GetContainingDirectory() const override;
+    bool IsWritable() const override;
+    bool IsReadable() const override;
+    std::size_t Read(u8* data, std::size_t length, std::size_t offset) const override;
+    std::size_t Write(const u8* data, std::size_t length, std::size_t offset) override;
+    std::span<const u8> GetMappedSpan(std::size_t length, std::size_t offset) const override;
+    bool Rename(std::string_view name) override;
+
+private:
+    Common::FS::MappedFile mapping;
+    std::string name;
+    VirtualDir parent;
+};
+
+} // namespace FileSys
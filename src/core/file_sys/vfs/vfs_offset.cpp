@@ -55,6 +55,14 @@ std::size_t OffsetVfsFile::Write(const u8* data, std::size_t length, std::size_t
     return file->Write(data, TrimToFit(length, r_offset), offset + r_offset);
 }
 
+std::span<const u8> OffsetVfsFile::GetMappedSpan(std::size_t length, std::size_t r_offset) const {
+    if (r_offset >= size) {
+        return {};
+    }
+
+    return file->GetMappedSpan(TrimToFit(length, r_offset), offset + r_offset);
+}
+
 std::optional<u8> OffsetVfsFile::ReadByte(std::size_t r_offset) const {
     if (r_offset >= size) {
         return std::nullopt;
@@ -3,14 +3,17 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <utility>
 #include "common/assert.h"
 #include "common/fs/file.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "core/file_sys/vfs/vfs.h"
+#include "core/file_sys/vfs/vfs_mapped.h"
 #include "core/file_sys/vfs/vfs_real.h"
 
 // For FileTimeStampRaw
@@ -79,7 +82,7 @@ VirtualFile RealVfsFilesystem::OpenFileFromEntry(std::string_view path_, std::op
                                                  std::optional<std::string> parent_path,
                                                  OpenMode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
-    std::scoped_lock lk{list_lock};
+    std::scoped_lock lk{cache_lock};
 
     if (auto it = cache.find(path); it != cache.end()) {
         if (auto file = it->second.lock(); file) {
@@ -92,7 +95,12 @@ VirtualFile RealVfsFilesystem::OpenFileFromEntry(std::string_view path_, std::op
     }
 
     auto reference = std::make_unique<FileReference>();
-    this->InsertReferenceIntoListLocked(*reference);
+    reference->shard = std::hash<std::string>{}(path) % NumReferenceShards;
+    {
+        ReferenceShard& shard = shards[reference->shard];
+        std::scoped_lock shard_lk{shard.list_lock};
+        this->InsertReferenceIntoListLocked(shard, *reference);
+    }
 
     auto file = std::shared_ptr<RealVfsFile>(
         new RealVfsFile(*this, std::move(reference), path, perms, size, std::move(parent_path)));
@@ -105,10 +113,20 @@ VirtualFile RealVfsFilesystem::OpenFile(std::string_view path_, OpenMode perms)
     return OpenFileFromEntry(path_, {}, {}, perms);
 }
 
+VirtualFile RealVfsFilesystem::OpenMappedFile(std::string_view path_) {
+    const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
+    FS::MappedFile mapping{path};
+    if (!mapping.IsOpen()) {
+        return nullptr;
+    }
+    return std::make_shared<MappedVfsFile>(std::move(mapping), std::string(FS::GetFilename(path)),
+                                           OpenDirectory(FS::GetParentPath(path), OpenMode::Read));
+}
+
 VirtualFile RealVfsFilesystem::CreateFile(std::string_view path_, OpenMode perms) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
     {
-        std::scoped_lock lk{list_lock};
+        std::scoped_lock lk{cache_lock};
         cache.erase(path);
     }
 
@@ -141,7 +159,7 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
     const auto old_path = FS::SanitizePath(old_path_, FS::DirectorySeparator::PlatformDefault);
     const auto new_path = FS::SanitizePath(new_path_, FS::DirectorySeparator::PlatformDefault);
     {
-        std::scoped_lock lk{list_lock};
+        std::scoped_lock lk{cache_lock};
         cache.erase(old_path);
         cache.erase(new_path);
     }
@@ -154,7 +172,7 @@ VirtualFile RealVfsFilesystem::MoveFile(std::string_view old_path_, std::string_
 bool RealVfsFilesystem::DeleteFile(std::string_view path_) {
     const auto path = FS::SanitizePath(path_, FS::DirectorySeparator::PlatformDefault);
     {
-        std::scoped_lock lk{list_lock};
+        std::scoped_lock lk{cache_lock};
         cache.erase(path);
     }
     return FS::RemoveFile(path);
@@ -195,76 +213,82 @@ bool RealVfsFilesystem::DeleteDirectory(std::string_view path_) {
     return FS::RemoveDirRecursively(path);
 }
 
-std::unique_lock<std::mutex> RealVfsFilesystem::RefreshReference(const std::string& path,
-                                                                 OpenMode perms,
-                                                                 FileReference& reference) {
-    std::unique_lock lk{list_lock};
+std::shared_ptr<FS::IOFile> RealVfsFilesystem::RefreshReference(const std::string& path,
+                                                                OpenMode perms,
+                                                                FileReference& reference) {
+    ReferenceShard& shard = shards[reference.shard];
+    std::scoped_lock lk{shard.list_lock};
 
     // Temporarily remove from list.
-    this->RemoveReferenceFromListLocked(reference);
+    this->RemoveReferenceFromListLocked(shard, reference);
 
     // Restore file if needed.
     if (!reference.file) {
-        this->EvictSingleReferenceLocked();
+        this->EvictSingleReferenceLocked(shard);
 
         reference.file =
             FS::FileOpen(path, ModeFlagsToFileAccessMode(perms), FS::FileType::BinaryFile);
         if (reference.file) {
-            num_open_files++;
+            shard.num_open_files++;
         }
     }
 
     // Reinsert into list.
-    this->InsertReferenceIntoListLocked(reference);
+    this->InsertReferenceIntoListLocked(shard, reference);
 
-    return lk;
+    // The caller keeps the file open while using it, even if it is evicted in the meantime.
+    return reference.file;
 }
 
 void RealVfsFilesystem::DropReference(std::unique_ptr<FileReference>&& reference) {
-    std::scoped_lock lk{list_lock};
+    ReferenceShard& shard = shards[reference->shard];
+    std::scoped_lock lk{shard.list_lock};
 
     // Remove from list.
-    this->RemoveReferenceFromListLocked(*reference);
+    this->RemoveReferenceFromListLocked(shard, *reference);
 
     // Close the file.
     if (reference->file) {
         reference->file.reset();
-        num_open_files--;
+        shard.num_open_files--;
     }
 }
 
-void RealVfsFilesystem::EvictSingleReferenceLocked() {
-    if (num_open_files < MaxOpenFiles || open_references.empty()) {
+void RealVfsFilesystem::EvictSingleReferenceLocked(ReferenceShard& shard) {
+    if (shard.num_open_files < MaxOpenFiles / NumReferenceShards ||
+        shard.open_references.empty()) {
         return;
     }
 
     // Get and remove from list.
-    auto& reference = open_references.back();
-    this->RemoveReferenceFromListLocked(reference);
+    auto& reference = shard.open_references.back();
+    this->RemoveReferenceFromListLocked(shard, reference);
 
     // Close the file.
     if (reference.file) {
         reference.file.reset();
-        num_open_files--;
+        shard.num_open_files--;
     }
 
     // Reinsert into closed list.
-    this->InsertReferenceIntoListLocked(reference);
+    this->InsertReferenceIntoListLocked(shard, reference);
 }
 
-void RealVfsFilesystem::InsertReferenceIntoListLocked(FileReference& reference) {
+void RealVfsFilesystem::InsertReferenceIntoListLocked(ReferenceShard& shard,
+                                                      FileReference& reference) {
     if (reference.file) {
-        open_references.push_front(reference);
+        shard.open_references.push_front(reference);
     } else {
-        closed_references.push_front(reference);
+        shard.closed_references.push_front(reference);
     }
 }
 
-void RealVfsFilesystem::RemoveReferenceFromListLocked(FileReference& reference) {
+void RealVfsFilesystem::RemoveReferenceFromListLocked(ReferenceShard& shard,
+                                                      FileReference& reference) {
     if (reference.file) {
-        open_references.erase(open_references.iterator_to(reference));
+        shard.open_references.erase(shard.open_references.iterator_to(reference));
     } else {
-        closed_references.erase(closed_references.iterator_to(reference));
+        shard.closed_references.erase(shard.closed_references.iterator_to(reference));
     }
 }
 
@@ -292,14 +316,14 @@ std::size_t RealVfsFile::GetSize() const {
     if (size) {
         return *size;
     }
-    auto lk = base.RefreshReference(path, perms, *reference);
-    return reference->file ? reference->file->GetSize() : 0;
+    const auto file = base.RefreshReference(path, perms, *reference);
+    return file ? file->GetSize() : 0;
 }
 
 bool RealVfsFile::Resize(std::size_t new_size) {
     size.reset();
-    auto lk = base.RefreshReference(path, perms, *reference);
-    return reference->file ? reference->file->SetSize(new_size) : false;
+    const auto file = base.RefreshReference(path, perms, *reference);
+    return file ? file->SetSize(new_size) : false;
 }
 
 VirtualDir RealVfsFile::GetContainingDirectory() const {
@@ -315,20 +339,15 @@ bool RealVfsFile::IsReadable() const {
 }
 
 std::size_t RealVfsFile::Read(u8* data, std::size_t length, std::size_t offset) const {
-    auto lk = base.RefreshReference(path, perms, *reference);
-    if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
-        return 0;
-    }
-    return reference->file->ReadSpan(std::span{data, length});
+    // Positional reads don't share a file pointer, so no lock is held while reading.
+    const auto file = base.RefreshReference(path, perms, *reference);
+    return file ? file->ReadAt(std::span{data, length}, offset) : 0;
 }
 
 std::size_t RealVfsFile::Write(const u8* data, std::size_t length, std::size_t offset) {
     size.reset();
-    auto lk = base.RefreshReference(path, perms, *reference);
-    if (!reference->file || !reference->file->Seek(static_cast<s64>(offset))) {
-        return 0;
-    }
-    return reference->file->WriteSpan(std::span{data, length});
+    const auto file = base.RefreshReference(path, perms, *reference);
+    return file ? file->WriteAt(std::span{data, length}, offset) : 0;
 }
 
 bool RealVfsFile::Rename(std::string_view name) {
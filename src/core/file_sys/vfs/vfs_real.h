@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <mutex>
 #include <optional>
@@ -19,6 +20,7 @@ namespace FileSys {
 
 struct FileReference : public Common::IntrusiveListBaseNode<FileReference> {
     std::shared_ptr<Common::FS::IOFile> file{};
+    size_t shard{};
 };
 
 class RealVfsFile;
@@ -45,18 +47,32 @@ public:
     VirtualDir MoveDirectory(std::string_view old_path, std::string_view new_path) override;
     bool DeleteDirectory(std::string_view path) override;
 
+    // Opens a file read-only by mapping it into memory, so that reads don't need system calls.
+    // Returns nullptr if the file can't be mapped. It must not be truncated while it is open.
+    VirtualFile OpenMappedFile(std::string_view path);
+
 private:
     using ReferenceListType = Common::IntrusiveListBaseTraits<FileReference>::ListType;
+
+    // The open file references are split by path into shards with their own lock and share of
+    // the open file limit, so that threads accessing different files don't contend.
+    static constexpr size_t NumReferenceShards = 16;
+
+    struct ReferenceShard {
+        ReferenceListType open_references;
+        ReferenceListType closed_references;
+        std::mutex list_lock;
+        size_t num_open_files{};
+    };
+
     std::map<std::string, std::weak_ptr<VfsFile>, std::less<>> cache;
-    ReferenceListType open_references;
-    ReferenceListType closed_references;
-    std::mutex list_lock;
-    size_t num_open_files{};
+    std::mutex cache_lock;
+    std::array<ReferenceShard, NumReferenceShards> shards;
 
 private:
     friend class RealVfsFile;
-    std::unique_lock<std::mutex> RefreshReference(const std::string& path, OpenMode perms,
-                                                  FileReference& reference);
+    std::shared_ptr<Common::FS::IOFile> RefreshReference(const std::string& path, OpenMode perms,
+                                                         FileReference& reference);
     void DropReference(std::unique_ptr<FileReference>&& reference);
 
 private:
@@ -66,9 +82,9 @@ private:
                                   OpenMode perms = OpenMode::Read);
 
 private:
-    void EvictSingleReferenceLocked();
-    void InsertReferenceIntoListLocked(FileReference& reference);
-    void RemoveReferenceFromListLocked(FileReference& reference);
+    void EvictSingleReferenceLocked(ReferenceShard& shard);
+    void InsertReferenceIntoListLocked(ReferenceShard& shard, FileReference& reference);
+    void RemoveReferenceFromListLocked(ReferenceShard& shard, FileReference& reference);
 };
 
 // An implementation of VfsFile that represents a file on the user's computer.
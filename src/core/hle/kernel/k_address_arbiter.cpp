@@ -109,14 +109,16 @@ bool UpdateIfEqual(KernelCore& kernel, s32* out, KProcessAddress address, s32 va
 
 class ThreadQueueImplForKAddressArbiter final : public KThreadQueue {
 public:
-    explicit ThreadQueueImplForKAddressArbiter(KernelCore& kernel, KAddressArbiter::ThreadTree* t)
-        : KThreadQueue(kernel), m_tree(t) {}
+    explicit ThreadQueueImplForKAddressArbiter(KernelCore& kernel, KAddressArbiter::Bucket* b)
+        : KThreadQueue(kernel), m_bucket(b) {}
 
     void CancelWait(KThread* waiting_thread, Result wait_result, bool cancel_timer_task) override {
         // If the thread is waiting on an address arbiter, remove it from the tree.
         if (waiting_thread->IsWaitingForAddressArbiter()) {
-            m_tree->erase(m_tree->iterator_to(*waiting_thread));
+            ThreadTree& tree = m_bucket->GetTree();
+            tree.erase(tree.iterator_to(*waiting_thread));
             waiting_thread->ClearAddressArbiter();
+            m_bucket->RemoveWaiter();
         }
 
         // Invoke the base cancel wait handler.
@@ -124,19 +126,27 @@ public:
     }
 
 private:
-    KAddressArbiter::ThreadTree* m_tree{};
+    using ThreadTree = KAddressArbiter::ThreadTree;
+
+    KAddressArbiter::Bucket* m_bucket{};
 };
 
 } // namespace
 
 Result KAddressArbiter::Signal(uint64_t addr, s32 count) {
+    Bucket& bucket = m_buckets.GetBucket(addr);
+
+    // If no thread waits on the address, there is nobody to wake up.
+    R_SUCCEED_IF(!bucket.HasWaiters());
+
     // Perform signaling.
     s32 num_waiters{};
     {
         KScopedSchedulerLock sl(m_kernel);
 
-        auto it = m_tree.nfind_key({addr, -1});
-        while ((it != m_tree.end()) && (count <= 0 || num_waiters < count) &&
+        ThreadTree& tree = bucket.GetTree();
+        auto it = tree.nfind_key({addr, -1});
+        while ((it != tree.end()) && (count <= 0 || num_waiters < count) &&
                (it->GetAddressArbiterKey() == addr)) {
             // End the thread's wait.
             KThread* target_thread = std::addressof(*it);
@@ -145,7 +155,8 @@ Result KAddressArbiter::Signal(uint64_t addr, s32 count) {
             ASSERT(target_thread->IsWaitingForAddressArbiter());
             target_thread->ClearAddressArbiter();
 
-            it = m_tree.erase(it);
+            it = tree.erase(it);
+            bucket.RemoveWaiter();
             ++num_waiters;
         }
     }
@@ -153,6 +164,8 @@ Result KAddressArbiter::Signal(uint64_t addr, s32 count) {
 }
 
 Result KAddressArbiter::SignalAndIncrementIfEqual(uint64_t addr, s32 value, s32 count) {
+    Bucket& bucket = m_buckets.GetBucket(addr);
+
     // Perform signaling.
     s32 num_waiters{};
     {
@@ -164,8 +177,9 @@ Result KAddressArbiter::SignalAndIncrementIfEqual(uint64_t addr, s32 value, s32
                  ResultInvalidCurrentMemory);
         R_UNLESS(user_value == value, ResultInvalidState);
 
-        auto it = m_tree.nfind_key({addr, -1});
-        while ((it != m_tree.end()) && (count <= 0 || num_waiters < count) &&
+        ThreadTree& tree = bucket.GetTree();
+        auto it = tree.nfind_key({addr, -1});
+        while ((it != tree.end()) && (count <= 0 || num_waiters < count) &&
                (it->GetAddressArbiterKey() == addr)) {
             // End the thread's wait.
             KThread* target_thread = std::addressof(*it);
@@ -174,7 +188,8 @@ Result KAddressArbiter::SignalAndIncrementIfEqual(uint64_t addr, s32 value, s32
             ASSERT(target_thread->IsWaitingForAddressArbiter());
             target_thread->ClearAddressArbiter();
 
-            it = m_tree.erase(it);
+            it = tree.erase(it);
+            bucket.RemoveWaiter();
             ++num_waiters;
         }
     }
@@ -182,25 +197,28 @@ Result KAddressArbiter::SignalAndIncrementIfEqual(uint64_t addr, s32 value, s32
 }
 
 Result KAddressArbiter::SignalAndModifyByWaitingCountIfEqual(uint64_t addr, s32 value, s32 count) {
+    Bucket& bucket = m_buckets.GetBucket(addr);
+    ThreadTree& tree = bucket.GetTree();
+
     // Perform signaling.
     s32 num_waiters{};
     {
         KScopedSchedulerLock sl(m_kernel);
 
-        auto it = m_tree.nfind_key({addr, -1});
+        auto it = tree.nfind_key({addr, -1});
         // Determine the updated value.
         s32 new_value{};
         if (count <= 0) {
-            if (it != m_tree.end() && it->GetAddressArbiterKey() == addr) {
+            if (it != tree.end() && it->GetAddressArbiterKey() == addr) {
                 new_value = value - 2;
             } else {
                 new_value = value + 1;
             }
         } else {
-            if (it != m_tree.end() && it->GetAddressArbiterKey() == addr) {
+            if (it != tree.end() && it->GetAddressArbiterKey() == addr) {
                 auto tmp_it = it;
                 s32 tmp_num_waiters{};
-                while (++tmp_it != m_tree.end() && tmp_it->GetAddressArbiterKey() == addr) {
+                while (++tmp_it != tree.end() && tmp_it->GetAddressArbiterKey() == addr) {
                     if (tmp_num_waiters++ >= count) {
                         break;
                     }
@@ -228,7 +246,7 @@ Result KAddressArbiter::SignalAndModifyByWaitingCountIfEqual(uint64_t addr, s32
         R_UNLESS(succeeded, ResultInvalidCurrentMemory);
         R_UNLESS(user_value == value, ResultInvalidState);
 
-        while ((it != m_tree.end()) && (count <= 0 || num_waiters < count) &&
+        while ((it != tree.end()) && (count <= 0 || num_waiters < count) &&
                (it->GetAddressArbiterKey() == addr)) {
             // End the thread's wait.
             KThread* target_thread = std::addressof(*it);
@@ -237,7 +255,8 @@ Result KAddressArbiter::SignalAndModifyByWaitingCountIfEqual(uint64_t addr, s32
             ASSERT(target_thread->IsWaitingForAddressArbiter());
             target_thread->ClearAddressArbiter();
 
-            it = m_tree.erase(it);
+            it = tree.erase(it);
+            bucket.RemoveWaiter();
             ++num_waiters;
         }
     }
@@ -248,7 +267,16 @@ Result KAddressArbiter::WaitIfLessThan(uint64_t addr, s32 value, bool decrement,
     // Prepare to wait.
     KThread* cur_thread = GetCurrentThreadPointer(m_kernel);
     KHardwareTimer* timer{};
-    ThreadQueueImplForKAddressArbiter wait_queue(m_kernel, std::addressof(m_tree));
+    Bucket& bucket = m_buckets.GetBucket(addr);
+    ThreadQueueImplForKAddressArbiter wait_queue(m_kernel, std::addressof(bucket));
+
+    // If the value is already too large to wait, we can fail without taking the scheduler lock.
+    if (!cur_thread->IsTerminationRequested()) {
+        s32 user_value{};
+        if (ReadFromUser(m_kernel, std::addressof(user_value), addr) && user_value >= value) {
+            R_THROW(ResultInvalidState);
+        }
+    }
 
     {
         KScopedSchedulerLockAndSleep slp{m_kernel, std::addressof(timer), cur_thread, timeout};
@@ -259,6 +287,9 @@ Result KAddressArbiter::WaitIfLessThan(uint64_t addr, s32 value, bool decrement,
             R_THROW(ResultTerminationRequested);
         }
 
+        // Let signals know that we may wait, before looking at the value.
+        bucket.AddWaiter();
+
         // Read the value from userspace.
         s32 user_value{};
         bool succeeded{};
@@ -269,25 +300,28 @@ Result KAddressArbiter::WaitIfLessThan(uint64_t addr, s32 value, bool decrement,
         }
 
         if (!succeeded) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultInvalidCurrentMemory);
         }
 
         // Check that the value is less than the specified one.
         if (user_value >= value) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultInvalidState);
         }
 
         // Check that the timeout is non-zero.
         if (timeout == 0) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultTimedOut);
         }
 
         // Set the arbiter.
-        cur_thread->SetAddressArbiter(std::addressof(m_tree), addr);
-        m_tree.insert(*cur_thread);
+        cur_thread->SetAddressArbiter(std::addressof(bucket.GetTree()), addr);
+        bucket.GetTree().insert(*cur_thread);
 
         // Wait for the thread to finish.
         wait_queue.SetHardwareTimer(timer);
@@ -303,7 +337,16 @@ Result KAddressArbiter::WaitIfEqual(uint64_t addr, s32 value, s64 timeout) {
     // Prepare to wait.
     KThread* cur_thread = GetCurrentThreadPointer(m_kernel);
     KHardwareTimer* timer{};
-    ThreadQueueImplForKAddressArbiter wait_queue(m_kernel, std::addressof(m_tree));
+    Bucket& bucket = m_buckets.GetBucket(addr);
+    ThreadQueueImplForKAddressArbiter wait_queue(m_kernel, std::addressof(bucket));
+
+    // If the value already changed, we can fail without taking the scheduler lock.
+    if (!cur_thread->IsTerminationRequested()) {
+        s32 user_value{};
+        if (ReadFromUser(m_kernel, std::addressof(user_value), addr) && user_value != value) {
+            R_THROW(ResultInvalidState);
+        }
+    }
 
     {
         KScopedSchedulerLockAndSleep slp{m_kernel, std::addressof(timer), cur_thread, timeout};
@@ -314,28 +357,34 @@ Result KAddressArbiter::WaitIfEqual(uint64_t addr, s32 value, s64 timeout) {
             R_THROW(ResultTerminationRequested);
         }
 
+        // Let signals know that we may wait, before looking at the value.
+        bucket.AddWaiter();
+
         // Read the value from userspace.
         s32 user_value{};
         if (!ReadFromUser(m_kernel, std::addressof(user_value), addr)) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultInvalidCurrentMemory);
         }
 
         // Check that the value is equal.
         if (value != user_value) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultInvalidState);
         }
 
         // Check that the timeout is non-zero.
         if (timeout == 0) {
+            bucket.RemoveWaiter();
             slp.CancelSleep();
             R_THROW(ResultTimedOut);
         }
 
         // Set the arbiter.
-        cur_thread->SetAddressArbiter(std::addressof(m_tree), addr);
-        m_tree.insert(*cur_thread);
+        cur_thread->SetAddressArbiter(std::addressof(bucket.GetTree()), addr);
+        bucket.GetTree().insert(*cur_thread);
 
         // Wait for the thread to finish.
         wait_queue.SetHardwareTimer(timer);
@@ -5,6 +5,7 @@
 
 #include "common/assert.h"
 #include "common/common_types.h"
+#include "core/hle/kernel/k_address_wait_buckets.h"
 #include "core/hle/kernel/k_condition_variable.h"
 #include "core/hle/kernel/svc_types.h"
 
@@ -21,6 +22,7 @@ class KernelCore;
 class KAddressArbiter {
 public:
     using ThreadTree = KConditionVariable::ThreadTree;
+    using Bucket = KAddressWaitBuckets::Bucket;
 
     explicit KAddressArbiter(Core::System& system);
     ~KAddressArbiter();
@@ -59,7 +61,7 @@ private:
     Result WaitIfEqual(uint64_t addr, s32 value, s64 timeout);
 
 private:
-    ThreadTree m_tree;
+    KAddressWaitBuckets m_buckets;
     Core::System& m_system;
     KernelCore& m_kernel;
 };
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+
+#include "common/common_types.h"
+#include "core/hle/kernel/k_thread.h"
+
+namespace Kernel {
+
+/**
+ * Threads waiting on guest addresses, hashed by address into buckets with a tree each. Every
+ * bucket counts the threads that are waiting or about to wait on it, so that signals to addresses
+ * nobody waits on can return without taking the scheduler lock. The trees themselves are still
+ * only accessed with the scheduler lock held, as waking a thread up requires it anyway.
+ */
+class KAddressWaitBuckets {
+public:
+    using ThreadTree = KThread::ConditionVariableThreadTreeType;
+
+    static constexpr size_t NumBuckets = 64;
+
+    class alignas(64) Bucket {
+    public:
+        ThreadTree& GetTree() {
+            return m_tree;
+        }
+
+        /**
+         * Announces a thread that is going to check the guest value of an address and wait on
+         * it. Must be called before reading the value, pairs with HasWaiters.
+         */
+        void AddWaiter() {
+            m_num_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        /// Removes a thread that stopped waiting, or decided not to wait
+        void RemoveWaiter() {
+            m_num_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Returns true when a thread might wait on the bucket. Must be called after updating the
+         * guest value of the address, so that either the waiter sees the new value or the signal
+         * sees the waiter.
+         */
+        bool HasWaiters() const {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return m_num_waiters.load(std::memory_order_seq_cst) != 0;
+        }
+
+    private:
+        ThreadTree m_tree{};
+        std::atomic<s32> m_num_waiters{};
+    };
+
+    Bucket& GetBucket(u64 address) {
+        // Addresses are at least word aligned, mix the bits above that into the bucket index.
+        constexpr u64 HashMultiplier = 0x9E3779B97F4A7C15ULL;
+        return m_buckets[((address >> 2) * HashMultiplier) >> (64 - BucketBits)];
+    }
+
+private:
+    static constexpr size_t BucketBits = std::countr_zero(NumBuckets);
+    static_assert((1ULL << BucketBits) == NumBuckets);
+
+    std::array<Bucket, NumBuckets> m_buckets{};
+};
+
+} // namespace Kernel
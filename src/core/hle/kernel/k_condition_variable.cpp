@@ -76,12 +76,12 @@ public:
 
 class ThreadQueueImplForKConditionVariableWaitConditionVariable final : public KThreadQueue {
 private:
-    KConditionVariable::ThreadTree* m_tree;
+    KConditionVariable::Bucket* m_bucket;
 
 public:
     explicit ThreadQueueImplForKConditionVariableWaitConditionVariable(
-        KernelCore& kernel, KConditionVariable::ThreadTree* t)
-        : KThreadQueue(kernel), m_tree(t) {}
+        KernelCore& kernel, KConditionVariable::Bucket* b)
+        : KThreadQueue(kernel), m_bucket(b) {}
 
     void CancelWait(KThread* waiting_thread, Result wait_result, bool cancel_timer_task) override {
         // Remove the thread as a waiter from its owner.
@@ -91,8 +91,10 @@ public:
 
         // If the thread is waiting on a condvar, remove it from the tree.
         if (waiting_thread->IsWaitingForConditionVariable()) {
-            m_tree->erase(m_tree->iterator_to(*waiting_thread));
+            KConditionVariable::ThreadTree& tree = m_bucket->GetTree();
+            tree.erase(tree.iterator_to(*waiting_thread));
             waiting_thread->ClearConditionVariable();
+            m_bucket->RemoveWaiter();
         }
 
         // Invoke the base cancel wait handler.
@@ -241,18 +243,32 @@ void KConditionVariable::SignalImpl(KThread* thread) {
 }
 
 void KConditionVariable::Signal(u64 cv_key, s32 count) {
+    Bucket& bucket = m_buckets.GetBucket(cv_key);
+
+    // If no thread waits on the key and its has waiter flag is already clear, there is nothing to
+    // do. Waiting threads announce themselves to the bucket before they set the flag.
+    if (!bucket.HasWaiters()) {
+        u32 has_waiter_flag{};
+        if (ReadFromUser(m_kernel, std::addressof(has_waiter_flag), cv_key) &&
+            has_waiter_flag == 0) {
+            return;
+        }
+    }
+
     // Perform signaling.
     s32 num_waiters{};
     {
         KScopedSchedulerLock sl(m_kernel);
 
-        auto it = m_tree.nfind_key({cv_key, -1});
-        while ((it != m_tree.end()) && (count <= 0 || num_waiters < count) &&
+        ThreadTree& tree = bucket.GetTree();
+        auto it = tree.nfind_key({cv_key, -1});
+        while ((it != tree.end()) && (count <= 0 || num_waiters < count) &&
                (it->GetConditionVariableKey() == cv_key)) {
             KThread* target_thread = std::addressof(*it);
 
-            it = m_tree.erase(it);
+            it = tree.erase(it);
             target_thread->ClearConditionVariable();
+            bucket.RemoveWaiter();
 
             this->SignalImpl(target_thread);
 
@@ -260,7 +276,7 @@ void KConditionVariable::Signal(u64 cv_key, s32 count) {
         }
 
         // If we have no waiters, clear the has waiter flag.
-        if (it == m_tree.end() || it->GetConditionVariableKey() != cv_key) {
+        if (it == tree.end() || it->GetConditionVariableKey() != cv_key) {
             const u32 has_waiter_flag{};
             WriteToUser(m_kernel, cv_key, std::addressof(has_waiter_flag));
         }
@@ -271,8 +287,9 @@ Result KConditionVariable::Wait(KProcessAddress addr, u64 key, u32 value, s64 ti
     // Prepare to wait.
     KThread* cur_thread = GetCurrentThreadPointer(m_kernel);
     KHardwareTimer* timer{};
+    Bucket& bucket = m_buckets.GetBucket(key);
     ThreadQueueImplForKConditionVariableWaitConditionVariable wait_queue(m_kernel,
-                                                                         std::addressof(m_tree));
+                                                                         std::addressof(bucket));
 
     {
         KScopedSchedulerLockAndSleep slp(m_kernel, std::addressof(timer), cur_thread, timeout);
@@ -283,6 +300,9 @@ Result KConditionVariable::Wait(KProcessAddress addr, u64 key, u32 value, s64 ti
             R_THROW(ResultTerminationRequested);
         }
 
+        // Let signals know that we may wait, before setting the has waiter flag.
+        bucket.AddWaiter();
+
         // Update the value and process for the next owner.
         {
             // Remove waiter thread.
@@ -312,17 +332,21 @@ Result KConditionVariable::Wait(KProcessAddress addr, u64 key, u32 value, s64 ti
 
             // Write the value to userspace.
             if (!WriteToUser(m_kernel, addr, std::addressof(next_value))) {
+                bucket.RemoveWaiter();
                 slp.CancelSleep();
                 R_THROW(ResultInvalidCurrentMemory);
             }
         }
 
         // If timeout is zero, time out.
-        R_UNLESS(timeout != 0, ResultTimedOut);
+        if (timeout == 0) {
+            bucket.RemoveWaiter();
+            R_THROW(ResultTimedOut);
+        }
 
         // Update condition variable tracking.
-        cur_thread->SetConditionVariable(std::addressof(m_tree), addr, key, value);
-        m_tree.insert(*cur_thread);
+        cur_thread->SetConditionVariable(std::addressof(bucket.GetTree()), addr, key, value);
+        bucket.GetTree().insert(*cur_thread);
 
         // Begin waiting.
         wait_queue.SetHardwareTimer(timer);
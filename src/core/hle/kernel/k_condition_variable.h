@@ -5,6 +5,7 @@
 
 #include "common/assert.h"
 
+#include "core/hle/kernel/k_address_wait_buckets.h"
 #include "core/hle/kernel/k_scheduler.h"
 #include "core/hle/kernel/k_thread.h"
 #include "core/hle/kernel/k_typed_address.h"
@@ -20,6 +21,7 @@ namespace Kernel {
 class KConditionVariable {
 public:
     using ThreadTree = typename KThread::ConditionVariableThreadTreeType;
+    using Bucket = KAddressWaitBuckets::Bucket;
 
     explicit KConditionVariable(Core::System& system);
     ~KConditionVariable();
@@ -39,7 +41,7 @@ private:
 private:
     Core::System& m_system;
     KernelCore& m_kernel;
-    ThreadTree m_tree{};
+    KAddressWaitBuckets m_buckets;
 };
 
 inline void BeforeUpdatePriority(KernelCore& kernel, KConditionVariable::ThreadTree* tree,
@@ -9,6 +9,7 @@
 
 #include "common/assert.h"
 #include "common/bit_set.h"
+#include "common/bit_util.h"
 #include "common/common_types.h"
 #include "common/concepts.h"
 
@@ -62,6 +63,7 @@ public:
     static_assert(LowestPriority >= HighestPriority);
     static constexpr size_t NumPriority = LowestPriority - HighestPriority + 1;
     static constexpr size_t NumCores = NumCores_;
+    static_assert(NumCores <= Common::BitSize<u64>());
 
     static constexpr bool IsValidCore(s32 core) {
         return 0 <= core && core < static_cast<s32>(NumCores);
@@ -75,54 +77,63 @@ private:
     using Entry = typename Member::QueueEntry;
 
 public:
-    class KPerCoreQueue {
+    // The roots and priority bitmap of a core are kept on their own cache lines, so that the
+    // lookups for one core do not pull in the state of the others.
+    static constexpr size_t CacheLineSize = 64;
+
+    class alignas(CacheLineSize) KPerCoreQueue {
     private:
-        std::array<Entry, NumCores> m_root{};
+        Common::BitSet64<NumPriority> m_available_priorities{};
+        std::array<Entry, NumPriority> m_root{};
 
     public:
         constexpr KPerCoreQueue() {
-            for (auto& per_core_root : m_root) {
-                per_core_root.Initialize();
+            for (auto& per_priority_root : m_root) {
+                per_priority_root.Initialize();
             }
         }
 
-        constexpr bool PushBack(s32 core, Member* member) {
+        constexpr void PushBack(s32 priority, s32 core, Member* member) {
             // Get the entry associated with the member.
             Entry& member_entry = member->GetPriorityQueueEntry(core);
 
             // Get the entry associated with the end of the queue.
-            Member* tail = m_root[core].GetPrev();
+            Member* tail = m_root[priority].GetPrev();
             Entry& tail_entry =
-                (tail != nullptr) ? tail->GetPriorityQueueEntry(core) : m_root[core];
+                (tail != nullptr) ? tail->GetPriorityQueueEntry(core) : m_root[priority];
 
             // Link the entries.
             member_entry.SetPrev(tail);
             member_entry.SetNext(nullptr);
             tail_entry.SetNext(member);
-            m_root[core].SetPrev(member);
+            m_root[priority].SetPrev(member);
 
-            return tail == nullptr;
+            if (tail == nullptr) {
+                m_available_priorities.SetBit(priority);
+            }
         }
 
-        constexpr bool PushFront(s32 core, Member* member) {
+        constexpr void PushFront(s32 priority, s32 core, Member* member) {
             // Get the entry associated with the member.
             Entry& member_entry = member->GetPriorityQueueEntry(core);
 
             // Get the entry associated with the front of the queue.
-            Member* head = m_root[core].GetNext();
+            Member* head = m_root[priority].GetNext();
             Entry& head_entry =
-                (head != nullptr) ? head->GetPriorityQueueEntry(core) : m_root[core];
+                (head != nullptr) ? head->GetPriorityQueueEntry(core) : m_root[priority];
 
             // Link the entries.
             member_entry.SetPrev(nullptr);
             member_entry.SetNext(head);
             head_entry.SetPrev(member);
-            m_root[core].SetNext(member);
+            m_root[priority].SetNext(member);
 
-            return (head == nullptr);
+            if (head == nullptr) {
+                m_available_priorities.SetBit(priority);
+            }
         }
 
-        constexpr bool Remove(s32 core, Member* member) {
+        constexpr void Remove(s32 priority, s32 core, Member* member) {
             // Get the entry associated with the member.
             Entry& member_entry = member->GetPriorityQueueEntry(core);
 
@@ -130,19 +141,33 @@ public:
             Member* prev = member_entry.GetPrev();
             Member* next = member_entry.GetNext();
             Entry& prev_entry =
-                (prev != nullptr) ? prev->GetPriorityQueueEntry(core) : m_root[core];
+                (prev != nullptr) ? prev->GetPriorityQueueEntry(core) : m_root[priority];
             Entry& next_entry =
-                (next != nullptr) ? next->GetPriorityQueueEntry(core) : m_root[core];
+                (next != nullptr) ? next->GetPriorityQueueEntry(core) : m_root[priority];
 
             // Unlink.
             prev_entry.SetNext(next);
             next_entry.SetPrev(prev);
 
-            return (this->GetFront(core) == nullptr);
+            if (this->GetFront(priority) == nullptr) {
+                m_available_priorities.ClearBit(priority);
+            }
         }
 
-        constexpr Member* GetFront(s32 core) const {
-            return m_root[core].GetNext();
+        constexpr s32 GetHighestPriority() const {
+            return static_cast<s32>(m_available_priorities.CountLeadingZero());
+        }
+
+        constexpr s32 GetNextPriority(s32 priority) const {
+            return static_cast<s32>(m_available_priorities.GetNextSet(priority));
+        }
+
+        constexpr bool IsEmpty() const {
+            return this->GetHighestPriority() > LowestPriority;
+        }
+
+        constexpr Member* GetFront(s32 priority) const {
+            return m_root[priority].GetNext();
         }
     };
 
@@ -158,9 +183,8 @@ public:
                 return;
             }
 
-            if (m_queues[priority].PushBack(core, member)) {
-                m_available_priorities[core].SetBit(priority);
-            }
+            m_queues[core].PushBack(priority, core, member);
+            m_available_cores |= UINT64_C(1) << core;
         }
 
         constexpr void PushFront(s32 priority, s32 core, Member* member) {
@@ -171,9 +195,8 @@ public:
                 return;
             }
 
-            if (m_queues[priority].PushFront(core, member)) {
-                m_available_priorities[core].SetBit(priority);
-            }
+            m_queues[core].PushFront(priority, core, member);
+            m_available_cores |= UINT64_C(1) << core;
         }
 
         constexpr void Remove(s32 priority, s32 core, Member* member) {
@@ -184,17 +207,18 @@ public:
                 return;
             }
 
-            if (m_queues[priority].Remove(core, member)) {
-                m_available_priorities[core].ClearBit(priority);
+            m_queues[core].Remove(priority, core, member);
+            if (m_queues[core].IsEmpty()) {
+                m_available_cores &= ~(UINT64_C(1) << core);
             }
         }
 
         constexpr Member* GetFront(s32 core) const {
             ASSERT(IsValidCore(core));
 
-            const s32 priority = static_cast<s32>(m_available_priorities[core].CountLeadingZero());
+            const s32 priority = m_queues[core].GetHighestPriority();
             if (priority <= LowestPriority) {
-                return m_queues[priority].GetFront(core);
+                return m_queues[core].GetFront(priority);
             } else {
                 return nullptr;
             }
@@ -205,7 +229,7 @@ public:
             ASSERT(IsValidPriority(priority));
 
             if (priority <= LowestPriority) {
-                return m_queues[priority].GetFront(core);
+                return m_queues[core].GetFront(priority);
             } else {
                 return nullptr;
             }
@@ -216,10 +240,9 @@ public:
 
             Member* next = member->GetPriorityQueueEntry(core).GetNext();
             if (next == nullptr) {
-                const s32 priority = static_cast<s32>(
-                    m_available_priorities[core].GetNextSet(member->GetPriority()));
+                const s32 priority = m_queues[core].GetNextPriority(member->GetPriority());
                 if (priority <= LowestPriority) {
-                    next = m_queues[priority].GetFront(core);
+                    next = m_queues[core].GetFront(priority);
                 }
             }
             return next;
@@ -230,8 +253,8 @@ public:
             ASSERT(IsValidPriority(priority));
 
             if (priority <= LowestPriority) {
-                m_queues[priority].Remove(core, member);
-                m_queues[priority].PushFront(core, member);
+                m_queues[core].Remove(priority, core, member);
+                m_queues[core].PushFront(priority, core, member);
             }
         }
 
@@ -240,17 +263,22 @@ public:
             ASSERT(IsValidPriority(priority));
 
             if (priority <= LowestPriority) {
-                m_queues[priority].Remove(core, member);
-                m_queues[priority].PushBack(core, member);
-                return m_queues[priority].GetFront(core);
+                m_queues[core].Remove(priority, core, member);
+                m_queues[core].PushBack(priority, core, member);
+                return m_queues[core].GetFront(priority);
             } else {
                 return nullptr;
             }
         }
 
+        /// Returns a mask of the cores that have at least one member queued
+        constexpr u64 GetAvailableCores() const {
+            return m_available_cores;
+        }
+
     private:
-        std::array<KPerCoreQueue, NumPriority> m_queues{};
-        std::array<Common::BitSet64<NumPriority>, NumCores> m_available_priorities{};
+        std::array<KPerCoreQueue, NumCores> m_queues{};
+        u64 m_available_cores{};
     };
 
 private:
@@ -349,6 +377,14 @@ public:
         return member->GetPriorityQueueEntry(core).GetNext();
     }
 
+    constexpr u64 GetScheduledCores() const {
+        return m_scheduled_queue.GetAvailableCores();
+    }
+
+    constexpr u64 GetSuggestedCores() const {
+        return m_suggested_queue.GetAvailableCores();
+    }
+
     // Mutators.
     constexpr void PushBack(Member* member) {
         // This is for host (dummy) threads that we do not want to enter the priority queue.
@@ -420,24 +456,22 @@ public:
         const s32 new_core = member->GetActiveCore();
 
         // Remove the member from all queues it was in before.
-        for (s32 core = 0; core < static_cast<s32>(NumCores); core++) {
-            if (prev_affinity.GetAffinity(core)) {
-                if (core == prev_core) {
-                    m_scheduled_queue.Remove(priority, core, member);
-                } else {
-                    m_suggested_queue.Remove(priority, core, member);
-                }
+        u64 affinity = prev_affinity.GetAffinityMask();
+        while (affinity) {
+            if (const s32 core = GetNextCore(affinity); core == prev_core) {
+                m_scheduled_queue.Remove(priority, core, member);
+            } else {
+                m_suggested_queue.Remove(priority, core, member);
             }
         }
 
         // And add the member to all queues it should be in now.
-        for (s32 core = 0; core < static_cast<s32>(NumCores); core++) {
-            if (new_affinity.GetAffinity(core)) {
-                if (core == new_core) {
-                    m_scheduled_queue.PushBack(priority, core, member);
-                } else {
-                    m_suggested_queue.PushBack(priority, core, member);
-                }
+        affinity = new_affinity.GetAffinityMask();
+        while (affinity) {
+            if (const s32 core = GetNextCore(affinity); core == new_core) {
+                m_scheduled_queue.PushBack(priority, core, member);
+            } else {
+                m_suggested_queue.PushBack(priority, core, member);
             }
         }
     }
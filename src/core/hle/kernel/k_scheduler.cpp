@@ -247,6 +247,9 @@ u64 KScheduler::UpdateHighestPriorityThreadsImpl(KernelCore& kernel) {
     }
 
     // Idle cores are bad. We're going to try to migrate threads to each idle core in turn.
+    // Migrations only add suggestions to cores that were running something, so idle cores
+    // without any suggested thread can be skipped right away.
+    idle_cores &= priority_queue.GetSuggestedCores();
     while (idle_cores != 0) {
         const s32 core_id = static_cast<s32>(std::countr_zero(idle_cores));
 
@@ -41,6 +41,7 @@
 #include "core/hle/kernel/k_worker_task_manager.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/physical_core.h"
+#include "core/hle/kernel/svc_trace.h"
 #include "core/hle/result.h"
 #include "core/hle/service/server_manager.h"
 #include "core/hle/service/sm/sm.h"
@@ -841,6 +842,7 @@ struct KernelCore::Impl {
     u32 single_core_thread_id{};
 
     std::array<u64, Core::Hardware::NUM_CPU_CORES> svc_ticks{};
+    SvcTracer svc_tracer;
 
     KWorkerTaskManager worker_task_manager;
 
@@ -1286,6 +1288,14 @@ void KernelCore::ExitSVCProfile() {
     MicroProfileLeave(MICROPROFILE_TOKEN(Kernel_SVC), impl->svc_ticks[CurrentPhysicalCoreIndex()]);
 }
 
+SvcTracer& KernelCore::GetSvcTracer() {
+    return impl->svc_tracer;
+}
+
+const SvcTracer& KernelCore::GetSvcTracer() const {
+    return impl->svc_tracer;
+}
+
 Init::KSlabResourceCounts& KernelCore::SlabResourceCounts() {
     return impl->slab_resource_counts;
 }
@@ -72,6 +72,7 @@ class KTransferMemory;
 class KWorkerTaskManager;
 class KCodeMemory;
 class PhysicalCore;
+class SvcTracer;
 
 namespace Init {
 struct KSlabResourceCounts;
@@ -275,6 +276,12 @@ public:
 
     void ExitSVCProfile();
 
+    /// Gets the tracer recording the supervisor calls of the guest.
+    SvcTracer& GetSvcTracer();
+
+    /// Gets the tracer recording the supervisor calls of the guest.
+    const SvcTracer& GetSvcTracer() const;
+
     /// Workaround for single-core mode when preempting threads while idle.
     bool IsPhantomModeForSingleCore() const;
     void SetIsPhantomModeForSingleCore(bool value);
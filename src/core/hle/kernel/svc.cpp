@@ -9,6 +9,7 @@
 #include "core/core.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/kernel/svc.h"
+#include "core/hle/kernel/svc_trace.h"
 
 namespace Kernel::Svc {
 
@@ -4420,6 +4421,259 @@ static void Call64(Core::System& system, u32 imm, std::span<uint64_t, 8> args) {
         break;
     }
 }
+
+const char* GetSvcName(u32 imm) {
+    switch (static_cast<SvcId>(imm)) {
+    case SvcId::SetHeapSize:
+        return "SetHeapSize";
+    case SvcId::SetMemoryPermission:
+        return "SetMemoryPermission";
+    case SvcId::SetMemoryAttribute:
+        return "SetMemoryAttribute";
+    case SvcId::MapMemory:
+        return "MapMemory";
+    case SvcId::UnmapMemory:
+        return "UnmapMemory";
+    case SvcId::QueryMemory:
+        return "QueryMemory";
+    case SvcId::ExitProcess:
+        return "ExitProcess";
+    case SvcId::CreateThread:
+        return "CreateThread";
+    case SvcId::StartThread:
+        return "StartThread";
+    case SvcId::ExitThread:
+        return "ExitThread";
+    case SvcId::SleepThread:
+        return "SleepThread";
+    case SvcId::GetThreadPriority:
+        return "GetThreadPriority";
+    case SvcId::SetThreadPriority:
+        return "SetThreadPriority";
+    case SvcId::GetThreadCoreMask:
+        return "GetThreadCoreMask";
+    case SvcId::SetThreadCoreMask:
+        return "SetThreadCoreMask";
+    case SvcId::GetCurrentProcessorNumber:
+        return "GetCurrentProcessorNumber";
+    case SvcId::SignalEvent:
+        return "SignalEvent";
+    case SvcId::ClearEvent:
+        return "ClearEvent";
+    case SvcId::MapSharedMemory:
+        return "MapSharedMemory";
+    case SvcId::UnmapSharedMemory:
+        return "UnmapSharedMemory";
+    case SvcId::CreateTransferMemory:
+        return "CreateTransferMemory";
+    case SvcId::CloseHandle:
+        return "CloseHandle";
+    case SvcId::ResetSignal:
+        return "ResetSignal";
+    case SvcId::WaitSynchronization:
+        return "WaitSynchronization";
+    case SvcId::CancelSynchronization:
+        return "CancelSynchronization";
+    case SvcId::ArbitrateLock:
+        return "ArbitrateLock";
+    case SvcId::ArbitrateUnlock:
+        return "ArbitrateUnlock";
+    case SvcId::WaitProcessWideKeyAtomic:
+        return "WaitProcessWideKeyAtomic";
+    case SvcId::SignalProcessWideKey:
+        return "SignalProcessWideKey";
+    case SvcId::GetSystemTick:
+        return "GetSystemTick";
+    case SvcId::ConnectToNamedPort:
+        return "ConnectToNamedPort";
+    case SvcId::SendSyncRequestLight:
+        return "SendSyncRequestLight";
+    case SvcId::SendSyncRequest:
+        return "SendSyncRequest";
+    case SvcId::SendSyncRequestWithUserBuffer:
+        return "SendSyncRequestWithUserBuffer";
+    case SvcId::SendAsyncRequestWithUserBuffer:
+        return "SendAsyncRequestWithUserBuffer";
+    case SvcId::GetProcessId:
+        return "GetProcessId";
+    case SvcId::GetThreadId:
+        return "GetThreadId";
+    case SvcId::Break:
+        return "Break";
+    case SvcId::OutputDebugString:
+        return "OutputDebugString";
+    case SvcId::ReturnFromException:
+        return "ReturnFromException";
+    case SvcId::GetInfo:
+        return "GetInfo";
+    case SvcId::FlushEntireDataCache:
+        return "FlushEntireDataCache";
+    case SvcId::FlushDataCache:
+        return "FlushDataCache";
+    case SvcId::MapPhysicalMemory:
+        return "MapPhysicalMemory";
+    case SvcId::UnmapPhysicalMemory:
+        return "UnmapPhysicalMemory";
+    case SvcId::GetDebugFutureThreadInfo:
+        return "GetDebugFutureThreadInfo";
+    case SvcId::GetLastThreadInfo:
+        return "GetLastThreadInfo";
+    case SvcId::GetResourceLimitLimitValue:
+        return "GetResourceLimitLimitValue";
+    case SvcId::GetResourceLimitCurrentValue:
+        return "GetResourceLimitCurrentValue";
+    case SvcId::SetThreadActivity:
+        return "SetThreadActivity";
+    case SvcId::GetThreadContext3:
+        return "GetThreadContext3";
+    case SvcId::WaitForAddress:
+        return "WaitForAddress";
+    case SvcId::SignalToAddress:
+        return "SignalToAddress";
+    case SvcId::SynchronizePreemptionState:
+        return "SynchronizePreemptionState";
+    case SvcId::GetResourceLimitPeakValue:
+        return "GetResourceLimitPeakValue";
+    case SvcId::CreateIoPool:
+        return "CreateIoPool";
+    case SvcId::CreateIoRegion:
+        return "CreateIoRegion";
+    case SvcId::KernelDebug:
+        return "KernelDebug";
+    case SvcId::ChangeKernelTraceState:
+        return "ChangeKernelTraceState";
+    case SvcId::CreateSession:
+        return "CreateSession";
+    case SvcId::AcceptSession:
+        return "AcceptSession";
+    case SvcId::ReplyAndReceiveLight:
+        return "ReplyAndReceiveLight";
+    case SvcId::ReplyAndReceive:
+        return "ReplyAndReceive";
+    case SvcId::ReplyAndReceiveWithUserBuffer:
+        return "ReplyAndReceiveWithUserBuffer";
+    case SvcId::CreateEvent:
+        return "CreateEvent";
+    case SvcId::MapIoRegion:
+        return "MapIoRegion";
+    case SvcId::UnmapIoRegion:
+        return "UnmapIoRegion";
+    case SvcId::MapPhysicalMemoryUnsafe:
+        return "MapPhysicalMemoryUnsafe";
+    case SvcId::UnmapPhysicalMemoryUnsafe:
+        return "UnmapPhysicalMemoryUnsafe";
+    case SvcId::SetUnsafeLimit:
+        return "SetUnsafeLimit";
+    case SvcId::CreateCodeMemory:
+        return "CreateCodeMemory";
+    case SvcId::ControlCodeMemory:
+        return "ControlCodeMemory";
+    case SvcId::SleepSystem:
+        return "SleepSystem";
+    case SvcId::ReadWriteRegister:
+        return "ReadWriteRegister";
+    case SvcId::SetProcessActivity:
+        return "SetProcessActivity";
+    case SvcId::CreateSharedMemory:
+        return "CreateSharedMemory";
+    case SvcId::MapTransferMemory:
+        return "MapTransferMemory";
+    case SvcId::UnmapTransferMemory:
+        return "UnmapTransferMemory";
+    case SvcId::CreateInterruptEvent:
+        return "CreateInterruptEvent";
+    case SvcId::QueryPhysicalAddress:
+        return "QueryPhysicalAddress";
+    case SvcId::QueryIoMapping:
+        return "QueryIoMapping";
+    case SvcId::CreateDeviceAddressSpace:
+        return "CreateDeviceAddressSpace";
+    case SvcId::AttachDeviceAddressSpace:
+        return "AttachDeviceAddressSpace";
+    case SvcId::DetachDeviceAddressSpace:
+        return "DetachDeviceAddressSpace";
+    case SvcId::MapDeviceAddressSpaceByForce:
+        return "MapDeviceAddressSpaceByForce";
+    case SvcId::MapDeviceAddressSpaceAligned:
+        return "MapDeviceAddressSpaceAligned";
+    case SvcId::UnmapDeviceAddressSpace:
+        return "UnmapDeviceAddressSpace";
+    case SvcId::InvalidateProcessDataCache:
+        return "InvalidateProcessDataCache";
+    case SvcId::StoreProcessDataCache:
+        return "StoreProcessDataCache";
+    case SvcId::FlushProcessDataCache:
+        return "FlushProcessDataCache";
+    case SvcId::DebugActiveProcess:
+        return "DebugActiveProcess";
+    case SvcId::BreakDebugProcess:
+        return "BreakDebugProcess";
+    case SvcId::TerminateDebugProcess:
+        return "TerminateDebugProcess";
+    case SvcId::GetDebugEvent:
+        return "GetDebugEvent";
+    case SvcId::ContinueDebugEvent:
+        return "ContinueDebugEvent";
+    case SvcId::GetProcessList:
+        return "GetProcessList";
+    case SvcId::GetThreadList:
+        return "GetThreadList";
+    case SvcId::GetDebugThreadContext:
+        return "GetDebugThreadContext";
+    case SvcId::SetDebugThreadContext:
+        return "SetDebugThreadContext";
+    case SvcId::QueryDebugProcessMemory:
+        return "QueryDebugProcessMemory";
+    case SvcId::ReadDebugProcessMemory:
+        return "ReadDebugProcessMemory";
+    case SvcId::WriteDebugProcessMemory:
+        return "WriteDebugProcessMemory";
+    case SvcId::SetHardwareBreakPoint:
+        return "SetHardwareBreakPoint";
+    case SvcId::GetDebugThreadParam:
+        return "GetDebugThreadParam";
+    case SvcId::GetSystemInfo:
+        return "GetSystemInfo";
+    case SvcId::CreatePort:
+        return "CreatePort";
+    case SvcId::ManageNamedPort:
+        return "ManageNamedPort";
+    case SvcId::ConnectToPort:
+        return "ConnectToPort";
+    case SvcId::SetProcessMemoryPermission:
+        return "SetProcessMemoryPermission";
+    case SvcId::MapProcessMemory:
+        return "MapProcessMemory";
+    case SvcId::UnmapProcessMemory:
+        return "UnmapProcessMemory";
+    case SvcId::QueryProcessMemory:
+        return "QueryProcessMemory";
+    case SvcId::MapProcessCodeMemory:
+        return "MapProcessCodeMemory";
+    case SvcId::UnmapProcessCodeMemory:
+        return "UnmapProcessCodeMemory";
+    case SvcId::CreateProcess:
+        return "CreateProcess";
+    case SvcId::StartProcess:
+        return "StartProcess";
+    case SvcId::TerminateProcess:
+        return "TerminateProcess";
+    case SvcId::GetProcessInfo:
+        return "GetProcessInfo";
+    case SvcId::CreateResourceLimit:
+        return "CreateResourceLimit";
+    case SvcId::SetResourceLimitLimitValue:
+        return "SetResourceLimitLimitValue";
+    case SvcId::CallSecureMonitor:
+        return "CallSecureMonitor";
+    case SvcId::MapInsecureMemory:
+        return "MapInsecureMemory";
+    case SvcId::UnmapInsecureMemory:
+        return "UnmapInsecureMemory";
+    default:
+        return nullptr;
+    }
+}
 // clang-format on
 
 void Call(Core::System& system, u32 imm) {
@@ -4430,10 +4684,14 @@ void Call(Core::System& system, u32 imm) {
     kernel.CurrentPhysicalCore().SaveSvcArguments(process, args);
     kernel.EnterSVCProfile();
 
-    if (process.Is64Bit()) {
-        Call64(system, imm, args);
-    } else {
-        Call32(system, imm, args);
+    {
+        SvcTracer::Scope trace_scope{kernel, imm, args};
+
+        if (process.Is64Bit()) {
+            Call64(system, imm, args);
+        } else {
+            Call32(system, imm, args);
+        }
     }
 
     kernel.ExitSVCProfile();
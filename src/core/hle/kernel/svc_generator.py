@@ -539,6 +539,9 @@ void SvcWrap_CallSecureMonitor64(Core::System& system, std::span<uint64_t, 8> ar
 // Perform a supervisor call by index.
 void Call(Core::System& system, u32 imm);
 
+// Get the name of a supervisor call by index, or nullptr if the index is unknown.
+const char* GetSvcName(u32 imm);
+
 } // namespace Kernel::Svc
 """
 
@@ -549,6 +552,7 @@ PROLOGUE_CPP = """
 #include "core/core.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/kernel/svc.h"
+#include "core/hle/kernel/svc_trace.h"
 
 namespace Kernel::Svc {
 
@@ -598,10 +602,14 @@ void Call(Core::System& system, u32 imm) {
     kernel.CurrentPhysicalCore().SaveSvcArguments(process, args);
     kernel.EnterSVCProfile();
 
-    if (process.Is64Bit()) {
-        Call64(system, imm, args);
-    } else {
-        Call32(system, imm, args);
+    {
+        SvcTracer::Scope trace_scope{kernel, imm, args};
+
+        if (process.Is64Bit()) {
+            Call64(system, imm, args);
+        } else {
+            Call32(system, imm, args);
+        }
     }
 
     kernel.ExitSVCProfile();
@@ -634,6 +642,25 @@ def emit_call(bitness, names, suffix):
     return "\n".join(lines)
 
 
+def emit_names(names):
+    indent = "    "
+    lines = [
+        "const char* GetSvcName(u32 imm) {",
+        f"{indent}switch (static_cast<SvcId>(imm)) {{"
+    ]
+
+    for _, name in names:
+        lines.append(f"{indent}case SvcId::{name}:")
+        lines.append(f"{indent*2}return \"{name}\";")
+
+    lines.append(f"{indent}default:")
+    lines.append(f"{indent*2}return nullptr;")
+    lines.append(f"{indent}}}")
+    lines.append("}")
+
+    return "\n".join(lines)
+
+
 def build_fn_declaration(return_type, name, arguments):
     arg_list = ["Core::System& system"]
     for arg in arguments:
@@ -690,6 +717,7 @@ def main():
 
     call_32 = emit_call(BIT_32, names, SUFFIX_NAMES[BIT_32])
     call_64 = emit_call(BIT_64, names, SUFFIX_NAMES[BIT_64])
+    svc_names = emit_names(names)
     enum_decls = build_enum_declarations()
 
     with open("svc.h", "w") as f:
@@ -714,6 +742,8 @@ def main():
         f.write(call_32)
         f.write("\n\n")
         f.write(call_64)
+        f.write("\n\n")
+        f.write(svc_names)
         f.write(EPILOGUE_CPP)
 
     print(f"Done (emitted {len(names)} definitions)")
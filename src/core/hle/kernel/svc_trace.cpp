@@ -0,0 +1,248 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <utility>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "core/hle/kernel/k_thread.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/svc.h"
+#include "core/hle/kernel/svc_trace.h"
+
+namespace Kernel {
+
+namespace {
+
+constexpr u64 NO_TOKEN = ~0ULL;
+
+} // Anonymous namespace
+
+struct SvcTracer::CoreState {
+    struct Slot {
+        /// Index of the call held by the slot plus one, zero while the slot is being written
+        std::atomic<u64> sequence{};
+        Entry entry{};
+    };
+
+    struct Counters {
+        std::atomic<u64> calls{};
+        std::atomic<u64> total_ns{};
+        std::atomic<u64> max_ns{};
+    };
+
+    alignas(64) std::atomic<u64> write_index{};
+    std::array<Slot, RingSize> slots{};
+    std::array<Counters, NumSvcs> counters{};
+};
+
+SvcTracer::Scope::Scope(KernelCore& kernel_, u32 svc_id_, std::span<const u64, 8> args_)
+    : kernel{kernel_}, tracer{kernel_.GetSvcTracer()}, start_ns{}, tick{}, svc_id{svc_id_},
+      recording{tracer.IsEnabled()} {
+    if (recording) {
+        std::ranges::copy(args_, args.begin());
+        start_ns = tracer.GetHostTimeNs();
+    }
+#if MICROPROFILE_ENABLED
+    if (const u64 token = tracer.GetTimerToken(svc_id); token != NO_TOKEN) {
+        tick = MicroProfileEnter(token);
+    }
+#endif
+}
+
+SvcTracer::Scope::~Scope() {
+#if MICROPROFILE_ENABLED
+    if (const u64 token = tracer.GetTimerToken(svc_id); token != NO_TOKEN) {
+        MicroProfileLeave(token, tick);
+    }
+#endif
+    if (!recording) {
+        return;
+    }
+    tracer.Record(Entry{
+        .args = args,
+        .thread_id = GetCurrentThread(kernel).GetThreadId(),
+        .start_ns = start_ns,
+        .duration_ns = tracer.GetHostTimeNs() - start_ns,
+        .svc_id = svc_id,
+        .core = static_cast<u32>(kernel.CurrentPhysicalCoreIndex()),
+    });
+}
+
+SvcTracer::SvcTracer()
+    : cores{std::make_unique<CoreState[]>(NumCores)},
+      creation_time{std::chrono::steady_clock::now()} {
+    timer_tokens.fill(NO_TOKEN);
+#if MICROPROFILE_ENABLED
+    for (u32 svc_id = 0; svc_id < NumSvcs; ++svc_id) {
+        if (const char* name = Svc::GetSvcName(svc_id)) {
+            timer_tokens[svc_id] = MicroProfileGetToken("SVC", name, MP_RGB(70, 200, 70));
+        }
+    }
+#endif
+}
+
+SvcTracer::~SvcTracer() = default;
+
+u64 SvcTracer::GetHostTimeNs() const {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - creation_time)
+                                .count());
+}
+
+u64 SvcTracer::GetTimerToken(u32 svc_id) const {
+    return svc_id < NumSvcs ? timer_tokens[svc_id] : NO_TOKEN;
+}
+
+void SvcTracer::Record(const Entry& entry) {
+    if (entry.core >= NumCores) {
+        return;
+    }
+    CoreState& core = cores[entry.core];
+
+    if (entry.svc_id < NumSvcs) {
+        // Only this core's thread writes its counters, so they don't need atomic updates
+        auto& counters = core.counters[entry.svc_id];
+        counters.calls.store(counters.calls.load(std::memory_order_relaxed) + 1,
+                             std::memory_order_relaxed);
+        counters.total_ns.store(
+            counters.total_ns.load(std::memory_order_relaxed) + entry.duration_ns,
+            std::memory_order_relaxed);
+        if (entry.duration_ns > counters.max_ns.load(std::memory_order_relaxed)) {
+            counters.max_ns.store(entry.duration_ns, std::memory_order_relaxed);
+        }
+    }
+
+    // Invalidate the slot while it is written, so that readers can tell torn entries apart
+    const u64 index = core.write_index.load(std::memory_order_relaxed);
+    auto& slot = core.slots[index % RingSize];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.entry = entry;
+    slot.sequence.store(index + 1, std::memory_order_release);
+    core.write_index.store(index + 1, std::memory_order_release);
+}
+
+std::vector<SvcTracer::Entry> SvcTracer::GetRecentCalls() const {
+    std::vector<Entry> calls;
+    for (size_t core_index = 0; core_index < NumCores; ++core_index) {
+        const CoreState& core = cores[core_index];
+        const u64 end = core.write_index.load(std::memory_order_acquire);
+        const u64 begin = end - std::min<u64>(end, RingSize);
+        for (u64 index = begin; index < end; ++index) {
+            const auto& slot = core.slots[index % RingSize];
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1) {
+                continue;
+            }
+            const Entry entry = slot.entry;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1) {
+                // Overwritten while it was being copied
+                continue;
+            }
+            calls.push_back(entry);
+        }
+    }
+    std::ranges::sort(calls, {}, &Entry::start_ns);
+    return calls;
+}
+
+SvcTracer::Stats SvcTracer::GetStats(u32 svc_id) const {
+    Stats stats{};
+    if (svc_id >= NumSvcs) {
+        return stats;
+    }
+    for (size_t core_index = 0; core_index < NumCores; ++core_index) {
+        const auto& counters = cores[core_index].counters[svc_id];
+        stats.calls += counters.calls.load(std::memory_order_relaxed);
+        stats.total_ns += counters.total_ns.load(std::memory_order_relaxed);
+        stats.max_ns = std::max(stats.max_ns, counters.max_ns.load(std::memory_order_relaxed));
+    }
+    return stats;
+}
+
+std::string SvcTracer::ExportJson() const {
+    const auto get_name = [](u32 svc_id) -> std::string {
+        const char* name = Svc::GetSvcName(svc_id);
+        return name ? name : fmt::format("Unknown{:#x}", svc_id);
+    };
+
+    std::vector<std::pair<u32, Stats>> called;
+    for (u32 svc_id = 0; svc_id < NumSvcs; ++svc_id) {
+        if (const Stats stats = GetStats(svc_id); stats.calls != 0) {
+            called.emplace_back(svc_id, stats);
+        }
+    }
+    std::ranges::sort(called, [](const auto& lhs, const auto& rhs) {
+        return lhs.second.total_ns > rhs.second.total_ns;
+    });
+
+    auto svcs = nlohmann::json::array();
+    for (const auto& [svc_id, stats] : called) {
+        svcs.push_back({
+            {"id", svc_id},
+            {"name", get_name(svc_id)},
+            {"calls", stats.calls},
+            {"total_ns", stats.total_ns},
+            {"mean_ns", stats.total_ns / stats.calls},
+            {"max_ns", stats.max_ns},
+        });
+    }
+
+    auto calls = nlohmann::json::array();
+    for (const Entry& entry : GetRecentCalls()) {
+        auto args = nlohmann::json::array();
+        for (const u64 arg : entry.args) {
+            args.push_back(fmt::format("{:#x}", arg));
+        }
+        calls.push_back({
+            {"core", entry.core},
+            {"thread_id", entry.thread_id},
+            {"id", entry.svc_id},
+            {"name", get_name(entry.svc_id)},
+            {"start_ns", entry.start_ns},
+            {"duration_ns", entry.duration_ns},
+            {"args", std::move(args)},
+        });
+    }
+    return nlohmann::json{{"svcs", std::move(svcs)}, {"calls", std::move(calls)}}.dump(4);
+}
+
+bool SvcTracer::ExportJson(const std::filesystem::path& path) const {
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_ERROR(Kernel_SVC, "Failed to create path for '{}' to save the SVC trace",
+                  Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    const std::string json = ExportJson();
+    if (Common::FS::WriteStringToFile(path, Common::FS::FileType::TextFile, json) != json.size()) {
+        LOG_ERROR(Kernel_SVC, "Failed to write the SVC trace to '{}'",
+                  Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    return true;
+}
+
+void SvcTracer::Reset() {
+    for (size_t core_index = 0; core_index < NumCores; ++core_index) {
+        CoreState& core = cores[core_index];
+        core.write_index.store(0, std::memory_order_relaxed);
+        for (auto& slot : core.slots) {
+            slot.sequence.store(0, std::memory_order_relaxed);
+        }
+        for (auto& counters : core.counters) {
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.total_ns.store(0, std::memory_order_relaxed);
+            counters.max_ns.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace Kernel
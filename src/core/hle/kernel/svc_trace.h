@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "common/common_types.h"
+#include "core/hardware_properties.h"
+
+namespace Kernel {
+
+class KernelCore;
+
+/**
+ * Records the supervisor calls made by the guest. Every core has a ring buffer with its most
+ * recent calls and counters of the calls and host time spent in every SVC, both written without
+ * locking by the host thread running the core. Every SVC also gets a microprofile timer in the
+ * "SVC" group. Recording reads the host clock twice per call, so it is disabled by default.
+ */
+class SvcTracer {
+public:
+    static constexpr size_t NumSvcs = 0x100;
+    static constexpr size_t NumCores = Core::Hardware::NUM_CPU_CORES;
+
+    /// Number of calls kept per core
+    static constexpr size_t RingSize = 1024;
+
+    struct Entry {
+        std::array<u64, 8> args{}; ///< Registers on entry to the SVC
+        u64 thread_id{};
+        u64 start_ns{};    ///< Host time since the tracer was created
+        u64 duration_ns{}; ///< Host time until the SVC returned, including time spent waiting
+        u32 svc_id{};
+        u32 core{}; ///< Core the SVC returned on
+    };
+
+    struct Stats {
+        u64 calls{};
+        u64 total_ns{};
+        u64 max_ns{};
+    };
+
+    /// Traces a SVC from construction to destruction, also as a microprofile scope
+    class Scope {
+    public:
+        explicit Scope(KernelCore& kernel_, u32 svc_id_, std::span<const u64, 8> args_);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        KernelCore& kernel;
+        SvcTracer& tracer;
+        std::array<u64, 8> args;
+        u64 start_ns;
+        u64 tick;
+        u32 svc_id;
+        bool recording;
+    };
+
+    SvcTracer();
+    ~SvcTracer();
+
+    SvcTracer(const SvcTracer&) = delete;
+    SvcTracer& operator=(const SvcTracer&) = delete;
+
+    void SetEnabled(bool enabled_) {
+        enabled.store(enabled_, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Returns the host time since the tracer was created
+    [[nodiscard]] u64 GetHostTimeNs() const;
+
+    /// Accounts one call, must only be called from the host thread running the entry's core
+    void Record(const Entry& entry);
+
+    /// Returns the calls still held by the ring buffers of all cores, oldest first
+    [[nodiscard]] std::vector<Entry> GetRecentCalls() const;
+
+    /// Returns the counters of a SVC summed over all cores
+    [[nodiscard]] Stats GetStats(u32 svc_id) const;
+
+    /// Returns the counters of all called SVCs and the recent calls as JSON
+    [[nodiscard]] std::string ExportJson() const;
+
+    /// Writes the counters of all called SVCs and the recent calls as JSON to a file
+    bool ExportJson(const std::filesystem::path& path) const;
+
+    /// Clears the counters and recent calls, must not race with calls being recorded
+    void Reset();
+
+private:
+    struct CoreState;
+
+    [[nodiscard]] u64 GetTimerToken(u32 svc_id) const;
+
+    std::unique_ptr<CoreState[]> cores;
+    std::array<u64, NumSvcs> timer_tokens{};
+    std::atomic_bool enabled{};
+    std::chrono::steady_clock::time_point creation_time;
+};
+
+} // namespace Kernel
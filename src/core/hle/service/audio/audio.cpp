@@ -29,6 +29,8 @@ void LoopProcess(Core::System& system) {
                                          std::make_shared<IAudioRendererManager>(system));
     server_manager->RegisterNamedService("hwopus",
                                          std::make_shared<IHardwareOpusDecoderManager>(system));
+    // Renderers and opus decoders are separate interfaces, so their updates run concurrently
+    server_manager->StartAdditionalHostThreads("audio", 2);
     ServerManager::RunServer(std::move(server_manager));
 }
 
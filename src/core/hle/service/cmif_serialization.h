@@ -338,16 +338,30 @@ void ReadInArgument(bool is_domain, CallArguments& args, const u8* raw_data, HLE
         } else if constexpr (ArgumentTraits<ArgType>::Type == ArgumentType::OutBuffer) {
             using ElementType = typename ArgType::Type;
 
-            // Set up scratch buffer.
-            auto& buffer = temp[OutBufferIndex];
+            // Write directly to guest memory when the buffer is contiguous in host memory.
+            std::span<u8> guest_span;
             if (ctx.CanWriteBuffer(OutBufferIndex)) {
+                if constexpr (ArgType::Attr & BufferAttr_HipcAutoSelect) {
+                    guest_span = ctx.GetWriteBufferSpan(OutBufferIndex);
+                } else if constexpr (ArgType::Attr & BufferAttr_HipcMapAlias) {
+                    guest_span = ctx.GetWriteBufferSpanB(OutBufferIndex);
+                } else /* if (ArgType::Attr & BufferAttr_HipcPointer) */ {
+                    guest_span = ctx.GetWriteBufferSpanC(OutBufferIndex);
+                }
+            }
+
+            // Otherwise set up scratch buffer. It is left empty for in place buffers, so that nothing is written back.
+            auto& buffer = temp[OutBufferIndex];
+            const bool in_place = !guest_span.empty() && reinterpret_cast<uintptr_t>(guest_span.data()) % alignof(ElementType) == 0;
+            if (!in_place && ctx.CanWriteBuffer(OutBufferIndex)) {
                 buffer.resize_destructive(ctx.GetWriteBufferSize(OutBufferIndex));
             } else {
                 buffer.resize_destructive(0);
             }
 
-            ElementType* ptr = (ElementType*) buffer.data();
-            size_t size = buffer.size() / sizeof(ElementType);
+            const std::span<u8> storage = in_place ? guest_span : std::span<u8>(buffer.data(), buffer.size());
+            ElementType* ptr = (ElementType*) storage.data();
+            size_t size = storage.size() / sizeof(ElementType);
 
             std::get<ArgIndex>(args) = std::span(ptr, size);
 
@@ -450,6 +450,38 @@ std::size_t HLERequestContext::WriteBufferC(const void* buffer, std::size_t size
     return size;
 }
 
+std::span<u8> HLERequestContext::GetWriteBufferSpan(std::size_t buffer_index) const {
+    const bool is_buffer_b{BufferDescriptorB().size() > buffer_index &&
+                           BufferDescriptorB()[buffer_index].Size()};
+    if (is_buffer_b) {
+        return GetWriteBufferSpanB(buffer_index);
+    }
+    return GetWriteBufferSpanC(buffer_index);
+}
+
+std::span<u8> HLERequestContext::GetWriteBufferSpanB(std::size_t buffer_index) const {
+    if (buffer_index >= BufferDescriptorB().size()) {
+        return {};
+    }
+    return GetGuestSpan(BufferDescriptorB()[buffer_index].Address(),
+                        BufferDescriptorB()[buffer_index].Size());
+}
+
+std::span<u8> HLERequestContext::GetWriteBufferSpanC(std::size_t buffer_index) const {
+    if (buffer_index >= BufferDescriptorC().size()) {
+        return {};
+    }
+    return GetGuestSpan(BufferDescriptorC()[buffer_index].Address(),
+                        BufferDescriptorC()[buffer_index].Size());
+}
+
+std::span<u8> HLERequestContext::GetGuestSpan(u64 address, std::size_t size) const {
+    if (u8* const pointer = memory.GetSpan(address, size); pointer) {
+        return {pointer, size};
+    }
+    return {};
+}
+
 std::size_t HLERequestContext::GetReadBufferSize(std::size_t buffer_index) const {
     const bool is_buffer_a{BufferDescriptorA().size() > buffer_index &&
                            BufferDescriptorA()[buffer_index].Size()};
@@ -281,6 +281,19 @@ public:
     std::size_t WriteBufferC(const void* buffer, std::size_t size,
                              std::size_t buffer_index = 0) const;
 
+    /**
+     * Helper function to get a view of the guest memory of a buffer, using the buffer descriptor
+     * chosen by WriteBuffer. The view is empty when the buffer is not contiguous in host memory,
+     * in which case it has to be written with WriteBuffer instead.
+     */
+    [[nodiscard]] std::span<u8> GetWriteBufferSpan(std::size_t buffer_index = 0) const;
+
+    /// Helper function to get a view of the guest memory of buffer B, like GetWriteBufferSpan
+    [[nodiscard]] std::span<u8> GetWriteBufferSpanB(std::size_t buffer_index = 0) const;
+
+    /// Helper function to get a view of the guest memory of buffer C, like GetWriteBufferSpan
+    [[nodiscard]] std::span<u8> GetWriteBufferSpanC(std::size_t buffer_index = 0) const;
+
     /* Helper function to write a buffer using the appropriate buffer descriptor
      *
      * @tparam T an arbitrary container that satisfies the
@@ -394,6 +407,8 @@ private:
 
     void ParseCommandBuffer(u32_le* src_cmdbuf, bool incoming);
 
+    [[nodiscard]] std::span<u8> GetGuestSpan(u64 address, std::size_t size) const;
+
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
     Kernel::KServerSession* server_session{};
     Kernel::KHandleTable* client_handle_table{};
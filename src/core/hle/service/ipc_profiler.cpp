@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "core/hle/service/ipc_profiler.h"
+
+namespace Service {
+
+namespace {
+
+// Microprofile has a fixed number of timers shared with the rest of the emulator, so only the
+// first services to be called get one
+constexpr std::size_t MAX_SERVICE_TIMERS = 128;
+
+constexpr u64 TOKEN_NOT_CREATED = 0;
+constexpr u64 NO_TOKEN = ~0ULL;
+
+} // Anonymous namespace
+
+struct IpcProfiler::ServiceTimer {
+    std::string name;
+    std::atomic<u64> token{TOKEN_NOT_CREATED};
+};
+
+void IpcProfiler::CommandStats::Record(std::chrono::nanoseconds latency) {
+    const u64 latency_ns = static_cast<u64>(std::max<s64>(latency.count(), 0));
+    const std::size_t bucket =
+        std::min<std::size_t>(std::bit_width(latency_ns), histogram.size() - 1);
+    calls.fetch_add(1, std::memory_order_relaxed);
+    total_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+    u64 current_max = max_ns.load(std::memory_order_relaxed);
+    while (latency_ns > current_max &&
+           !max_ns.compare_exchange_weak(current_max, latency_ns, std::memory_order_relaxed)) {
+    }
+}
+
+IpcProfiler::LazyCommandStats::LazyCommandStats(const LazyCommandStats& other)
+    : stats{other.stats.load(std::memory_order_relaxed)} {}
+
+IpcProfiler::LazyCommandStats& IpcProfiler::LazyCommandStats::operator=(
+    const LazyCommandStats& other) {
+    stats.store(other.stats.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return *this;
+}
+
+IpcProfiler::CommandStats* IpcProfiler::LazyCommandStats::Get(IpcProfiler& profiler,
+                                                             std::string_view service_name,
+                                                             u32 command_id,
+                                                             std::string_view command_name,
+                                                             bool is_tipc) const {
+    if (CommandStats* const cached = stats.load(std::memory_order_acquire)) {
+        return cached;
+    }
+    // Concurrent first calls get the same statistics from the profiler
+    CommandStats* const command_stats =
+        profiler.GetCommandStats(service_name, command_id, command_name, is_tipc);
+    stats.store(command_stats, std::memory_order_release);
+    return command_stats;
+}
+
+IpcProfiler::CommandScope::CommandScope([[maybe_unused]] IpcProfiler& profiler,
+                                         CommandStats* stats_)
+    : stats{stats_}, start{std::chrono::steady_clock::now()}, token{NO_TOKEN}, tick{} {
+#if MICROPROFILE_ENABLED
+    if (stats) {
+        token = profiler.GetTimerToken(*stats->timer);
+        if (token != NO_TOKEN) {
+            tick = MicroProfileEnter(token);
+        }
+    }
+#endif
+}
+
+IpcProfiler::CommandScope::~CommandScope() {
+#if MICROPROFILE_ENABLED
+    if (token != NO_TOKEN) {
+        MicroProfileLeave(token, tick);
+    }
+#endif
+    if (stats) {
+        stats->Record(std::chrono::steady_clock::now() - start);
+    }
+}
+
+IpcProfiler::IpcProfiler() = default;
+
+IpcProfiler::~IpcProfiler() = default;
+
+IpcProfiler::CommandStats* IpcProfiler::GetCommandStats(std::string_view service_name,
+                                                        u32 command_id,
+                                                        std::string_view command_name,
+                                                        bool is_tipc) {
+    std::scoped_lock lk{mutex};
+    auto [it, inserted] =
+        commands.try_emplace(std::tuple{std::string{service_name}, command_id, is_tipc});
+    if (!inserted) {
+        return it->second.get();
+    }
+
+    auto timer_it = timers.find(service_name);
+    if (timer_it == timers.end()) {
+        auto timer = std::make_unique<ServiceTimer>();
+        timer->name = std::string{service_name};
+        timer_it = timers.emplace(std::string{service_name}, std::move(timer)).first;
+    }
+
+    auto stats = std::make_unique<CommandStats>();
+    stats->service_name = std::string{service_name};
+    stats->command_name = std::string{command_name};
+    stats->command_id = command_id;
+    stats->is_tipc = is_tipc;
+    stats->timer = timer_it->second.get();
+    it->second = std::move(stats);
+    return it->second.get();
+}
+
+u64 IpcProfiler::GetTimerToken(ServiceTimer& timer) {
+    if (const u64 token = timer.token.load(std::memory_order_acquire);
+        token != TOKEN_NOT_CREATED) {
+        return token;
+    }
+    std::scoped_lock lk{mutex};
+    u64 token = timer.token.load(std::memory_order_relaxed);
+    if (token != TOKEN_NOT_CREATED) {
+        return token;
+    }
+    token = NO_TOKEN;
+#if MICROPROFILE_ENABLED
+    if (num_tokens < MAX_SERVICE_TIMERS) {
+        ++num_tokens;
+        token = MicroProfileGetToken("HLE", timer.name.c_str(), MP_RGB(160, 80, 200));
+    }
+#endif
+    timer.token.store(token, std::memory_order_release);
+    return token;
+}
+
+std::string IpcProfiler::ExportJson() const {
+    std::vector<const CommandStats*> called;
+    {
+        std::scoped_lock lk{mutex};
+        for (const auto& [key, stats] : commands) {
+            if (stats->calls.load(std::memory_order_relaxed) != 0) {
+                called.push_back(stats.get());
+            }
+        }
+    }
+    std::ranges::sort(called, [](const CommandStats* lhs, const CommandStats* rhs) {
+        return lhs->total_ns.load(std::memory_order_relaxed) >
+               rhs->total_ns.load(std::memory_order_relaxed);
+    });
+
+    auto commands_json = nlohmann::json::array();
+    for (const CommandStats* stats : called) {
+        const u64 calls = stats->calls.load(std::memory_order_relaxed);
+        const u64 total_ns = stats->total_ns.load(std::memory_order_relaxed);
+
+        // Bucket i holds the latencies from 2^(i-1) ns up to 2^i ns
+        auto histogram = nlohmann::json::array();
+        for (std::size_t bucket = 0; bucket < NumBuckets; ++bucket) {
+            const u64 count = stats->histogram[bucket].load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            histogram.push_back({
+                {"min_ns", bucket == 0 ? 0ULL : 1ULL << (bucket - 1)},
+                {"count", count},
+            });
+        }
+        commands_json.push_back({
+            {"service", stats->service_name},
+            {"command_id", stats->command_id},
+            {"command", stats->command_name},
+            {"tipc", stats->is_tipc},
+            {"calls", calls},
+            {"total_ns", total_ns},
+            {"mean_ns", total_ns / std::max<u64>(calls, 1)},
+            {"max_ns", stats->max_ns.load(std::memory_order_relaxed)},
+            {"histogram", std::move(histogram)},
+        });
+    }
+    return nlohmann::json{{"commands", std::move(commands_json)}}.dump(4);
+}
+
+bool IpcProfiler::ExportJson(const std::filesystem::path& path) const {
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_ERROR(Service, "Failed to create path for '{}' to save the IPC profile",
+                  Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    const std::string json = ExportJson();
+    if (Common::FS::WriteStringToFile(path, Common::FS::FileType::TextFile, json) != json.size()) {
+        LOG_ERROR(Service, "Failed to write the IPC profile to '{}'",
+                  Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    return true;
+}
+
+void IpcProfiler::Reset() {
+    std::scoped_lock lk{mutex};
+    for (auto& [key, stats] : commands) {
+        stats->calls.store(0, std::memory_order_relaxed);
+        stats->total_ns.store(0, std::memory_order_relaxed);
+        stats->max_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : stats->histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+} // namespace Service
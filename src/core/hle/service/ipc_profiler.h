@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#include "common/common_types.h"
+
+namespace Service {
+
+/**
+ * Counts the calls of every HLE service command and keeps a histogram of their latency. Commands
+ * are registered on their first call, after which their statistics are updated without locking.
+ * Statistics are kept for the lifetime of the system, across processes.
+ */
+class IpcProfiler {
+public:
+    /// Latencies are bucketed by their bit width in nanoseconds, the last bucket is open ended
+    static constexpr std::size_t NumBuckets = 32;
+
+    struct ServiceTimer;
+
+    struct CommandStats {
+        std::string service_name;
+        std::string command_name;
+        u32 command_id{};
+        bool is_tipc{};
+        ServiceTimer* timer{};
+
+        std::atomic<u64> calls{};
+        std::atomic<u64> total_ns{};
+        std::atomic<u64> max_ns{};
+        std::array<std::atomic<u64>, NumBuckets> histogram{};
+
+        /// Accounts one call of the command
+        void Record(std::chrono::nanoseconds latency);
+    };
+
+    /// Statistics of a command, looked up on its first call so that creating a service doesn't
+    /// register all of its commands
+    class LazyCommandStats {
+    public:
+        LazyCommandStats() = default;
+        LazyCommandStats(std::nullptr_t) {}
+        LazyCommandStats(const LazyCommandStats& other);
+        LazyCommandStats& operator=(const LazyCommandStats& other);
+
+        [[nodiscard]] CommandStats* Get(IpcProfiler& profiler, std::string_view service_name,
+                                        u32 command_id, std::string_view command_name,
+                                        bool is_tipc) const;
+
+    private:
+        mutable std::atomic<CommandStats*> stats{};
+    };
+
+    /// Measures a call from construction to destruction, also as a microprofile scope
+    class CommandScope {
+    public:
+        explicit CommandScope(IpcProfiler& profiler, CommandStats* stats_);
+        ~CommandScope();
+
+        CommandScope(const CommandScope&) = delete;
+        CommandScope& operator=(const CommandScope&) = delete;
+
+    private:
+        CommandStats* stats;
+        std::chrono::steady_clock::time_point start;
+        u64 token;
+        u64 tick;
+    };
+
+    IpcProfiler();
+    ~IpcProfiler();
+
+    IpcProfiler(const IpcProfiler&) = delete;
+    IpcProfiler& operator=(const IpcProfiler&) = delete;
+
+    /// Returns the statistics of a command, which stay valid for the lifetime of the profiler
+    [[nodiscard]] CommandStats* GetCommandStats(std::string_view service_name, u32 command_id,
+                                                std::string_view command_name, bool is_tipc);
+
+    /// Returns the statistics of all called commands as JSON, sorted by total time
+    [[nodiscard]] std::string ExportJson() const;
+
+    /// Writes the statistics of all called commands as JSON to a file
+    bool ExportJson(const std::filesystem::path& path) const;
+
+    /// Clears the statistics of all commands
+    void Reset();
+
+private:
+    [[nodiscard]] u64 GetTimerToken(ServiceTimer& timer);
+
+    mutable std::mutex mutex;
+    std::map<std::string, std::unique_ptr<ServiceTimer>, std::less<>> timers;
+    std::map<std::tuple<std::string, u32, bool>, std::unique_ptr<CommandStats>, std::less<>>
+        commands;
+    std::size_t num_tokens{};
+};
+
+} // namespace Service
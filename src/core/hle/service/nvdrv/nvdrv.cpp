@@ -62,6 +62,8 @@ void LoopProcess(Core::System& system) {
     server_manager->RegisterNamedService("nvdrv:s", NvdrvInterfaceFactoryForSysmodules);
     server_manager->RegisterNamedService("nvdrv:t", NvdrvInterfaceFactoryForTesting);
     server_manager->RegisterNamedService("nvmemp", std::make_shared<NVMEMP>(system));
+    // Each session has its own interface, so ioctls of different sessions run concurrently
+    server_manager->StartAdditionalHostThreads("nvservices", 2);
     ServerManager::RunServer(std::move(server_manager));
 }
 
@@ -113,7 +115,7 @@ NvResult Module::VerifyFD(DeviceFD fd) const {
         return NvResult::InvalidState;
     }
 
-    if (open_files.find(fd) == open_files.end()) {
+    if (!FindDevice(fd)) {
         LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
         return NvResult::NotImplemented;
     }
@@ -121,6 +123,12 @@ NvResult Module::VerifyFD(DeviceFD fd) const {
     return NvResult::Success;
 }
 
+std::shared_ptr<Devices::nvdevice> Module::FindDevice(DeviceFD fd) const {
+    std::shared_lock lk{open_files_mutex};
+    const auto itr = open_files.find(fd);
+    return itr == open_files.end() ? nullptr : itr->second;
+}
+
 DeviceFD Module::Open(const std::string& device_name, NvCore::SessionId session_id) {
     auto it = builders.find(device_name);
     if (it == builders.end()) {
@@ -128,9 +136,13 @@ DeviceFD Module::Open(const std::string& device_name, NvCore::SessionId session_
         return INVALID_NVDRV_FD;
     }
 
-    const DeviceFD fd = next_fd++;
-    auto& builder = it->second;
-    auto device = builder(fd)->second;
+    std::shared_ptr<Devices::nvdevice> device;
+    DeviceFD fd;
+    {
+        std::scoped_lock lk{open_files_mutex};
+        fd = next_fd++;
+        device = it->second(fd)->second;
+    }
 
     device->OnOpen(session_id, fd);
 
@@ -144,14 +156,14 @@ NvResult Module::Ioctl1(DeviceFD fd, Ioctl command, std::span<const u8> input,
         return NvResult::InvalidState;
     }
 
-    const auto itr = open_files.find(fd);
+    const auto device = FindDevice(fd);
 
-    if (itr == open_files.end()) {
+    if (!device) {
         LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
         return NvResult::NotImplemented;
     }
 
-    return itr->second->Ioctl1(fd, command, input, output);
+    return device->Ioctl1(fd, command, input, output);
 }
 
 NvResult Module::Ioctl2(DeviceFD fd, Ioctl command, std::span<const u8> input,
@@ -161,14 +173,14 @@ NvResult Module::Ioctl2(DeviceFD fd, Ioctl command, std::span<const u8> input,
         return NvResult::InvalidState;
     }
 
-    const auto itr = open_files.find(fd);
+    const auto device = FindDevice(fd);
 
-    if (itr == open_files.end()) {
+    if (!device) {
         LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
         return NvResult::NotImplemented;
     }
 
-    return itr->second->Ioctl2(fd, command, input, inline_input, output);
+    return device->Ioctl2(fd, command, input, inline_input, output);
 }
 
 NvResult Module::Ioctl3(DeviceFD fd, Ioctl command, std::span<const u8> input, std::span<u8> output,
@@ -178,14 +190,14 @@ NvResult Module::Ioctl3(DeviceFD fd, Ioctl command, std::span<const u8> input, s
         return NvResult::InvalidState;
     }
 
-    const auto itr = open_files.find(fd);
+    const auto device = FindDevice(fd);
 
-    if (itr == open_files.end()) {
+    if (!device) {
         LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
         return NvResult::NotImplemented;
     }
 
-    return itr->second->Ioctl3(fd, command, input, output, inline_output);
+    return device->Ioctl3(fd, command, input, output, inline_output);
 }
 
 NvResult Module::Close(DeviceFD fd) {
@@ -194,16 +206,21 @@ NvResult Module::Close(DeviceFD fd) {
         return NvResult::InvalidState;
     }
 
-    const auto itr = open_files.find(fd);
+    std::shared_ptr<Devices::nvdevice> device;
+    {
+        std::scoped_lock lk{open_files_mutex};
+        const auto itr = open_files.find(fd);
 
-    if (itr == open_files.end()) {
-        LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
-        return NvResult::NotImplemented;
-    }
+        if (itr == open_files.end()) {
+            LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
+            return NvResult::NotImplemented;
+        }
 
-    itr->second->OnClose(fd);
+        device = std::move(itr->second);
+        open_files.erase(itr);
+    }
 
-    open_files.erase(itr);
+    device->OnClose(fd);
 
     return NvResult::Success;
 }
@@ -214,14 +231,14 @@ NvResult Module::QueryEvent(DeviceFD fd, u32 event_id, Kernel::KEvent*& event) {
         return NvResult::InvalidState;
     }
 
-    const auto itr = open_files.find(fd);
+    const auto device = FindDevice(fd);
 
-    if (itr == open_files.end()) {
+    if (!device) {
         LOG_ERROR(Service_NVDRV, "Could not find DeviceFD={}!", fd);
         return NvResult::NotImplemented;
     }
 
-    event = itr->second->QueryEvent(event_id);
+    event = device->QueryEvent(event_id);
     if (!event) {
         return NvResult::BadParameter;
     }
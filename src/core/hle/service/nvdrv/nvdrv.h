@@ -7,6 +7,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <shared_mutex>
 #include <span>
 #include <string>
 #include <unordered_map>
@@ -62,10 +63,7 @@ public:
     /// Returns a pointer to one of the available devices, identified by its name.
     template <typename T>
     std::shared_ptr<T> GetDevice(DeviceFD fd) {
-        auto itr = open_files.find(fd);
-        if (itr == open_files.end())
-            return nullptr;
-        return std::static_pointer_cast<T>(itr->second);
+        return std::static_pointer_cast<T>(FindDevice(fd));
     }
 
     NvResult VerifyFD(DeviceFD fd) const;
@@ -94,6 +92,8 @@ public:
 private:
     friend class EventInterface;
 
+    std::shared_ptr<Devices::nvdevice> FindDevice(DeviceFD fd) const;
+
     /// Manages syncpoints on the host
     NvCore::Container container;
 
@@ -103,6 +103,8 @@ private:
     using FilesContainerType = std::unordered_map<DeviceFD, std::shared_ptr<Devices::nvdevice>>;
     /// Mapping of file descriptors to the devices they reference.
     FilesContainerType open_files;
+    /// Devices are opened and used from the host threads of nvdrv and of other services
+    mutable std::shared_mutex open_files_mutex;
 
     KernelHelpers::ServiceContext service_context;
 
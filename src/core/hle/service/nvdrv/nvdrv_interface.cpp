@@ -16,6 +16,32 @@
 
 namespace Service::Nvidia {
 
+namespace {
+
+// Ioctl outputs are written in place when the buffer is contiguous in host memory. The scratch
+// buffer is only used otherwise, and is left empty so that nothing is written back.
+std::span<u8> PrepareOutputBuffer(HLERequestContext& ctx, Ioctl command, std::size_t buffer_index,
+                                  Common::ScratchBuffer<u8>& scratch) {
+    if (command.is_out != 0) {
+        if (const std::span<u8> guest_span = ctx.GetWriteBufferSpan(buffer_index);
+            !guest_span.empty()) {
+            scratch.resize_destructive(0);
+            return guest_span;
+        }
+    }
+    scratch.resize_destructive(ctx.GetWriteBufferSize(buffer_index));
+    return {scratch.data(), scratch.size()};
+}
+
+void WriteOutputBuffer(HLERequestContext& ctx, Ioctl command, std::size_t buffer_index,
+                       const Common::ScratchBuffer<u8>& scratch) {
+    if (command.is_out != 0 && scratch.size() != 0) {
+        ctx.WriteBuffer(scratch, buffer_index);
+    }
+}
+
+} // Anonymous namespace
+
 void NVDRV::Open(HLERequestContext& ctx) {
     LOG_DEBUG(Service_NVDRV, "called");
     IPC::ResponseBuilder rb{ctx, 4};
@@ -65,13 +91,11 @@ void NVDRV::Ioctl1(HLERequestContext& ctx) {
     }
 
     // Check device
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
+    const auto output = PrepareOutputBuffer(ctx, command, 0, output_buffer);
     const auto input_buffer = ctx.ReadBuffer(0);
 
-    const auto nv_result = nvdrv->Ioctl1(fd, command, input_buffer, output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer);
-    }
+    const auto nv_result = nvdrv->Ioctl1(fd, command, input_buffer, output);
+    WriteOutputBuffer(ctx, command, 0, output_buffer);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
@@ -92,13 +116,10 @@ void NVDRV::Ioctl2(HLERequestContext& ctx) {
 
     const auto input_buffer = ctx.ReadBuffer(0);
     const auto input_inlined_buffer = ctx.ReadBuffer(1);
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
+    const auto output = PrepareOutputBuffer(ctx, command, 0, output_buffer);
 
-    const auto nv_result =
-        nvdrv->Ioctl2(fd, command, input_buffer, input_inlined_buffer, output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer);
-    }
+    const auto nv_result = nvdrv->Ioctl2(fd, command, input_buffer, input_inlined_buffer, output);
+    WriteOutputBuffer(ctx, command, 0, output_buffer);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
@@ -118,15 +139,12 @@ void NVDRV::Ioctl3(HLERequestContext& ctx) {
     }
 
     const auto input_buffer = ctx.ReadBuffer(0);
-    output_buffer.resize_destructive(ctx.GetWriteBufferSize(0));
-    inline_output_buffer.resize_destructive(ctx.GetWriteBufferSize(1));
+    const auto output = PrepareOutputBuffer(ctx, command, 0, output_buffer);
+    const auto inline_output = PrepareOutputBuffer(ctx, command, 1, inline_output_buffer);
 
-    const auto nv_result =
-        nvdrv->Ioctl3(fd, command, input_buffer, output_buffer, inline_output_buffer);
-    if (command.is_out != 0) {
-        ctx.WriteBuffer(output_buffer, 0);
-        ctx.WriteBuffer(inline_output_buffer, 1);
-    }
+    const auto nv_result = nvdrv->Ioctl3(fd, command, input_buffer, output, inline_output);
+    WriteOutputBuffer(ctx, command, 0, output_buffer);
+    WriteOutputBuffer(ctx, command, 1, inline_output_buffer);
 
     IPC::ResponseBuilder rb{ctx, 3};
     rb.Push(ResultSuccess);
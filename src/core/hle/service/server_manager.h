@@ -48,6 +48,12 @@ public:
     Result ManageDeferral(Kernel::KEvent** out_event);
 
     Result LoopProcess();
+
+    /**
+     * Starts host threads that serve sessions in addition to the one running LoopProcess. A
+     * session is only served by one thread at a time, so its requests stay in order, while
+     * requests of different sessions run concurrently unless they lock the same service.
+     */
     void StartAdditionalHostThreads(const char* name, size_t num_threads);
 
     static void RunServer(std::unique_ptr<ServerManager>&& server);
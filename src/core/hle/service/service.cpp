@@ -90,8 +90,7 @@ void ServiceFrameworkBase::InvokeRequest(HLERequestContext& ctx) {
         return ReportUnimplementedFunction(ctx, info);
     }
 
-    LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
-    handler_invoker(this, info->handler_callback, ctx);
+    InvokeHandler(ctx, info);
 }
 
 void ServiceFrameworkBase::InvokeRequestTipc(HLERequestContext& ctx) {
@@ -104,13 +103,24 @@ void ServiceFrameworkBase::InvokeRequestTipc(HLERequestContext& ctx) {
         return ReportUnimplementedFunction(ctx, info);
     }
 
+    InvokeHandler(ctx, info);
+}
+
+void ServiceFrameworkBase::InvokeHandler(HLERequestContext& ctx, const FunctionInfoBase* info) {
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName(), ctx.CommandBuffer()));
+    auto& profiler = system.GetIpcProfiler();
+    const IpcProfiler::CommandScope profile_scope{
+        profiler, info->stats.Get(profiler, service_name, info->expected_header, info->name,
+                                  ctx.IsTipc())};
     handler_invoker(this, info->handler_callback, ctx);
 }
 
 Result ServiceFrameworkBase::HandleSyncRequest(Kernel::KServerSession& session,
                                                HLERequestContext& ctx) {
-    const auto guard = LockService();
+    std::unique_lock<std::mutex> guard;
+    if (!reentrant) {
+        guard = LockService();
+    }
 
     Result result = ResultSuccess;
 
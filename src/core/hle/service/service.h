@@ -9,6 +9,7 @@
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
 #include "core/hle/service/hle_ipc.h"
+#include "core/hle/service/ipc_profiler.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Namespace Service
@@ -78,6 +79,16 @@ protected:
         return std::unique_lock{lock_service};
     }
 
+    /**
+     * Declares that the handlers of the service synchronize access to its members themselves.
+     * Requests to re-entrant services are not serialized with LockService, so that the sessions
+     * of the service can be served concurrently by the host threads of its server manager.
+     * Requests of each session are still served one at a time, in order.
+     */
+    void SetReentrant(bool reentrant_) {
+        reentrant = reentrant_;
+    }
+
     /// System context that the service operates under.
     Core::System& system;
 
@@ -92,6 +103,7 @@ private:
         u32 expected_header;
         HandlerFnP<ServiceFrameworkBase> handler_callback;
         const char* name;
+        IpcProfiler::LazyCommandStats stats;
     };
 
     using InvokerFn = void(ServiceFrameworkBase* object, HandlerFnP<ServiceFrameworkBase> member,
@@ -104,6 +116,7 @@ private:
     void RegisterHandlersBase(const FunctionInfoBase* functions, std::size_t n);
     void RegisterHandlersBaseTipc(const FunctionInfoBase* functions, std::size_t n);
     void ReportUnimplementedFunction(HLERequestContext& ctx, const FunctionInfoBase* info);
+    void InvokeHandler(HLERequestContext& ctx, const FunctionInfoBase* info);
 
     /// Maximum number of concurrent sessions that this service can handle.
     u32 max_sessions;
@@ -112,6 +125,9 @@ private:
     /// which is not supported.
     bool service_registered = false;
 
+    /// Whether requests can be handled without holding the service lock
+    bool reentrant = false;
+
     /// Function used to safely up-cast pointers to the derived class before invoking a handler.
     InvokerFn* handler_invoker;
     boost::container::flat_map<u32, FunctionInfoBase> handlers;
@@ -155,7 +171,8 @@ protected:
             : FunctionInfoBase{
                   expected_header_,
                   // Type-erase member function pointer by casting it down to the base class.
-                  static_cast<HandlerFnP<ServiceFrameworkBase>>(handler_callback_), name_} {}
+                  static_cast<HandlerFnP<ServiceFrameworkBase>>(handler_callback_), name_,
+                  nullptr} {}
     };
     using FunctionInfo = FunctionInfoTyped<Self>;
 
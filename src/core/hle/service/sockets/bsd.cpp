@@ -1011,6 +1011,8 @@ BSD::BSD(Core::System& system_, const char* name)
     // clang-format on
 
     RegisterHandlers(functions);
+    // Socket calls can block, so they are not serialized with the other sessions.
+    SetReentrant(true);
 
     if (auto room_member = room_network.GetRoomMember().lock()) {
         proxy_packet_received = room_member->BindOnProxyPacketReceived(
@@ -1026,11 +1028,6 @@ BSD::~BSD() {
     }
 }
 
-std::unique_lock<std::mutex> BSD::LockService() {
-    // Do not lock socket IClient instances.
-    return {};
-}
-
 BSDCFG::BSDCFG(Core::System& system_) : ServiceFramework{system_, "bsdcfg"} {
     // clang-format off
     static const FunctionInfo functions[] = {
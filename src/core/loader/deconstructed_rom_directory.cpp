@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <cstring>
 #include "common/logging/log.h"
 #include "common/settings.h"
@@ -9,6 +10,7 @@
 #include "core/file_sys/control_metadata.h"
 #include "core/file_sys/patch_manager.h"
 #include "core/file_sys/romfs_factory.h"
+#include "core/file_sys/vfs/vfs_real.h"
 #include "core/hle/kernel/k_page_table.h"
 #include "core/hle/kernel/k_process.h"
 #include "core/hle/service/filesystem/filesystem.h"
@@ -255,6 +257,28 @@ AppLoader_DeconstructedRomDirectory::LoadResult AppLoader_DeconstructedRomDirect
         LOG_DEBUG(Loader, "loaded module {} @ {:#X}", module, load_addr);
     }
 
+    // RomFS, from the first .romfs file next to the modules. It is only read from, so it is
+    // mapped when it comes from the host filesystem to parse and read it without system calls.
+    const auto& files = dir->GetFiles();
+    const auto romfs_iter =
+        std::find_if(files.begin(), files.end(),
+                     [](const FileSys::VirtualFile& f) { return f->GetExtension() == "romfs"; });
+    if (romfs_iter != files.end()) {
+        romfs = *romfs_iter;
+        const auto real_vfs =
+            std::dynamic_pointer_cast<FileSys::RealVfsFilesystem>(system.GetFilesystem());
+        if (real_vfs != nullptr && std::dynamic_pointer_cast<FileSys::RealVfsFile>(romfs)) {
+            if (auto mapped = real_vfs->OpenMappedFile(romfs->GetFullPath()); mapped != nullptr) {
+                romfs = std::move(mapped);
+            }
+        }
+
+        system.GetFileSystemController().RegisterProcess(
+            process.GetProcessId(), metadata.GetTitleID(),
+            std::make_shared<FileSys::RomFSFactory>(*this, system.GetContentProvider(),
+                                                    system.GetFileSystemController()));
+    }
+
     is_loaded = true;
     return {ResultStatus::Success,
             LoadParameters{metadata.GetMainThreadPriority(), metadata.GetMainThreadStackSize()}};
@@ -63,6 +63,12 @@ struct Memory::Impl {
 #endif
     }
 
+    void SetCurrentPageTable(Common::PageTable& page_table) {
+        // The host buffer is only used to mirror mappings into the fastmem arena
+        current_page_table = &page_table;
+        current_page_table->fastmem_arena = nullptr;
+    }
+
     void MapMemoryRegion(Common::PageTable& page_table, Common::ProcessAddress base, u64 size,
                          Common::PhysicalAddress target, Common::MemoryPermission perms,
                          bool separate_heap) {
@@ -247,8 +253,7 @@ struct Memory::Impl {
                    auto on_memory, auto on_rasterizer, auto increment) {
         const auto& page_table = *current_page_table;
         std::size_t remaining_size = size;
-        std::size_t page_index = addr >> SUYU_PAGEBITS;
-        std::size_t page_offset = addr & SUYU_PAGEMASK;
+        u64 current_vaddr = GetInteger(addr);
         bool user_accessible = true;
 
         if (!AddressSpaceContains(page_table, addr, size)) [[unlikely]] {
@@ -257,12 +262,12 @@ struct Memory::Impl {
         }
 
         while (remaining_size) {
+            const auto [pointer, type] =
+                page_table.pointers[current_vaddr >> SUYU_PAGEBITS].PointerType();
+            // Pages of the same type backed by contiguous memory are handled as a single block
             const std::size_t copy_amount =
-                std::min(static_cast<std::size_t>(SUYU_PAGESIZE) - page_offset, remaining_size);
-            const auto current_vaddr =
-                static_cast<u64>((page_index << SUYU_PAGEBITS) + page_offset);
+                page_table.GetContiguousSize(current_vaddr, remaining_size);
 
-            const auto [pointer, type] = page_table.pointers[page_index].PointerType();
             switch (type) {
             case Common::PageType::Unmapped: {
                 user_accessible = false;
@@ -270,8 +275,7 @@ struct Memory::Impl {
                 break;
             }
             case Common::PageType::Memory: {
-                u8* mem_ptr =
-                    reinterpret_cast<u8*>(pointer + page_offset + (page_index << SUYU_PAGEBITS));
+                u8* mem_ptr = reinterpret_cast<u8*>(pointer + current_vaddr);
                 on_memory(copy_amount, mem_ptr);
                 break;
             }
@@ -289,8 +293,7 @@ struct Memory::Impl {
                 UNREACHABLE();
             }
 
-            page_index++;
-            page_offset = 0;
+            current_vaddr += copy_amount;
             increment(copy_amount);
             remaining_size -= copy_amount;
         }
@@ -335,20 +338,18 @@ struct Memory::Impl {
         return ReadBlockImpl<true>(src_addr, dest_buffer, size);
     }
 
-    const u8* GetSpan(const VAddr src_addr, const std::size_t size) const {
-        if (current_page_table->blocks[src_addr >> SUYU_PAGEBITS] ==
-            current_page_table->blocks[(src_addr + size) >> SUYU_PAGEBITS]) {
-            return GetPointerSilent(src_addr);
+    u8* GetSpan(const VAddr src_addr, const std::size_t size) const {
+        if (size == 0 || !AddressSpaceContains(*current_page_table, src_addr, size)) {
+            return nullptr;
         }
-        return nullptr;
-    }
-
-    u8* GetSpan(const VAddr src_addr, const std::size_t size) {
-        if (current_page_table->blocks[src_addr >> SUYU_PAGEBITS] ==
-            current_page_table->blocks[(src_addr + size) >> SUYU_PAGEBITS]) {
-            return GetPointerSilent(src_addr);
+        // Rasterizer cached pages are left to the block accessors, which flush and invalidate them
+        const auto [pointer, type] =
+            current_page_table->pointers[src_addr >> SUYU_PAGEBITS].PointerType();
+        if (type != Common::PageType::Memory || pointer == 0 ||
+            current_page_table->GetContiguousSize(src_addr, size) != size) {
+            return nullptr;
         }
-        return nullptr;
+        return reinterpret_cast<u8*>(pointer + src_addr);
     }
 
     template <bool UNSAFE>
@@ -410,7 +411,7 @@ struct Memory::Impl {
     bool CopyBlock(Common::ProcessAddress dest_addr, Common::ProcessAddress src_addr,
                    const std::size_t size) {
         return WalkBlock(
-            dest_addr, size,
+            src_addr, size,
             [&](const std::size_t copy_amount, const Common::ProcessAddress current_vaddr) {
                 LOG_ERROR(HW_Memory,
                           "Unmapped CopyBlock @ 0x{:016X} (start address = 0x{:016X}, size = {})",
@@ -649,11 +650,9 @@ struct Memory::Impl {
             while (base != end) {
                 page_table.pointers[base].Store(0, type);
                 page_table.backing_addr[base] = 0;
-                page_table.blocks[base] = 0;
                 base += 1;
             }
         } else {
-            auto orig_base = base;
             while (base != end) {
                 auto host_ptr =
                     reinterpret_cast<uintptr_t>(system.DeviceMemory().GetPointer<u8>(target)) -
@@ -661,7 +660,6 @@ struct Memory::Impl {
                 auto backing = GetInteger(target) - (base << SUYU_PAGEBITS);
                 page_table.pointers[base].Store(host_ptr, type);
                 page_table.backing_addr[base] = backing;
-                page_table.blocks[base] = orig_base << SUYU_PAGEBITS;
 
                 ASSERT_MSG(page_table.pointers[base].Pointer(),
                            "memory mapping base yield a nullptr within the table");
@@ -799,6 +797,51 @@ struct Memory::Impl {
         return true;
     }
 
+    /**
+     * Calls func with the ranges of device addresses a block of host memory is mapped to. Pages
+     * mapped to a single device address are merged with the previous pages when both ranges are
+     * contiguous, so that large blocks notify the GPU once.
+     */
+    void ForEachDeviceRange(VAddr v_address, const u8* p, size_t size,
+                            Common::ScratchBuffer<u32>& scratch_buffer, auto&& func) {
+        DAddr range_address = 0;
+        size_t range_size = 0;
+        const auto flush_range = [&] {
+            if (range_size != 0) {
+                func(range_address, range_size);
+                range_size = 0;
+            }
+        };
+        while (size != 0) {
+            const size_t page_size =
+                std::min<size_t>(DEVICE_PAGESIZE - (v_address & DEVICE_PAGEMASK), size);
+            size_t num_addresses = 0;
+            DAddr first_address = 0;
+            gpu_device_memory->ApplyOpOnPointer(p, scratch_buffer, [&](DAddr address) {
+                if (num_addresses++ == 0) {
+                    first_address = address;
+                    return;
+                }
+                if (num_addresses == 2) {
+                    flush_range();
+                    func(first_address, page_size);
+                }
+                func(address, page_size);
+            });
+            if (num_addresses == 1) {
+                if (range_size == 0 || range_address + range_size != first_address) {
+                    flush_range();
+                    range_address = first_address;
+                }
+                range_size += page_size;
+            }
+            v_address += page_size;
+            p += page_size;
+            size -= page_size;
+        }
+        flush_range();
+    }
+
     void HandleRasterizerDownload(VAddr v_address, size_t size) {
         const auto* p = GetPointerImpl(
             v_address, []() {}, []() {});
@@ -807,14 +850,15 @@ struct Memory::Impl {
         }
         const size_t core = system.GetCurrentHostThreadID();
         auto& current_area = rasterizer_read_areas[core];
-        gpu_device_memory->ApplyOpOnPointer(p, scratch_buffers[core], [&](DAddr address) {
-            const DAddr end_address = address + size;
-            if (current_area.start_address <= address && end_address <= current_area.end_address)
-                [[likely]] {
-                return;
-            }
-            current_area = system.GPU().OnCPURead(address, size);
-        });
+        ForEachDeviceRange(v_address, p, size, scratch_buffers[core],
+                           [&](DAddr address, size_t range_size) {
+                               const DAddr end_address = address + range_size;
+                               if (current_area.start_address <= address &&
+                                   end_address <= current_area.end_address) [[likely]] {
+                                   return;
+                               }
+                               current_area = system.GPU().OnCPURead(address, range_size);
+                           });
     }
 
     void HandleRasterizerWrite(VAddr v_address, size_t size) {
@@ -835,19 +879,22 @@ struct Memory::Impl {
                 sys_core_guard.unlock();
             }
         };
-        gpu_device_memory->ApplyOpOnPointer(p, scratch_buffers[core], [&](DAddr address) {
-            auto& current_area = rasterizer_write_areas[core];
-            PAddr subaddress = address >> SUYU_PAGEBITS;
-            bool do_collection = current_area.last_address == subaddress;
-            if (!do_collection) [[unlikely]] {
-                do_collection = system.GPU().OnCPUWrite(address, size);
-                if (!do_collection) {
-                    return;
+        ForEachDeviceRange(
+            v_address, p, size, scratch_buffers[core], [&](DAddr address, size_t range_size) {
+                auto& current_area = rasterizer_write_areas[core];
+                const PAddr subaddress = address >> SUYU_PAGEBITS;
+                const PAddr last_subaddress = (address + range_size - 1) >> SUYU_PAGEBITS;
+                bool do_collection =
+                    subaddress == last_subaddress && current_area.last_address == subaddress;
+                if (!do_collection) [[unlikely]] {
+                    do_collection = system.GPU().OnCPUWrite(address, range_size);
+                    if (!do_collection) {
+                        return;
+                    }
+                    current_area.last_address = last_subaddress;
                 }
-                current_area.last_address = subaddress;
-            }
-            gpu_dirty_managers[core].Collect(address, size);
-        });
+                gpu_dirty_managers[core].Collect(address, range_size);
+            });
     }
 
     struct GPUDirtyState {
@@ -907,6 +954,10 @@ void Memory::SetCurrentPageTable(Kernel::KProcess& process) {
     impl->SetCurrentPageTable(process);
 }
 
+void Memory::SetCurrentPageTable(Common::PageTable& page_table) {
+    impl->SetCurrentPageTable(page_table);
+}
+
 void Memory::MapMemoryRegion(Common::PageTable& page_table, Common::ProcessAddress base, u64 size,
                              Common::PhysicalAddress target, Common::MemoryPermission perms,
                              bool separate_heap) {
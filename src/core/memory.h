@@ -78,6 +78,14 @@ public:
      */
     void SetCurrentPageTable(Kernel::KProcess& process);
 
+    /**
+     * Changes the currently active page table to one that doesn't belong to a process, such as
+     * a page table built by a tool. Fastmem is not used with it.
+     *
+     * @param page_table The page table to use.
+     */
+    void SetCurrentPageTable(Common::PageTable& page_table);
+
     /**
      * Maps an allocated buffer onto a region of the emulated process address space.
      *
@@ -48,6 +48,8 @@ void ConfigureCpuDebug::SetConfiguration() {
     ui->cpuopt_ignore_memory_aborts->setEnabled(runtime_lock);
     ui->cpuopt_ignore_memory_aborts->setChecked(
         Settings::values.cpuopt_ignore_memory_aborts.GetValue());
+    ui->use_huge_pages->setEnabled(runtime_lock);
+    ui->use_huge_pages->setChecked(Settings::values.use_huge_pages.GetValue());
 }
 
 void ConfigureCpuDebug::ApplyConfiguration() {
@@ -63,6 +65,7 @@ void ConfigureCpuDebug::ApplyConfiguration() {
     Settings::values.cpuopt_fastmem_exclusives = ui->cpuopt_fastmem_exclusives->isChecked();
     Settings::values.cpuopt_recompile_exclusives = ui->cpuopt_recompile_exclusives->isChecked();
     Settings::values.cpuopt_ignore_memory_aborts = ui->cpuopt_ignore_memory_aborts->isChecked();
+    Settings::values.use_huge_pages = ui->use_huge_pages->isChecked();
 }
 
 void ConfigureCpuDebug::changeEvent(QEvent* event) {
@@ -61,6 +61,7 @@ void ConfigureFilesystem::SetConfiguration() {
     ui->gamecard_current_game->setChecked(Settings::values.gamecard_current_game.GetValue());
     ui->dump_exefs->setChecked(Settings::values.dump_exefs.GetValue());
     ui->dump_nso->setChecked(Settings::values.dump_nso.GetValue());
+    ui->verify_nca_integrity->setChecked(Settings::values.verify_nca_integrity.GetValue());
 
     ui->cache_game_list->setChecked(UISettings::values.cache_game_list.GetValue());
 
@@ -81,6 +82,7 @@ void ConfigureFilesystem::ApplyConfiguration() {
     Settings::values.gamecard_current_game = ui->gamecard_current_game->isChecked();
     Settings::values.dump_exefs = ui->dump_exefs->isChecked();
     Settings::values.dump_nso = ui->dump_nso->isChecked();
+    Settings::values.verify_nca_integrity = ui->verify_nca_integrity->isChecked();
 
     UISettings::values.cache_game_list = ui->cache_game_list->isChecked();
 }
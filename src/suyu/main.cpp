@@ -128,6 +128,8 @@ static FileSys::VirtualFile VfsDirectoryCreateFileWrapper(const FileSys::Virtual
 #include "core/file_sys/savedata_factory.h"
 #include "core/file_sys/submission_package.h"
 #include "core/hle/kernel/k_process.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/svc_trace.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/filesystem/filesystem.h"
 #include "core/hle/service/sm/sm.h"
@@ -1537,6 +1539,8 @@ void GMainWindow::ConnectMenuEvents() {
     connect_menu(ui->action_Display_Dock_Widget_Headers, &GMainWindow::OnDisplayTitleBars);
     connect_menu(ui->action_Show_Filter_Bar, &GMainWindow::OnToggleFilterBar);
     connect_menu(ui->action_Show_Status_Bar, &GMainWindow::OnToggleStatusBar);
+    connect_menu(ui->action_Record_Svc_Trace, &GMainWindow::OnToggleSvcTrace);
+    connect_menu(ui->action_Export_Svc_Trace, &GMainWindow::OnExportSvcTrace);
     connect_menu(ui->action_Show_Folders_In_List, &GMainWindow::OnToggleFoldersInList);
 
     connect_menu(ui->action_Reset_Window_Size_720, &GMainWindow::ResetWindowSize720);
@@ -1621,6 +1625,7 @@ void GMainWindow::UpdateMenuState() {
     }
 
     ui->action_Capture_Screenshot->setEnabled(emulation_running && !is_paused);
+    ui->action_Export_Svc_Trace->setEnabled(emulation_running);
 
     if (emulation_running && is_paused) {
         ui->action_Pause->setText(tr("&Continue"));
@@ -4380,6 +4385,28 @@ void GMainWindow::OnToggleStatusBar() {
     statusBar()->setVisible(ui->action_Show_Status_Bar->isChecked());
 }
 
+void GMainWindow::OnToggleSvcTrace() {
+    system->Kernel().GetSvcTracer().SetEnabled(ui->action_Record_Svc_Trace->isChecked());
+}
+
+void GMainWindow::OnExportSvcTrace() {
+    const auto log_path =
+        QString::fromStdString(Common::FS::GetSuyuPathString(Common::FS::SuyuPath::LogDir));
+    const auto date = QDateTime::currentDateTime().toString(QStringLiteral("yyyy-MM-dd_hh-mm-ss"));
+    const QString filename = QFileDialog::getSaveFileName(
+        this, tr("Export SVC Trace"), QStringLiteral("%1/svc_trace_%2.json").arg(log_path, date),
+        tr("JSON Files (*.json)"));
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    // The trace is read without stopping the emulated cores, calls being recorded are skipped
+    if (!system->Kernel().GetSvcTracer().ExportJson(filename.toStdU16String())) {
+        QMessageBox::warning(this, tr("Export SVC Trace"),
+                             tr("Failed to write the SVC trace to %1.").arg(filename));
+    }
+}
+
 void GMainWindow::OnToggleFoldersInList() {
     UISettings::values.show_folders_in_list = ui->action_Show_Folders_In_List->isChecked();
 
@@ -416,6 +416,8 @@ private slots:
     void OnAbout();
     void OnToggleFilterBar();
     void OnToggleStatusBar();
+    void OnToggleSvcTrace();
+    void OnExportSvcTrace();
     void OnToggleFoldersInList();
     void OnDisplayTitleBars(bool);
     void InitializeHotkeys();
@@ -12,6 +12,7 @@
 #include <fmt/ostream.h>
 
 #include "common/detached_tasks.h"
+#include "common/fs/fs_util.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
@@ -28,9 +29,12 @@
 #include "core/file_sys/nca_metadata.h"
 #include "core/file_sys/registered_cache.h"
 #include "core/file_sys/vfs/vfs_real.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/svc_trace.h"
 #include "core/hle/service/am/applet_manager.h"
 #include "core/hle/service/am/service/library_applet_creator.h"
 #include "core/hle/service/filesystem/filesystem.h"
+#include "core/hle/service/ipc_profiler.h"
 #include "core/loader/loader.h"
 #include "frontend_common/config.h"
 #include "input_common/main.h"
@@ -77,9 +81,14 @@ static void PrintHelp(const char* argv0) {
                  "-f, --fullscreen      Start in fullscreen mode\n"
                  "-g, --game            File path of the game to load\n"
                  "-h, --help            Display this help and exit\n"
+                 "-i, --ipc-profile     Write the call statistics of the HLE services as JSON to\n"
+                 "                      the specified file on exit\n"
                  "-m, --multiplayer=nick:password@address:port"
                  " Nickname, password, address and port for multiplayer\n"
                  "-p, --program         Pass following string as arguments to executable\n"
+                 "-s, --svc-trace       Record the supervisor calls of the guest and write their\n"
+                 "                      statistics and the most recent calls as JSON to the\n"
+                 "                      specified file on exit\n"
                  "-u, --user            Select a specific user profile from 0 to 7\n"
                  "-v, --version         Output version information and exit\n"
                  "-l, "
@@ -217,6 +226,8 @@ int main(int argc, char** argv) {
 #endif
     std::string filepath;
     std::optional<std::string> config_path;
+    std::optional<std::string> ipc_profile_path;
+    std::optional<std::string> svc_trace_path;
     std::string program_args;
     std::optional<int> selected_user;
 
@@ -233,10 +244,12 @@ int main(int argc, char** argv) {
         {"config", required_argument, 0, 'c'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
+        {"ipc-profile", required_argument, 0, 'i'},
         {"game", required_argument, 0, 'g'},
         {"applet-params", optional_argument, 0, 'l'},
         {"multiplayer", required_argument, 0, 'm'},
         {"program", optional_argument, 0, 'p'},
+        {"svc-trace", required_argument, 0, 's'},
         {"user", required_argument, 0, 'u'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
@@ -244,7 +257,7 @@ int main(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:fhvp::c:u:l::", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:fhi:s:vp::c:u:l::", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'c':
@@ -257,6 +270,12 @@ int main(int argc, char** argv) {
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
+            case 'i':
+                ipc_profile_path = optarg;
+                break;
+            case 's':
+                svc_trace_path = optarg;
+                break;
             case 'g': {
                 const std::string str_arg(optarg);
                 filepath = str_arg;
@@ -477,7 +496,22 @@ int main(int argc, char** argv) {
             [](VideoCore::LoadCallbackStage, size_t value, size_t total) {});
     }
 
+    if (svc_trace_path) {
+        system.Kernel().GetSvcTracer().SetEnabled(true);
+    }
+
+    const auto export_profiles = [&] {
+        if (ipc_profile_path) {
+            void(system.GetIpcProfiler().ExportJson(Common::FS::ToU8String(*ipc_profile_path)));
+        }
+        if (svc_trace_path) {
+            void(system.Kernel().GetSvcTracer().ExportJson(
+                Common::FS::ToU8String(*svc_trace_path)));
+        }
+    };
+
     system.RegisterExitCallback([&] {
+        export_profiles();
         // Just exit right away.
         exit(0);
     });
@@ -495,6 +529,7 @@ int main(int argc, char** argv) {
     }
     system.DetachDebugger();
     void(system.Pause());
+    export_profiles();
     system.ShutdownMainProcess();
 
 #ifdef __unix__
@@ -1,6 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2021 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include "common/host_memory.h"
@@ -184,3 +190,55 @@ TEST_CASE("HostMemory: Partial sparse middle unmap and check bindings", "[common
     REQUIRE(ptr[0x0000] == 19);
     REQUIRE(ptr[0x3fff] == 12);
 }
+
+TEST_CASE("HostMemory: Huge page mappings", "[common]") {
+    HostMemory mem(BACKING_SIZE, VIRTUAL_SIZE, true);
+    // Aligned mapping that can use huge pages and a mirror of it that can't
+    mem.Map(0x400000, 0x200000, 0x400000, PERMS, HEAP);
+    mem.Map(0x1001000, 0x300000, 0x201000, PERMS, HEAP);
+
+    volatile u8* const aligned = mem.VirtualBasePointer() + 0x400000;
+    volatile u8* const mirror = mem.VirtualBasePointer() + 0x1001000;
+    aligned[0x100000] = 33;
+    aligned[0x2fffff] = 44;
+    REQUIRE(mirror[0] == 33);
+    REQUIRE(mirror[0x1fffff] == 44);
+
+    mem.ClearBackingRegion(0x300000, 0x1000, 0);
+    REQUIRE(aligned[0x100000] == 0);
+    REQUIRE(aligned[0x2fffff] == 44);
+}
+
+TEST_CASE("HostMemory: Random access throughput", "[.][benchmark][common]") {
+    constexpr size_t REGION_SIZE = 512_MiB;
+    constexpr size_t NUM_READS = 1ULL << 20;
+
+    std::mt19937_64 rng{0x68756765};
+    std::uniform_int_distribution<size_t> offset_dist{0, REGION_SIZE / sizeof(u64) - 1};
+    std::vector<size_t> offsets(NUM_READS);
+    for (size_t& offset : offsets) {
+        offset = offset_dist(rng) * sizeof(u64);
+    }
+
+    for (const bool use_huge_pages : {false, true}) {
+        HostMemory mem(REGION_SIZE, VIRTUAL_SIZE, use_huge_pages);
+        mem.Map(0, 0, REGION_SIZE, PERMS, HEAP);
+        u8* const data = mem.VirtualBasePointer();
+
+        // Fault the whole region in, so that only the translation of addresses is measured
+        std::memset(data, 1, REGION_SIZE);
+
+        const std::string name = !use_huge_pages    ? "small pages"
+                                 : mem.UsesHugePages() ? "huge pages"
+                                                       : "huge pages (unavailable on this host)";
+        BENCHMARK("Random 8 byte reads, " + name) {
+            u64 sum = 0;
+            for (const size_t offset : offsets) {
+                u64 value;
+                std::memcpy(&value, data + offset, sizeof(value));
+                sum += value;
+            }
+            return sum;
+        };
+    }
+}
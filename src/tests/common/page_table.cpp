@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/host_memory.h"
+#include "common/literals.h"
+#include "common/page_table.h"
+
+namespace {
+using Common::PageTable;
+using Common::PageType;
+using namespace Common::Literals;
+
+constexpr size_t ADDRESS_SPACE_BITS = 36;
+constexpr size_t PAGE_BITS = 12;
+constexpr size_t PAGE_SIZE = 1ULL << PAGE_BITS;
+constexpr size_t BACKING_SIZE = 128_MiB;
+constexpr u64 BASE_ADDRESS = 0x8000'0000;
+
+/// Maps pages to the backing memory the way Core::Memory does, in the given physical page order
+void MapPages(PageTable& page_table, Common::HostMemory& memory, u64 vaddr,
+              std::span<const size_t> physical_pages, PageType type = PageType::Memory) {
+    for (const size_t physical_page : physical_pages) {
+        const u64 paddr = physical_page * PAGE_SIZE;
+        const uintptr_t host_ptr =
+            type == PageType::Memory
+                ? reinterpret_cast<uintptr_t>(memory.BackingBasePointer() + paddr) - vaddr
+                : 0;
+        page_table.pointers[vaddr >> PAGE_BITS].Store(host_ptr, type);
+        page_table.backing_addr[vaddr >> PAGE_BITS] = paddr - vaddr;
+        vaddr += PAGE_SIZE;
+    }
+}
+
+/// Copies page by page, like Core::Memory did before coalescing contiguous pages
+void ReadPagewise(const PageTable& page_table, u64 vaddr, u8* dest, size_t size) {
+    while (size != 0) {
+        const size_t copy_amount = std::min(PAGE_SIZE - (vaddr & (PAGE_SIZE - 1)), size);
+        const uintptr_t pointer = page_table.pointers[vaddr >> PAGE_BITS].Pointer();
+        std::memcpy(dest, reinterpret_cast<const u8*>(pointer + vaddr), copy_amount);
+        vaddr += copy_amount;
+        dest += copy_amount;
+        size -= copy_amount;
+    }
+}
+
+void ReadCoalesced(const PageTable& page_table, u64 vaddr, u8* dest, size_t size) {
+    while (size != 0) {
+        const size_t copy_amount = page_table.GetContiguousSize(vaddr, size);
+        const uintptr_t pointer = page_table.pointers[vaddr >> PAGE_BITS].Pointer();
+        std::memcpy(dest, reinterpret_cast<const u8*>(pointer + vaddr), copy_amount);
+        vaddr += copy_amount;
+        dest += copy_amount;
+        size -= copy_amount;
+    }
+}
+
+/// Accesses memory through the page table, like Core::Memory does for non-fastmem accesses
+u32 Read32(const PageTable& page_table, u64 vaddr) {
+    u32 value;
+    const uintptr_t pointer = page_table.pointers[vaddr >> PAGE_BITS].Pointer();
+    std::memcpy(&value, reinterpret_cast<const u8*>(pointer + vaddr), sizeof(value));
+    return value;
+}
+
+void Write32(const PageTable& page_table, u64 vaddr, u32 value) {
+    const uintptr_t pointer = page_table.pointers[vaddr >> PAGE_BITS].Pointer();
+    std::memcpy(reinterpret_cast<u8*>(pointer + vaddr), &value, sizeof(value));
+}
+
+/// Direct mapped software TLB in front of the page table, to compare against the table alone
+class SoftwareTlb {
+public:
+    static constexpr size_t NUM_ENTRIES = 64;
+
+    explicit SoftwareTlb(const PageTable& page_table_) : page_table{page_table_} {
+        entries.fill({~0ULL, 0});
+    }
+
+    u8* Translate(u64 vaddr) {
+        const u64 page = vaddr >> PAGE_BITS;
+        // Fold the upper bits into the index, the pages are aligned to large powers of two
+        const u64 folded = page ^ (page >> 6) ^ (page >> 12) ^ (page >> 18) ^ (page >> 24);
+        Entry& entry = entries[folded % NUM_ENTRIES];
+        if (entry.page != page) {
+            entry = {page, page_table.pointers[page].Pointer()};
+        }
+        return reinterpret_cast<u8*>(entry.pointer + vaddr);
+    }
+
+    u32 Read32(u64 vaddr) {
+        u32 value;
+        std::memcpy(&value, Translate(vaddr), sizeof(value));
+        return value;
+    }
+
+    void Write32(u64 vaddr, u32 value) {
+        std::memcpy(Translate(vaddr), &value, sizeof(value));
+    }
+
+private:
+    struct alignas(16) Entry {
+        u64 page;
+        uintptr_t pointer;
+    };
+
+    const PageTable& page_table;
+    std::array<Entry, NUM_ENTRIES> entries;
+};
+} // Anonymous namespace
+
+TEST_CASE("PageTable: Contiguous size", "[common]") {
+    Common::HostMemory memory(BACKING_SIZE, 1ULL << ADDRESS_SPACE_BITS);
+    PageTable page_table;
+    page_table.Resize(ADDRESS_SPACE_BITS, PAGE_BITS);
+
+    // Pages 0-3 are contiguous, page 4 jumps back, pages 5-6 are cached by the rasterizer
+    const std::vector<size_t> physical_pages{10, 11, 12, 13, 2, 3, 4};
+    MapPages(page_table, memory, BASE_ADDRESS, std::span{physical_pages}.first(5));
+    MapPages(page_table, memory, BASE_ADDRESS + 5 * PAGE_SIZE, std::span{physical_pages}.last(2),
+             PageType::RasterizerCachedMemory);
+
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS, 16_MiB) == 4 * PAGE_SIZE);
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS + 0x123, 16_MiB) == 4 * PAGE_SIZE - 0x123);
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS + 0x123, 0x100) == 0x100);
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS + 4 * PAGE_SIZE, 16_MiB) == PAGE_SIZE);
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS + 5 * PAGE_SIZE, 16_MiB) == 2 * PAGE_SIZE);
+    // Unmapped pages are contiguous with each other
+    REQUIRE(page_table.GetContiguousSize(BASE_ADDRESS + 7 * PAGE_SIZE, 3 * PAGE_SIZE) ==
+            3 * PAGE_SIZE);
+
+    std::vector<u8> expected(7 * PAGE_SIZE);
+    std::vector<u8> result(expected.size());
+    for (size_t page = 0; page < 5; ++page) {
+        u8* const backing = memory.BackingBasePointer() + physical_pages[page] * PAGE_SIZE;
+        std::memset(backing, static_cast<int>(page + 1), PAGE_SIZE);
+    }
+    ReadPagewise(page_table, BASE_ADDRESS, expected.data(), 5 * PAGE_SIZE);
+    ReadCoalesced(page_table, BASE_ADDRESS, result.data(), 5 * PAGE_SIZE);
+    REQUIRE(result == expected);
+}
+
+TEST_CASE("PageTable: Read32/Write32 throughput", "[.][benchmark][common]") {
+    Common::HostMemory memory(BACKING_SIZE, 1ULL << ADDRESS_SPACE_BITS);
+    PageTable page_table;
+    page_table.Resize(ADDRESS_SPACE_BITS, PAGE_BITS);
+
+    constexpr size_t NUM_ACCESSES = 1ULL << 16;
+    constexpr u64 ADDRESS_SPACE_END = 1ULL << ADDRESS_SPACE_BITS;
+
+    for (const size_t working_set : {8, 64, 4096}) {
+        // The pages are spread over the address space, like the heap, stacks and TLS of different
+        // threads, so that their entries in the page table are far apart
+        const u64 stride = ((ADDRESS_SPACE_END - BASE_ADDRESS) / working_set) & ~(PAGE_SIZE - 1);
+        std::vector<u64> pages(working_set);
+        for (size_t i = 0; i < working_set; ++i) {
+            pages[i] = BASE_ADDRESS + i * stride;
+            MapPages(page_table, memory, pages[i], std::vector<size_t>{i});
+        }
+
+        std::mt19937 rng{0x746c62};
+        std::vector<u64> addresses(NUM_ACCESSES);
+        for (u64& address : addresses) {
+            address = pages[rng() % working_set] + (rng() % (PAGE_SIZE / sizeof(u32))) * 4;
+        }
+
+        SoftwareTlb tlb{page_table};
+        const std::string name = std::to_string(working_set) + " pages";
+        BENCHMARK("Read32 page table, " + name) {
+            u32 sum = 0;
+            for (const u64 address : addresses) {
+                sum += Read32(page_table, address);
+            }
+            return sum;
+        };
+        BENCHMARK("Read32 software TLB, " + name) {
+            u32 sum = 0;
+            for (const u64 address : addresses) {
+                sum += tlb.Read32(address);
+            }
+            return sum;
+        };
+        BENCHMARK("Write32 page table, " + name) {
+            for (const u64 address : addresses) {
+                Write32(page_table, address, static_cast<u32>(address));
+            }
+            return addresses.size();
+        };
+        BENCHMARK("Write32 software TLB, " + name) {
+            for (const u64 address : addresses) {
+                tlb.Write32(address, static_cast<u32>(address));
+            }
+            return addresses.size();
+        };
+    }
+}
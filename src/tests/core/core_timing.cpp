@@ -1,15 +1,21 @@
 // SPDX-FileCopyrightText: 2016 Dolphin Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdlib>
 #include <memory>
 #include <optional>
+#include <random>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -40,6 +46,12 @@ struct ScopeInit final {
     Core::Timing::CoreTiming core_timing;
 };
 
+constexpr size_t NUM_BENCHMARK_EVENTS = 10000;
+
+std::optional<std::chrono::nanoseconds> NullCallback(s64 time, std::chrono::nanoseconds ns_late) {
+    return std::nullopt;
+}
+
 u64 TestTimerSpeed(Core::Timing::CoreTiming& core_timing) {
     const u64 start = core_timing.GetGlobalTimeNs().count();
     volatile u64 placebo = 0;
@@ -139,3 +151,176 @@ TEST_CASE("CoreTiming[BasicOrderNoPausing]", "[core]") {
     printf("HostTimer No Pausing Timer Time: %.3f %.6f\n", timer_time / 1000.f,
            timer_time / 1000000.f);
 }
+
+TEST_CASE("CoreTiming[UnscheduleAndLooping]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+    std::atomic<int> num_unscheduled_calls = 0;
+    std::atomic<int> num_looping_calls = 0;
+    const auto unscheduled = Core::Timing::CreateEvent(
+        "unscheduled",
+        [&](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+            ++num_unscheduled_calls;
+            return std::nullopt;
+        });
+    const auto looping = Core::Timing::CreateEvent(
+        "looping", [&](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+            ++num_looping_calls;
+            return std::nullopt;
+        });
+
+    core_timing.SyncPause(true);
+    // Events far enough in the future to be placed in the upper levels of the wheel
+    for (s64 i = 0; i < 100; ++i) {
+        core_timing.ScheduleEvent(std::chrono::microseconds{100 + i * 50}, unscheduled);
+    }
+    core_timing.UnscheduleEvent(unscheduled);
+    core_timing.ScheduleEvent(std::chrono::milliseconds{2}, unscheduled);
+    core_timing.ScheduleLoopingEvent(std::chrono::microseconds{50}, std::chrono::microseconds{100},
+                                     looping);
+    core_timing.SyncPause(false);
+
+    while (num_unscheduled_calls == 0) {
+        std::this_thread::yield();
+    }
+    while (num_looping_calls < 10) {
+        std::this_thread::yield();
+    }
+    core_timing.UnscheduleEvent(looping);
+    const int num_calls = num_looping_calls;
+
+    // Wait for the unscheduled events to be discarded
+    while (core_timing.HasPendingEvents()) {
+        std::this_thread::yield();
+    }
+    REQUIRE(num_unscheduled_calls == 1);
+    REQUIRE(num_looping_calls == num_calls);
+}
+
+TEST_CASE("CoreTiming[UnscheduledEventsAreNotPending]", "[core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+    std::atomic<int> num_calls = 0;
+    const auto unscheduled = Core::Timing::CreateEvent(
+        "unscheduled",
+        [&](s64, std::chrono::nanoseconds) -> std::optional<std::chrono::nanoseconds> {
+            ++num_calls;
+            return std::nullopt;
+        });
+    const auto wait_until_idle = [&core_timing] {
+        // Far less than the time at which the unscheduled events would have expired
+        const auto start = std::chrono::steady_clock::now();
+        while (core_timing.HasPendingEvents()) {
+            REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds{30});
+            std::this_thread::yield();
+        }
+    };
+    const auto schedule_events = [&] {
+        for (s64 i = 0; i < 100; ++i) {
+            core_timing.ScheduleEvent(std::chrono::minutes{10} + std::chrono::milliseconds{i},
+                                      unscheduled);
+        }
+    };
+
+    // Discarded by the timer thread
+    core_timing.SyncPause(true);
+    schedule_events();
+    core_timing.UnscheduleEvent(unscheduled, Core::Timing::UnscheduleEventType::NoWait);
+    core_timing.SyncPause(false);
+    wait_until_idle();
+
+    // Discarded while the timer thread waits for them
+    schedule_events();
+    core_timing.UnscheduleEvent(unscheduled);
+    wait_until_idle();
+    REQUIRE(num_calls == 0);
+}
+
+TEST_CASE("CoreTiming[SchedulingThroughput]", "[.][benchmark][core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+    const auto event = Core::Timing::CreateEvent("benchmark", NullCallback);
+
+    std::mt19937 rng{0x636f7265};
+    std::vector<std::chrono::nanoseconds> delays(NUM_BENCHMARK_EVENTS);
+    for (auto& delay : delays) {
+        delay = std::chrono::nanoseconds{
+            std::uniform_int_distribution<s64>{1'000, 1'000'000'000}(rng)};
+    }
+
+    // The events are far enough in the future to never expire while being scheduled
+    core_timing.SyncPause(true);
+    BENCHMARK_ADVANCED("Schedule " + std::to_string(NUM_BENCHMARK_EVENTS) + " events")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            for (const auto delay : delays) {
+                core_timing.ScheduleEvent(std::chrono::seconds{10} + delay, event);
+            }
+        });
+        core_timing.ClearPendingEvents();
+    };
+
+    constexpr size_t NUM_THREADS = 4;
+    BENCHMARK_ADVANCED("Schedule " + std::to_string(NUM_BENCHMARK_EVENTS) + " events from " +
+                       std::to_string(NUM_THREADS) + " threads")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            std::array<std::jthread, NUM_THREADS> threads;
+            for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+                threads[thread] = std::jthread([&, thread] {
+                    for (size_t i = thread; i < delays.size(); i += NUM_THREADS) {
+                        core_timing.ScheduleEvent(std::chrono::seconds{10} + delays[i], event);
+                    }
+                });
+            }
+        });
+        core_timing.ClearPendingEvents();
+    };
+
+    // Schedule and expire every event in a single advance of the timing
+    BENCHMARK_ADVANCED("Schedule and expire " + std::to_string(NUM_BENCHMARK_EVENTS) + " events")
+    (Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            for (const auto delay : delays) {
+                core_timing.ScheduleEvent(core_timing.GetGlobalTimeNs() - delay, event, true);
+            }
+            return core_timing.Advance();
+        });
+    };
+}
+
+TEST_CASE("CoreTiming[LatencyJitter]", "[.][benchmark][core]") {
+    ScopeInit guard;
+    auto& core_timing = guard.core_timing;
+
+    std::vector<s64> latencies;
+    latencies.reserve(NUM_BENCHMARK_EVENTS);
+    std::atomic<size_t> num_calls = 0;
+    const auto event = Core::Timing::CreateEvent(
+        "latency", [&](s64, std::chrono::nanoseconds ns_late)
+                       -> std::optional<std::chrono::nanoseconds> {
+            latencies.push_back(ns_late.count());
+            ++num_calls;
+            return std::nullopt;
+        });
+
+    // Spread the events over 100ms, scheduled while the timer thread is running
+    core_timing.SyncPause(false);
+    std::mt19937 rng{0x6a6974};
+    for (size_t i = 0; i < NUM_BENCHMARK_EVENTS; ++i) {
+        core_timing.ScheduleEvent(
+            std::chrono::nanoseconds{std::uniform_int_distribution<s64>{0, 100'000'000}(rng)},
+            event);
+    }
+    while (num_calls < NUM_BENCHMARK_EVENTS) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+
+    std::ranges::sort(latencies);
+    const auto percentile = [&latencies](size_t percent) {
+        return latencies[(latencies.size() - 1) * percent / 100];
+    };
+    WARN("Latency of " << NUM_BENCHMARK_EVENTS << " events in ns: median " << percentile(50)
+                       << ", p99 " << percentile(99) << ", max " << latencies.back());
+    REQUIRE(latencies.front() >= 0);
+}
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/cipher.h>
+
+#include "common/common_types.h"
+#include "core/crypto/aes_util.h"
+#include "core/crypto/key_manager.h"
+
+namespace {
+using Core::Crypto::AESCipher;
+using Core::Crypto::Key128;
+using Core::Crypto::Key256;
+using Core::Crypto::Mode;
+using Core::Crypto::Op;
+
+std::vector<u8> MakeData(size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> data(size);
+    std::ranges::generate(data, [&rng] { return static_cast<u8>(rng()); });
+    return data;
+}
+
+template <size_t Size>
+std::array<u8, Size> MakeArray(u32 seed) {
+    std::array<u8, Size> array;
+    const std::vector<u8> data = MakeData(Size, seed);
+    std::ranges::copy(data, array.begin());
+    return array;
+}
+
+std::array<u8, 0x10> AddToCounter(std::array<u8, 0x10> counter, size_t value) {
+    for (size_t i = counter.size(); i-- > 0 && value != 0;) {
+        value += counter[i];
+        counter[i] = static_cast<u8>(value);
+        value >>= 8;
+    }
+    return counter;
+}
+
+/// Transcodes data with mbedtls alone, as the reference for AESCipher
+std::vector<u8> MbedtlsTranscode(mbedtls_cipher_type_t type, std::span<const u8> key,
+                                 std::span<const u8> iv, std::span<const u8> data, Op op) {
+    mbedtls_cipher_context_t context;
+    mbedtls_cipher_init(&context);
+    REQUIRE(mbedtls_cipher_setup(&context, mbedtls_cipher_info_from_type(type)) == 0);
+    REQUIRE(mbedtls_cipher_setkey(&context, key.data(), static_cast<int>(key.size() * 8),
+                                  op == Op::Encrypt ? MBEDTLS_ENCRYPT : MBEDTLS_DECRYPT) == 0);
+    REQUIRE(mbedtls_cipher_set_iv(&context, iv.data(), iv.size()) == 0);
+
+    std::vector<u8> result(data.size());
+    size_t written = 0;
+    REQUIRE(mbedtls_cipher_update(&context, data.data(), data.size(), result.data(), &written) ==
+            0);
+    REQUIRE(written == data.size());
+    mbedtls_cipher_free(&context);
+    return result;
+}
+
+std::vector<u8> MbedtlsXts(const Key256& key, std::span<const u8> data, size_t sector_id,
+                           size_t sector_size, Op op) {
+    std::vector<u8> result;
+    for (size_t offset = 0; offset < data.size(); offset += sector_size, ++sector_id) {
+        std::array<u8, 0x10> tweak{};
+        for (size_t i = 0; i < sizeof(u64); ++i) {
+            tweak[0xF - i] = static_cast<u8>(static_cast<u64>(sector_id) >> (i * 8));
+        }
+        const auto sector = MbedtlsTranscode(MBEDTLS_CIPHER_AES_128_XTS, key, tweak,
+                                             data.subspan(offset, sector_size), op);
+        result.insert(result.end(), sector.begin(), sector.end());
+    }
+    return result;
+}
+} // Anonymous namespace
+
+TEST_CASE("AESCipher: CTR matches mbedtls", "[core]") {
+    const Key128 key = MakeArray<0x10>(1);
+    // The low bytes of the counter are about to wrap, to check the carry into the upper half.
+    std::array<u8, 0x10> iv = MakeArray<0x10>(2);
+    std::fill(iv.begin() + 10, iv.end(), u8{0xFF});
+
+    AESCipher<Key128> cipher(key, Mode::CTR);
+    for (const size_t size : {0x1, 0xF, 0x10, 0x11, 0x70, 0x80, 0x90, 0x3FF, 0x400, 0x4010}) {
+        const std::vector<u8> data = MakeData(size, static_cast<u32>(size));
+        const auto expected = MbedtlsTranscode(MBEDTLS_CIPHER_AES_128_CTR, key, iv, data,
+                                               Op::Encrypt);
+
+        std::vector<u8> result(size);
+        cipher.SetIV(iv);
+        cipher.Transcode(data.data(), size, result.data(), Op::Decrypt);
+        REQUIRE(result == expected);
+
+        // Consecutive calls continue after the counter of the last, even partial, block
+        const size_t half = size / 2;
+        result = data;
+        cipher.SetIV(iv);
+        cipher.Transcode(result.data(), half, result.data(), Op::Encrypt);
+        cipher.Transcode(result.data() + half, size - half, result.data() + half, Op::Encrypt);
+
+        auto reference = MbedtlsTranscode(MBEDTLS_CIPHER_AES_128_CTR, key, iv,
+                                          std::span{data}.first(half), Op::Encrypt);
+        const auto second_iv = AddToCounter(iv, (half + 0xF) / 0x10);
+        const auto second = MbedtlsTranscode(MBEDTLS_CIPHER_AES_128_CTR, key, second_iv,
+                                             std::span{data}.subspan(half), Op::Encrypt);
+        reference.insert(reference.end(), second.begin(), second.end());
+        REQUIRE(result == reference);
+    }
+}
+
+TEST_CASE("AESCipher: XTS matches mbedtls", "[core]") {
+    const Key256 key = MakeArray<0x20>(3);
+    AESCipher<Key256> cipher(key, Mode::XTS);
+
+    for (const size_t sector_size : {0x10, 0x200, 0x4000}) {
+        const std::vector<u8> data = MakeData(sector_size * 5, static_cast<u32>(sector_size));
+        const size_t sector_id = 0x1234567;
+
+        const auto expected = MbedtlsXts(key, data, sector_id, sector_size, Op::Encrypt);
+        std::vector<u8> encrypted(data.size());
+        cipher.XTSTranscode(data.data(), data.size(), encrypted.data(), sector_id, sector_size,
+                            Op::Encrypt);
+        REQUIRE(encrypted == expected);
+
+        REQUIRE(MbedtlsXts(key, encrypted, sector_id, sector_size, Op::Decrypt) == data);
+        std::vector<u8> decrypted = encrypted;
+        cipher.XTSTranscode(decrypted.data(), decrypted.size(), decrypted.data(), sector_id,
+                            sector_size, Op::Decrypt);
+        REQUIRE(decrypted == data);
+    }
+
+    // Sectors that aren't a multiple of the block size use ciphertext stealing
+    const std::vector<u8> data = MakeData(0x1F, 4);
+    std::vector<u8> encrypted(data.size());
+    cipher.XTSTranscode(data.data(), data.size(), encrypted.data(), 7, data.size(), Op::Encrypt);
+    REQUIRE(encrypted == MbedtlsXts(key, data, 7, data.size(), Op::Encrypt));
+}
+
+TEST_CASE("AESCipher: CTR and XTS throughput", "[.][benchmark][core]") {
+    constexpr size_t DATA_SIZE = 16 * 1024 * 1024;
+    constexpr size_t SECTOR_SIZE = 0x200;
+    const std::vector<u8> data = MakeData(DATA_SIZE, 5);
+    std::vector<u8> result(DATA_SIZE);
+    const Key128 key128 = MakeArray<0x10>(6);
+    const Key256 key256 = MakeArray<0x20>(7);
+    const std::array<u8, 0x10> iv = MakeArray<0x10>(8);
+
+    AESCipher<Key128> ctr(key128, Mode::CTR);
+    AESCipher<Key256> xts(key256, Mode::XTS);
+
+    BENCHMARK("CTR, mbedtls") {
+        return MbedtlsTranscode(MBEDTLS_CIPHER_AES_128_CTR, key128, iv, data, Op::Decrypt)[0];
+    };
+    BENCHMARK("CTR, AESCipher") {
+        ctr.SetIV(iv);
+        ctr.Transcode(data.data(), data.size(), result.data(), Op::Decrypt);
+        return result[0];
+    };
+    BENCHMARK("XTS, mbedtls") {
+        return MbedtlsXts(key256, data, 0, SECTOR_SIZE, Op::Decrypt)[0];
+    };
+    BENCHMARK("XTS, AESCipher") {
+        xts.XTSTranscode(data.data(), data.size(), result.data(), 0, SECTOR_SIZE, Op::Decrypt);
+        return result[0];
+    };
+}
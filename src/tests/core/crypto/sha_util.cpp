@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <mbedtls/sha256.h>
+
+#include "common/common_types.h"
+#include "common/hex_util.h"
+#include "core/crypto/sha_util.h"
+
+namespace {
+using Core::Crypto::SHA256Hash;
+
+std::vector<u8> MakeData(size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> data(size);
+    std::ranges::generate(data, [&rng] { return static_cast<u8>(rng()); });
+    return data;
+}
+
+SHA256Hash MbedtlsSHA256(std::span<const u8> data) {
+    SHA256Hash hash;
+    mbedtls_sha256_ret(data.data(), data.size(), hash.data(), 0);
+    return hash;
+}
+} // Anonymous namespace
+
+TEST_CASE("SHA256: Matches mbedtls", "[core]") {
+    constexpr std::string_view abc = "abc";
+    REQUIRE(Core::Crypto::CalculateSHA256({reinterpret_cast<const u8*>(abc.data()), abc.size()}) ==
+            Common::HexStringToArray<0x20>(
+                "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    // Every padding length, then sizes spanning several blocks
+    for (size_t size = 0; size < 0x200; ++size) {
+        const std::vector<u8> data = MakeData(size, static_cast<u32>(size));
+        REQUIRE(Core::Crypto::CalculateSHA256(data) == MbedtlsSHA256(data));
+    }
+    const std::vector<u8> data = MakeData(0x12345, 1);
+    REQUIRE(Core::Crypto::CalculateSHA256(data) == MbedtlsSHA256(data));
+}
+
+TEST_CASE("SHA256: Incremental updates", "[core]") {
+    const std::vector<u8> data = MakeData(0x10000, 2);
+    std::mt19937 rng{3};
+    for (size_t i = 0; i < 20; ++i) {
+        Core::Crypto::SHA256Context context;
+        size_t offset = 0;
+        while (offset < data.size()) {
+            const size_t size = std::min<size_t>(rng() % 0x300, data.size() - offset);
+            context.Update(std::span{data}.subspan(offset, size));
+            offset += size;
+        }
+        REQUIRE(context.Finish() == MbedtlsSHA256(data));
+    }
+}
+
+TEST_CASE("SHA256: Throughput", "[.][benchmark][core]") {
+    const std::vector<u8> data = MakeData(16 * 1024 * 1024, 4);
+
+    BENCHMARK("mbedtls") {
+        return MbedtlsSHA256(data)[0];
+    };
+    BENCHMARK("CalculateSHA256") {
+        return Core::Crypto::CalculateSHA256(data)[0];
+    };
+}
@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/file_sys/fssystem/fssystem_aes_ctr_storage.h"
+#include "core/file_sys/fssystem/fssystem_alignment_matching_storage.h"
+#include "core/file_sys/fssystem/fssystem_decrypted_block_cache_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+using FileSys::DecryptedBlockCache;
+using FileSys::DecryptedBlockCacheStorage;
+
+constexpr std::array<u8, 0x10> KEY{0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+                                   0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff};
+constexpr std::array<u8, 0x10> IV{0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef};
+
+std::vector<u8> MakeData(size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> data(size);
+    std::ranges::generate(data, [&rng] { return static_cast<u8>(rng()); });
+    return data;
+}
+
+/// Returns a storage decrypting an AES-CTR encrypted copy of data, like the one of a NCA section
+FileSys::VirtualFile MakeDecryptedStorage(const std::vector<u8>& data) {
+    auto encrypted = std::make_shared<FileSys::VectorVfsFile>(std::vector<u8>(data.size()));
+    FileSys::AesCtrStorage{encrypted, KEY.data(), KEY.size(), IV.data(), IV.size()}.Write(
+        data.data(), data.size(), 0);
+    REQUIRE(encrypted->ReadAllBytes() != data);
+
+    auto aes_ctr_storage = std::make_shared<FileSys::AesCtrStorage>(
+        std::move(encrypted), KEY.data(), KEY.size(), IV.data(), IV.size());
+    return std::make_shared<FileSys::AlignmentMatchingStorage<0x10, 1>>(
+        std::move(aes_ctr_storage));
+}
+
+bool IsZero(const std::vector<u8>& buffer, size_t size) {
+    return std::all_of(buffer.begin(), buffer.begin() + size, [](u8 value) { return value == 0; });
+}
+
+DecryptedBlockCache::SectionId MakeSectionId(u8 value) {
+    DecryptedBlockCache::SectionId id{};
+    id.fill(value);
+    return id;
+}
+} // Anonymous namespace
+
+TEST_CASE("DecryptedBlockCacheStorage: Reads match the decrypted data", "[core]") {
+    constexpr size_t SECTION_SIZE = DecryptedBlockCache::BlockSize * 20 + 0x1230;
+    constexpr size_t CACHED_BLOCKS = 8;
+    const std::vector<u8> data = MakeData(SECTION_SIZE, 1);
+    DecryptedBlockCache cache{DecryptedBlockCache::BlockSize * CACHED_BLOCKS};
+    DecryptedBlockCacheStorage storage{MakeDecryptedStorage(data), MakeSectionId(1), cache};
+    REQUIRE(storage.GetSize() == SECTION_SIZE);
+
+    std::mt19937 rng{2};
+    for (size_t i = 0; i < 500; ++i) {
+        const size_t offset = rng() % SECTION_SIZE;
+        const size_t size = rng() % (DecryptedBlockCache::BlockSize * 3) + 1;
+        std::vector<u8> buffer(size);
+        const size_t read = storage.Read(buffer.data(), size, offset);
+        REQUIRE(read == std::min(size, SECTION_SIZE - offset));
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + read, data.begin() + offset));
+        REQUIRE(cache.GetNumBlocks() <= CACHED_BLOCKS);
+    }
+    REQUIRE(storage.Read(nullptr, 0x10, SECTION_SIZE) == 0);
+}
+
+TEST_CASE("DecryptedBlockCacheStorage: Blocks are shared by section id", "[core]") {
+    constexpr size_t SECTION_SIZE = DecryptedBlockCache::BlockSize * 4;
+    const std::vector<u8> data = MakeData(SECTION_SIZE, 3);
+    DecryptedBlockCache cache;
+    DecryptedBlockCacheStorage storage{MakeDecryptedStorage(data), MakeSectionId(1), cache};
+
+    std::vector<u8> buffer(SECTION_SIZE);
+    REQUIRE(storage.Read(buffer.data(), DecryptedBlockCache::BlockSize, 0) ==
+            DecryptedBlockCache::BlockSize);
+    REQUIRE(cache.GetNumBlocks() == 1);
+
+    // Another storage of the same section is served from the cache, unlike one of another section
+    const auto zeros = std::make_shared<FileSys::VectorVfsFile>(std::vector<u8>(SECTION_SIZE));
+    DecryptedBlockCacheStorage same_section{zeros, MakeSectionId(1), cache};
+    DecryptedBlockCacheStorage other_section{zeros, MakeSectionId(2), cache};
+
+    REQUIRE(same_section.Read(buffer.data(), 0x100, 0x80) == 0x100);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + 0x100, data.begin() + 0x80));
+    REQUIRE(other_section.Read(buffer.data(), 0x100, 0x80) == 0x100);
+    REQUIRE(IsZero(buffer, 0x100));
+    REQUIRE(cache.GetNumBlocks() == 2);
+
+    cache.Clear();
+    REQUIRE(cache.GetNumBlocks() == 0);
+    REQUIRE(same_section.Read(buffer.data(), 0x100, 0x80) == 0x100);
+    REQUIRE(IsZero(buffer, 0x100));
+}
+
+TEST_CASE("DecryptedBlockCacheStorage: Concurrent reads match the decrypted data", "[core]") {
+    constexpr size_t SECTION_SIZE = DecryptedBlockCache::BlockSize * 64;
+    constexpr size_t CACHED_BLOCKS = 32;
+    constexpr size_t NUM_THREADS = 4;
+    const std::vector<u8> data = MakeData(SECTION_SIZE, 6);
+    DecryptedBlockCache cache{DecryptedBlockCache::BlockSize * CACHED_BLOCKS};
+    // An AES-CTR storage can't be read by several threads at once, so read plain data instead
+    DecryptedBlockCacheStorage storage{std::make_shared<FileSys::VectorVfsFile>(data),
+                                       MakeSectionId(1), cache};
+
+    // Readers share blocks and evict each other's, across all shards of the cache
+    std::array<bool, NUM_THREADS> matched{};
+    std::vector<std::thread> threads;
+    for (size_t index = 0; index < NUM_THREADS; ++index) {
+        threads.emplace_back([&, index] {
+            std::mt19937 rng{static_cast<u32>(index + 7)};
+            std::vector<u8> buffer(DecryptedBlockCache::BlockSize * 2);
+            bool all_matched = true;
+            for (size_t i = 0; i < 2000; ++i) {
+                const size_t offset = rng() % (SECTION_SIZE - buffer.size());
+                all_matched &= storage.Read(buffer.data(), buffer.size(), offset) == buffer.size();
+                all_matched &= std::equal(buffer.begin(), buffer.end(), data.begin() + offset);
+            }
+            matched[index] = all_matched;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(std::ranges::all_of(matched, [](bool value) { return value; }));
+    REQUIRE(cache.GetNumBlocks() <= CACHED_BLOCKS);
+}
+
+TEST_CASE("DecryptedBlockCacheStorage: Cold and warm read throughput", "[.][benchmark][core]") {
+    constexpr size_t SECTION_SIZE = 32 * 1024 * 1024;
+    constexpr size_t READ_SIZE = 0x1000;
+    constexpr size_t NUM_READS = 4096;
+    constexpr size_t WORKING_SET = 16 * 1024 * 1024;
+    const std::vector<u8> data = MakeData(SECTION_SIZE, 4);
+    const FileSys::VirtualFile decrypted = MakeDecryptedStorage(data);
+    DecryptedBlockCache cache;
+    DecryptedBlockCacheStorage storage{decrypted, MakeSectionId(1), cache};
+
+    // Small reads spread over a working set that fits the cache, like those of RomFS files
+    std::mt19937 rng{5};
+    std::vector<size_t> offsets(NUM_READS);
+    for (size_t& offset : offsets) {
+        offset = (rng() % (WORKING_SET / READ_SIZE)) * READ_SIZE;
+    }
+    std::vector<u8> buffer(READ_SIZE);
+    const auto read_all = [&](const FileSys::VirtualFile& file) {
+        for (const size_t offset : offsets) {
+            file->Read(buffer.data(), READ_SIZE, offset);
+        }
+        return buffer[0];
+    };
+    const auto read_all_cached = [&] {
+        for (const size_t offset : offsets) {
+            storage.Read(buffer.data(), READ_SIZE, offset);
+        }
+        return buffer[0];
+    };
+
+    BENCHMARK("Uncached") {
+        return read_all(decrypted);
+    };
+    BENCHMARK("Cold cache") {
+        cache.Clear();
+        return read_all_cached();
+    };
+    read_all_cached();
+    BENCHMARK("Warm cache") {
+        return read_all_cached();
+    };
+}
@@ -0,0 +1,237 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/crypto/sha_util.h"
+#include "core/file_sys/fssystem/fssystem_integrity_romfs_storage.h"
+#include "core/file_sys/fssystem/fssystem_integrity_verification_storage.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+using FileSys::VerifiedBlockBitmap;
+
+struct HashTree {
+    FileSys::HierarchicalIntegrityVerificationInformation info;
+    FileSys::Hash master_hash;
+    std::vector<s32> block_orders;
+    std::vector<FileSys::VirtualFile> layers; ///< Hash layers first, data last
+};
+
+std::vector<u8> MakeData(size_t size, u32 seed) {
+    std::mt19937 rng{seed};
+    std::vector<u8> data(size);
+    std::ranges::generate(data, [&rng] { return static_cast<u8>(rng()); });
+    return data;
+}
+
+/// Hashes each block of data, with the last one padded with zeros
+std::vector<u8> HashBlocks(const std::vector<u8>& data, size_t block_size) {
+    std::vector<u8> hashes;
+    std::vector<u8> block(block_size);
+    for (size_t offset = 0; offset < data.size(); offset += block_size) {
+        std::ranges::fill(block, u8{0});
+        std::copy_n(data.begin() + offset, std::min(block_size, data.size() - offset),
+                    block.begin());
+        const auto hash = Core::Crypto::CalculateSHA256(block);
+        hashes.insert(hashes.end(), hash.begin(), hash.end());
+    }
+    return hashes;
+}
+
+/// Builds the hash layers of data, given the block order of each hash layer and of the data
+HashTree MakeHashTree(std::vector<u8> data, const std::vector<s32>& block_orders) {
+    HashTree tree{};
+    tree.block_orders = block_orders;
+    tree.info.max_layers = static_cast<u32>(block_orders.size() + 1);
+
+    std::vector<std::vector<u8>> layers(block_orders.size());
+    layers.back() = std::move(data);
+    for (size_t level = layers.size() - 1; level > 0; --level) {
+        layers[level - 1] = HashBlocks(layers[level], size_t{1} << block_orders[level]);
+    }
+    const std::vector<u8> master_hash = HashBlocks(layers[0], size_t{1} << block_orders[0]);
+    REQUIRE(master_hash.size() == sizeof(tree.master_hash));
+    std::ranges::copy(master_hash, tree.master_hash.value.begin());
+
+    for (size_t level = 0; level < layers.size(); ++level) {
+        tree.info.info[level].offset = 0;
+        tree.info.info[level].size = static_cast<s64>(layers[level].size());
+        tree.info.info[level].block_order = block_orders[level];
+        tree.layers.push_back(std::make_shared<FileSys::VectorVfsFile>(std::move(layers[level])));
+    }
+    return tree;
+}
+
+std::shared_ptr<FileSys::IntegrityRomFsStorage> OpenStorage(const HashTree& tree,
+                                                            bool verify_data) {
+    FileSys::HierarchicalIntegrityVerificationStorage::HierarchicalStorageInformation storage_info;
+    for (size_t level = 0; level < tree.layers.size(); ++level) {
+        storage_info[static_cast<s32>(level + 1)] = tree.layers[level];
+    }
+    auto storage = std::make_shared<FileSys::IntegrityRomFsStorage>();
+    REQUIRE(R_SUCCEEDED(storage->Initialize(tree.info, tree.master_hash, storage_info, 0, 0, 0,
+                                            verify_data, tree.layers.back())));
+    return storage;
+}
+
+std::shared_ptr<VerifiedBlockBitmap> GetDataBitmap(const HashTree& tree) {
+    const s32 level = static_cast<s32>(tree.layers.size() - 1);
+    const size_t block_size = size_t{1} << tree.block_orders.back();
+    return VerifiedBlockBitmap::GetShared(
+        tree.layers.back(), tree.master_hash.value, level,
+        Common::DivideUp(tree.layers.back()->GetSize(), block_size));
+}
+
+void Corrupt(const HashTree& tree, size_t offset) {
+    u8 value{};
+    tree.layers.back()->Read(&value, 1, offset);
+    value ^= 0x5a;
+    tree.layers.back()->Write(&value, 1, offset);
+}
+
+bool IsZero(const std::vector<u8>& buffer, size_t offset) {
+    return std::all_of(buffer.begin() + offset, buffer.end(), [](u8 value) { return value == 0; });
+}
+} // Anonymous namespace
+
+TEST_CASE("IntegrityVerificationStorage: Verified reads match the data", "[core]") {
+    VerifiedBlockBitmap::ClearShared();
+    constexpr size_t DATA_SIZE = 0x1000 * 40 + 0x123;
+    const std::vector<u8> data = MakeData(DATA_SIZE, 1);
+    const HashTree tree = MakeHashTree(data, {9, 9, 12});
+    const auto storage = OpenStorage(tree, true);
+    REQUIRE(storage->GetSize() == DATA_SIZE);
+
+    std::mt19937 rng{2};
+    for (size_t i = 0; i < 300; ++i) {
+        const size_t offset = rng() % DATA_SIZE;
+        const size_t size = std::min<size_t>(rng() % 0x3000 + 1, DATA_SIZE - offset);
+        std::vector<u8> buffer(size);
+        REQUIRE(storage->Read(buffer.data(), size, offset) == size);
+        REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+    }
+
+    std::vector<u8> buffer(DATA_SIZE);
+    REQUIRE(storage->Read(buffer.data(), DATA_SIZE, 0) == DATA_SIZE);
+    REQUIRE(buffer == data);
+    const auto bitmap = GetDataBitmap(tree);
+    REQUIRE(bitmap->GetNumVerified() == bitmap->GetNumBlocks());
+}
+
+TEST_CASE("IntegrityVerificationStorage: Corrupted blocks are not read", "[core]") {
+    VerifiedBlockBitmap::ClearShared();
+    constexpr size_t BLOCK_SIZE = 0x1000;
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 16, 3);
+    const HashTree tree = MakeHashTree(data, {9, 9, 12});
+    Corrupt(tree, BLOCK_SIZE * 5 + 0x80);
+    const auto storage = OpenStorage(tree, true);
+
+    // Reads stop before the corrupted block, and don't return any of its data
+    std::vector<u8> buffer(BLOCK_SIZE * 4, 0xff);
+    REQUIRE(storage->Read(buffer.data(), buffer.size(), BLOCK_SIZE * 3 + 0x10) ==
+            BLOCK_SIZE * 2 - 0x10);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + BLOCK_SIZE * 2 - 0x10,
+                       data.begin() + BLOCK_SIZE * 3 + 0x10));
+    REQUIRE(IsZero(buffer, BLOCK_SIZE * 2 - 0x10));
+    REQUIRE(storage->Read(buffer.data(), 0x10, BLOCK_SIZE * 5 + 0x200) == 0);
+
+    // Other blocks can still be read
+    REQUIRE(storage->Read(buffer.data(), BLOCK_SIZE, BLOCK_SIZE * 6) == BLOCK_SIZE);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + BLOCK_SIZE, data.begin() + BLOCK_SIZE * 6));
+    REQUIRE(!GetDataBitmap(tree)->IsVerified(5));
+
+    // Without verification, the corrupted data is read as is
+    const auto unverified = OpenStorage(tree, false);
+    REQUIRE(unverified->Read(buffer.data(), BLOCK_SIZE, BLOCK_SIZE * 5) == BLOCK_SIZE);
+    REQUIRE(
+        !std::equal(buffer.begin(), buffer.begin() + BLOCK_SIZE, data.begin() + BLOCK_SIZE * 5));
+}
+
+TEST_CASE("IntegrityVerificationStorage: Blocks are verified once per session", "[core]") {
+    VerifiedBlockBitmap::ClearShared();
+    constexpr size_t BLOCK_SIZE = 0x4000;
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 128, 4);
+    const HashTree tree = MakeHashTree(data, {14, 14, 14});
+
+    // A large read is hashed in parallel
+    std::vector<u8> buffer(data.size());
+    const auto first = OpenStorage(tree, true);
+    REQUIRE(first->Read(buffer.data(), buffer.size(), 0) == buffer.size());
+    REQUIRE(buffer == data);
+    REQUIRE(GetDataBitmap(tree)->GetNumVerified() == 128);
+
+    // Verified blocks aren't hashed again, also by storages opened later on the same data
+    Corrupt(tree, BLOCK_SIZE * 100);
+    const auto storage = OpenStorage(tree, true);
+    REQUIRE(storage->Read(buffer.data(), BLOCK_SIZE, BLOCK_SIZE * 100) == BLOCK_SIZE);
+
+    // Until the verified blocks are forgotten
+    VerifiedBlockBitmap::ClearShared();
+    REQUIRE(OpenStorage(tree, true)->Read(buffer.data(), buffer.size(), 0) == BLOCK_SIZE * 100);
+    REQUIRE(std::equal(buffer.begin(), buffer.begin() + BLOCK_SIZE * 100, data.begin()));
+    REQUIRE(IsZero(buffer, BLOCK_SIZE * 100));
+}
+
+TEST_CASE("IntegrityVerificationStorage: Verified blocks are not shared between files", "[core]") {
+    VerifiedBlockBitmap::ClearShared();
+    constexpr size_t BLOCK_SIZE = 0x1000;
+    const std::vector<u8> data = MakeData(BLOCK_SIZE * 16, 6);
+    const HashTree tree = MakeHashTree(data, {12, 12, 12});
+    const HashTree copy = MakeHashTree(data, {12, 12, 12});
+    REQUIRE(copy.master_hash.value == tree.master_hash.value);
+
+    std::vector<u8> buffer(data.size());
+    const auto storage = OpenStorage(tree, true);
+    REQUIRE(storage->Read(buffer.data(), buffer.size(), 0) == buffer.size());
+
+    // Another file with the same hash tree verifies its own blocks
+    Corrupt(copy, BLOCK_SIZE * 3);
+    const auto copy_storage = OpenStorage(copy, true);
+    REQUIRE(copy_storage->Read(buffer.data(), buffer.size(), 0) == BLOCK_SIZE * 3);
+    REQUIRE(GetDataBitmap(copy)->GetNumVerified() == 3);
+    REQUIRE(GetDataBitmap(tree)->GetNumVerified() == 16);
+
+    // The verified blocks are forgotten once no storage of the file uses them
+    Corrupt(tree, BLOCK_SIZE * 3);
+    REQUIRE(OpenStorage(tree, true)->Read(buffer.data(), BLOCK_SIZE, BLOCK_SIZE * 3) == BLOCK_SIZE);
+    const std::weak_ptr<VerifiedBlockBitmap> bitmap = GetDataBitmap(tree);
+    storage->Finalize();
+    REQUIRE(bitmap.expired());
+    REQUIRE(OpenStorage(tree, true)->Read(buffer.data(), BLOCK_SIZE, BLOCK_SIZE * 3) == 0);
+}
+
+TEST_CASE("IntegrityVerificationStorage: Read throughput", "[.][benchmark][core]") {
+    constexpr size_t DATA_SIZE = 32 * 1024 * 1024;
+    constexpr size_t READ_SIZE = 1024 * 1024;
+    const HashTree tree = MakeHashTree(MakeData(DATA_SIZE, 5), {14, 14, 14});
+    const auto unverified = OpenStorage(tree, false);
+
+    std::vector<u8> buffer(READ_SIZE);
+    const auto read_all = [&](const FileSys::VirtualFile& storage) {
+        for (size_t offset = 0; offset < DATA_SIZE; offset += READ_SIZE) {
+            storage->Read(buffer.data(), READ_SIZE, offset);
+        }
+        return buffer[0];
+    };
+
+    BENCHMARK("Unverified") {
+        return read_all(unverified);
+    };
+    BENCHMARK("First touch") {
+        VerifiedBlockBitmap::ClearShared();
+        return read_all(OpenStorage(tree, true));
+    };
+    const auto verified = OpenStorage(tree, true);
+    read_all(verified);
+    BENCHMARK("Verified") {
+        return read_all(verified);
+    };
+}
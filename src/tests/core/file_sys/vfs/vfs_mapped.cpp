@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "core/file_sys/romfs.h"
+#include "core/file_sys/vfs/vfs_concat.h"
+#include "core/file_sys/vfs/vfs_offset.h"
+#include "core/file_sys/vfs/vfs_real.h"
+#include "core/file_sys/vfs/vfs_vector.h"
+
+namespace {
+std::filesystem::path TestDirectory() {
+    return std::filesystem::temp_directory_path() / "suyu_vfs_mapped_test";
+}
+
+std::vector<u8> MakeData(size_t size) {
+    std::vector<u8> data(size);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<u8>(i * 13 + (i >> 8));
+    }
+    return data;
+}
+
+std::string CreateTestFile(const std::string& name, std::span<const u8> data) {
+    const auto path = TestDirectory() / name;
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    REQUIRE(file.WriteSpan(data) == data.size());
+    return Common::FS::PathToUTF8String(path);
+}
+} // Anonymous namespace
+
+TEST_CASE("MappedVfsFile: Reads and spans", "[core]") {
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+    REQUIRE(Common::FS::CreateDirs(TestDirectory()));
+
+    constexpr size_t FILE_SIZE = 0x3000;
+    const std::vector<u8> data = MakeData(FILE_SIZE);
+    const std::string path = CreateTestFile("mapped.bin", data);
+
+    FileSys::RealVfsFilesystem filesystem;
+    REQUIRE(filesystem.OpenMappedFile(Common::FS::PathToUTF8String(TestDirectory() / "none")) ==
+            nullptr);
+    const FileSys::VirtualFile file = filesystem.OpenMappedFile(path);
+    REQUIRE(file != nullptr);
+    REQUIRE(file->GetName() == "mapped.bin");
+    REQUIRE(file->GetSize() == FILE_SIZE);
+    REQUIRE(!file->IsWritable());
+    REQUIRE(file->GetContainingDirectory()->GetFile("mapped.bin") != nullptr);
+
+    REQUIRE(file->ReadAllBytes() == data);
+    std::vector<u8> tail(0x100);
+    REQUIRE(file->Read(tail.data(), tail.size(), FILE_SIZE - 0x10) == 0x10);
+    REQUIRE(file->Read(tail.data(), tail.size(), FILE_SIZE) == 0);
+
+    // Spans point into the mapping and are clipped to the end of the file
+    const std::span<const u8> span = file->GetMappedSpan(0x100, 0x80);
+    REQUIRE(span.size() == 0x100);
+    REQUIRE(std::equal(span.begin(), span.end(), data.begin() + 0x80));
+    REQUIRE(file->GetMappedSpan(0x100, FILE_SIZE - 0x10).size() == 0x10);
+    REQUIRE(file->GetMappedSpan(0x100, FILE_SIZE).empty());
+
+    // Offset files pass spans through
+    const auto offset_file = std::make_shared<FileSys::OffsetVfsFile>(file, 0x1000, 0x1000);
+    const std::span<const u8> offset_span = offset_file->GetMappedSpan(0x2000, 0x800);
+    REQUIRE(offset_span.size() == 0x800);
+    REQUIRE(offset_span.data() == file->GetMappedSpan(1, 0x1800).data());
+    REQUIRE(offset_file->GetMappedSpan(1, 0x1000).empty());
+
+    // Concatenated files pass spans through as long as they don't cross files
+    std::vector<FileSys::VirtualFile> parts{
+        std::make_shared<FileSys::OffsetVfsFile>(file, 0x1000, 0),
+        std::make_shared<FileSys::OffsetVfsFile>(file, 0x2000, 0x1000),
+    };
+    const FileSys::VirtualFile concat =
+        FileSys::ConcatenatedVfsFile::MakeConcatenatedFile("concat", std::move(parts));
+    REQUIRE(concat->GetMappedSpan(0x100, 0x1800).data() == file->GetMappedSpan(1, 0x1800).data());
+    REQUIRE(concat->GetMappedSpan(0x100, 0xf80).empty());
+    REQUIRE(concat->GetMappedSpan(0x100, FILE_SIZE - 0x80).size() == 0x80);
+    REQUIRE(concat->GetMappedSpan(0x100, FILE_SIZE).empty());
+
+    // Files read through system calls have nothing to hand out
+    REQUIRE(filesystem.OpenFile(path)->GetMappedSpan(0x100, 0).empty());
+
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+}
+
+TEST_CASE("MappedVfsFile: RomFS is parsed from the mapping", "[core]") {
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+    REQUIRE(Common::FS::CreateDirs(TestDirectory()));
+
+    const std::vector<u8> first = MakeData(0x1234);
+    const std::vector<u8> second = MakeData(0x80);
+    const auto sub = std::make_shared<FileSys::VectorVfsDirectory>(
+        std::vector<FileSys::VirtualFile>{
+            std::make_shared<FileSys::VectorVfsFile>(second, "second.bin")},
+        std::vector<FileSys::VirtualDir>{}, "sub");
+    const auto root = std::make_shared<FileSys::VectorVfsDirectory>(
+        std::vector<FileSys::VirtualFile>{
+            std::make_shared<FileSys::VectorVfsFile>(first, "first.bin")},
+        std::vector<FileSys::VirtualDir>{sub});
+    const std::string path =
+        CreateTestFile("game.romfs", FileSys::CreateRomFS(root, nullptr)->ReadAllBytes());
+
+    FileSys::RealVfsFilesystem filesystem;
+    const FileSys::VirtualFile file = filesystem.OpenMappedFile(path);
+    REQUIRE(file != nullptr);
+    const FileSys::VirtualDir extracted = FileSys::ExtractRomFS(file);
+    REQUIRE(extracted != nullptr);
+
+    const FileSys::VirtualFile first_file = extracted->GetFile("first.bin");
+    REQUIRE(first_file != nullptr);
+    REQUIRE(first_file->ReadAllBytes() == first);
+    REQUIRE(first_file->GetMappedSpan(first.size()).size() == first.size());
+    const FileSys::VirtualFile second_file = extracted->GetFileRelative("sub/second.bin");
+    REQUIRE(second_file != nullptr);
+    REQUIRE(second_file->ReadAllBytes() == second);
+
+    // Files without a mapping are parsed the same way
+    const FileSys::VirtualDir read = FileSys::ExtractRomFS(filesystem.OpenFile(path));
+    REQUIRE(read != nullptr);
+    REQUIRE(read->GetFileRelative("sub/second.bin")->ReadAllBytes() == second);
+
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+}
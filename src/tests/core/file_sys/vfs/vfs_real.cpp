@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/path_util.h"
+#include "core/file_sys/vfs/vfs_real.h"
+
+namespace {
+std::filesystem::path TestDirectory() {
+    return std::filesystem::temp_directory_path() / "suyu_vfs_real_test";
+}
+
+u8 PatternAt(size_t file_index, size_t offset) {
+    return static_cast<u8>((offset * 31 + file_index * 7) ^ (offset >> 8));
+}
+
+std::string CreateTestFile(size_t file_index, size_t size) {
+    std::vector<u8> data(size);
+    for (size_t offset = 0; offset < size; ++offset) {
+        data[offset] = PatternAt(file_index, offset);
+    }
+    const auto path = TestDirectory() / ("file_" + std::to_string(file_index) + ".bin");
+    Common::FS::IOFile file{path, Common::FS::FileAccessMode::Write,
+                            Common::FS::FileType::BinaryFile};
+    REQUIRE(file.WriteSpan(std::span<const u8>{data}) == size);
+    return Common::FS::PathToUTF8String(path);
+}
+
+bool MatchesPattern(size_t file_index, size_t offset, const std::vector<u8>& data) {
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i] != PatternAt(file_index, offset + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+} // Anonymous namespace
+
+TEST_CASE("RealVfsFile: Parallel reads", "[core]") {
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+    REQUIRE(Common::FS::CreateDirs(TestDirectory()));
+
+    constexpr size_t FILE_SIZE = 1ULL << 22;
+    constexpr size_t NUM_THREADS = 8;
+    constexpr size_t READS_PER_THREAD = 256;
+    FileSys::RealVfsFilesystem filesystem;
+    const auto file = filesystem.OpenFile(CreateTestFile(0, FILE_SIZE));
+    REQUIRE(file != nullptr);
+    REQUIRE(file->GetSize() == FILE_SIZE);
+
+    // One byte per thread, as std::vector<bool> would share words between threads
+    std::vector<u8> results(NUM_THREADS);
+    std::vector<std::thread> threads;
+    for (size_t thread_index = 0; thread_index < NUM_THREADS; ++thread_index) {
+        threads.emplace_back([&, thread_index] {
+            std::mt19937 rng{static_cast<u32>(thread_index)};
+            bool matches = true;
+            for (size_t i = 0; i < READS_PER_THREAD; ++i) {
+                const size_t offset = rng() % FILE_SIZE;
+                const size_t length = rng() % 0x4000 + 1;
+                std::vector<u8> data(length);
+                const size_t read = file->Read(data.data(), length, offset);
+                data.resize(read);
+                matches &= read == std::min(length, FILE_SIZE - offset);
+                matches &= MatchesPattern(0, offset, data);
+            }
+            results[thread_index] = matches ? 1 : 0;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const u8 matches : results) {
+        REQUIRE(matches);
+    }
+
+    // Reading beyond the end of the file returns what is there
+    std::vector<u8> tail(0x100);
+    REQUIRE(file->Read(tail.data(), tail.size(), FILE_SIZE - 0x10) == 0x10);
+    REQUIRE(file->Read(tail.data(), tail.size(), FILE_SIZE + 0x10) == 0);
+
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+}
+
+TEST_CASE("RealVfsFile: Reads and writes with evicted references", "[core]") {
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+    REQUIRE(Common::FS::CreateDirs(TestDirectory()));
+
+    // More files than can be open at once, so that their references get evicted and reopened
+    constexpr size_t NUM_FILES = 600;
+    constexpr size_t FILE_SIZE = 0x200;
+    FileSys::RealVfsFilesystem filesystem;
+    std::vector<FileSys::VirtualFile> files;
+    for (size_t file_index = 0; file_index < NUM_FILES; ++file_index) {
+        const std::string path = CreateTestFile(file_index, FILE_SIZE);
+        files.push_back(filesystem.OpenFile(path, FileSys::OpenMode::ReadWrite));
+        REQUIRE(files.back() != nullptr);
+    }
+
+    for (size_t pass = 0; pass < 2; ++pass) {
+        for (size_t file_index = 0; file_index < NUM_FILES; ++file_index) {
+            std::vector<u8> data(FILE_SIZE / 2);
+            REQUIRE(files[file_index]->Read(data.data(), data.size(), pass * data.size()) ==
+                    data.size());
+            REQUIRE(MatchesPattern(file_index, pass * data.size(), data));
+        }
+    }
+
+    // Writes are seen by later reads, also after the file was evicted
+    const std::vector<u8> written{1, 2, 3, 4};
+    REQUIRE(files[0]->Write(written.data(), written.size(), 0x10) == written.size());
+    for (size_t file_index = 1; file_index < NUM_FILES; ++file_index) {
+        u8 value{};
+        REQUIRE(files[file_index]->Read(&value, 1, 0) == 1);
+    }
+    std::vector<u8> data(written.size());
+    REQUIRE(files[0]->Read(data.data(), data.size(), 0x10) == data.size());
+    REQUIRE(data == written);
+
+    files.clear();
+    (void)Common::FS::RemoveDirRecursively(TestDirectory());
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/hle/kernel/k_address_wait_buckets.h"
+
+TEST_CASE("KAddressWaitBuckets: Neighbouring addresses use different buckets", "[core]") {
+    constexpr size_t NUM_ADDRESSES = 64;
+    auto buckets = std::make_unique<Kernel::KAddressWaitBuckets>();
+    std::set<const Kernel::KAddressWaitBuckets::Bucket*> used;
+    for (u64 index = 0; index < NUM_ADDRESSES; ++index) {
+        used.insert(&buckets->GetBucket(0x8000'1000 + index * sizeof(u32)));
+    }
+    REQUIRE(used.size() >= NUM_ADDRESSES / 2);
+}
+
+TEST_CASE("KAddressWaitBuckets: Signals see the threads about to wait", "[core]") {
+    // The waiter checks a value and sleeps while it is unchanged, the signaler changes it and only
+    // takes the lock to wake the waiter up when the bucket has waiters, like KAddressArbiter
+    constexpr s32 NUM_ITERATIONS = 20000;
+    Kernel::KAddressWaitBuckets::Bucket bucket;
+    std::mutex scheduler_lock;
+    std::condition_variable wakeup;
+    bool waiting = false;
+    std::atomic<bool> lost_wakeup = false;
+    std::atomic<s32> value = 0;
+    std::atomic<s32> iteration = -1;
+
+    std::thread waiter{[&] {
+        for (s32 i = 0; i < NUM_ITERATIONS; ++i) {
+            iteration = i;
+            // Give the signaler a chance to run between the announcement and the check
+            std::this_thread::yield();
+            std::unique_lock lock{scheduler_lock};
+            bucket.AddWaiter();
+            if (value.load() != i) {
+                bucket.RemoveWaiter();
+                continue;
+            }
+            waiting = true;
+            if (!wakeup.wait_for(lock, std::chrono::seconds{10}, [&] { return !waiting; })) {
+                lost_wakeup = true;
+                waiting = false;
+                bucket.RemoveWaiter();
+                return;
+            }
+        }
+    }};
+    for (s32 i = 0; i < NUM_ITERATIONS && !lost_wakeup; ++i) {
+        while (iteration.load() < i && !lost_wakeup) {
+            std::this_thread::yield();
+        }
+        value = i + 1;
+        if (!bucket.HasWaiters()) {
+            continue;
+        }
+        std::scoped_lock lock{scheduler_lock};
+        if (waiting) {
+            waiting = false;
+            bucket.RemoveWaiter();
+            wakeup.notify_one();
+        }
+    }
+    waiter.join();
+
+    REQUIRE(!lost_wakeup);
+    REQUIRE(!bucket.HasWaiters());
+}
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "core/hardware_properties.h"
+#include "core/hle/kernel/k_affinity_mask.h"
+#include "core/hle/kernel/k_priority_queue.h"
+
+namespace {
+constexpr size_t NUM_CORES = Core::Hardware::NUM_CPU_CORES;
+constexpr s32 LOWEST_PRIORITY = 63;
+constexpr s32 HIGHEST_PRIORITY = 0;
+
+/// Minimal stand-in for KThread with the members the priority queue needs
+class TestThread {
+public:
+    class QueueEntry {
+    public:
+        constexpr void Initialize() {
+            m_prev = nullptr;
+            m_next = nullptr;
+        }
+
+        constexpr TestThread* GetPrev() const {
+            return m_prev;
+        }
+        constexpr TestThread* GetNext() const {
+            return m_next;
+        }
+        constexpr void SetPrev(TestThread* thread) {
+            m_prev = thread;
+        }
+        constexpr void SetNext(TestThread* thread) {
+            m_next = thread;
+        }
+
+    private:
+        TestThread* m_prev{};
+        TestThread* m_next{};
+    };
+
+    TestThread(s32 priority_, s32 active_core_, u64 affinity_)
+        : priority{priority_}, active_core{active_core_} {
+        affinity.SetAffinityMask(affinity_);
+    }
+
+    QueueEntry& GetPriorityQueueEntry(s32 core) {
+        return entries[core];
+    }
+    const QueueEntry& GetPriorityQueueEntry(s32 core) const {
+        return entries[core];
+    }
+
+    const Kernel::KAffinityMask& GetAffinityMask() const {
+        return affinity;
+    }
+
+    s32 GetActiveCore() const {
+        return active_core;
+    }
+    void SetActiveCore(s32 core) {
+        active_core = core;
+    }
+
+    s32 GetPriority() const {
+        return priority;
+    }
+    void SetPriority(s32 priority_) {
+        priority = priority_;
+    }
+
+    bool IsDummyThread() const {
+        return false;
+    }
+
+private:
+    std::array<QueueEntry, NUM_CORES> entries{};
+    Kernel::KAffinityMask affinity;
+    s32 priority;
+    s32 active_core;
+};
+
+using TestQueue = Kernel::KPriorityQueue<TestThread, NUM_CORES, LOWEST_PRIORITY, HIGHEST_PRIORITY>;
+
+/// Straightforward model of the scheduled and suggested queues of every core
+class ReferenceQueue {
+public:
+    void PushBack(TestThread* thread) {
+        ForEachCore(thread, [&](std::list<TestThread*>& list) { list.push_back(thread); });
+    }
+
+    void Remove(TestThread* thread) {
+        ForEachCore(thread, [&](std::list<TestThread*>& list) { list.remove(thread); });
+    }
+
+    void ChangeCore(TestThread* thread, s32 new_core) {
+        const s32 prev_core = thread->GetActiveCore();
+        const s32 priority = thread->GetPriority();
+        scheduled[prev_core][priority].remove(thread);
+        suggested[new_core][priority].remove(thread);
+        scheduled[new_core][priority].push_back(thread);
+        suggested[prev_core][priority].push_back(thread);
+    }
+
+    std::vector<TestThread*> Get(bool scheduled, s32 core) const {
+        std::vector<TestThread*> result;
+        for (const auto& list : (scheduled ? this->scheduled : suggested)[core]) {
+            result.insert(result.end(), list.begin(), list.end());
+        }
+        return result;
+    }
+
+private:
+    using Lists = std::array<std::array<std::list<TestThread*>, LOWEST_PRIORITY + 1>, NUM_CORES>;
+
+    template <typename Func>
+    void ForEachCore(TestThread* thread, Func&& func) {
+        u64 affinity = thread->GetAffinityMask().GetAffinityMask();
+        while (affinity != 0) {
+            const s32 core = std::countr_zero(affinity);
+            affinity &= affinity - 1;
+            Lists& lists = core == thread->GetActiveCore() ? scheduled : suggested;
+            func(lists[core][thread->GetPriority()]);
+        }
+    }
+
+    Lists scheduled;
+    Lists suggested;
+};
+
+std::vector<TestThread*> Walk(const TestQueue& queue, bool scheduled, s32 core) {
+    std::vector<TestThread*> result;
+    TestThread* thread = scheduled ? queue.GetScheduledFront(core) : queue.GetSuggestedFront(core);
+    while (thread != nullptr) {
+        result.push_back(thread);
+        thread = scheduled ? queue.GetScheduledNext(core, thread)
+                           : queue.GetSuggestedNext(core, thread);
+    }
+    return result;
+}
+
+std::vector<std::unique_ptr<TestThread>> MakeThreads(size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<s32> priority_dist{24, 59};
+    std::uniform_int_distribution<u64> affinity_dist{1, (1ULL << NUM_CORES) - 1};
+    std::vector<std::unique_ptr<TestThread>> threads;
+    for (size_t i = 0; i < count; ++i) {
+        const u64 affinity = affinity_dist(rng);
+        threads.push_back(std::make_unique<TestThread>(priority_dist(rng),
+                                                       std::countr_zero(affinity), affinity));
+    }
+    return threads;
+}
+
+/// Moves a thread to the core it is suggested for, the way the scheduler migrates threads
+void Migrate(TestQueue& queue, TestThread* thread, s32 core) {
+    const s32 prev_core = thread->GetActiveCore();
+    thread->SetActiveCore(core);
+    queue.ChangeCore(prev_core, thread);
+}
+} // Anonymous namespace
+
+TEST_CASE("KPriorityQueue: Matches reference model", "[kernel]") {
+    std::mt19937 rng{0x6b707171};
+    auto threads = MakeThreads(64, rng);
+    TestQueue queue;
+    ReferenceQueue reference;
+    std::vector<bool> queued(threads.size());
+
+    for (size_t step = 0; step < 4000; ++step) {
+        const size_t index = rng() % threads.size();
+        TestThread* const thread = threads[index].get();
+        if (!queued[index]) {
+            queue.PushBack(thread);
+            reference.PushBack(thread);
+            queued[index] = true;
+        } else if (rng() % 2 == 0) {
+            queue.Remove(thread);
+            reference.Remove(thread);
+            queued[index] = false;
+        } else {
+            // Migrate to another core the thread has affinity for
+            const s32 new_core = static_cast<s32>(rng() % NUM_CORES);
+            if (new_core == thread->GetActiveCore() ||
+                !thread->GetAffinityMask().GetAffinity(new_core)) {
+                continue;
+            }
+            reference.ChangeCore(thread, new_core);
+            Migrate(queue, thread, new_core);
+        }
+
+        u64 scheduled_cores = 0;
+        u64 suggested_cores = 0;
+        for (s32 core = 0; core < static_cast<s32>(NUM_CORES); ++core) {
+            const auto scheduled = reference.Get(true, core);
+            const auto suggested = reference.Get(false, core);
+            REQUIRE(Walk(queue, true, core) == scheduled);
+            REQUIRE(Walk(queue, false, core) == suggested);
+            scheduled_cores |= scheduled.empty() ? 0 : 1ULL << core;
+            suggested_cores |= suggested.empty() ? 0 : 1ULL << core;
+        }
+        REQUIRE(queue.GetScheduledCores() == scheduled_cores);
+        REQUIRE(queue.GetSuggestedCores() == suggested_cores);
+    }
+}
+
+TEST_CASE("KPriorityQueue: Priority changes", "[kernel]") {
+    TestThread low{50, 0, 0b0011};
+    TestThread high{30, 1, 0b0011};
+    TestQueue queue;
+    queue.PushBack(std::addressof(low));
+    queue.PushBack(std::addressof(high));
+
+    REQUIRE(queue.GetScheduledFront(0) == std::addressof(low));
+    REQUIRE(queue.GetSuggestedFront(0) == std::addressof(high));
+    REQUIRE(queue.GetSuggestedNext(0, std::addressof(high)) == nullptr);
+
+    low.SetPriority(20);
+    queue.ChangePriority(50, false, std::addressof(low));
+    REQUIRE(queue.GetScheduledFront(0, 20) == std::addressof(low));
+    REQUIRE(queue.GetScheduledFront(0, 50) == nullptr);
+    REQUIRE(queue.GetSuggestedFront(1) == std::addressof(low));
+    REQUIRE(queue.GetSuggestedNext(1, std::addressof(low)) == nullptr);
+    REQUIRE(queue.GetSuggestedCores() == 0b0011);
+
+    queue.Remove(std::addressof(low));
+    queue.Remove(std::addressof(high));
+    REQUIRE(queue.GetScheduledCores() == 0);
+    REQUIRE(queue.GetSuggestedCores() == 0);
+}
+
+TEST_CASE("KPriorityQueue: Reschedule throughput", "[.][benchmark][kernel]") {
+    constexpr size_t RESCHEDULES = 1000;
+
+    for (const size_t num_threads : {64, 256, 512}) {
+        std::mt19937 rng{0x7363686564};
+        auto threads = MakeThreads(num_threads, rng);
+        TestQueue queue;
+
+        // Half of the threads are runnable, the other half waits on something
+        std::vector<TestThread*> waiting;
+        for (size_t i = 0; i < threads.size(); ++i) {
+            if (i % 2 == 0) {
+                queue.PushBack(threads[i].get());
+            } else {
+                waiting.push_back(threads[i].get());
+            }
+        }
+
+        // Every reschedule, the top thread of a core starts waiting and wakes up a waiter. Cores
+        // without a runnable thread take one of their suggested threads, like the scheduler does
+        // for idle cores.
+        BENCHMARK("Contended waits, " + std::to_string(num_threads) + " threads, " +
+                  std::to_string(RESCHEDULES) + " reschedules") {
+            for (size_t i = 0; i < RESCHEDULES; ++i) {
+                const s32 core = static_cast<s32>(i % NUM_CORES);
+                TestThread* top = queue.GetScheduledFront(core);
+                if (top == nullptr) {
+                    if (TestThread* suggested = queue.GetSuggestedFront(core)) {
+                        Migrate(queue, suggested, core);
+                    }
+                    continue;
+                }
+                queue.Remove(top);
+                const size_t woken = rng() % waiting.size();
+                queue.PushBack(waiting[woken]);
+                waiting[woken] = top;
+            }
+            return queue.GetScheduledFront(0);
+        };
+    }
+}
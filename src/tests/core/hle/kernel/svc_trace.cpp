@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "core/hle/kernel/svc.h"
+#include "core/hle/kernel/svc_trace.h"
+
+namespace {
+using Kernel::SvcTracer;
+
+SvcTracer::Entry MakeEntry(Kernel::Svc::SvcId id, u32 core, u64 start_ns, u64 duration_ns) {
+    return SvcTracer::Entry{
+        .args = {start_ns, 1, 2, 3, 4, 5, 6, 7},
+        .thread_id = 0x48 + core,
+        .start_ns = start_ns,
+        .duration_ns = duration_ns,
+        .svc_id = static_cast<u32>(id),
+        .core = core,
+    };
+}
+} // Anonymous namespace
+
+TEST_CASE("SvcTracer: Counts calls per SVC", "[core]") {
+    using Kernel::Svc::SvcId;
+    SvcTracer tracer;
+    REQUIRE(!tracer.IsEnabled());
+
+    tracer.Record(MakeEntry(SvcId::WaitSynchronization, 0, 100, 5000));
+    tracer.Record(MakeEntry(SvcId::WaitSynchronization, 1, 200, 1000));
+    tracer.Record(MakeEntry(SvcId::SendSyncRequest, 2, 300, 700));
+
+    const SvcTracer::Stats wait = tracer.GetStats(static_cast<u32>(SvcId::WaitSynchronization));
+    REQUIRE(wait.calls == 2);
+    REQUIRE(wait.total_ns == 6000);
+    REQUIRE(wait.max_ns == 5000);
+    REQUIRE(tracer.GetStats(static_cast<u32>(SvcId::SendSyncRequest)).calls == 1);
+    REQUIRE(tracer.GetStats(static_cast<u32>(SvcId::SleepThread)).calls == 0);
+
+    // Recent calls of all cores are merged by start time
+    const auto calls = tracer.GetRecentCalls();
+    REQUIRE(calls.size() == 3);
+    REQUIRE(calls[0].core == 0);
+    REQUIRE(calls[1].core == 1);
+    REQUIRE(calls[2].svc_id == static_cast<u32>(SvcId::SendSyncRequest));
+    REQUIRE(calls[2].thread_id == 0x4a);
+
+    const auto json = nlohmann::json::parse(tracer.ExportJson());
+    REQUIRE(json["svcs"].size() == 2);
+    REQUIRE(json["svcs"][0]["name"] == "WaitSynchronization");
+    REQUIRE(json["svcs"][0]["mean_ns"] == 3000);
+    REQUIRE(json["calls"].size() == 3);
+    REQUIRE(json["calls"][2]["args"][1] == "0x1");
+
+    tracer.Reset();
+    REQUIRE(tracer.GetRecentCalls().empty());
+    REQUIRE(tracer.GetStats(static_cast<u32>(SvcId::WaitSynchronization)).calls == 0);
+}
+
+TEST_CASE("SvcTracer: Keeps the most recent calls", "[core]") {
+    using Kernel::Svc::SvcId;
+    SvcTracer tracer;
+
+    constexpr u64 NUM_CALLS = SvcTracer::RingSize * 2 + 10;
+    for (u64 i = 0; i < NUM_CALLS; ++i) {
+        tracer.Record(MakeEntry(SvcId::ArbitrateLock, 3, i, 1));
+    }
+
+    const auto calls = tracer.GetRecentCalls();
+    REQUIRE(calls.size() == SvcTracer::RingSize);
+    REQUIRE(calls.front().start_ns == NUM_CALLS - SvcTracer::RingSize);
+    REQUIRE(calls.back().start_ns == NUM_CALLS - 1);
+    REQUIRE(tracer.GetStats(static_cast<u32>(SvcId::ArbitrateLock)).calls == NUM_CALLS);
+}
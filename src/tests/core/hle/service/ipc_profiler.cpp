@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+
+#include "core/hle/service/ipc_profiler.h"
+
+using namespace std::chrono_literals;
+using Service::IpcProfiler;
+
+TEST_CASE("IpcProfiler: Commands are registered once", "[core]") {
+    IpcProfiler profiler;
+    IpcProfiler::CommandStats* const stats = profiler.GetCommandStats("fsp-srv", 1, "Open", false);
+    REQUIRE(profiler.GetCommandStats("fsp-srv", 1, "Open", false) == stats);
+    REQUIRE(profiler.GetCommandStats("fsp-srv", 1, "Open", true) != stats);
+    REQUIRE(profiler.GetCommandStats("fsp-srv", 2, "Read", false) != stats);
+    REQUIRE(profiler.GetCommandStats("nvdrv", 1, "Ioctl", false) != stats);
+    REQUIRE(stats->service_name == "fsp-srv");
+    REQUIRE(stats->command_name == "Open");
+}
+
+TEST_CASE("IpcProfiler: Commands are looked up on their first call", "[core]") {
+    IpcProfiler profiler;
+    const IpcProfiler::LazyCommandStats lazy{nullptr};
+    REQUIRE(profiler.ExportJson().find("Open") == std::string::npos);
+
+    IpcProfiler::CommandStats* const stats = lazy.Get(profiler, "fsp-srv", 1, "Open", false);
+    REQUIRE(stats == profiler.GetCommandStats("fsp-srv", 1, "Open", false));
+    REQUIRE(lazy.Get(profiler, "fsp-srv", 2, "Read", false) == stats);
+
+    const IpcProfiler::LazyCommandStats copy = lazy;
+    REQUIRE(copy.Get(profiler, "nvdrv", 1, "Ioctl", false) == stats);
+}
+
+TEST_CASE("IpcProfiler: Latency histogram", "[core]") {
+    IpcProfiler profiler;
+    IpcProfiler::CommandStats* const stats = profiler.GetCommandStats("vi:m", 7, "Draw", false);
+    stats->Record(0ns);
+    stats->Record(1ns);
+    stats->Record(1000ns);
+    stats->Record(1023ns);
+    stats->Record(1024ns);
+    stats->Record(1h);
+
+    REQUIRE(stats->calls == 6);
+    REQUIRE(stats->max_ns == static_cast<u64>(std::chrono::nanoseconds{1h}.count()));
+    REQUIRE(stats->histogram[0] == 1);
+    REQUIRE(stats->histogram[1] == 1);
+    REQUIRE(stats->histogram[10] == 2);
+    REQUIRE(stats->histogram[11] == 1);
+    REQUIRE(stats->histogram[IpcProfiler::NumBuckets - 1] == 1);
+
+    profiler.Reset();
+    REQUIRE(stats->calls == 0);
+    REQUIRE(stats->max_ns == 0);
+    REQUIRE(stats->histogram[10] == 0);
+}
+
+TEST_CASE("IpcProfiler: Concurrent calls and JSON export", "[core]") {
+    IpcProfiler profiler;
+    IpcProfiler::CommandStats* const hot = profiler.GetCommandStats("hid", 1, "Hot", false);
+    IpcProfiler::CommandStats* const cold = profiler.GetCommandStats("hid", 2, "Cold", false);
+    [[maybe_unused]] IpcProfiler::CommandStats* const unused =
+        profiler.GetCommandStats("hid", 3, "Unused", false);
+
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_CALLS = 10000;
+    std::vector<std::jthread> threads;
+    for (size_t thread = 0; thread < NUM_THREADS; ++thread) {
+        threads.emplace_back([&] {
+            for (size_t call = 0; call < NUM_CALLS; ++call) {
+                IpcProfiler::CommandScope scope{profiler, hot};
+            }
+        });
+    }
+    threads.clear();
+    cold->Record(1ns);
+    REQUIRE(hot->calls == NUM_THREADS * NUM_CALLS);
+
+    const auto json = nlohmann::json::parse(profiler.ExportJson());
+    const auto& commands = json["commands"];
+    REQUIRE(commands.size() == 2);
+    REQUIRE(commands[0]["command"] == "Hot");
+    REQUIRE(commands[0]["calls"] == NUM_THREADS * NUM_CALLS);
+    REQUIRE(commands[1]["command"] == "Cold");
+    REQUIRE(commands[1]["histogram"].size() == 1);
+    REQUIRE(commands[1]["histogram"][0]["min_ns"] == 1);
+}
@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/host_memory.h"
+#include "common/literals.h"
+#include "common/page_table.h"
+#include "core/core.h"
+#include "core/device_memory.h"
+#include "core/memory.h"
+
+namespace {
+using namespace Common::Literals;
+using Core::Memory::SUYU_PAGEBITS;
+using Core::Memory::SUYU_PAGESIZE;
+
+constexpr size_t ADDRESS_SPACE_BITS = 36;
+constexpr u64 BASE_ADDRESS = 0x8000'0000;
+
+/// Memory accessed through a page table built by the test instead of a guest process
+class MappedMemory {
+public:
+    MappedMemory() {
+        system.Initialize();
+        page_table.Resize(ADDRESS_SPACE_BITS, SUYU_PAGEBITS);
+        memory.SetCurrentPageTable(page_table);
+    }
+
+    /// Maps a run of contiguous physical pages
+    void Map(u64 vaddr, size_t first_page, size_t num_pages) {
+        memory.MapMemoryRegion(page_table, vaddr, num_pages * SUYU_PAGESIZE,
+                               PhysicalAddress(first_page), Common::MemoryPermission::ReadWrite,
+                               false);
+    }
+
+    /// Maps physical pages one by one, in the given order
+    void Map(u64 vaddr, std::span<const size_t> physical_pages) {
+        for (const size_t physical_page : physical_pages) {
+            Map(vaddr, physical_page, 1);
+            vaddr += SUYU_PAGESIZE;
+        }
+    }
+
+    [[nodiscard]] u8* Backing(size_t physical_page) {
+        return system.DeviceMemory().GetPointer<u8>(PhysicalAddress(physical_page));
+    }
+
+    Core::System system;
+    Common::PageTable page_table;
+    Core::Memory::Memory memory{system};
+
+private:
+    [[nodiscard]] static Common::PhysicalAddress PhysicalAddress(size_t physical_page) {
+        return Common::PhysicalAddress{Core::DramMemoryMap::Base + physical_page * SUYU_PAGESIZE};
+    }
+};
+
+std::vector<size_t> FragmentedPages(size_t first_page, size_t num_pages) {
+    std::vector<size_t> pages(num_pages);
+    std::iota(pages.begin(), pages.end(), first_page);
+    std::ranges::shuffle(pages, std::mt19937{0x70616765});
+    return pages;
+}
+} // Anonymous namespace
+
+TEST_CASE("Memory: Block accesses across fragmented pages", "[core]") {
+    constexpr size_t NUM_PAGES = 64;
+    MappedMemory mapped;
+    const std::vector<size_t> physical_pages = FragmentedPages(0, NUM_PAGES);
+    mapped.Map(BASE_ADDRESS, physical_pages);
+
+    std::mt19937 rng{0x626c6b};
+    std::vector<u8> expected(NUM_PAGES * SUYU_PAGESIZE);
+    std::ranges::generate(expected, [&rng] { return static_cast<u8>(rng()); });
+    for (size_t page = 0; page < NUM_PAGES; ++page) {
+        std::memcpy(mapped.Backing(physical_pages[page]), expected.data() + page * SUYU_PAGESIZE,
+                    SUYU_PAGESIZE);
+    }
+
+    constexpr size_t OFFSET = 0x123;
+    std::vector<u8> result(expected.size() - 2 * OFFSET);
+    REQUIRE(mapped.memory.ReadBlock(BASE_ADDRESS + OFFSET, result.data(), result.size()));
+    REQUIRE(std::equal(result.begin(), result.end(), expected.begin() + OFFSET));
+
+    std::ranges::generate(result, [&rng] { return static_cast<u8>(rng()); });
+    REQUIRE(mapped.memory.WriteBlock(BASE_ADDRESS + OFFSET, result.data(), result.size()));
+    std::ranges::copy(result, expected.begin() + OFFSET);
+    for (size_t page = 0; page < NUM_PAGES; ++page) {
+        REQUIRE(std::memcmp(mapped.Backing(physical_pages[page]),
+                            expected.data() + page * SUYU_PAGESIZE, SUYU_PAGESIZE) == 0);
+    }
+}
+
+TEST_CASE("Memory: Block copy throughput", "[.][benchmark][core]") {
+    constexpr size_t MAX_TRANSFER_SIZE = 64_MiB;
+    constexpr size_t NUM_PAGES = MAX_TRANSFER_SIZE / SUYU_PAGESIZE;
+    constexpr u64 FRAGMENTED_ADDRESS = BASE_ADDRESS + MAX_TRANSFER_SIZE;
+    MappedMemory mapped;
+    mapped.Map(BASE_ADDRESS, 0, NUM_PAGES);
+    mapped.Map(FRAGMENTED_ADDRESS, FragmentedPages(NUM_PAGES, NUM_PAGES));
+
+    std::vector<u8> buffer(MAX_TRANSFER_SIZE);
+    auto& memory = mapped.memory;
+    for (size_t size = 4_KiB; size <= MAX_TRANSFER_SIZE; size *= 4) {
+        const std::string size_name = std::to_string(size / 1_KiB) + " KiB";
+        BENCHMARK("ReadBlock " + size_name) {
+            return memory.ReadBlock(BASE_ADDRESS, buffer.data(), size);
+        };
+        BENCHMARK("ReadBlock fragmented " + size_name) {
+            return memory.ReadBlock(FRAGMENTED_ADDRESS, buffer.data(), size);
+        };
+        BENCHMARK("WriteBlock " + size_name) {
+            return memory.WriteBlock(BASE_ADDRESS, buffer.data(), size);
+        };
+        BENCHMARK("WriteBlock fragmented " + size_name) {
+            return memory.WriteBlock(FRAGMENTED_ADDRESS, buffer.data(), size);
+        };
+    }
+}
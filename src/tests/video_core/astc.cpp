@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/div_ceil.h"
+#include "video_core/textures/astc.h"
+
+namespace {
+struct Footprint {
+    u32 width;
+    u32 height;
+};
+
+// Every 2D block footprint supported by the Tegra X1
+constexpr std::array<Footprint, 14> FOOTPRINTS{{
+    {4, 4},
+    {5, 4},
+    {5, 5},
+    {6, 5},
+    {6, 6},
+    {8, 5},
+    {8, 6},
+    {8, 8},
+    {10, 5},
+    {10, 6},
+    {10, 8},
+    {10, 10},
+    {12, 10},
+    {12, 12},
+}};
+
+constexpr std::array<u32, 10> LDR_ENDPOINT_MODES{0, 1, 4, 5, 6, 8, 9, 10, 12, 13};
+
+void WriteBits(std::span<u8, 16> block, u32 offset, u32 num_bits, u32 value) {
+    for (u32 bit = 0; bit < num_bits; ++bit) {
+        const u32 position = offset + bit;
+        const u8 mask = static_cast<u8>(1U << (position % 8));
+        if ((value >> bit) & 1) {
+            block[position / 8] |= mask;
+        } else {
+            block[position / 8] &= static_cast<u8>(~mask);
+        }
+    }
+}
+
+/**
+ * Builds a valid LDR block with random endpoints and weights. The weight grid, weight range,
+ * partition count, dual plane usage and endpoint modes are picked at random to exercise the
+ * same decoding paths a real texture does.
+ */
+void MakeBlock(std::mt19937& rng, Footprint footprint, std::span<u8, 16> block) {
+    for (u8& value : block) {
+        value = static_cast<u8>(rng());
+    }
+    // Block mode layout with a (B + 4) x (A + 2) weight grid and a bit based weight range
+    const u32 grid_width = 4 + rng() % (std::min(footprint.width, 7U) - 3);
+    const u32 grid_height = 2 + rng() % (std::min(footprint.height, 5U) - 1);
+    const u32 num_partitions = 1 + rng() % 2;
+    const bool dual_plane = grid_width * grid_height * 2 <= 48 && (rng() % 4) == 0;
+    const u32 num_weights = grid_width * grid_height * (dual_plane ? 2 : 1);
+    const u32 weight_bits = std::clamp(48 / num_weights, 1U, 3U);
+
+    // R is a three bit value, ranges 2, 4 and 7 encode weights with 1, 2 and 3 bits
+    static constexpr std::array<u32, 4> WEIGHT_RANGES{0, 2, 4, 7};
+    const u32 range = WEIGHT_RANGES[weight_bits];
+    u32 mode = (range >> 1) & 3;
+    mode |= (range & 1) << 4;
+    mode |= (grid_height - 2) << 5;
+    mode |= (grid_width - 4) << 7;
+    mode |= (dual_plane ? 1U : 0U) << 10;
+    WriteBits(block, 0, 11, mode);
+    WriteBits(block, 11, 2, num_partitions - 1);
+
+    const u32 endpoint_mode = LDR_ENDPOINT_MODES[rng() % LDR_ENDPOINT_MODES.size()];
+    if (num_partitions == 1) {
+        WriteBits(block, 13, 4, endpoint_mode);
+    } else {
+        // Keep the random partition index and share the endpoint mode between partitions
+        WriteBits(block, 23, 6, endpoint_mode << 2);
+    }
+}
+
+std::vector<u8> MakeTexture(Footprint footprint, u32 width, u32 height, u32 depth) {
+    std::mt19937 rng(footprint.width * 16 + footprint.height);
+    const u32 num_blocks = Common::DivCeil(width, footprint.width) *
+                           Common::DivCeil(height, footprint.height) * depth;
+    std::vector<u8> data(num_blocks * 16);
+    for (u32 block = 0; block < num_blocks; ++block) {
+        MakeBlock(rng, footprint, std::span<u8, 16>(data.data() + block * 16, 16));
+    }
+    return data;
+}
+
+/// Replaces every third block with a constant color LDR void extent block
+void AddVoidExtentBlocks(std::vector<u8>& data) {
+    std::mt19937 rng(static_cast<u32>(data.size()));
+    for (size_t offset = 0; offset < data.size(); offset += 16 * 3) {
+        const std::span<u8, 16> block(data.data() + offset, 16);
+        WriteBits(block, 0, 12, 0xdfc);
+        WriteBits(block, 12, 26, 0x3ffffff);
+        WriteBits(block, 38, 26, 0x3ffffff);
+        for (u32 channel = 0; channel < 4; ++channel) {
+            WriteBits(block, 64 + channel * 16, 16, static_cast<u16>(rng()));
+        }
+    }
+}
+
+/// 64-bit FNV-1a hash of decoded pixels
+u64 Digest(std::span<const u8> data) {
+    u64 hash = 0xcbf29ce484222325ULL;
+    for (const u8 value : data) {
+        hash = (hash ^ value) * 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+std::string FootprintName(Footprint footprint, u32 width, u32 height, u32 depth) {
+    return std::to_string(footprint.width) + "x" + std::to_string(footprint.height) + " " +
+           std::to_string(width) + "x" + std::to_string(height) + "x" + std::to_string(depth);
+}
+} // Anonymous namespace
+
+TEST_CASE("ASTC: Layered decompression matches per slice decompression", "[video_core]") {
+    // Sizes that are not aligned to the footprint exercise the partial blocks on the edges
+    constexpr u32 width = 37;
+    constexpr u32 height = 23;
+    constexpr u32 depth = 3;
+    for (const Footprint footprint : FOOTPRINTS) {
+        const auto data = MakeTexture(footprint, width, height, depth);
+        std::vector<u8> layered(width * height * depth * 4);
+        Tegra::Texture::ASTC::Decompress(data, width, height, depth, footprint.width,
+                                         footprint.height, layered);
+
+        const size_t slice_data_size = data.size() / depth;
+        const size_t slice_size = width * height * 4;
+        for (u32 slice = 0; slice < depth; ++slice) {
+            std::vector<u8> output(slice_size);
+            Tegra::Texture::ASTC::Decompress(
+                std::span(data).subspan(slice * slice_data_size, slice_data_size), width, height,
+                1, footprint.width, footprint.height, output);
+            REQUIRE(std::equal(output.begin(), output.end(),
+                               layered.begin() + slice * slice_size));
+        }
+    }
+}
+
+TEST_CASE("ASTC: Decompression matches the previous decoder", "[video_core]") {
+    // Digests of the output of the decoder before it was split into per block jobs
+    struct Expected {
+        u64 valid_blocks;
+        u64 void_extent_blocks;
+    };
+    constexpr std::array<Expected, FOOTPRINTS.size()> EXPECTED{{
+        {0xfbbec8dab10dc99aULL, 0x028a5dfd566e3073ULL},
+        {0x2ea57aba1e1900dfULL, 0xdef379a436bb5ed0ULL},
+        {0xe531dfa89aef0453ULL, 0x006233c83667b272ULL},
+        {0xb58fc96cc4f14cedULL, 0xf55e0d697408f82cULL},
+        {0x8d8f3a4c8c88fb1bULL, 0xc497757d780097bbULL},
+        {0xdfcc9db32be986abULL, 0x6346b865c47b7ad1ULL},
+        {0xec5d68c9c220b794ULL, 0x7d201871f56bc503ULL},
+        {0xe90e383a4a47cee4ULL, 0xdb192fc641da14deULL},
+        {0xf78d89fe92d9c571ULL, 0xb967992e4e12bf1fULL},
+        {0xace49cccaf3b1331ULL, 0x6dd57df3ad8f6642ULL},
+        {0xc7433b7b811fa567ULL, 0x45703e2d4d83e28eULL},
+        {0x1f4c3cad9fb16dbfULL, 0x4f064263066a9b72ULL},
+        {0x098c30872becb24eULL, 0x227ead7bf466c63eULL},
+        {0x6902595a5469eb13ULL, 0xb5fac741ad1405ceULL},
+    }};
+    constexpr u32 width = 37;
+    constexpr u32 height = 23;
+    constexpr u32 depth = 2;
+    for (size_t i = 0; i < FOOTPRINTS.size(); ++i) {
+        const Footprint footprint = FOOTPRINTS[i];
+        INFO(FootprintName(footprint, width, height, depth));
+        std::vector<u8> output(width * height * depth * 4);
+
+        std::vector<u8> data = MakeTexture(footprint, width, height, depth);
+        Tegra::Texture::ASTC::Decompress(data, width, height, depth, footprint.width,
+                                         footprint.height, output);
+        CHECK(Digest(output) == EXPECTED[i].valid_blocks);
+
+        AddVoidExtentBlocks(data);
+        Tegra::Texture::ASTC::Decompress(data, width, height, depth, footprint.width,
+                                         footprint.height, output);
+        CHECK(Digest(output) == EXPECTED[i].void_extent_blocks);
+    }
+}
+
+TEST_CASE("ASTC: Decompress benchmark", "[.][benchmark][video_core]") {
+    for (const Footprint footprint : FOOTPRINTS) {
+        for (const auto [width, height, depth] :
+             {std::array<u32, 3>{1024, 1024, 1}, std::array<u32, 3>{256, 256, 16}}) {
+            const auto data = MakeTexture(footprint, width, height, depth);
+            std::vector<u8> output(width * height * depth * 4);
+            BENCHMARK(FootprintName(footprint, width, height, depth)) {
+                Tegra::Texture::ASTC::Decompress(data, width, height, depth, footprint.width,
+                                                 footprint.height, output);
+                return output[0];
+            };
+        }
+    }
+}
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/frontend/graphics_context.h"
+#include "video_core/control/channel_state.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/pushbuffer_capture.h"
+#include "video_core/pushbuffer_replayer.h"
+
+namespace {
+using Tegra::CommandHeader;
+using Tegra::CommandList;
+using Tegra::CommandListHeader;
+using Tegra::SubmissionMode;
+using Tegra::Engines::Maxwell3D;
+
+constexpr u32 AS_ID = 1;
+constexpr s32 CHANNEL = 1;
+constexpr GPUVAddr PUSHBUFFER_ADDR = 0x1'0000'0000;
+constexpr u64 PUSHBUFFER_SIZE = 0x100000;
+constexpr DAddr PUSHBUFFER_DEV_ADDR = 0x8000'0000;
+
+// Registers without side effects, so that method runs are only stored
+constexpr u32 SCRATCH_METHOD = MAXWELL3D_REG_INDEX(shadow_scratch);
+
+void AppendMethods(std::vector<u32>& words, SubmissionMode mode, u32 method,
+                   const std::vector<u32>& arguments) {
+    CommandHeader header{};
+    header.method.Assign(method);
+    header.method_count.Assign(static_cast<u32>(arguments.size()));
+    header.mode.Assign(mode);
+    words.push_back(header.argument);
+    words.insert(words.end(), arguments.begin(), arguments.end());
+}
+
+/// Window for the null renderer, which doesn't present anything
+class NullEmuWindow final : public Core::Frontend::EmuWindow {
+public:
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override {
+        return std::make_unique<Core::Frontend::GraphicsContext>();
+    }
+
+    bool IsShown() const override {
+        return false;
+    }
+};
+
+/// Synchronous GPU using the null renderer, with a channel bound to the 3D engine
+class GpuChannel {
+public:
+    GpuChannel()
+        : renderer_backend{Settings::values.renderer_backend.GetValue()},
+          use_asynchronous_gpu{Settings::values.use_asynchronous_gpu_emulation.GetValue()} {
+        Settings::values.renderer_backend.SetValue(Settings::RendererBackend::Null);
+        Settings::values.use_asynchronous_gpu_emulation.SetValue(false);
+        system.Initialize();
+        REQUIRE(system.InitializeGPU(emu_window) == Core::SystemResultStatus::Success);
+
+        target = std::make_unique<Tegra::Capture::GpuReplayTarget>(system);
+        target->CreateAddressSpace(Tegra::Capture::AddressSpaceRecord{
+            .as_id = AS_ID,
+            .address_space_bits = 40,
+            .big_page_bits = 16,
+            .page_bits = 12,
+            .split_address = 1ULL << 34,
+        });
+        target->Map(Tegra::Capture::MapRecord{
+            .as_id = AS_ID,
+            .kind = 0,
+            .gpu_addr = PUSHBUFFER_ADDR,
+            .dev_addr = PUSHBUFFER_DEV_ADDR,
+            .size = PUSHBUFFER_SIZE,
+            .is_big_pages = 1,
+            .reserved = 0,
+        });
+        std::vector<u32> bind;
+        AppendMethods(bind, SubmissionMode::Increasing,
+                      static_cast<u32>(Tegra::BufferMethods::BindObject),
+                      {static_cast<u32>(Tegra::EngineID::MAXWELL_B)});
+        Dispatch(std::vector<std::vector<u32>>{bind});
+    }
+
+    ~GpuChannel() {
+        Settings::values.renderer_backend.SetValue(renderer_backend);
+        Settings::values.use_asynchronous_gpu_emulation.SetValue(use_asynchronous_gpu);
+    }
+
+    /// Writes each segment right after the previous one, returning the command list to run them
+    CommandList Write(const std::vector<std::vector<u32>>& segments) {
+        CommandList command_list;
+        GPUVAddr gpu_addr = PUSHBUFFER_ADDR;
+        for (const std::vector<u32>& words : segments) {
+            const size_t size = words.size() * sizeof(u32);
+            REQUIRE(gpu_addr + size <= PUSHBUFFER_ADDR + PUSHBUFFER_SIZE);
+            target->WriteMemory(AS_ID, gpu_addr,
+                                std::span{reinterpret_cast<const u8*>(words.data()), size});
+            CommandListHeader header{};
+            header.addr.Assign(gpu_addr);
+            header.size.Assign(words.size());
+            command_list.command_lists.push_back(header);
+            gpu_addr += size;
+        }
+        return command_list;
+    }
+
+    /// Pushes a copy of the command list and executes it with DmaPusher::DispatchCalls
+    void Dispatch(const CommandList& command_list) {
+        target->Submit(CHANNEL, AS_ID, CommandList{command_list});
+    }
+
+    void Dispatch(const std::vector<std::vector<u32>>& segments) {
+        Dispatch(Write(segments));
+    }
+
+    [[nodiscard]] Maxwell3D& Engine() {
+        return *target->GetChannel(CHANNEL)->maxwell_3d;
+    }
+
+private:
+    NullEmuWindow emu_window;
+    Core::System system;
+    std::unique_ptr<Tegra::Capture::GpuReplayTarget> target;
+    Settings::RendererBackend renderer_backend;
+    bool use_asynchronous_gpu;
+};
+} // Anonymous namespace
+
+TEST_CASE("DmaPusher: Method runs reach the engine registers", "[video_core]") {
+    GpuChannel channel;
+
+    // The increasing run is split across both segments
+    std::vector<u32> first;
+    AppendMethods(first, SubmissionMode::Increasing, SCRATCH_METHOD, {1, 2, 3, 4, 5, 6});
+    std::vector<u32> second(first.end() - 3, first.end());
+    first.resize(first.size() - 3);
+    AppendMethods(second, SubmissionMode::NonIncreasing, SCRATCH_METHOD + 16, {7, 8, 9});
+    AppendMethods(second, SubmissionMode::IncreaseOnce, SCRATCH_METHOD + 32, {10, 11, 12});
+    channel.Dispatch(std::vector<std::vector<u32>>{first, second});
+
+    // Plain register writes stay queued until the engine executes a method
+    Maxwell3D& maxwell_3d = channel.Engine();
+    maxwell_3d.ConsumeSink();
+    const auto& scratch = maxwell_3d.regs.shadow_scratch;
+    for (u32 index = 0; index < 6; ++index) {
+        REQUIRE(scratch[index] == index + 1);
+    }
+    REQUIRE(scratch[16] == 9);
+    REQUIRE(scratch[17] == 0);
+    REQUIRE(scratch[32] == 10);
+    REQUIRE(scratch[33] == 12);
+}
+
+TEST_CASE("DmaPusher: Dispatch throughput", "[.][benchmark][video_core]") {
+    // Draw-heavy submissions: command lists made of short method runs
+    constexpr size_t NUM_LISTS = 16;
+    constexpr size_t RUNS_PER_LIST = 256;
+    GpuChannel channel;
+
+    const auto benchmark = [&](const std::string& name, SubmissionMode mode) {
+        std::vector<u32> words;
+        for (u32 run = 0; run < RUNS_PER_LIST; ++run) {
+            const std::vector<u32> arguments(1 + run % 8, run);
+            AppendMethods(words, mode, SCRATCH_METHOD + (run % 32) * 8, arguments);
+        }
+        const u64 num_methods = (words.size() - RUNS_PER_LIST) * NUM_LISTS;
+        const CommandList command_list =
+            channel.Write(std::vector<std::vector<u32>>(NUM_LISTS, words));
+        BENCHMARK(name + ", " + std::to_string(num_methods) + " methods") {
+            channel.Dispatch(command_list);
+            // Apply the queued register writes, as the next draw would
+            Maxwell3D& maxwell_3d = channel.Engine();
+            maxwell_3d.ConsumeSink();
+            return maxwell_3d.regs.shadow_scratch[0];
+        };
+    };
+    benchmark("Increasing runs", SubmissionMode::Increasing);
+    benchmark("Non-increasing runs", SubmissionMode::NonIncreasing);
+    benchmark("Increase-once runs", SubmissionMode::IncreaseOnce);
+}
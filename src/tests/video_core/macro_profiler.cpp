@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/fs.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_profiler.h"
+
+namespace {
+using Tegra::Engines::Maxwell3D;
+using Tegra::MacroPattern;
+using Tegra::MacroProfiler;
+using Tegra::Macro::Opcode;
+using Tegra::Macro::Operation;
+using Tegra::Macro::ResultOperation;
+using namespace std::chrono_literals;
+
+std::filesystem::path ProfilePath() {
+    return std::filesystem::temp_directory_path() / "suyu_macro_profiler_test.txt";
+}
+
+u32 SetMethod(u32 method, u32 increment) {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(ResultOperation::MoveAndSetMethod);
+    opcode.immediate.Assign(static_cast<s32>(method | (increment << 12)));
+    return opcode.raw;
+}
+
+u32 FetchAndSend() {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(ResultOperation::FetchAndSend);
+    opcode.src_a.Assign(1);
+    return opcode.raw;
+}
+
+u32 Exit() {
+    Opcode opcode{};
+    opcode.operation.Assign(Operation::AddImmediate);
+    opcode.result_operation.Assign(ResultOperation::Move);
+    opcode.is_exit.Assign(1);
+    return opcode.raw;
+}
+
+std::vector<u32> ConstBufferStoreProgram() {
+    return {SetMethod(MAXWELL3D_REG_INDEX(const_buffer.offset), 1), FetchAndSend(),
+            FetchAndSend(), FetchAndSend(), Exit(), FetchAndSend()};
+}
+
+std::vector<u32> DrawProgram() {
+    return {SetMethod(MAXWELL3D_REG_INDEX(draw.begin), 0), FetchAndSend(),
+            SetMethod(MAXWELL3D_REG_INDEX(draw.end), 0), Exit(), FetchAndSend()};
+}
+} // Anonymous namespace
+
+TEST_CASE("MacroProfiler: Classifies programs", "[video_core]") {
+    REQUIRE(Tegra::AnalyzeMacro(ConstBufferStoreProgram()) == MacroPattern::ConstBufferStore);
+    REQUIRE(Tegra::AnalyzeMacro(DrawProgram()) == MacroPattern::Draw);
+
+    // Methods with an address computed at runtime can't be classified
+    std::vector<u32> dynamic_program = ConstBufferStoreProgram();
+    Opcode set_method{dynamic_program[0]};
+    set_method.src_a.Assign(1);
+    dynamic_program[0] = set_method.raw;
+    REQUIRE(Tegra::AnalyzeMacro(dynamic_program) == MacroPattern::Unknown);
+}
+
+TEST_CASE("MacroProfiler: Profiles accumulate across sessions", "[video_core]") {
+    const auto path = ProfilePath();
+    (void)Common::FS::RemoveFile(path);
+    {
+        MacroProfiler profiler{path};
+        profiler.AddProgram(1, ConstBufferStoreProgram(), false);
+        profiler.AddProgram(2, DrawProgram(), true);
+        for (int i = 0; i < 600; ++i) {
+            profiler.Record(1, 10us);
+            profiler.Record(2, 20us);
+        }
+        // Not enough invocations yet
+        REQUIRE(profiler.FindHLECandidates().empty());
+    }
+    {
+        MacroProfiler profiler{path};
+        const auto& entries = profiler.Entries();
+        REQUIRE(entries.size() == 2);
+        REQUIRE(entries.at(1).invocations == 600);
+        REQUIRE(entries.at(1).total_time == 6ms);
+        REQUIRE(entries.at(1).size == ConstBufferStoreProgram().size());
+        REQUIRE(entries.at(1).pattern == MacroPattern::ConstBufferStore);
+        REQUIRE(entries.at(2).has_hle_program);
+
+        for (int i = 0; i < 600; ++i) {
+            profiler.Record(1, 10us);
+        }
+        // Macros that already have a HLE implementation are never candidates
+        const auto candidates = profiler.FindHLECandidates();
+        REQUIRE(candidates.size() == 1);
+        REQUIRE(candidates[0].first == 1);
+        REQUIRE(candidates[0].second.invocations == 1200);
+    }
+    (void)Common::FS::RemoveFile(path);
+}
@@ -0,0 +1,188 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "video_core/pipeline_cache_file.h"
+
+namespace {
+using VideoCommon::PipelineCacheEntry;
+using VideoCommon::PipelineCacheReader;
+using VideoCommon::PipelineCacheStatus;
+
+constexpr u32 CACHE_VERSION = 7;
+
+std::filesystem::path CachePath() {
+    return std::filesystem::temp_directory_path() / "suyu_pipeline_cache_test.bin";
+}
+
+std::vector<u8> MakeData(size_t size, u8 seed) {
+    std::vector<u8> data(size);
+    std::iota(data.begin(), data.end(), seed);
+    return data;
+}
+
+std::vector<u64> KeyHashes(const PipelineCacheReader& reader) {
+    std::vector<u64> key_hashes;
+    for (const PipelineCacheEntry& entry : reader.Entries()) {
+        key_hashes.push_back(entry.key_hash);
+    }
+    return key_hashes;
+}
+} // Anonymous namespace
+
+TEST_CASE("PipelineCacheFile: Entries round trip through the index", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    const std::vector<u8> first = MakeData(4096, 1);
+    const std::vector<u8> second = MakeData(100, 2);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 1, first);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 2, second);
+
+    PipelineCacheReader reader;
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(!reader.HasIndex());
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{1, 2});
+    // Repeated data has to compress
+    REQUIRE(reader.Entries()[0].compressed_size < first.size());
+    REQUIRE(reader.Decompress(reader.Entries()[0]) == first);
+    REQUIRE(reader.Decompress(reader.Entries()[1]) == second);
+
+    const std::vector<PipelineCacheEntry> entries(reader.Entries().begin(),
+                                                  reader.Entries().end());
+    const u64 data_end = reader.DataEnd();
+    reader.Close();
+    REQUIRE(VideoCommon::WritePipelineCacheIndex(path, data_end, entries));
+
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(reader.HasIndex());
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{1, 2});
+    REQUIRE(reader.Decompress(reader.Entries()[1]) == second);
+    reader.Close();
+
+    // Appending replaces the index, it is rebuilt by scanning the entries
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 3, second);
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(!reader.HasIndex());
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{1, 2, 3});
+    reader.Close();
+
+    REQUIRE(reader.Open(path, CACHE_VERSION + 1) == PipelineCacheStatus::OldVersion);
+    reader.Close();
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PipelineCacheFile: Truncated appends are discarded", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    const std::vector<u8> data = MakeData(512, 3);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 1, data);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 2, data);
+    {
+        // Simulate a crash in the middle of writing the second entry
+        const Common::FS::IOFile file(path, Common::FS::FileAccessMode::ReadWrite);
+        REQUIRE(file.SetSize(file.GetSize() - 4));
+    }
+    PipelineCacheReader reader;
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{1});
+
+    const std::vector<PipelineCacheEntry> entries(reader.Entries().begin(),
+                                                  reader.Entries().end());
+    const u64 data_end = reader.DataEnd();
+    reader.Close();
+    REQUIRE(VideoCommon::WritePipelineCacheIndex(path, data_end, entries));
+
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 3, data);
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{1, 3});
+    REQUIRE(reader.Decompress(reader.Entries()[1]) == data);
+    reader.Close();
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PipelineCacheFile: Compaction drops duplicated and corrupted entries", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    const std::vector<u8> first = MakeData(256, 1);
+    const std::vector<u8> second = MakeData(256, 2);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 1, first);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 2, second);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 1, second);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 3, first);
+    VideoCommon::AppendPipelineCacheEntry(path, CACHE_VERSION, 2, first);
+
+    PipelineCacheReader reader;
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    const u64 corrupted_offset = reader.Entries()[4].offset;
+    reader.Close();
+    {
+        // Flip a byte of the compressed data of the last entry
+        const Common::FS::IOFile file(path, Common::FS::FileAccessMode::ReadWrite);
+        u8 value{};
+        REQUIRE(file.Seek(static_cast<s64>(corrupted_offset)));
+        REQUIRE(file.ReadObject(value));
+        value ^= 0xff;
+        REQUIRE(file.Seek(static_cast<s64>(corrupted_offset)));
+        REQUIRE(file.WriteObject(value));
+    }
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(reader.Decompress(reader.Entries()[4]).empty());
+
+    // The newest copy that passes its checksum is the one loaded and kept
+    const auto copies = VideoCommon::GroupPipelineCacheCopies(reader.Entries());
+    REQUIRE(copies.size() == 3);
+    REQUIRE(std::ranges::equal(copies[0], std::array<size_t, 2>{2, 0}));
+    REQUIRE(std::ranges::equal(copies[1], std::array<size_t, 1>{3}));
+    REQUIRE(std::ranges::equal(copies[2], std::array<size_t, 2>{4, 1}));
+    reader.Close();
+
+    REQUIRE(VideoCommon::CompactPipelineCache(path, CACHE_VERSION));
+    REQUIRE(!Common::FS::Exists(std::filesystem::path{path} += ".tmp"));
+
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Ok);
+    REQUIRE(reader.HasIndex());
+    REQUIRE(KeyHashes(reader) == std::vector<u64>{2, 1, 3});
+    REQUIRE(reader.Decompress(reader.Entries()[0]) == second);
+    REQUIRE(reader.Decompress(reader.Entries()[1]) == second);
+    REQUIRE(reader.Decompress(reader.Entries()[2]) == first);
+    reader.Close();
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PipelineCacheFile: Legacy and foreign files are detected", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    PipelineCacheReader reader;
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::NotFound);
+    {
+        const Common::FS::IOFile file(path, Common::FS::FileAccessMode::Write);
+        const std::array<char, 8> magic{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
+        REQUIRE(file.WriteObject(magic));
+        REQUIRE(file.WriteObject(CACHE_VERSION));
+    }
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Legacy);
+    REQUIRE(reader.Open(path, CACHE_VERSION + 1) == PipelineCacheStatus::OldVersion);
+    reader.Close();
+    {
+        const Common::FS::IOFile file(path, Common::FS::FileAccessMode::Write);
+        REQUIRE(file.WriteObject(u64{0x1234}));
+        REQUIRE(file.WriteObject(u64{0x5678}));
+    }
+    REQUIRE(reader.Open(path, CACHE_VERSION) == PipelineCacheStatus::Invalid);
+    reader.Close();
+    (void)Common::FS::RemoveFile(path);
+}
@@ -0,0 +1,433 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/settings.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/frontend/graphics_context.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/engines/puller.h"
+#include "video_core/memory_manager.h"
+#include "video_core/pushbuffer_capture.h"
+#include "video_core/pushbuffer_replayer.h"
+
+namespace {
+using namespace Tegra::Capture;
+using Tegra::CommandHeader;
+using Tegra::CommandList;
+using Tegra::CommandListHeader;
+using Tegra::SubmissionMode;
+using Tegra::Engines::Maxwell3D;
+
+constexpr u32 AS_ID = 3;
+constexpr s32 CHANNEL = 1;
+constexpr GPUVAddr PUSHBUFFER_ADDR = 0x1'0000'0000;
+constexpr u64 PUSHBUFFER_SIZE = 0x20000;
+constexpr DAddr PUSHBUFFER_DEV_ADDR = 0x8000'0000;
+
+// Registers without side effects, so that method runs are only stored
+constexpr u32 SCRATCH_METHOD = MAXWELL3D_REG_INDEX(shadow_scratch);
+// Semaphore operation of the puller that writes the payload and a timestamp
+constexpr u32 SEMAPHORE_WRITE_LONG = 0x2;
+
+std::filesystem::path CapturePath() {
+    return std::filesystem::temp_directory_path() / "suyu_pushbuffer_capture_test.pbcap";
+}
+
+std::vector<u8> MakeCaptureHeader() {
+    const FileHeader header{
+        .magic_number = MAGIC_NUMBER,
+        .version = CAPTURE_VERSION,
+        .reserved = 0,
+    };
+    std::vector<u8> capture(sizeof(header));
+    std::memcpy(capture.data(), &header, sizeof(header));
+    return capture;
+}
+
+/// Builds an increasing method run with the given arguments
+void AppendMethods(std::vector<u32>& words, u32 method, std::initializer_list<u32> arguments) {
+    CommandHeader header{};
+    header.method.Assign(method);
+    header.method_count.Assign(static_cast<u32>(arguments.size()));
+    header.mode.Assign(SubmissionMode::Increasing);
+    words.push_back(header.argument);
+    words.insert(words.end(), arguments);
+}
+
+/// Builds an increasing method run of num_arguments words
+void AppendMethods(std::vector<u32>& words, u32 method, u32 num_arguments) {
+    CommandHeader header{};
+    header.method.Assign(method);
+    header.method_count.Assign(num_arguments);
+    header.mode.Assign(SubmissionMode::Increasing);
+    words.push_back(header.argument);
+    for (u32 argument = 0; argument < num_arguments; ++argument) {
+        words.push_back(argument);
+    }
+}
+
+/// Appends an address space with the pushbuffer mapped in it
+void AppendLayout(std::vector<u8>& capture) {
+    AppendRecord(capture, RecordType::AddressSpace,
+                 AddressSpaceRecord{
+                     .as_id = AS_ID,
+                     .address_space_bits = 40,
+                     .big_page_bits = 16,
+                     .page_bits = 12,
+                     .split_address = 1ULL << 34,
+                 });
+    AppendRecord(capture, RecordType::Map,
+                 MapRecord{
+                     .as_id = AS_ID,
+                     .kind = 0,
+                     .gpu_addr = PUSHBUFFER_ADDR,
+                     .dev_addr = PUSHBUFFER_DEV_ADDR,
+                     .size = PUSHBUFFER_SIZE,
+                     .is_big_pages = 1,
+                     .reserved = 0,
+                 });
+}
+
+/// Builds the binding of the 3D engine to subchannel 0
+std::vector<u32> BindMaxwell3D() {
+    std::vector<u32> words;
+    AppendMethods(words, static_cast<u32>(Tegra::BufferMethods::BindObject),
+                  {static_cast<u32>(Tegra::EngineID::MAXWELL_B)});
+    return words;
+}
+
+/// Appends a submission of command lists, each one placed right after the previous one
+void AppendSubmit(std::vector<u8>& capture, std::span<const std::vector<u32>> segments) {
+    std::vector<u8> data;
+    GPUVAddr gpu_addr = PUSHBUFFER_ADDR;
+    for (const std::vector<u32>& words : segments) {
+        CommandListHeader header{};
+        header.addr.Assign(gpu_addr);
+        header.size.Assign(words.size());
+        const size_t offset = data.size();
+        data.resize(offset + sizeof(header) + words.size() * sizeof(u32));
+        std::memcpy(data.data() + offset, &header, sizeof(header));
+        std::memcpy(data.data() + offset + sizeof(header), words.data(),
+                    words.size() * sizeof(u32));
+        gpu_addr += words.size() * sizeof(u32);
+    }
+    const SubmitRecord record{
+        .channel = CHANNEL,
+        .as_id = AS_ID,
+        .num_entries = static_cast<u32>(segments.size()),
+        .is_prefetch = 0,
+    };
+    AppendRecord(capture, RecordType::Submit, record, data);
+}
+
+void WriteCapture(const std::filesystem::path& path, std::span<const u8> capture) {
+    const Common::FS::IOFile file(path, Common::FS::FileAccessMode::Write);
+    REQUIRE(file.WriteSpan(capture) == capture.size());
+}
+
+/// Window for the null renderer, which doesn't present anything
+class NullEmuWindow final : public Core::Frontend::EmuWindow {
+public:
+    std::unique_ptr<Core::Frontend::GraphicsContext> CreateSharedContext() const override {
+        return std::make_unique<Core::Frontend::GraphicsContext>();
+    }
+
+    bool IsShown() const override {
+        return false;
+    }
+};
+
+/// System with a synchronous GPU using the null renderer, and nothing else
+class GpuSystem {
+public:
+    GpuSystem()
+        : renderer_backend{Settings::values.renderer_backend.GetValue()},
+          use_asynchronous_gpu{Settings::values.use_asynchronous_gpu_emulation.GetValue()} {
+        Settings::values.renderer_backend.SetValue(Settings::RendererBackend::Null);
+        Settings::values.use_asynchronous_gpu_emulation.SetValue(false);
+        system.Initialize();
+        REQUIRE(system.InitializeGPU(emu_window) == Core::SystemResultStatus::Success);
+    }
+
+    ~GpuSystem() {
+        Settings::values.renderer_backend.SetValue(renderer_backend);
+        Settings::values.use_asynchronous_gpu_emulation.SetValue(use_asynchronous_gpu);
+    }
+
+    NullEmuWindow emu_window;
+    Core::System system;
+
+private:
+    Settings::RendererBackend renderer_backend;
+    bool use_asynchronous_gpu;
+};
+
+class RecordingTarget final : public ReplayTarget {
+public:
+    void CreateAddressSpace(const AddressSpaceRecord& record) override {
+        address_spaces.push_back(record.as_id);
+    }
+
+    void Map(const MapRecord& record) override {
+        mapped_size += record.size;
+    }
+
+    void MapSparse(const MapSparseRecord& record) override {
+        sparse_size += record.size;
+    }
+
+    void Unmap(const UnmapRecord& record) override {
+        mapped_size -= record.size;
+    }
+
+    void WriteMemory(u32 as_id, GPUVAddr gpu_addr, std::span<const u8> data) override {
+        writes.push_back(gpu_addr);
+        written_bytes.insert(written_bytes.end(), data.begin(), data.end());
+    }
+
+    void Submit(s32 channel, u32 as_id, CommandList&& command_list) override {
+        submitted_lists.push_back(command_list.command_lists.size());
+        prefetched_words += command_list.prefetch_command_list.size();
+    }
+
+    void EndFrame() override {
+        ++frames;
+    }
+
+    std::vector<u32> address_spaces;
+    u64 mapped_size = 0;
+    u64 sparse_size = 0;
+    std::vector<GPUVAddr> writes;
+    std::vector<u8> written_bytes;
+    std::vector<size_t> submitted_lists;
+    size_t prefetched_words = 0;
+    u64 frames = 0;
+};
+
+/// Discards every event, to measure the cost of decoding a capture
+class NullTarget final : public ReplayTarget {
+public:
+    void CreateAddressSpace(const AddressSpaceRecord&) override {}
+    void Map(const MapRecord&) override {}
+    void MapSparse(const MapSparseRecord&) override {}
+    void Unmap(const UnmapRecord&) override {}
+    void WriteMemory(u32, GPUVAddr, std::span<const u8>) override {}
+    void Submit(s32, u32, CommandList&&) override {}
+    void EndFrame() override {}
+};
+} // Anonymous namespace
+
+TEST_CASE("PushbufferCapture: Records replay in order", "[video_core]") {
+    const auto path = CapturePath();
+    std::vector<u8> capture = MakeCaptureHeader();
+    AppendLayout(capture);
+    AppendRecord(capture, RecordType::MapSparse,
+                 MapSparseRecord{
+                     .as_id = AS_ID,
+                     .is_big_pages = 1,
+                     .gpu_addr = 0x2'0000'0000,
+                     .size = 0x10000,
+                 });
+
+    const std::vector<u8> snapshot(0x1000, 0xab);
+    const std::vector<u8> compressed =
+        Common::Compression::CompressDataZSTDDefault(snapshot.data(), snapshot.size());
+    AppendRecord(capture, RecordType::Memory,
+                 MemoryRecord{
+                     .as_id = AS_ID,
+                     .size = static_cast<u32>(snapshot.size()),
+                     .gpu_addr = PUSHBUFFER_ADDR + 0x10000,
+                 },
+                 compressed);
+
+    // The second method run is split across both command lists
+    std::vector<u32> first;
+    AppendMethods(first, 0x100, 4);
+    AppendMethods(first, 0x200, 6);
+    std::vector<u32> second(first.end() - 3, first.end());
+    first.resize(first.size() - 3);
+    AppendMethods(second, 0x300, 1);
+    const std::vector<std::vector<u32>> segments{first, second};
+    AppendSubmit(capture, segments);
+
+    CommandHeader inline_method{};
+    inline_method.mode.Assign(SubmissionMode::Inline);
+    AppendRecord(capture, RecordType::Submit,
+                 SubmitRecord{
+                     .channel = CHANNEL,
+                     .as_id = AS_ID,
+                     .num_entries = 1,
+                     .is_prefetch = 1,
+                 },
+                 std::span<const u8>{reinterpret_cast<const u8*>(&inline_method),
+                                     sizeof(inline_method)});
+    AppendRecord(capture, RecordType::Frame, FrameRecord{.frame = 7});
+    AppendRecord(capture, RecordType::Unmap,
+                 UnmapRecord{
+                     .as_id = AS_ID,
+                     .reserved = 0,
+                     .gpu_addr = PUSHBUFFER_ADDR,
+                     .size = PUSHBUFFER_SIZE,
+                 });
+    WriteCapture(path, capture);
+    {
+        CaptureReader reader;
+        REQUIRE(reader.Open(path));
+        RecordingTarget target;
+        const std::optional<ReplayStats> stats = Replay(reader, target);
+        REQUIRE(stats);
+        REQUIRE(stats->frames == 1);
+        REQUIRE(stats->submits == 2);
+        REQUIRE(stats->command_lists == 2);
+        REQUIRE(stats->methods == 4 + 6 + 1 + 1);
+        REQUIRE(stats->command_bytes == (first.size() + second.size() + 1) * sizeof(u32));
+        REQUIRE(stats->snapshot_bytes == snapshot.size());
+
+        REQUIRE(target.address_spaces == std::vector<u32>{AS_ID});
+        REQUIRE(target.mapped_size == 0);
+        REQUIRE(target.sparse_size == 0x10000);
+        REQUIRE(target.frames == 1);
+        REQUIRE(target.submitted_lists == std::vector<size_t>{2, 0});
+        REQUIRE(target.prefetched_words == 1);
+        // The snapshot is written first, then the words of each command list at their address
+        const GPUVAddr second_addr = PUSHBUFFER_ADDR + first.size() * sizeof(u32);
+        REQUIRE(target.writes ==
+                std::vector<GPUVAddr>{PUSHBUFFER_ADDR + 0x10000, PUSHBUFFER_ADDR, second_addr});
+        REQUIRE(std::equal(snapshot.begin(), snapshot.end(), target.written_bytes.begin()));
+
+        // Replaying again from the start gives the same results
+        reader.Rewind();
+        RecordingTarget second_target;
+        REQUIRE(Replay(reader, second_target)->methods == stats->methods);
+    }
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PushbufferCapture: Truncated and foreign files", "[video_core]") {
+    const auto path = CapturePath();
+    std::vector<u8> capture = MakeCaptureHeader();
+    AppendRecord(capture, RecordType::Frame, FrameRecord{.frame = 0});
+    AppendRecord(capture, RecordType::Frame, FrameRecord{.frame = 1});
+    // Simulate a capture interrupted while writing the last record
+    capture.resize(capture.size() - 1);
+    WriteCapture(path, capture);
+
+    {
+        CaptureReader reader;
+        REQUIRE(reader.Open(path));
+        RecordingTarget target;
+        const std::optional<ReplayStats> stats = Replay(reader, target);
+        REQUIRE(stats);
+        REQUIRE(stats->frames == 1);
+    }
+    capture[0] = 'y';
+    WriteCapture(path, capture);
+    {
+        CaptureReader reader;
+        REQUIRE(!reader.Open(path));
+    }
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PushbufferCapture: Replay on the GPU", "[video_core]") {
+    constexpr GPUVAddr SEMAPHORE_ADDR = PUSHBUFFER_ADDR + 0x10000;
+    constexpr u32 PAYLOAD = 0x12345678;
+    std::vector<u32> words = BindMaxwell3D();
+    AppendMethods(words, SCRATCH_METHOD, 8);
+    // Write the payload with the semaphore of the puller
+    AppendMethods(words, static_cast<u32>(Tegra::BufferMethods::SemaphoreAddressHigh),
+                  {static_cast<u32>(SEMAPHORE_ADDR >> 32), static_cast<u32>(SEMAPHORE_ADDR),
+                   PAYLOAD, SEMAPHORE_WRITE_LONG});
+
+    std::vector<u8> capture = MakeCaptureHeader();
+    AppendLayout(capture);
+    AppendSubmit(capture, std::vector<std::vector<u32>>{words});
+    AppendRecord(capture, RecordType::Frame, FrameRecord{.frame = 0});
+    const auto path = CapturePath();
+    WriteCapture(path, capture);
+    {
+        GpuSystem gpu_system;
+        CaptureReader reader;
+        REQUIRE(reader.Open(path));
+        GpuReplayTarget target{gpu_system.system};
+        const std::optional<ReplayStats> stats = Replay(reader, target);
+        REQUIRE(stats);
+        REQUIRE(stats->methods == 1 + 8 + 4);
+
+        Tegra::MemoryManager* const memory_manager = target.GetAddressSpace(AS_ID);
+        REQUIRE(memory_manager);
+        REQUIRE(memory_manager->Read<u32>(PUSHBUFFER_ADDR) == words[0]);
+        REQUIRE(memory_manager->Read<u32>(SEMAPHORE_ADDR) == PAYLOAD);
+    }
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("PushbufferCapture: Replay throughput", "[.][benchmark][video_core]") {
+    // Draw-heavy frames: many small command lists made of short increasing method runs
+    constexpr size_t NUM_FRAMES = 60;
+    constexpr size_t SUBMITS_PER_FRAME = 64;
+    constexpr size_t LISTS_PER_SUBMIT = 4;
+    constexpr size_t RUNS_PER_LIST = 256;
+    const auto path = CapturePath();
+
+    // The address space and the engine binding are replayed once, before the measured frames
+    GpuSystem gpu_system;
+    GpuReplayTarget gpu_target{gpu_system.system};
+    {
+        std::vector<u8> capture = MakeCaptureHeader();
+        AppendLayout(capture);
+        AppendSubmit(capture, std::vector<std::vector<u32>>{BindMaxwell3D()});
+        WriteCapture(path, capture);
+        CaptureReader reader;
+        REQUIRE(reader.Open(path));
+        REQUIRE(Replay(reader, gpu_target));
+    }
+
+    std::vector<u32> words;
+    for (size_t run = 0; run < RUNS_PER_LIST; ++run) {
+        AppendMethods(words, SCRATCH_METHOD + static_cast<u32>(run % 32) * 8, 1 + run % 8);
+    }
+    const std::vector<std::vector<u32>> segments(LISTS_PER_SUBMIT, words);
+    REQUIRE(segments.size() * words.size() * sizeof(u32) <= PUSHBUFFER_SIZE);
+    std::vector<u8> capture = MakeCaptureHeader();
+    for (size_t frame = 0; frame < NUM_FRAMES; ++frame) {
+        for (size_t submit = 0; submit < SUBMITS_PER_FRAME; ++submit) {
+            AppendSubmit(capture, segments);
+        }
+        AppendRecord(capture, RecordType::Frame, FrameRecord{.frame = frame});
+    }
+    WriteCapture(path, capture);
+    {
+        CaptureReader reader;
+        REQUIRE(reader.Open(path));
+        NullTarget null_target;
+        const u64 num_methods = Replay(reader, null_target)->methods;
+        WARN("Methods per replay: " << num_methods);
+
+        const std::string frames = std::to_string(NUM_FRAMES) + " frames";
+        BENCHMARK("Decode " + frames) {
+            reader.Rewind();
+            return Replay(reader, null_target)->methods;
+        };
+        BENCHMARK("Replay " + frames + " through DmaPusher") {
+            reader.Rewind();
+            return Replay(reader, gpu_target)->methods;
+        };
+    }
+    (void)Common::FS::RemoveFile(path);
+}
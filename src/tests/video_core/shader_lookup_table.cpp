@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "video_core/shader_cache.h"
+#include "video_core/shader_lookup_table.h"
+
+namespace {
+using VideoCommon::ShaderInfo;
+using VideoCommon::ShaderLookupTable;
+
+constexpr size_t NUM_SHADERS = 4096;
+constexpr VAddr BASE_ADDR = 0x8000'0000;
+constexpr VAddr SHADER_STRIDE = 0x100;
+
+VAddr ShaderAddr(size_t index) {
+    return BASE_ADDR + index * SHADER_STRIDE;
+}
+
+std::vector<ShaderInfo> MakeShaders(size_t count) {
+    std::vector<ShaderInfo> shaders(count);
+    for (size_t index = 0; index < count; ++index) {
+        shaders[index].unique_hash = index;
+    }
+    return shaders;
+}
+
+/// Removes and registers shaders again in the background, like CPU writes to shader memory do
+template <typename Invalidate>
+class Invalidator {
+public:
+    explicit Invalidator(Invalidate invalidate)
+        : thread{[invalidate](std::stop_token stop_token) {
+              for (size_t index = 0; !stop_token.stop_requested(); ++index) {
+                  invalidate(index % NUM_SHADERS);
+              }
+          }} {}
+
+private:
+    std::jthread thread;
+};
+} // Anonymous namespace
+
+TEST_CASE("ShaderLookupTable: Insert, find and erase", "[video_core]") {
+    std::vector<ShaderInfo> shaders = MakeShaders(NUM_SHADERS);
+    ShaderLookupTable table;
+    for (size_t index = 0; index < NUM_SHADERS; ++index) {
+        REQUIRE(table.Insert(ShaderAddr(index), &shaders[index]));
+    }
+    REQUIRE(table.Size() == NUM_SHADERS);
+    REQUIRE(!table.Insert(ShaderAddr(0), &shaders[1]));
+    REQUIRE(table.Find(ShaderAddr(0)) == &shaders[0]);
+
+    for (size_t index = 0; index < NUM_SHADERS; index += 2) {
+        REQUIRE(table.Erase(ShaderAddr(index)));
+    }
+    REQUIRE(!table.Erase(ShaderAddr(0)));
+    REQUIRE(table.Size() == NUM_SHADERS / 2);
+    for (size_t index = 0; index < NUM_SHADERS; ++index) {
+        REQUIRE(table.Find(ShaderAddr(index)) == (index % 2 ? &shaders[index] : nullptr));
+    }
+    REQUIRE(table.Find(ShaderAddr(NUM_SHADERS)) == nullptr);
+
+    // Churn through tombstones without growing the live set
+    for (size_t round = 0; round < 16; ++round) {
+        for (size_t index = 0; index < NUM_SHADERS; index += 2) {
+            REQUIRE(table.Insert(ShaderAddr(index), &shaders[index]));
+        }
+        for (size_t index = 0; index < NUM_SHADERS; index += 2) {
+            REQUIRE(table.Erase(ShaderAddr(index)));
+        }
+    }
+    REQUIRE(table.Size() == NUM_SHADERS / 2);
+    REQUIRE(table.Find(ShaderAddr(1)) == &shaders[1]);
+    REQUIRE(table.Find(ShaderAddr(2)) == nullptr);
+}
+
+TEST_CASE("ShaderLookupTable: Lookups during invalidation", "[video_core]") {
+    std::vector<ShaderInfo> shaders = MakeShaders(NUM_SHADERS);
+    ShaderLookupTable table;
+    // Odd shaders stay registered, even shaders are removed and registered again
+    for (size_t index = 1; index < NUM_SHADERS; index += 2) {
+        table.Insert(ShaderAddr(index), &shaders[index]);
+    }
+    std::atomic_bool wrong_result{};
+    {
+        Invalidator invalidator{[&](size_t index) {
+            const size_t even = index & ~size_t{1};
+            if (!table.Erase(ShaderAddr(even))) {
+                table.Insert(ShaderAddr(even), &shaders[even]);
+            }
+        }};
+        for (size_t iteration = 0; iteration < 1'000'000; ++iteration) {
+            const size_t index = iteration % NUM_SHADERS;
+            const ShaderInfo* const shader = table.Find(ShaderAddr(index));
+            const bool is_valid = index % 2 ? shader == &shaders[index]
+                                            : shader == nullptr || shader == &shaders[index];
+            if (!is_valid) {
+                wrong_result = true;
+            }
+        }
+    }
+    REQUIRE(!wrong_result);
+}
+
+TEST_CASE("ShaderLookupTable: Lookup latency under invalidation", "[.][benchmark][video_core]") {
+    std::vector<ShaderInfo> shaders = MakeShaders(NUM_SHADERS);
+    size_t lookup_index = 0;
+
+    {
+        std::mutex mutex;
+        std::unordered_map<VAddr, ShaderInfo*> map;
+        for (size_t index = 0; index < NUM_SHADERS; ++index) {
+            map.emplace(ShaderAddr(index), &shaders[index]);
+        }
+        Invalidator invalidator{[&](size_t index) {
+            std::scoped_lock lock{mutex};
+            if (map.erase(ShaderAddr(index)) == 0) {
+                map.emplace(ShaderAddr(index), &shaders[index]);
+            }
+        }};
+        BENCHMARK("Mutex and unordered_map") {
+            std::scoped_lock lock{mutex};
+            const auto it = map.find(ShaderAddr(++lookup_index % NUM_SHADERS));
+            return it != map.end() ? it->second : nullptr;
+        };
+    }
+    {
+        std::mutex mutex;
+        ShaderLookupTable table;
+        for (size_t index = 0; index < NUM_SHADERS; ++index) {
+            table.Insert(ShaderAddr(index), &shaders[index]);
+        }
+        Invalidator invalidator{[&](size_t index) {
+            std::scoped_lock lock{mutex};
+            if (!table.Erase(ShaderAddr(index))) {
+                table.Insert(ShaderAddr(index), &shaders[index]);
+            }
+        }};
+        BENCHMARK("ShaderLookupTable") {
+            return table.Find(ShaderAddr(++lookup_index % NUM_SHADERS));
+        };
+    }
+}
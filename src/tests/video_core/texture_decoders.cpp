@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/scope_exit.h"
+#include "video_core/textures/decoders.h"
+
+using namespace Tegra::Texture;
+
+namespace {
+constexpr std::array KERNELS{
+    SwizzleKernel::SSE41,
+    SwizzleKernel::AVX2,
+    SwizzleKernel::NEON,
+};
+
+constexpr u32 HEIGHT = 37;
+constexpr u32 DEPTH = 3;
+
+std::vector<u8> MakeRandomBuffer(std::mt19937& rng, size_t size) {
+    std::vector<u8> buffer(size);
+    for (u8& value : buffer) {
+        value = static_cast<u8>(rng());
+    }
+    return buffer;
+}
+
+template <typename Func>
+void ForEachKernel(Func&& func) {
+    const SwizzleKernel default_kernel = GetSwizzleKernel();
+    SCOPE_EXIT {
+        SetSwizzleKernel(default_kernel);
+    };
+    for (const SwizzleKernel kernel : KERNELS) {
+        if (IsSwizzleKernelSupported(kernel)) {
+            func(kernel);
+        }
+    }
+}
+} // Anonymous namespace
+
+TEST_CASE("Swizzle: Kernels match scalar path", "[video_core]") {
+    ForEachKernel([](SwizzleKernel kernel) {
+        std::mt19937 rng(0x5eed);
+        for (const u32 bytes_per_pixel : {1U, 2U, 4U, 8U, 16U}) {
+            for (const u32 width : {1U, 17U, 64U, 100U, 257U}) {
+                for (u32 block_height = 0; block_height <= 5; ++block_height) {
+                    for (u32 block_depth = 0; block_depth <= 2; ++block_depth) {
+                        const size_t tiled_size = CalculateSize(true, bytes_per_pixel, width,
+                                                                HEIGHT, DEPTH, block_height,
+                                                                block_depth);
+                        const size_t linear_size = width * HEIGHT * DEPTH * bytes_per_pixel;
+                        const auto tiled = MakeRandomBuffer(rng, tiled_size);
+                        const auto linear = MakeRandomBuffer(rng, linear_size);
+
+                        std::vector<u8> expected_linear(linear_size);
+                        std::vector<u8> expected_tiled(tiled_size);
+                        SetSwizzleKernel(SwizzleKernel::Scalar);
+                        UnswizzleTexture(expected_linear, tiled, bytes_per_pixel, width, HEIGHT,
+                                         DEPTH, block_height, block_depth);
+                        SwizzleTexture(expected_tiled, linear, bytes_per_pixel, width, HEIGHT,
+                                       DEPTH, block_height, block_depth);
+
+                        std::vector<u8> result_linear(linear_size);
+                        std::vector<u8> result_tiled(tiled_size);
+                        SetSwizzleKernel(kernel);
+                        UnswizzleTexture(result_linear, tiled, bytes_per_pixel, width, HEIGHT,
+                                         DEPTH, block_height, block_depth);
+                        SwizzleTexture(result_tiled, linear, bytes_per_pixel, width, HEIGHT, DEPTH,
+                                       block_height, block_depth);
+
+                        REQUIRE(result_linear == expected_linear);
+                        REQUIRE(result_tiled == expected_tiled);
+                    }
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE("Swizzle: Subrect kernels match scalar path", "[video_core]") {
+    ForEachKernel([](SwizzleKernel kernel) {
+        std::mt19937 rng(0x5eed);
+        for (const u32 bytes_per_pixel : {1U, 2U, 3U, 4U, 6U, 8U, 12U, 16U}) {
+            for (const u32 width : {17U, 100U, 257U}) {
+                for (u32 block_height = 0; block_height <= 5; ++block_height) {
+                    for (u32 block_depth = 0; block_depth <= 2; ++block_depth) {
+                        const u32 origin_x = width / 3;
+                        const u32 origin_y = 5;
+                        const u32 extent_x = width - origin_x;
+                        const u32 extent_y = HEIGHT - origin_y;
+                        const u32 pitch = extent_x * bytes_per_pixel;
+                        const size_t tiled_size = CalculateSize(true, bytes_per_pixel, width,
+                                                                HEIGHT, DEPTH, block_height,
+                                                                block_depth);
+                        const size_t linear_size = pitch * HEIGHT * DEPTH;
+                        const auto tiled = MakeRandomBuffer(rng, tiled_size);
+                        const auto linear = MakeRandomBuffer(rng, linear_size);
+
+                        std::vector<u8> expected_linear(linear_size);
+                        std::vector<u8> expected_tiled(tiled);
+                        SetSwizzleKernel(SwizzleKernel::Scalar);
+                        UnswizzleSubrect(expected_linear, tiled, bytes_per_pixel, width, HEIGHT,
+                                         DEPTH, origin_x, origin_y, extent_x, extent_y,
+                                         block_height, block_depth, pitch);
+                        SwizzleSubrect(expected_tiled, linear, bytes_per_pixel, width, HEIGHT,
+                                       DEPTH, origin_x, origin_y, extent_x, extent_y, block_height,
+                                       block_depth, pitch);
+
+                        std::vector<u8> result_linear(linear_size);
+                        std::vector<u8> result_tiled(tiled);
+                        SetSwizzleKernel(kernel);
+                        UnswizzleSubrect(result_linear, tiled, bytes_per_pixel, width, HEIGHT,
+                                         DEPTH, origin_x, origin_y, extent_x, extent_y,
+                                         block_height, block_depth, pitch);
+                        SwizzleSubrect(result_tiled, linear, bytes_per_pixel, width, HEIGHT, DEPTH,
+                                       origin_x, origin_y, extent_x, extent_y, block_height,
+                                       block_depth, pitch);
+
+                        REQUIRE(result_linear == expected_linear);
+                        REQUIRE(result_tiled == expected_tiled);
+                    }
+                }
+            }
+        }
+    });
+}
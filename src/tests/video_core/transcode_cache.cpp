@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/transcode_cache.h"
+
+namespace {
+using VideoCommon::BufferImageCopy;
+using VideoCommon::ImageInfo;
+using VideoCommon::TranscodeCache;
+using VideoCommon::TranscodeKey;
+using Copies = boost::container::small_vector<BufferImageCopy, 16>;
+
+std::filesystem::path CachePath() {
+    return std::filesystem::temp_directory_path() / "suyu_transcode_cache_test.bin";
+}
+
+ImageInfo MakeInfo(u32 width, u32 height) {
+    ImageInfo info;
+    info.format = VideoCore::Surface::PixelFormat::ASTC_2D_4X4_UNORM;
+    info.type = VideoCommon::ImageType::e2D;
+    info.size = {width, height, 1};
+    return info;
+}
+
+std::array<BufferImageCopy, 1> MakeCopies(size_t size) {
+    std::array<BufferImageCopy, 1> copies{};
+    copies[0].buffer_size = size;
+    copies[0].buffer_row_length = 64;
+    copies[0].buffer_image_height = 64;
+    return copies;
+}
+
+std::vector<u8> MakeData(size_t size, u8 seed) {
+    std::vector<u8> data(size);
+    std::iota(data.begin(), data.end(), seed);
+    return data;
+}
+} // Anonymous namespace
+
+TEST_CASE("TranscodeCache: Entries persist across sessions", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    const std::vector<u8> guest = MakeData(1024, 1);
+    const TranscodeKey key = TranscodeCache::MakeKey(guest, MakeInfo(64, 64));
+    const std::vector<u8> transcoded = MakeData(2048, 7);
+    const auto copies = MakeCopies(transcoded.size());
+    {
+        TranscodeCache cache;
+        cache.Open(path);
+        REQUIRE(cache.IsOpen());
+        cache.Store(key, transcoded, copies);
+    }
+    TranscodeCache cache;
+    cache.Open(path);
+    REQUIRE(cache.IsOpen());
+    REQUIRE(cache.Contains(key));
+
+    std::vector<u8> output(4096);
+    Copies loaded_copies(1);
+    REQUIRE(cache.Load(key, output, loaded_copies));
+    REQUIRE(std::equal(transcoded.begin(), transcoded.end(), output.begin()));
+    REQUIRE(loaded_copies[0].buffer_size == transcoded.size());
+    REQUIRE(loaded_copies[0].buffer_row_length == 64);
+
+    // The same guest data with different image parameters is a different image
+    const TranscodeKey other_key = TranscodeCache::MakeKey(guest, MakeInfo(32, 128));
+    REQUIRE(!(other_key == key));
+    REQUIRE(!cache.Contains(other_key));
+    REQUIRE(!cache.Load(other_key, output, loaded_copies));
+
+    cache.Close();
+    (void)Common::FS::RemoveFile(path);
+}
+
+TEST_CASE("TranscodeCache: Truncated entries are discarded", "[video_core]") {
+    const auto path = CachePath();
+    (void)Common::FS::RemoveFile(path);
+
+    const TranscodeKey first_key = TranscodeCache::MakeKey(MakeData(256, 1), MakeInfo(16, 16));
+    const TranscodeKey second_key = TranscodeCache::MakeKey(MakeData(256, 2), MakeInfo(16, 16));
+    const std::vector<u8> transcoded = MakeData(512, 3);
+    const auto copies = MakeCopies(transcoded.size());
+    {
+        TranscodeCache cache;
+        cache.Open(path);
+        cache.Store(first_key, transcoded, copies);
+        cache.Store(second_key, transcoded, copies);
+    }
+    {
+        // Simulate a crash in the middle of writing the second entry
+        const Common::FS::IOFile file(path, Common::FS::FileAccessMode::ReadWrite);
+        REQUIRE(file.SetSize(file.GetSize() - 100));
+    }
+    const TranscodeKey third_key = TranscodeCache::MakeKey(MakeData(256, 4), MakeInfo(16, 16));
+    {
+        TranscodeCache cache;
+        cache.Open(path);
+        cache.Store(third_key, transcoded, copies);
+    }
+    TranscodeCache cache;
+    cache.Open(path);
+
+    std::vector<u8> output(transcoded.size());
+    Copies loaded_copies(1);
+    REQUIRE(cache.Load(first_key, output, loaded_copies));
+    REQUIRE(!cache.Load(second_key, output, loaded_copies));
+    REQUIRE(cache.Load(third_key, output, loaded_copies));
+    REQUIRE(output == transcoded);
+
+    cache.Close();
+    (void)Common::FS::RemoveFile(path);
+}
@@ -1,10 +1,17 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
+#if defined(_MSC_VER) && defined(ARCHITECTURE_x86_64)
+#include <xmmintrin.h>
+#endif
+
 #include "common/cityhash.h"
 #include "common/microprofile.h"
 #include "common/settings.h"
 #include "core/core.h"
+#include "core/device_memory_manager.h"
 #include "video_core/dma_pusher.h"
 #include "video_core/engines/maxwell_3d.h"
 #include "video_core/gpu.h"
@@ -16,6 +23,18 @@ namespace Tegra {
 constexpr u32 MacroRegistersStart = 0xE00;
 constexpr u32 ComputeInline = 0x6D;
 
+// Bytes of the next command list segment pulled into the cache ahead of time
+constexpr size_t CommandPrefetchSize = 512;
+constexpr size_t CacheLineSize = 64;
+
+static void PrefetchCacheLine(const u8* pointer) {
+#if defined(_MSC_VER) && defined(ARCHITECTURE_x86_64)
+    _mm_prefetch(reinterpret_cast<const char*>(pointer), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(pointer);
+#endif
+}
+
 DmaPusher::DmaPusher(Core::System& system_, GPU& gpu_, MemoryManager& memory_manager_,
                      Control::ChannelState& channel_state_)
     : gpu{gpu_}, system{system_}, memory_manager{memory_manager_}, puller{gpu_, memory_manager_,
@@ -72,6 +91,13 @@ bool DmaPusher::Step() {
             dma_pushbuffer.pop();
             dma_pushbuffer_subindex = 0;
         }
+        if (!dma_pushbuffer.empty()) {
+            // Start fetching the next segment while this one is being processed
+            const CommandList& next_command_list{dma_pushbuffer.front()};
+            if (dma_pushbuffer_subindex < next_command_list.command_lists.size()) {
+                PrefetchSegment(next_command_list.command_lists[dma_pushbuffer_subindex]);
+            }
+        }
 
         if (command_list_header.size == 0) {
             return true;
@@ -131,19 +157,20 @@ void DmaPusher::ProcessCommands(std::span<const CommandHeader> commands) {
                 dma_state.is_last_call = true;
                 index += max_write;
                 continue;
-            } else {
-                dma_state.is_last_call = dma_state.method_count <= 1;
-                CallMethod(command_header.argument);
-            }
-
-            if (!dma_state.non_incrementing) {
-                dma_state.method++;
             }
-
-            if (dma_increment_once) {
-                dma_state.non_incrementing = true;
+            if (!dma_increment_once) {
+                // Dispatch every method of an increasing run available in this segment at once
+                const u32 num_methods = static_cast<u32>(
+                    std::min<std::size_t>(dma_state.method_count, commands.size() - index));
+                CallIncreasingMethods(commands.subspan(index, num_methods));
+                index += num_methods;
+                continue;
             }
+            dma_state.is_last_call = dma_state.method_count <= 1;
+            CallMethod(command_header.argument);
+            dma_state.method++;
 
+            dma_state.non_incrementing = true;
             dma_state.method_count--;
         } else {
             // No command active - this is the first word of a new one
@@ -206,6 +233,40 @@ void DmaPusher::CallMethod(u32 argument) const {
     }
 }
 
+void DmaPusher::CallIncreasingMethods(std::span<const CommandHeader> arguments) {
+    const u64 word_offset = dma_state.dma_word_offset;
+    std::size_t index = 0;
+    for (; index < arguments.size() && dma_state.method < non_puller_methods; ++index) {
+        dma_state.dma_word_offset = word_offset + index * sizeof(u32);
+        dma_state.is_last_call = dma_state.method_count <= 1;
+        CallMethod(arguments[index].argument);
+        dma_state.method++;
+        dma_state.method_count--;
+    }
+    if (index == arguments.size()) {
+        return;
+    }
+    // Plain register writes are queued in the engine's sink and applied in a single call the
+    // next time the engine has to execute a method
+    Engines::EngineInterface* const subchannel = subchannels[dma_state.subchannel];
+    auto& method_sink = subchannel->method_sink;
+    for (; index < arguments.size(); ++index) {
+        const u32 method = dma_state.method;
+        const u32 argument = arguments[index].argument;
+        if (!subchannel->execution_mask[method]) [[likely]] {
+            method_sink.emplace_back(method, argument);
+        } else {
+            dma_state.dma_word_offset = word_offset + index * sizeof(u32);
+            subchannel->ConsumeSink();
+            subchannel->current_dma_segment = dma_state.dma_get + dma_state.dma_word_offset;
+            subchannel->CallMethod(method, argument, dma_state.method_count <= 1);
+        }
+        dma_state.method++;
+        dma_state.method_count--;
+    }
+    dma_state.is_last_call = dma_state.method_count == 0;
+}
+
 void DmaPusher::CallMultiMethod(const u32* base_start, u32 num_methods) const {
     if (dma_state.method < non_puller_methods) {
         puller.CallMultiMethod(dma_state.method, dma_state.subchannel, base_start, num_methods,
@@ -219,6 +280,21 @@ void DmaPusher::CallMultiMethod(const u32* base_start, u32 num_methods) const {
     }
 }
 
+void DmaPusher::PrefetchSegment(const CommandListHeader& command_list_header) const {
+    const GPUVAddr address = command_list_header.addr;
+    const u8* const pointer = memory_manager.GetPointer<u8>(address);
+    if (!pointer) {
+        return;
+    }
+    // Only the first page is known to be contiguous in host memory
+    const size_t page_remaining = Core::DEVICE_PAGESIZE - (address & Core::DEVICE_PAGEMASK);
+    const size_t size = std::min({static_cast<size_t>(command_list_header.size) * sizeof(u32),
+                                  CommandPrefetchSize, page_remaining});
+    for (size_t offset = 0; offset < size; offset += CacheLineSize) {
+        PrefetchCacheLine(pointer + offset);
+    }
+}
+
 void DmaPusher::BindRasterizer(VideoCore::RasterizerInterface* rasterizer) {
     puller.BindRasterizer(rasterizer);
 }
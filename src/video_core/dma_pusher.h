@@ -149,6 +149,12 @@ private:
     void CallMethod(u32 argument) const;
     void CallMultiMethod(const u32* base_start, u32 num_methods) const;
 
+    /// Call consecutive methods of an increasing run, starting at the current method
+    void CallIncreasingMethods(std::span<const CommandHeader> arguments);
+
+    /// Pull the start of a command list segment into the cache before it is processed
+    void PrefetchSegment(const CommandListHeader& command_list_header) const;
+
     Common::ScratchBuffer<CommandHeader>
         command_headers; ///< Buffer for list of commands fetched at once
 
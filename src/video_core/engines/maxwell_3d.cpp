@@ -42,6 +42,10 @@ void Maxwell3D::BindRasterizer(VideoCore::RasterizerInterface* rasterizer_) {
     upload_state.BindRasterizer(rasterizer_);
 }
 
+void Maxwell3D::BindMacroProfiler(MacroProfiler* profiler) {
+    macro_engine->BindProfiler(profiler);
+}
+
 void Maxwell3D::InitializeRegisterDefaults() {
     // Initializes registers to their default values - what games expect them to be at boot. This is
     // for certain registers that may not be explicitly set by games.
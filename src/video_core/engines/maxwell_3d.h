@@ -59,6 +59,9 @@ public:
     /// Binds a rasterizer to this engine.
     void BindRasterizer(VideoCore::RasterizerInterface* rasterizer);
 
+    /// Accounts the macros executed by this engine in a profiler.
+    void BindMacroProfiler(MacroProfiler* profiler);
+
     /// Register structure of the Maxwell3D engine.
     struct Regs {
         static constexpr std::size_t NUM_REGS = 0xE00;
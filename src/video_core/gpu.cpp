@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2018 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <chrono>
@@ -31,6 +32,8 @@
 #include "video_core/host1x/host1x.h"
 #include "video_core/host1x/syncpoint_manager.h"
 #include "video_core/memory_manager.h"
+#include "video_core/macro/macro_profiler.h"
+#include "video_core/pushbuffer_recorder.h"
 #include "video_core/renderer_base.h"
 #include "video_core/shader_notify.h"
 
@@ -40,13 +43,24 @@ struct GPU::Impl {
     explicit Impl(GPU& gpu_, Core::System& system_, bool is_async_, bool use_nvdec_)
         : gpu{gpu_}, system{system_}, host1x{system.Host1x()}, use_nvdec{use_nvdec_},
           shader_notify{std::make_unique<VideoCore::ShaderNotify>()}, is_async{is_async_},
-          gpu_thread{system_, is_async_}, scheduler{std::make_unique<Control::Scheduler>(gpu)} {}
+          gpu_thread{system_, is_async_}, scheduler{std::make_unique<Control::Scheduler>(gpu)} {
+        const s32 capture_frames = Settings::values.pushbuffer_capture_frames.GetValue();
+        if (capture_frames > 0) {
+            const s32 start_frame =
+                std::max(Settings::values.pushbuffer_capture_start_frame.GetValue(), 0);
+            recorder = std::make_unique<PushbufferRecorder>(system, static_cast<u64>(start_frame),
+                                                            static_cast<u64>(capture_frames));
+        }
+    }
 
     ~Impl() = default;
 
     std::shared_ptr<Control::ChannelState> CreateChannel(s32 channel_id) {
         auto channel_state = std::make_shared<Tegra::Control::ChannelState>(channel_id);
-        channels.emplace(channel_id, channel_state);
+        {
+            std::scoped_lock lk{channels_mutex};
+            channels.emplace(channel_id, channel_state);
+        }
         scheduler->DeclareChannel(channel_state);
         return channel_state;
     }
@@ -55,10 +69,13 @@ struct GPU::Impl {
         if (bound_channel == channel_id) {
             return;
         }
-        auto it = channels.find(channel_id);
-        ASSERT(it != channels.end());
+        {
+            std::scoped_lock lk{channels_mutex};
+            auto it = channels.find(channel_id);
+            ASSERT(it != channels.end());
+            current_channel = it->second.get();
+        }
         bound_channel = channel_id;
-        current_channel = it->second.get();
 
         rasterizer->BindChannel(*current_channel);
     }
@@ -70,11 +87,21 @@ struct GPU::Impl {
     void InitChannel(Control::ChannelState& to_init, u64 program_id) {
         to_init.Init(system, gpu, program_id);
         to_init.BindRasterizer(rasterizer);
+        if (Settings::values.profile_macros) {
+            if (!macro_profiler) {
+                macro_profiler =
+                    std::make_unique<MacroProfiler>(MacroProfiler::GetProfilePath(program_id));
+            }
+            to_init.maxwell_3d->BindMacroProfiler(macro_profiler.get());
+        }
         rasterizer->InitializeChannel(to_init);
     }
 
     void InitAddressSpace(Tegra::MemoryManager& memory_manager) {
         memory_manager.BindRasterizer(rasterizer);
+        if (recorder) {
+            memory_manager.BindRecorder(recorder.get());
+        }
     }
 
     void ReleaseChannel(Control::ChannelState& to_release) {
@@ -247,6 +274,18 @@ struct GPU::Impl {
 
     /// Push GPU command entries to be processed
     void PushGPUEntries(s32 channel, Tegra::CommandList&& entries) {
+        if (recorder) [[unlikely]] {
+            std::shared_ptr<Tegra::MemoryManager> memory_manager;
+            {
+                std::scoped_lock lk{channels_mutex};
+                if (const auto it = channels.find(channel); it != channels.end()) {
+                    memory_manager = it->second->memory_manager;
+                }
+            }
+            if (memory_manager) {
+                recorder->OnSubmit(channel, *memory_manager, entries);
+            }
+        }
         gpu_thread.SubmitList(channel, std::move(entries));
     }
 
@@ -286,6 +325,9 @@ struct GPU::Impl {
 
     void RequestComposite(std::vector<Tegra::FramebufferConfig>&& layers,
                           std::vector<Service::Nvidia::NvFence>&& fences) {
+        if (recorder) [[unlikely]] {
+            recorder->OnFrame();
+        }
         size_t num_fences{fences.size()};
         size_t current_request_counter{};
         {
@@ -341,6 +383,11 @@ struct GPU::Impl {
     std::unique_ptr<VideoCore::RendererBase> renderer;
     VideoCore::RasterizerInterface* rasterizer = nullptr;
     const bool use_nvdec;
+    /// Records submitted command lists when a pushbuffer capture is requested, it has to outlive
+    /// the address spaces owned by channels
+    std::unique_ptr<PushbufferRecorder> recorder;
+    /// Counts macro executions of all channels when macro profiling is enabled
+    std::unique_ptr<MacroProfiler> macro_profiler;
 
     s32 new_channel_id{1};
     /// Shader build notifier
@@ -369,6 +416,8 @@ struct GPU::Impl {
     std::unique_ptr<Core::Frontend::GraphicsContext> cpu_context;
 
     std::unique_ptr<Tegra::Control::Scheduler> scheduler;
+    /// Channels are created by nvdrv service threads while others submit to existing ones
+    std::mutex channels_mutex;
     std::unordered_map<s32, std::shared_ptr<Tegra::Control::ChannelState>> channels;
     Tegra::Control::ChannelState* current_channel;
     s32 bound_channel{-1};
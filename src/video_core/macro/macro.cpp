@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2020 yuzu Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
 #include <cstring>
 #include <fstream>
 #include <optional>
@@ -18,6 +19,7 @@
 #include "video_core/macro/macro.h"
 #include "video_core/macro/macro_hle.h"
 #include "video_core/macro/macro_interpreter.h"
+#include "video_core/macro/macro_profiler.h"
 
 #ifdef ARCHITECTURE_x86_64
 #include "video_core/macro/macro_jit_x64.h"
@@ -69,9 +71,22 @@ void MacroEngine::ClearCode(u32 method) {
 }
 
 void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
+    if (!profiler) [[likely]] {
+        ExecuteMacro(method, parameters);
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    if (const std::optional<u64> hash = ExecuteMacro(method, parameters)) {
+        profiler->Record(*hash, std::chrono::steady_clock::now() - start);
+    }
+}
+
+std::optional<u64> MacroEngine::ExecuteMacro(u32 method, const std::vector<u32>& parameters) {
     auto compiled_macro = macro_cache.find(method);
     if (compiled_macro != macro_cache.end()) {
         const auto& cache_info = compiled_macro->second;
+        // The macro can upload code and invalidate its own cache entry while it executes
+        const u64 hash = cache_info.hash;
         if (cache_info.has_hle_program) {
             MICROPROFILE_SCOPE(MacroHLE);
             cache_info.hle_program->Execute(parameters, method);
@@ -79,6 +94,7 @@ void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
             maxwell3d.RefreshParameters();
             cache_info.lle_program->Execute(parameters, method);
         }
+        return hash;
     } else {
         // Macro not compiled, check if it's uploaded and if so, compile it
         std::optional<u32> mid_method;
@@ -92,7 +108,7 @@ void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
             }
             if (!mid_method.has_value()) {
                 ASSERT_MSG(false, "Macro 0x{0:x} was not uploaded", method);
-                return;
+                return std::nullopt;
             }
         }
         auto& cache_info = macro_cache[method];
@@ -111,8 +127,13 @@ void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
             cache_info.lle_program = Compile(code);
         }
 
-        auto hle_program = hle_macros->GetHLEProgram(cache_info.hash);
-        if (!hle_program || Settings::values.disable_macro_hle) {
+        const u64 hash = cache_info.hash;
+        auto hle_program = hle_macros->GetHLEProgram(hash);
+        const bool use_hle_program = hle_program && !Settings::values.disable_macro_hle;
+        if (profiler) {
+            profiler->AddProgram(hash, uploaded_macro_code[method], use_hle_program);
+        }
+        if (!use_hle_program) {
             maxwell3d.RefreshParameters();
             cache_info.lle_program->Execute(parameters, method);
         } else {
@@ -123,8 +144,9 @@ void MacroEngine::Execute(u32 method, const std::vector<u32>& parameters) {
         }
 
         if (Settings::values.dump_macros) {
-            Dump(cache_info.hash, macro_code->second, cache_info.has_hle_program);
+            Dump(hash, macro_code->second, use_hle_program);
         }
+        return hash;
     }
 }
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 #include "common/bit_field.h"
@@ -96,6 +97,7 @@ union MethodAddress {
 } // namespace Macro
 
 class HLEMacro;
+class MacroProfiler;
 
 class CachedMacro {
 public:
@@ -123,6 +125,11 @@ public:
     // Compiles the macro if its not in the cache, and executes the compiled macro
     void Execute(u32 method, const std::vector<u32>& parameters);
 
+    // Accounts the executed macros in a profiler, nullptr to stop profiling
+    void BindProfiler(MacroProfiler* profiler_) {
+        profiler = profiler_;
+    }
+
 protected:
     virtual std::unique_ptr<CachedMacro> Compile(const std::vector<u32>& code) = 0;
 
@@ -134,9 +141,13 @@ private:
         bool has_hle_program{};
     };
 
+    // Returns the hash of the executed macro, nullopt if it was not uploaded
+    std::optional<u64> ExecuteMacro(u32 method, const std::vector<u32>& parameters);
+
     std::unordered_map<u32, CacheInfo> macro_cache;
     std::unordered_map<u32, std::vector<u32>> uploaded_macro_code;
     std::unique_ptr<HLEMacro> hle_macros;
+    MacroProfiler* profiler{};
     Engines::Maxwell3D& maxwell3d;
 };
 
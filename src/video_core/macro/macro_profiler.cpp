@@ -0,0 +1,259 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/fs/path_util.h"
+#include "common/logging/log.h"
+#include "video_core/engines/maxwell_3d.h"
+#include "video_core/macro/macro.h"
+#include "video_core/macro/macro_profiler.h"
+
+namespace Tegra {
+
+using Maxwell3D = Engines::Maxwell3D;
+
+namespace {
+
+constexpr std::string_view PROFILE_HEADER =
+    "# hash invocations total_time_ns size has_hle_program pattern\n";
+
+// Macros have to be called this often, and take this share of the total macro time, to be
+// reported as HLE candidates
+constexpr u64 MIN_CANDIDATE_INVOCATIONS = 1000;
+constexpr double MIN_CANDIDATE_TIME_SHARE = 0.01;
+
+constexpr std::array PATTERN_NAMES{
+    std::pair{MacroPattern::Unknown, std::string_view{"Unknown"}},
+    std::pair{MacroPattern::Draw, std::string_view{"Draw"}},
+    std::pair{MacroPattern::Clear, std::string_view{"Clear"}},
+    std::pair{MacroPattern::ConstBufferStore, std::string_view{"ConstBufferStore"}},
+    std::pair{MacroPattern::MemoryUpload, std::string_view{"MemoryUpload"}},
+    std::pair{MacroPattern::ConstBufferBind, std::string_view{"ConstBufferBind"}},
+};
+
+[[nodiscard]] MacroPattern ParsePattern(std::string_view name) {
+    for (const auto& [pattern, pattern_name] : PATTERN_NAMES) {
+        if (pattern_name == name) {
+            return pattern;
+        }
+    }
+    return MacroPattern::Unknown;
+}
+
+[[nodiscard]] bool SetsMethod(Macro::ResultOperation operation) {
+    switch (operation) {
+    case Macro::ResultOperation::MoveAndSetMethod:
+    case Macro::ResultOperation::FetchAndSetMethod:
+    case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
+    case Macro::ResultOperation::MoveAndSetMethodSend:
+        return true;
+    default:
+        return false;
+    }
+}
+
+[[nodiscard]] bool Sends(Macro::ResultOperation operation) {
+    switch (operation) {
+    case Macro::ResultOperation::FetchAndSend:
+    case Macro::ResultOperation::MoveAndSend:
+    case Macro::ResultOperation::MoveAndSetMethodFetchAndSend:
+    case Macro::ResultOperation::MoveAndSetMethodSend:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // Anonymous namespace
+
+std::string_view GetMacroPatternName(MacroPattern pattern) {
+    for (const auto& [known_pattern, name] : PATTERN_NAMES) {
+        if (known_pattern == pattern) {
+            return name;
+        }
+    }
+    return "Invalid";
+}
+
+MacroPattern AnalyzeMacro(std::span<const u32> code) {
+    std::bitset<Maxwell3D::Regs::NUM_REGS> written;
+    std::optional<Macro::MethodAddress> method_address;
+    for (const u32 word : code) {
+        const Macro::Opcode opcode{word};
+        if (opcode.operation == Macro::Operation::Branch) {
+            continue;
+        }
+        if (SetsMethod(opcode.result_operation)) {
+            if (opcode.operation == Macro::Operation::AddImmediate && opcode.src_a == 0) {
+                method_address.emplace();
+                method_address->raw = static_cast<u32>(opcode.immediate.Value());
+            } else {
+                method_address.reset();
+            }
+        }
+        if (!Sends(opcode.result_operation) || !method_address) {
+            continue;
+        }
+        if (method_address->address < Maxwell3D::Regs::NUM_REGS) {
+            written.set(method_address->address);
+        }
+        method_address->address.Assign(method_address->address + method_address->increment);
+    }
+
+    const auto writes = [&written](size_t method, size_t count = 1) {
+        for (size_t index = method; index < method + count; ++index) {
+            if (written[index]) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (writes(MAXWELL3D_REG_INDEX(draw.begin)) || writes(MAXWELL3D_REG_INDEX(draw.end))) {
+        return MacroPattern::Draw;
+    }
+    if (writes(MAXWELL3D_REG_INDEX(clear_surface))) {
+        return MacroPattern::Clear;
+    }
+    if (writes(MAXWELL3D_REG_INDEX(const_buffer.buffer), Maxwell3D::Regs::NumCBData)) {
+        return MacroPattern::ConstBufferStore;
+    }
+    if (writes(MAXWELL3D_REG_INDEX(launch_dma)) || writes(MAXWELL3D_REG_INDEX(inline_data))) {
+        return MacroPattern::MemoryUpload;
+    }
+    // Size, address and offset of the constant buffer
+    if (writes(MAXWELL3D_REG_INDEX(const_buffer), 4)) {
+        return MacroPattern::ConstBufferBind;
+    }
+    constexpr size_t bind_group_stride = sizeof(Maxwell3D::Regs::BindGroup) / sizeof(u32);
+    for (size_t stage = 0; stage < Maxwell3D::Regs::MaxShaderStage; ++stage) {
+        if (writes(MAXWELL3D_REG_INDEX(bind_groups[0].raw_config) + stage * bind_group_stride)) {
+            return MacroPattern::ConstBufferBind;
+        }
+    }
+    return MacroPattern::Unknown;
+}
+
+MacroProfiler::MacroProfiler(std::filesystem::path path_) : path{std::move(path_)} {
+    Load();
+}
+
+MacroProfiler::~MacroProfiler() {
+    Save();
+}
+
+std::filesystem::path MacroProfiler::GetProfilePath(u64 program_id) {
+    const auto base_dir{Common::FS::GetSuyuPath(Common::FS::SuyuPath::DumpDir)};
+    return base_dir / "macro_profiles" / fmt::format("{:016x}.txt", program_id);
+}
+
+void MacroProfiler::AddProgram(u64 hash, std::span<const u32> code, bool has_hle_program) {
+    Entry& entry = entries[hash];
+    if (entry.size == 0) {
+        entry.size = static_cast<u32>(code.size());
+        entry.pattern = AnalyzeMacro(code);
+    }
+    entry.has_hle_program = has_hle_program;
+}
+
+void MacroProfiler::Save() const {
+    if (entries.empty()) {
+        return;
+    }
+    if (!Common::FS::CreateParentDirs(path)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create macro profile directories");
+        return;
+    }
+    std::vector<std::pair<u64, Entry>> sorted(entries.begin(), entries.end());
+    std::ranges::sort(sorted, [](const auto& lhs, const auto& rhs) {
+        return lhs.second.total_time > rhs.second.total_time;
+    });
+    std::string profile{PROFILE_HEADER};
+    for (const auto& [hash, entry] : sorted) {
+        profile += fmt::format("{:016x} {} {} {} {} {}\n", hash, entry.invocations,
+                               entry.total_time.count(), entry.size,
+                               entry.has_hle_program ? 1 : 0, GetMacroPatternName(entry.pattern));
+    }
+    if (Common::FS::WriteStringToFile(path, Common::FS::FileType::TextFile, profile) !=
+        profile.size()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write macro profile {}",
+                  Common::FS::PathToUTF8String(path));
+        return;
+    }
+    for (const auto& [hash, entry] : FindHLECandidates()) {
+        LOG_INFO(HW_GPU,
+                 "Macro {:016x} is a HLE candidate: {} instructions, {} calls, {} ms, pattern {}",
+                 hash, entry.size, entry.invocations,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(entry.total_time).count(),
+                 GetMacroPatternName(entry.pattern));
+    }
+}
+
+std::vector<std::pair<u64, MacroProfiler::Entry>> MacroProfiler::FindHLECandidates() const {
+    std::chrono::nanoseconds total_time{};
+    for (const auto& [hash, entry] : entries) {
+        if (!entry.has_hle_program) {
+            total_time += entry.total_time;
+        }
+    }
+    std::vector<std::pair<u64, Entry>> candidates;
+    for (const auto& [hash, entry] : entries) {
+        if (entry.has_hle_program || entry.pattern == MacroPattern::Unknown ||
+            entry.invocations < MIN_CANDIDATE_INVOCATIONS) {
+            continue;
+        }
+        const double time_share = static_cast<double>(entry.total_time.count()) /
+                                  static_cast<double>(std::max<s64>(total_time.count(), 1));
+        if (time_share >= MIN_CANDIDATE_TIME_SHARE) {
+            candidates.emplace_back(hash, entry);
+        }
+    }
+    std::ranges::sort(candidates, [](const auto& lhs, const auto& rhs) {
+        return lhs.second.total_time > rhs.second.total_time;
+    });
+    return candidates;
+}
+
+void MacroProfiler::Load() {
+    if (!Common::FS::Exists(path)) {
+        return;
+    }
+    std::istringstream profile{
+        Common::FS::ReadStringFromFile(path, Common::FS::FileType::TextFile)};
+    std::string line;
+    while (std::getline(profile, line)) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        std::istringstream fields{line};
+        u64 hash{};
+        u64 invocations{};
+        s64 total_time{};
+        u32 size{};
+        u32 has_hle_program{};
+        std::string pattern;
+        if (!(fields >> std::hex >> hash >> std::dec >> invocations >> total_time >> size >>
+              has_hle_program >> pattern)) {
+            LOG_WARNING(HW_GPU, "Ignoring malformed macro profile line \"{}\"", line);
+            continue;
+        }
+        Entry& entry = entries[hash];
+        entry.invocations += invocations;
+        entry.total_time += std::chrono::nanoseconds{total_time};
+        entry.size = size;
+        entry.pattern = ParsePattern(pattern);
+        entry.has_hle_program = has_hle_program != 0;
+    }
+}
+
+} // namespace Tegra
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace Tegra {
+
+/// Kind of work a macro program does, as far as it can be told from the methods it sends
+enum class MacroPattern : u32 {
+    Unknown,
+    Draw,             ///< Begins or ends draws, like indirect draws forwarding their parameters
+    Clear,            ///< Clears render targets
+    ConstBufferStore, ///< Writes data to a constant buffer
+    MemoryUpload,     ///< Writes to memory with inline data
+    ConstBufferBind,  ///< Selects or binds constant buffers without writing to them
+};
+
+[[nodiscard]] std::string_view GetMacroPatternName(MacroPattern pattern);
+
+/**
+ * Classifies a macro program by the methods it sends to. Method addresses are followed as if the
+ * program was straight-line code, and only addresses set from immediates are known.
+ */
+[[nodiscard]] MacroPattern AnalyzeMacro(std::span<const u32> code);
+
+/**
+ * Counts the invocations and execution time of macros by the hash of their program. The counts
+ * are merged into a profile that persists across sessions of the same title. Macros are executed
+ * from the GPU thread, which is the only one accessing the profiler.
+ */
+class MacroProfiler {
+public:
+    struct Entry {
+        u64 invocations{};
+        std::chrono::nanoseconds total_time{};
+        u32 size{};
+        MacroPattern pattern{};
+        bool has_hle_program{};
+    };
+
+    /// Creates a profiler accumulating on top of the profile at path, if there is one
+    explicit MacroProfiler(std::filesystem::path path_);
+    ~MacroProfiler();
+
+    MacroProfiler(const MacroProfiler&) = delete;
+    MacroProfiler& operator=(const MacroProfiler&) = delete;
+
+    /// Returns the path of the profile of a title
+    [[nodiscard]] static std::filesystem::path GetProfilePath(u64 program_id);
+
+    /// Registers a compiled macro, its program is analyzed the first time it is seen
+    void AddProgram(u64 hash, std::span<const u32> code, bool has_hle_program);
+
+    /// Accounts one execution of a macro
+    void Record(u64 hash, std::chrono::nanoseconds time) {
+        Entry& entry = entries[hash];
+        ++entry.invocations;
+        entry.total_time += time;
+    }
+
+    /// Writes the profile and logs the macros that are worth implementing in HLE
+    void Save() const;
+
+    /**
+     * Returns the hot macros without a HLE implementation whose program matches a known pattern,
+     * hottest first
+     */
+    [[nodiscard]] std::vector<std::pair<u64, Entry>> FindHLECandidates() const;
+
+    [[nodiscard]] const std::unordered_map<u64, Entry>& Entries() const {
+        return entries;
+    }
+
+private:
+    void Load();
+
+    std::filesystem::path path;
+    std::unordered_map<u64, Entry> entries;
+};
+
+} // namespace Tegra
@@ -13,6 +13,7 @@
 #include "video_core/host1x/host1x.h"
 #include "video_core/invalidation_accumulator.h"
 #include "video_core/memory_manager.h"
+#include "video_core/pushbuffer_recorder.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_base.h"
 
@@ -54,7 +55,11 @@ MemoryManager::MemoryManager(Core::System& system_, u64 address_space_bits_,
     : MemoryManager(system_, system_.Host1x().MemoryManager(), address_space_bits_, split_address_,
                     big_page_bits_, page_bits_) {}
 
-MemoryManager::~MemoryManager() = default;
+MemoryManager::~MemoryManager() {
+    if (recorder) {
+        recorder->OnDestroyAddressSpace(*this);
+    }
+}
 
 template <bool is_big_page>
 MemoryManager::EntryType MemoryManager::GetEntry(size_t position) const {
@@ -179,8 +184,19 @@ void MemoryManager::BindRasterizer(VideoCore::RasterizerInterface* rasterizer_)
     rasterizer = rasterizer_;
 }
 
+void MemoryManager::BindRecorder(PushbufferRecorder* recorder_) {
+    recorder = recorder_;
+    if (recorder) {
+        recorder->OnCreateAddressSpace(*this, address_space_bits, big_page_bits, page_bits,
+                                       split_address);
+    }
+}
+
 GPUVAddr MemoryManager::Map(GPUVAddr gpu_addr, DAddr dev_addr, std::size_t size, PTEKind kind,
                             bool is_big_pages) {
+    if (recorder) [[unlikely]] {
+        recorder->OnMap(*this, gpu_addr, dev_addr, size, kind, is_big_pages);
+    }
     if (is_big_pages) [[likely]] {
         return BigPageTableOp<EntryType::Mapped>(gpu_addr, dev_addr, size, kind);
     }
@@ -188,6 +204,9 @@ GPUVAddr MemoryManager::Map(GPUVAddr gpu_addr, DAddr dev_addr, std::size_t size,
 }
 
 GPUVAddr MemoryManager::MapSparse(GPUVAddr gpu_addr, std::size_t size, bool is_big_pages) {
+    if (recorder) [[unlikely]] {
+        recorder->OnMapSparse(*this, gpu_addr, size, is_big_pages);
+    }
     if (is_big_pages) [[likely]] {
         return BigPageTableOp<EntryType::Reserved>(gpu_addr, 0, size, PTEKind::INVALID);
     }
@@ -198,6 +217,9 @@ void MemoryManager::Unmap(GPUVAddr gpu_addr, std::size_t size) {
     if (size == 0) {
         return;
     }
+    if (recorder) [[unlikely]] {
+        recorder->OnUnmap(*this, gpu_addr, size);
+    }
     GetSubmappedRangeImpl<false>(gpu_addr, size, page_stash);
 
     for (const auto& [map_addr, map_size] : page_stash) {
@@ -33,6 +33,8 @@ class System;
 
 namespace Tegra {
 
+class PushbufferRecorder;
+
 class MemoryManager final {
 public:
     explicit MemoryManager(Core::System& system_, u64 address_space_bits_ = 40,
@@ -52,6 +54,10 @@ public:
     /// Binds a renderer to the memory manager.
     void BindRasterizer(VideoCore::RasterizerInterface* rasterizer);
 
+    /// Binds a pushbuffer recorder that is notified of every change to the address space, nullptr
+    /// unbinds it.
+    void BindRecorder(PushbufferRecorder* recorder);
+
     [[nodiscard]] std::optional<DAddr> GpuToCpuAddress(GPUVAddr addr) const;
 
     [[nodiscard]] std::optional<DAddr> GpuToCpuAddress(GPUVAddr addr, std::size_t size) const;
@@ -209,6 +215,7 @@ private:
     u64 big_page_table_mask;
 
     VideoCore::RasterizerInterface* rasterizer = nullptr;
+    PushbufferRecorder* recorder = nullptr;
 
     enum class EntryType : u64 {
         Free = 0,
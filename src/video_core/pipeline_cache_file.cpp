@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <system_error>
+#include <unordered_map>
+
+#include "common/cityhash.h"
+#include "common/fs/file.h"
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "video_core/pipeline_cache_file.h"
+
+namespace VideoCommon {
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'s', 'u', 'y', 'u', 'p', 'c', 'c', 'h'};
+constexpr std::array<char, 8> LEGACY_MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
+constexpr std::array<char, 4> ENTRY_MAGIC_NUMBER{'p', 'c', 'e', 'n'};
+constexpr std::array<char, 8> INDEX_MAGIC_NUMBER{'s', 'u', 'y', 'u', 'p', 'i', 'd', 'x'};
+
+// Bump when the layout of the container changes, independently of the backend cache version
+constexpr u32 CONTAINER_VERSION = 1;
+
+struct FileHeader {
+    std::array<char, 8> magic_number;
+    u32 container_version;
+    u32 cache_version;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+struct EntryHeader {
+    std::array<char, 4> magic_number;
+    u32 compressed_size;
+    u32 uncompressed_size;
+    u32 reserved;
+    u64 key_hash;
+    u64 checksum;
+};
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+
+struct IndexFooter {
+    u64 index_offset;
+    u64 num_entries;
+    u64 index_checksum;
+    std::array<char, 8> magic_number;
+};
+static_assert(std::is_trivially_copyable_v<IndexFooter>);
+
+// Legacy caches only had the magic number and the cache version
+constexpr size_t LEGACY_HEADER_SIZE = LEGACY_MAGIC_NUMBER.size() + sizeof(u32);
+
+[[nodiscard]] u64 Checksum(std::span<const u8> data) {
+    return Common::CityHash64(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+template <typename T>
+[[nodiscard]] T ReadAt(std::span<const u8> data, u64 offset) {
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(value));
+    return value;
+}
+
+/// Returns true when footer describes an index that fills the rest of a file of file_size bytes
+[[nodiscard]] bool IsFooterConsistent(const IndexFooter& footer, u64 file_size) {
+    if (footer.magic_number != INDEX_MAGIC_NUMBER || footer.index_offset < sizeof(FileHeader)) {
+        return false;
+    }
+    if (footer.num_entries > file_size / sizeof(PipelineCacheEntry)) {
+        return false;
+    }
+    return footer.index_offset + footer.num_entries * sizeof(PipelineCacheEntry) +
+               sizeof(IndexFooter) ==
+           file_size;
+}
+
+[[nodiscard]] FileHeader MakeFileHeader(u32 cache_version) {
+    return FileHeader{
+        .magic_number = MAGIC_NUMBER,
+        .container_version = CONTAINER_VERSION,
+        .cache_version = cache_version,
+    };
+}
+
+/// Write an index and its footer at the current position of file, which must be index_offset
+bool WriteIndex(Common::FS::IOFile& file, u64 index_offset,
+                std::span<const PipelineCacheEntry> entries) {
+    const std::span<const u8> index_bytes(reinterpret_cast<const u8*>(entries.data()),
+                                          entries.size_bytes());
+    const IndexFooter footer{
+        .index_offset = index_offset,
+        .num_entries = entries.size(),
+        .index_checksum = Checksum(index_bytes),
+        .magic_number = INDEX_MAGIC_NUMBER,
+    };
+    return file.WriteSpan(entries) == entries.size() && file.WriteObject(footer);
+}
+
+} // Anonymous namespace
+
+PipelineCacheStatus PipelineCacheReader::Open(const std::filesystem::path& filename,
+                                              u32 expected_cache_version) {
+    Close();
+    file.Open(filename);
+    if (!file.IsOpen()) {
+        return PipelineCacheStatus::NotFound;
+    }
+    const std::span<const u8> data{file.Data()};
+    if (data.size() >= LEGACY_HEADER_SIZE &&
+        ReadAt<std::array<char, 8>>(data, 0) == LEGACY_MAGIC_NUMBER) {
+        const u32 legacy_version = ReadAt<u32>(data, LEGACY_MAGIC_NUMBER.size());
+        return legacy_version == expected_cache_version ? PipelineCacheStatus::Legacy
+                                                        : PipelineCacheStatus::OldVersion;
+    }
+    if (data.size() < sizeof(FileHeader)) {
+        return PipelineCacheStatus::Invalid;
+    }
+    const auto header = ReadAt<FileHeader>(data, 0);
+    if (header.magic_number != MAGIC_NUMBER) {
+        return PipelineCacheStatus::Invalid;
+    }
+    if (header.container_version != CONTAINER_VERSION ||
+        header.cache_version != expected_cache_version) {
+        return PipelineCacheStatus::OldVersion;
+    }
+    if (!ReadIndex()) {
+        ScanEntries();
+    }
+    return PipelineCacheStatus::Ok;
+}
+
+void PipelineCacheReader::Close() {
+    file.Close();
+    entries.clear();
+    data_end = 0;
+    has_index = false;
+}
+
+std::vector<u8> PipelineCacheReader::Decompress(const PipelineCacheEntry& entry) const {
+    const std::span<const u8> compressed{file.Data().subspan(entry.offset, entry.compressed_size)};
+    if (Checksum(compressed) != entry.checksum) {
+        return {};
+    }
+    std::vector<u8> data{Common::Compression::DecompressDataZSTD(compressed)};
+    if (data.size() != entry.uncompressed_size) {
+        return {};
+    }
+    return data;
+}
+
+bool PipelineCacheReader::ReadIndex() {
+    const std::span<const u8> data{file.Data()};
+    if (data.size() < sizeof(FileHeader) + sizeof(IndexFooter)) {
+        return false;
+    }
+    const auto footer = ReadAt<IndexFooter>(data, data.size() - sizeof(IndexFooter));
+    if (!IsFooterConsistent(footer, data.size())) {
+        return false;
+    }
+    const std::span<const u8> index_bytes{
+        data.subspan(footer.index_offset, footer.num_entries * sizeof(PipelineCacheEntry))};
+    if (Checksum(index_bytes) != footer.index_checksum) {
+        return false;
+    }
+    entries.resize(footer.num_entries);
+    std::memcpy(entries.data(), index_bytes.data(), index_bytes.size());
+    for (const PipelineCacheEntry& entry : entries) {
+        if (entry.offset + entry.compressed_size > footer.index_offset) {
+            entries.clear();
+            return false;
+        }
+    }
+    data_end = footer.index_offset;
+    has_index = true;
+    return true;
+}
+
+void PipelineCacheReader::ScanEntries() {
+    const std::span<const u8> data{file.Data()};
+    u64 offset = sizeof(FileHeader);
+    while (data.size() - offset >= sizeof(EntryHeader)) {
+        const auto header = ReadAt<EntryHeader>(data, offset);
+        if (header.magic_number != ENTRY_MAGIC_NUMBER ||
+            data.size() - offset - sizeof(EntryHeader) < header.compressed_size) {
+            // Either the trailing index or an interrupted append, both are rewritten later
+            break;
+        }
+        entries.push_back(PipelineCacheEntry{
+            .offset = offset + sizeof(EntryHeader),
+            .key_hash = header.key_hash,
+            .checksum = header.checksum,
+            .compressed_size = header.compressed_size,
+            .uncompressed_size = header.uncompressed_size,
+        });
+        offset += sizeof(EntryHeader) + header.compressed_size;
+    }
+    data_end = offset;
+}
+
+void AppendPipelineCacheEntry(const std::filesystem::path& filename, u32 cache_version,
+                              u64 key_hash, std::span<const u8> data) {
+    const std::vector<u8> compressed{
+        Common::Compression::CompressDataZSTDDefault(data.data(), data.size())};
+    if (compressed.empty()) {
+        LOG_ERROR(Common_Filesystem, "Failed to compress pipeline cache entry");
+        return;
+    }
+    const bool exists{Common::FS::Exists(filename)};
+    Common::FS::IOFile file(filename, exists ? Common::FS::FileAccessMode::ReadWrite
+                                             : Common::FS::FileAccessMode::Write);
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+        return;
+    }
+    const u64 file_size{file.GetSize()};
+    if (file_size < sizeof(FileHeader)) {
+        if (!file.SetSize(0) || !file.WriteObject(MakeFileHeader(cache_version))) {
+            LOG_ERROR(Common_Filesystem, "Failed to write pipeline cache header");
+            return;
+        }
+    } else if (file_size >= sizeof(FileHeader) + sizeof(IndexFooter)) {
+        // New entries go where the index is, it is rebuilt the next time the file is loaded
+        IndexFooter footer{};
+        if (file.Seek(static_cast<s64>(file_size - sizeof(IndexFooter))) &&
+            file.ReadObject(footer) && IsFooterConsistent(footer, file_size) &&
+            !file.SetSize(footer.index_offset)) {
+            return;
+        }
+    }
+    const EntryHeader header{
+        .magic_number = ENTRY_MAGIC_NUMBER,
+        .compressed_size = static_cast<u32>(compressed.size()),
+        .uncompressed_size = static_cast<u32>(data.size()),
+        .reserved = 0,
+        .key_hash = key_hash,
+        .checksum = Checksum(compressed),
+    };
+    if (!file.Seek(0, Common::FS::SeekOrigin::End) || !file.WriteObject(header) ||
+        file.WriteSpan(std::span<const u8>{compressed}) != compressed.size()) {
+        // A partial entry is discarded the next time the file is loaded
+        LOG_ERROR(Common_Filesystem, "Failed to append to pipeline cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+    }
+}
+
+bool WritePipelineCacheIndex(const std::filesystem::path& filename, u64 data_end,
+                             std::span<const PipelineCacheEntry> entries) {
+    Common::FS::IOFile file(filename, Common::FS::FileAccessMode::ReadWrite);
+    if (!file.IsOpen() || !file.SetSize(data_end) ||
+        !file.Seek(0, Common::FS::SeekOrigin::End) || !WriteIndex(file, data_end, entries)) {
+        LOG_ERROR(Common_Filesystem, "Failed to write pipeline cache index {}",
+                  Common::FS::PathToUTF8String(filename));
+        return false;
+    }
+    return true;
+}
+
+std::vector<PipelineCacheCopies> GroupPipelineCacheCopies(
+    std::span<const PipelineCacheEntry> entries) {
+    std::vector<PipelineCacheCopies> groups;
+    std::unordered_map<u64, size_t> group_indices;
+    // Walk the entries backwards so that each group starts with the newest copy
+    for (size_t entry_index = entries.size(); entry_index-- > 0;) {
+        const auto [it, is_new] =
+            group_indices.try_emplace(entries[entry_index].key_hash, groups.size());
+        if (is_new) {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(entry_index);
+    }
+    std::ranges::reverse(groups);
+    return groups;
+}
+
+bool CompactPipelineCache(const std::filesystem::path& filename, u32 expected_cache_version) {
+    PipelineCacheReader reader;
+    if (reader.Open(filename, expected_cache_version) != PipelineCacheStatus::Ok) {
+        return false;
+    }
+    std::filesystem::path temp_filename{filename};
+    temp_filename += ".tmp";
+
+    std::vector<PipelineCacheEntry> index;
+    bool success{};
+    {
+        Common::FS::IOFile file(temp_filename, Common::FS::FileAccessMode::Write);
+        success = file.IsOpen() && file.WriteObject(MakeFileHeader(expected_cache_version));
+
+        // Keep the newest valid copy of each pipeline, dropping duplicated and corrupted entries
+        const std::span<const PipelineCacheEntry> entries{reader.Entries()};
+        std::vector<size_t> kept_entries;
+        for (const PipelineCacheCopies& copies : GroupPipelineCacheCopies(entries)) {
+            const auto it = std::ranges::find_if(copies, [&](size_t entry_index) {
+                return !reader.Decompress(entries[entry_index]).empty();
+            });
+            if (it != copies.end()) {
+                kept_entries.push_back(*it);
+            }
+        }
+        std::ranges::sort(kept_entries);
+
+        u64 offset{sizeof(FileHeader)};
+        for (const size_t entry_index : kept_entries) {
+            if (!success) {
+                break;
+            }
+            const PipelineCacheEntry& entry{entries[entry_index]};
+            const EntryHeader header{
+                .magic_number = ENTRY_MAGIC_NUMBER,
+                .compressed_size = entry.compressed_size,
+                .uncompressed_size = entry.uncompressed_size,
+                .reserved = 0,
+                .key_hash = entry.key_hash,
+                .checksum = entry.checksum,
+            };
+            const std::span<const u8> compressed{
+                reader.Data().subspan(entry.offset, entry.compressed_size)};
+            success = file.WriteObject(header) && file.WriteSpan(compressed) == compressed.size();
+
+            PipelineCacheEntry& new_entry{index.emplace_back(entry)};
+            new_entry.offset = offset + sizeof(EntryHeader);
+            offset += sizeof(EntryHeader) + entry.compressed_size;
+        }
+        success = success && WriteIndex(file, offset, index);
+    }
+    const size_t num_entries{reader.Entries().size()};
+    reader.Close();
+
+    std::error_code ec;
+    if (success) {
+        std::filesystem::rename(temp_filename, filename, ec);
+    }
+    if (!success || ec) {
+        LOG_ERROR(Common_Filesystem, "Failed to compact pipeline cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+        std::filesystem::remove(temp_filename, ec);
+        return false;
+    }
+    LOG_INFO(Common_Filesystem, "Compacted pipeline cache, removed {} of {} entries",
+             num_entries - index.size(), num_entries);
+    return true;
+}
+
+} // namespace VideoCommon
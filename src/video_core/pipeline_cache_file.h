@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <boost/container/small_vector.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/mapped_file.h"
+
+namespace VideoCommon {
+
+/**
+ * Pipeline cache files are made of a header, a list of zstd compressed entries and a trailing
+ * index. Entries are only ever appended. Appending drops the trailing index, which is written
+ * again the next time the file is loaded, so a partial append only loses the entry being
+ * written. Every entry is checksummed, corrupted entries are skipped when loading.
+ */
+
+/// Compressed pipeline in a pipeline cache file, also used as the on-disk index record
+struct PipelineCacheEntry {
+    u64 offset;            ///< Offset of the compressed data in the file
+    u64 key_hash;          ///< Hash of the pipeline key, used to find duplicated pipelines
+    u64 checksum;          ///< Hash of the compressed data
+    u32 compressed_size;   ///< Size of the compressed data in bytes
+    u32 uncompressed_size; ///< Size of the decompressed data in bytes
+};
+static_assert(std::is_trivially_copyable_v<PipelineCacheEntry>);
+
+enum class PipelineCacheStatus {
+    Ok,         ///< The file was opened and its entries indexed
+    NotFound,   ///< The file does not exist
+    Invalid,    ///< The file is not a pipeline cache
+    OldVersion, ///< The file was written with a different cache version
+    Legacy,     ///< The file has the expected version but the uncompressed legacy layout
+};
+
+class PipelineCacheReader {
+public:
+    /// Map a pipeline cache file and index its entries
+    [[nodiscard]] PipelineCacheStatus Open(const std::filesystem::path& filename,
+                                           u32 expected_cache_version);
+
+    /// Unmap the file and forget its entries
+    void Close();
+
+    /// Returns the entries of the file in the order they were appended
+    [[nodiscard]] std::span<const PipelineCacheEntry> Entries() const noexcept {
+        return entries;
+    }
+
+    /// Returns true when the entries were read from a valid trailing index
+    [[nodiscard]] bool HasIndex() const noexcept {
+        return has_index;
+    }
+
+    /// Returns the offset where the last complete entry ends
+    [[nodiscard]] u64 DataEnd() const noexcept {
+        return data_end;
+    }
+
+    /// Returns the mapped contents of the file
+    [[nodiscard]] std::span<const u8> Data() const noexcept {
+        return file.Data();
+    }
+
+    /// Verify and decompress an entry
+    /// @returns The decompressed entry, or an empty vector when the entry is corrupted
+    [[nodiscard]] std::vector<u8> Decompress(const PipelineCacheEntry& entry) const;
+
+private:
+    bool ReadIndex();
+    void ScanEntries();
+
+    Common::FS::MappedFile file;
+    std::vector<PipelineCacheEntry> entries;
+    u64 data_end = 0;
+    bool has_index = false;
+};
+
+/// Copies of a pipeline in a cache file, as indices of its entries from the newest to the oldest
+using PipelineCacheCopies = boost::container::small_vector<size_t, 1>;
+
+/**
+ * Group the entries of a cache file by pipeline key, ordered by the position of their newest copy.
+ * Loading and compaction both use the newest copy of a pipeline that passes its checksum.
+ */
+[[nodiscard]] std::vector<PipelineCacheCopies> GroupPipelineCacheCopies(
+    std::span<const PipelineCacheEntry> entries);
+
+/// Compress and append a pipeline to a cache file, creating the file when it does not exist
+void AppendPipelineCacheEntry(const std::filesystem::path& filename, u32 cache_version,
+                              u64 key_hash, std::span<const u8> data);
+
+/// Drop everything past data_end in a cache file and write a trailing index for entries
+bool WritePipelineCacheIndex(const std::filesystem::path& filename, u64 data_end,
+                             std::span<const PipelineCacheEntry> entries);
+
+/// Rewrite a cache file keeping only the newest valid entry of each pipeline key
+bool CompactPipelineCache(const std::filesystem::path& filename, u32 expected_cache_version);
+
+} // namespace VideoCommon
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/logging/log.h"
+#include "video_core/pushbuffer_capture.h"
+
+namespace Tegra::Capture {
+
+bool CaptureReader::Open(const std::filesystem::path& filename) {
+    file.Open(filename);
+    offset = 0;
+    const std::span<const u8> data = file.Data();
+    if (data.size() < sizeof(FileHeader)) {
+        LOG_ERROR(HW_GPU, "Failed to open pushbuffer capture {}", filename.string());
+        file.Close();
+        return false;
+    }
+    FileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic_number != MAGIC_NUMBER || header.version != CAPTURE_VERSION) {
+        LOG_ERROR(HW_GPU, "{} is not a pushbuffer capture of version {}", filename.string(),
+                  CAPTURE_VERSION);
+        file.Close();
+        return false;
+    }
+    offset = sizeof(FileHeader);
+    return true;
+}
+
+std::optional<Record> CaptureReader::Next() {
+    const std::span<const u8> data = file.Data();
+    if (offset + sizeof(RecordHeader) > data.size()) {
+        return std::nullopt;
+    }
+    RecordHeader header;
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    const size_t payload_offset = offset + sizeof(header);
+    if (payload_offset + header.size > data.size()) {
+        // The capture was interrupted while writing this record
+        LOG_WARNING(HW_GPU, "Pushbuffer capture is truncated at offset {}", offset);
+        offset = data.size();
+        return std::nullopt;
+    }
+    offset = payload_offset + header.size;
+    return Record{
+        .type = header.type,
+        .payload = data.subspan(payload_offset, header.size),
+    };
+}
+
+} // namespace Tegra::Capture
@@ -0,0 +1,166 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/fs/mapped_file.h"
+
+namespace Tegra::Capture {
+
+/**
+ * Pushbuffer captures are made of a header followed by a stream of records. Each record has a
+ * type, the size of its payload and a fixed size body, optionally followed by variable data.
+ *
+ * A capture starts with every address space and mapping that existed when recording started,
+ * followed by snapshots of the mapped memory. After that, it holds the events of the captured
+ * frames in the order they happened.
+ */
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'s', 'u', 'y', 'u', 'p', 'b', 'c', 'p'};
+constexpr u32 CAPTURE_VERSION = 1;
+
+struct FileHeader {
+    std::array<char, 8> magic_number;
+    u32 version;
+    u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+enum class RecordType : u32 {
+    AddressSpace, ///< An address space was created
+    Map,          ///< Device memory was mapped into an address space
+    MapSparse,    ///< A range of an address space was reserved
+    Unmap,        ///< A range of an address space was unmapped
+    Memory,       ///< Contents of a range of an address space, followed by zstd data
+    Submit,       ///< A command list was submitted, followed by its entries
+    Frame,        ///< A frame was presented
+};
+
+struct RecordHeader {
+    RecordType type;
+    u32 size; ///< Size of the record body and its data in bytes
+};
+static_assert(std::is_trivially_copyable_v<RecordHeader>);
+
+struct AddressSpaceRecord {
+    u32 as_id;
+    u32 address_space_bits;
+    u32 big_page_bits;
+    u32 page_bits;
+    u64 split_address;
+};
+
+struct MapRecord {
+    u32 as_id;
+    u32 kind;
+    u64 gpu_addr;
+    u64 dev_addr;
+    u64 size;
+    u32 is_big_pages;
+    u32 reserved;
+};
+
+struct MapSparseRecord {
+    u32 as_id;
+    u32 is_big_pages;
+    u64 gpu_addr;
+    u64 size;
+};
+
+struct UnmapRecord {
+    u32 as_id;
+    u32 reserved;
+    u64 gpu_addr;
+    u64 size;
+};
+
+struct MemoryRecord {
+    u32 as_id;
+    u32 size; ///< Size of the decompressed memory
+    u64 gpu_addr;
+};
+
+/**
+ * Submitted command lists are followed by their entries. Regular lists have num_entries
+ * CommandListHeaders, each one followed by the command words it points to at submission time.
+ * Prefetched lists have num_entries command words.
+ */
+struct SubmitRecord {
+    s32 channel;
+    u32 as_id;
+    u32 num_entries;
+    u32 is_prefetch;
+};
+
+struct FrameRecord {
+    u64 frame;
+};
+
+/// Serialize a record at the end of a buffer
+template <typename Body>
+void AppendRecord(std::vector<u8>& buffer, RecordType type, const Body& body,
+                  std::span<const u8> data = {}) {
+    static_assert(std::is_trivially_copyable_v<Body>);
+    const RecordHeader header{
+        .type = type,
+        .size = static_cast<u32>(sizeof(Body) + data.size()),
+    };
+    const size_t offset = buffer.size();
+    buffer.resize(offset + sizeof(header) + header.size);
+    std::memcpy(buffer.data() + offset, &header, sizeof(header));
+    std::memcpy(buffer.data() + offset + sizeof(header), &body, sizeof(body));
+    if (!data.empty()) {
+        std::memcpy(buffer.data() + offset + sizeof(header) + sizeof(body), data.data(),
+                    data.size());
+    }
+}
+
+struct Record {
+    RecordType type;
+    std::span<const u8> payload;
+
+    /// Returns the fixed size body of the record
+    template <typename Body>
+    [[nodiscard]] Body Read() const {
+        Body body;
+        std::memcpy(&body, payload.data(), sizeof(body));
+        return body;
+    }
+
+    /// Returns the variable data following the body of the record
+    template <typename Body>
+    [[nodiscard]] std::span<const u8> Data() const {
+        return payload.subspan(sizeof(Body));
+    }
+};
+
+class CaptureReader {
+public:
+    /// Map a capture file
+    /// @returns True when the file is a capture of the current version
+    [[nodiscard]] bool Open(const std::filesystem::path& filename);
+
+    /// Read the next record
+    /// @returns The record, or std::nullopt at the end of the capture or on a truncated record
+    [[nodiscard]] std::optional<Record> Next();
+
+    /// Restart reading from the first record
+    void Rewind() noexcept {
+        offset = sizeof(FileHeader);
+    }
+
+private:
+    Common::FS::MappedFile file;
+    size_t offset = 0;
+};
+
+} // namespace Tegra::Capture
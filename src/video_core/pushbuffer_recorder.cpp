@@ -0,0 +1,350 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/fs/path_util.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/memory_manager.h"
+#include "video_core/pushbuffer_capture.h"
+#include "video_core/pushbuffer_recorder.h"
+
+namespace Tegra {
+
+namespace {
+using namespace Common::Literals;
+
+// Mapped memory is snapshotted in chunks to bound the size of the staging buffer
+constexpr u64 SNAPSHOT_CHUNK_SIZE = 4_MiB;
+// Records are written to disk when this much data has been buffered, or at the end of a frame
+constexpr size_t FLUSH_THRESHOLD = 16_MiB;
+
+[[nodiscard]] u32 AddressSpaceId(const MemoryManager& memory_manager) {
+    return static_cast<u32>(memory_manager.GetID());
+}
+} // Anonymous namespace
+
+PushbufferRecorder::PushbufferRecorder(Core::System& system_, u64 start_frame_, u64 num_frames)
+    : system{system_}, start_frame{start_frame_}, end_frame{start_frame_ + num_frames} {}
+
+PushbufferRecorder::~PushbufferRecorder() {
+    std::scoped_lock lock{mutex};
+    EndCapture();
+    // Address spaces can outlive the GPU that owns the recorder
+    for (const auto& [as_id, address_space] : address_spaces) {
+        address_space.memory_manager->BindRecorder(nullptr);
+    }
+}
+
+void PushbufferRecorder::OnCreateAddressSpace(MemoryManager& memory_manager,
+                                              u64 address_space_bits, u64 big_page_bits,
+                                              u64 page_bits, GPUVAddr split_address) {
+    std::scoped_lock lock{mutex};
+    // Starting the capture records the live layout, check it before changing the layout
+    const bool is_capturing = PrepareCapture();
+    const u32 as_id = AddressSpaceId(memory_manager);
+    AddressSpace address_space{
+        .memory_manager = &memory_manager,
+        .address_space_bits = address_space_bits,
+        .big_page_bits = big_page_bits,
+        .page_bits = page_bits,
+        .split_address = split_address,
+        .mappings = {},
+    };
+    const auto [it, is_new] = address_spaces.try_emplace(as_id, std::move(address_space));
+    if (is_capturing && is_new) {
+        AppendLayout(as_id, it->second);
+    }
+}
+
+void PushbufferRecorder::OnDestroyAddressSpace(MemoryManager& memory_manager) {
+    std::scoped_lock lock{mutex};
+    address_spaces.erase(AddressSpaceId(memory_manager));
+}
+
+void PushbufferRecorder::OnMap(MemoryManager& memory_manager, GPUVAddr gpu_addr, DAddr dev_addr,
+                               u64 size, PTEKind kind, bool is_big_pages) {
+    std::scoped_lock lock{mutex};
+    // Starting the capture takes a snapshot, the new mapping is not populated yet
+    const bool is_capturing = PrepareCapture();
+    const auto it = address_spaces.find(AddressSpaceId(memory_manager));
+    if (it == address_spaces.end()) {
+        return;
+    }
+    const Mapping mapping{
+        .size = size,
+        .dev_addr = dev_addr,
+        .kind = kind,
+        .is_big_pages = is_big_pages,
+        .is_sparse = false,
+    };
+    EraseMappings(it->second, gpu_addr, size);
+    it->second.mappings.emplace(gpu_addr, mapping);
+    if (is_capturing) {
+        AppendMapping(it->first, gpu_addr, mapping);
+    }
+}
+
+void PushbufferRecorder::OnMapSparse(MemoryManager& memory_manager, GPUVAddr gpu_addr, u64 size,
+                                     bool is_big_pages) {
+    std::scoped_lock lock{mutex};
+    const bool is_capturing = PrepareCapture();
+    const auto it = address_spaces.find(AddressSpaceId(memory_manager));
+    if (it == address_spaces.end()) {
+        return;
+    }
+    const Mapping mapping{
+        .size = size,
+        .dev_addr = 0,
+        .kind = PTEKind::INVALID,
+        .is_big_pages = is_big_pages,
+        .is_sparse = true,
+    };
+    EraseMappings(it->second, gpu_addr, size);
+    it->second.mappings.emplace(gpu_addr, mapping);
+    if (is_capturing) {
+        AppendMapping(it->first, gpu_addr, mapping);
+    }
+}
+
+void PushbufferRecorder::OnUnmap(MemoryManager& memory_manager, GPUVAddr gpu_addr, u64 size) {
+    std::scoped_lock lock{mutex};
+    const bool is_capturing = PrepareCapture();
+    const auto it = address_spaces.find(AddressSpaceId(memory_manager));
+    if (it == address_spaces.end()) {
+        return;
+    }
+    EraseMappings(it->second, gpu_addr, size);
+    if (is_capturing) {
+        const Capture::UnmapRecord record{
+            .as_id = it->first,
+            .reserved = 0,
+            .gpu_addr = gpu_addr,
+            .size = size,
+        };
+        Capture::AppendRecord(buffer, Capture::RecordType::Unmap, record);
+    }
+}
+
+void PushbufferRecorder::OnSubmit(s32 channel, MemoryManager& memory_manager,
+                                  const CommandList& command_list) {
+    std::scoped_lock lock{mutex};
+    if (!PrepareCapture()) {
+        return;
+    }
+    const bool is_prefetch = !command_list.prefetch_command_list.empty();
+    scratch.clear();
+    if (is_prefetch) {
+        const auto& words = command_list.prefetch_command_list;
+        scratch.resize(words.size() * sizeof(CommandHeader));
+        std::memcpy(scratch.data(), words.data(), scratch.size());
+    } else {
+        // Command words live in guest memory and may be overwritten once the GPU consumed them,
+        // store them next to their headers as they are at submission time
+        for (const CommandListHeader& header : command_list.command_lists) {
+            const size_t offset = scratch.size();
+            const size_t words_size = header.size * sizeof(u32);
+            scratch.resize(offset + sizeof(header) + words_size);
+            std::memcpy(scratch.data() + offset, &header, sizeof(header));
+            memory_manager.ReadBlockUnsafe(header.addr, scratch.data() + offset + sizeof(header),
+                                           words_size);
+        }
+    }
+    const Capture::SubmitRecord record{
+        .channel = channel,
+        .as_id = AddressSpaceId(memory_manager),
+        .num_entries = static_cast<u32>(is_prefetch ? command_list.prefetch_command_list.size()
+                                                    : command_list.command_lists.size()),
+        .is_prefetch = is_prefetch ? 1U : 0U,
+    };
+    Capture::AppendRecord(buffer, Capture::RecordType::Submit, record, scratch);
+    if (buffer.size() >= FLUSH_THRESHOLD) {
+        Flush();
+    }
+}
+
+void PushbufferRecorder::OnFrame() {
+    std::scoped_lock lock{mutex};
+    if (PrepareCapture()) {
+        Capture::AppendRecord(buffer, Capture::RecordType::Frame, Capture::FrameRecord{frame});
+        Flush();
+    }
+    ++frame;
+    if (frame == end_frame) {
+        EndCapture();
+        return;
+    }
+    // Snapshot memory at the frame boundary, before the first submission of the captured frame
+    (void)PrepareCapture();
+}
+
+void PushbufferRecorder::EraseMappings(AddressSpace& address_space, GPUVAddr gpu_addr, u64 size) {
+    auto& mappings = address_space.mappings;
+    const GPUVAddr end = gpu_addr + size;
+    auto it = mappings.upper_bound(gpu_addr);
+    if (it != mappings.begin()) {
+        // The previous mapping may extend into the range
+        --it;
+    }
+    while (it != mappings.end() && it->first < end) {
+        const GPUVAddr mapping_start = it->first;
+        const Mapping mapping = it->second;
+        const GPUVAddr mapping_end = mapping_start + mapping.size;
+        if (mapping_end <= gpu_addr) {
+            ++it;
+            continue;
+        }
+        it = mappings.erase(it);
+        if (mapping_start < gpu_addr) {
+            Mapping head = mapping;
+            head.size = gpu_addr - mapping_start;
+            mappings.emplace(mapping_start, head);
+        }
+        if (mapping_end > end) {
+            Mapping tail = mapping;
+            tail.size = mapping_end - end;
+            if (!mapping.is_sparse) {
+                tail.dev_addr += end - mapping_start;
+            }
+            it = mappings.emplace(end, tail).first;
+        }
+    }
+}
+
+void PushbufferRecorder::AppendLayout(u32 as_id, const AddressSpace& address_space) {
+    const Capture::AddressSpaceRecord record{
+        .as_id = as_id,
+        .address_space_bits = static_cast<u32>(address_space.address_space_bits),
+        .big_page_bits = static_cast<u32>(address_space.big_page_bits),
+        .page_bits = static_cast<u32>(address_space.page_bits),
+        .split_address = address_space.split_address,
+    };
+    Capture::AppendRecord(buffer, Capture::RecordType::AddressSpace, record);
+    for (const auto& [gpu_addr, mapping] : address_space.mappings) {
+        AppendMapping(as_id, gpu_addr, mapping);
+    }
+}
+
+void PushbufferRecorder::AppendMapping(u32 as_id, GPUVAddr gpu_addr, const Mapping& mapping) {
+    if (mapping.is_sparse) {
+        const Capture::MapSparseRecord record{
+            .as_id = as_id,
+            .is_big_pages = mapping.is_big_pages ? 1U : 0U,
+            .gpu_addr = gpu_addr,
+            .size = mapping.size,
+        };
+        Capture::AppendRecord(buffer, Capture::RecordType::MapSparse, record);
+        return;
+    }
+    const Capture::MapRecord record{
+        .as_id = as_id,
+        .kind = static_cast<u32>(mapping.kind),
+        .gpu_addr = gpu_addr,
+        .dev_addr = mapping.dev_addr,
+        .size = mapping.size,
+        .is_big_pages = mapping.is_big_pages ? 1U : 0U,
+        .reserved = 0,
+    };
+    Capture::AppendRecord(buffer, Capture::RecordType::Map, record);
+}
+
+bool PushbufferRecorder::PrepareCapture() {
+    if (!IsRecording() || has_failed) {
+        return false;
+    }
+    if (!file.IsOpen()) {
+        BeginCapture();
+    }
+    return !has_failed;
+}
+
+void PushbufferRecorder::BeginCapture() {
+    const auto base_dir{Common::FS::GetSuyuPath(Common::FS::SuyuPath::DumpDir)};
+    const auto capture_dir{base_dir / "pushbuffers"};
+    if (!Common::FS::CreateDir(base_dir) || !Common::FS::CreateDir(capture_dir)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create pushbuffer capture directories");
+        has_failed = true;
+        return;
+    }
+    const auto filename{capture_dir / fmt::format("{:016x}_{}.pbcap",
+                                                  system.GetApplicationProcessProgramID(),
+                                                  start_frame)};
+    file.Open(filename, Common::FS::FileAccessMode::Write);
+    const Capture::FileHeader header{
+        .magic_number = Capture::MAGIC_NUMBER,
+        .version = Capture::CAPTURE_VERSION,
+        .reserved = 0,
+    };
+    if (!file.IsOpen() || !file.WriteObject(header)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create pushbuffer capture {}",
+                  Common::FS::PathToUTF8String(filename));
+        file.Close();
+        has_failed = true;
+        return;
+    }
+    LOG_INFO(HW_GPU, "Capturing frames {} to {} into {}", start_frame, end_frame - 1,
+             Common::FS::PathToUTF8String(filename));
+
+    buffer.clear();
+    for (const auto& [as_id, address_space] : address_spaces) {
+        AppendLayout(as_id, address_space);
+    }
+    for (const auto& [as_id, address_space] : address_spaces) {
+        const MemoryManager& memory_manager = *address_space.memory_manager;
+        for (const auto& [start, mapping] : address_space.mappings) {
+            if (mapping.is_sparse) {
+                continue;
+            }
+            const GPUVAddr end = start + mapping.size;
+            for (GPUVAddr chunk = start; chunk < end; chunk += SNAPSHOT_CHUNK_SIZE) {
+                const u64 chunk_size = std::min(end - chunk, SNAPSHOT_CHUNK_SIZE);
+                scratch.resize(chunk_size);
+                memory_manager.ReadBlockUnsafe(chunk, scratch.data(), chunk_size);
+                const std::vector<u8> compressed =
+                    Common::Compression::CompressDataZSTDDefault(scratch.data(), scratch.size());
+                const Capture::MemoryRecord record{
+                    .as_id = as_id,
+                    .size = static_cast<u32>(chunk_size),
+                    .gpu_addr = chunk,
+                };
+                Capture::AppendRecord(buffer, Capture::RecordType::Memory, record, compressed);
+                if (buffer.size() >= FLUSH_THRESHOLD) {
+                    Flush();
+                }
+            }
+        }
+    }
+    Flush();
+}
+
+void PushbufferRecorder::Flush() {
+    if (!file.IsOpen() || buffer.empty()) {
+        return;
+    }
+    if (file.WriteSpan(std::span<const u8>{buffer}) != buffer.size()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write pushbuffer capture, stopping the capture");
+        file.Close();
+        has_failed = true;
+    }
+    buffer.clear();
+}
+
+void PushbufferRecorder::EndCapture() {
+    if (!file.IsOpen()) {
+        return;
+    }
+    Flush();
+    file.Close();
+    LOG_INFO(HW_GPU, "Pushbuffer capture finished");
+}
+
+} // namespace Tegra
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "video_core/pte_kind.h"
+
+namespace Core {
+class System;
+}
+
+namespace Tegra {
+
+struct CommandList;
+class MemoryManager;
+
+/**
+ * Records the command lists submitted to the GPU, the address spaces they run in and the memory
+ * they reference into a pushbuffer capture (see pushbuffer_capture.h).
+ *
+ * Until the first captured frame, only the live layout of each address space is tracked. When
+ * capturing starts, that layout and the contents of every mapped range are written, followed by
+ * every event until the last captured frame is presented.
+ */
+class PushbufferRecorder {
+public:
+    explicit PushbufferRecorder(Core::System& system, u64 start_frame, u64 num_frames);
+    ~PushbufferRecorder();
+
+    PushbufferRecorder(const PushbufferRecorder&) = delete;
+    PushbufferRecorder& operator=(const PushbufferRecorder&) = delete;
+
+    /// Starts tracking an address space
+    void OnCreateAddressSpace(MemoryManager& memory_manager, u64 address_space_bits,
+                              u64 big_page_bits, u64 page_bits, GPUVAddr split_address);
+
+    /// Stops tracking an address space that is being destroyed
+    void OnDestroyAddressSpace(MemoryManager& memory_manager);
+
+    void OnMap(MemoryManager& memory_manager, GPUVAddr gpu_addr, DAddr dev_addr, u64 size,
+               PTEKind kind, bool is_big_pages);
+
+    void OnMapSparse(MemoryManager& memory_manager, GPUVAddr gpu_addr, u64 size,
+                     bool is_big_pages);
+
+    void OnUnmap(MemoryManager& memory_manager, GPUVAddr gpu_addr, u64 size);
+
+    /// Records a command list submitted to a channel running in the given address space
+    void OnSubmit(s32 channel, MemoryManager& memory_manager, const CommandList& command_list);
+
+    /// Records the presentation of a frame
+    void OnFrame();
+
+private:
+    struct Mapping {
+        u64 size;
+        DAddr dev_addr; ///< Zero for sparse mappings
+        PTEKind kind;
+        bool is_big_pages;
+        bool is_sparse;
+    };
+
+    struct AddressSpace {
+        MemoryManager* memory_manager;
+        u64 address_space_bits;
+        u64 big_page_bits;
+        u64 page_bits;
+        GPUVAddr split_address;
+        std::map<GPUVAddr, Mapping> mappings; ///< Live mappings, by GPU address
+    };
+
+    [[nodiscard]] bool IsRecording() const noexcept {
+        return frame >= start_frame && frame < end_frame;
+    }
+
+    /// Removes the parts of the live mappings in the given range, splitting them if needed
+    static void EraseMappings(AddressSpace& address_space, GPUVAddr gpu_addr, u64 size);
+
+    /// Records an address space and its live mappings
+    void AppendLayout(u32 as_id, const AddressSpace& address_space);
+
+    void AppendMapping(u32 as_id, GPUVAddr gpu_addr, const Mapping& mapping);
+
+    /// Returns true when events have to be written to the capture, starting it if needed
+    [[nodiscard]] bool PrepareCapture();
+
+    /// Opens the capture file, writes the tracked layout and snapshots every mapped range
+    void BeginCapture();
+
+    /// Writes the records buffered so far to the capture file
+    void Flush();
+
+    /// Closes the capture file
+    void EndCapture();
+
+    Core::System& system;
+    const u64 start_frame;
+    const u64 end_frame;
+    u64 frame = 0;
+
+    std::mutex mutex;
+    std::map<u32, AddressSpace> address_spaces;
+    std::vector<u8> buffer;
+    std::vector<u8> scratch;
+    Common::FS::IOFile file;
+    bool has_failed = false;
+};
+
+} // namespace Tegra
@@ -0,0 +1,307 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "common/alignment.h"
+#include "common/host_memory.h"
+#include "common/logging/log.h"
+#include "common/page_table.h"
+#include "common/zstd_compression.h"
+#include "core/core.h"
+#include "core/device_memory.h"
+#include "core/hle/kernel/board/nintendo/nx/k_system_control.h"
+#include "core/memory.h"
+#include "video_core/control/channel_state.h"
+#include "video_core/dma_pusher.h"
+#include "video_core/gpu.h"
+#include "video_core/host1x/host1x.h"
+#include "video_core/memory_manager.h"
+#include "video_core/pushbuffer_replayer.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+
+namespace Tegra::Capture {
+
+namespace {
+
+/// Counts the method calls a stream of command words decodes to, the same way DmaPusher does
+class MethodCounter {
+public:
+    [[nodiscard]] u64 Count(std::span<const u8> bytes) {
+        const size_t num_words = bytes.size() / sizeof(CommandHeader);
+        u64 num_methods = 0;
+        for (size_t index = 0; index < num_words;) {
+            if (pending_arguments > 0) {
+                const u32 num_arguments =
+                    static_cast<u32>(std::min<size_t>(pending_arguments, num_words - index));
+                pending_arguments -= num_arguments;
+                num_methods += num_arguments;
+                index += num_arguments;
+                continue;
+            }
+            CommandHeader header;
+            std::memcpy(&header, bytes.data() + index * sizeof(header), sizeof(header));
+            switch (header.mode) {
+            case SubmissionMode::Increasing:
+            case SubmissionMode::NonIncreasing:
+            case SubmissionMode::IncreaseOnce:
+                pending_arguments = header.method_count;
+                break;
+            case SubmissionMode::Inline:
+                ++num_methods;
+                break;
+            default:
+                break;
+            }
+            ++index;
+        }
+        return num_methods;
+    }
+
+private:
+    u32 pending_arguments = 0;
+};
+
+template <typename Body>
+[[nodiscard]] bool HasBody(const Record& record) {
+    return record.payload.size() >= sizeof(Body);
+}
+
+} // Anonymous namespace
+
+GpuReplayTarget::GpuReplayTarget(Core::System& system_)
+    : system{system_}, gpu{system_.GPU()}, page_table{std::make_unique<Common::PageTable>()},
+      memory{std::make_unique<Core::Memory::Memory>(system_)},
+      next_physical_address{Core::DramMemoryMap::Base},
+      physical_end{Core::DramMemoryMap::Base +
+                   Kernel::Board::Nintendo::Nx::KSystemControl::Init::GetIntendedMemorySize()},
+      backed_pages(size_t{1} << (MaxwellDeviceMemoryManager::AS_BITS -
+                                 Core::Memory::SUYU_PAGEBITS)) {
+    page_table->Resize(MaxwellDeviceMemoryManager::AS_BITS, Core::Memory::SUYU_PAGEBITS);
+    memory->SetCurrentPageTable(*page_table);
+    asid = gpu.Host1x().MemoryManager().RegisterProcess(memory.get()).id;
+}
+
+GpuReplayTarget::~GpuReplayTarget() {
+    auto& device_memory = gpu.Host1x().MemoryManager();
+    for (size_t page = 0; page < backed_pages.size();) {
+        if (!backed_pages[page]) {
+            ++page;
+            continue;
+        }
+        const size_t first_page = page;
+        while (page < backed_pages.size() && backed_pages[page]) {
+            ++page;
+        }
+        device_memory.Unmap(first_page << Core::Memory::SUYU_PAGEBITS,
+                            (page - first_page) << Core::Memory::SUYU_PAGEBITS);
+    }
+    device_memory.UnregisterProcess(Core::Asid{asid});
+}
+
+void GpuReplayTarget::CreateAddressSpace(const AddressSpaceRecord& record) {
+    auto memory_manager =
+        std::make_shared<MemoryManager>(system, record.address_space_bits, record.split_address,
+                                        record.big_page_bits, record.page_bits);
+    gpu.InitAddressSpace(*memory_manager);
+    address_spaces.insert_or_assign(record.as_id, std::move(memory_manager));
+}
+
+void GpuReplayTarget::Map(const MapRecord& record) {
+    MemoryManager* const memory_manager = GetAddressSpace(record.as_id);
+    if (!memory_manager) {
+        LOG_ERROR(HW_GPU, "Map in unknown address space {}", record.as_id);
+        return;
+    }
+    BackDeviceMemory(record.dev_addr, record.size);
+    memory_manager->Map(record.gpu_addr, record.dev_addr, record.size,
+                        static_cast<PTEKind>(record.kind), record.is_big_pages != 0);
+}
+
+void GpuReplayTarget::MapSparse(const MapSparseRecord& record) {
+    if (MemoryManager* const memory_manager = GetAddressSpace(record.as_id)) {
+        memory_manager->MapSparse(record.gpu_addr, record.size, record.is_big_pages != 0);
+    }
+}
+
+void GpuReplayTarget::Unmap(const UnmapRecord& record) {
+    if (MemoryManager* const memory_manager = GetAddressSpace(record.as_id)) {
+        memory_manager->Unmap(record.gpu_addr, record.size);
+    }
+}
+
+void GpuReplayTarget::WriteMemory(u32 as_id, GPUVAddr gpu_addr, std::span<const u8> data) {
+    if (MemoryManager* const memory_manager = GetAddressSpace(as_id)) {
+        memory_manager->WriteBlock(gpu_addr, data.data(), data.size());
+    }
+}
+
+void GpuReplayTarget::Submit(s32 channel, u32 as_id, CommandList&& command_list) {
+    auto it = channels.find(channel);
+    if (it == channels.end()) {
+        // Channels stay in the address space of their first submission
+        const auto address_space = address_spaces.find(as_id);
+        if (address_space == address_spaces.end()) {
+            LOG_ERROR(HW_GPU, "Submission to channel {} in unknown address space {}", channel,
+                      as_id);
+            return;
+        }
+        std::shared_ptr<Control::ChannelState> channel_state = gpu.AllocateChannel();
+        channel_state->memory_manager = address_space->second;
+        // No application is loaded, there is no program to apply workarounds for
+        gpu.InitChannel(*channel_state, 0);
+        it = channels.emplace(channel, std::move(channel_state)).first;
+    }
+    Control::ChannelState& channel_state = *it->second;
+    gpu.BindChannel(channel_state.bind_id);
+    channel_state.dma_pusher->Push(std::move(command_list));
+    channel_state.dma_pusher->DispatchCalls();
+}
+
+void GpuReplayTarget::EndFrame() {
+    // Presented framebuffers are not captured, only advance the per frame state of the caches
+    gpu.Renderer().ReadRasterizer()->TickFrame();
+}
+
+MemoryManager* GpuReplayTarget::GetAddressSpace(u32 as_id) {
+    const auto it = address_spaces.find(as_id);
+    return it != address_spaces.end() ? it->second.get() : nullptr;
+}
+
+Control::ChannelState* GpuReplayTarget::GetChannel(s32 channel) {
+    const auto it = channels.find(channel);
+    return it != channels.end() ? it->second.get() : nullptr;
+}
+
+void GpuReplayTarget::BackDeviceMemory(DAddr dev_addr, u64 size) {
+    const size_t end_page = std::min<size_t>(
+        Common::DivideUp(dev_addr + size, Core::Memory::SUYU_PAGESIZE), backed_pages.size());
+    size_t page = dev_addr >> Core::Memory::SUYU_PAGEBITS;
+    while (page < end_page) {
+        if (backed_pages[page]) {
+            ++page;
+            continue;
+        }
+        const size_t first_page = page;
+        while (page < end_page && !backed_pages[page]) {
+            ++page;
+        }
+        const DAddr run_addr = first_page << Core::Memory::SUYU_PAGEBITS;
+        const u64 run_size = (page - first_page) << Core::Memory::SUYU_PAGEBITS;
+        if (physical_end - next_physical_address < run_size) {
+            LOG_ERROR(HW_GPU, "Out of physical memory to back device memory at 0x{:x}", run_addr);
+            return;
+        }
+        memory->MapMemoryRegion(*page_table, run_addr, run_size,
+                                Common::PhysicalAddress{next_physical_address},
+                                Common::MemoryPermission::ReadWrite, false);
+        gpu.Host1x().MemoryManager().Map(run_addr, run_addr, run_size, Core::Asid{asid});
+        std::fill(backed_pages.begin() + first_page, backed_pages.begin() + page, true);
+        next_physical_address += run_size;
+    }
+}
+
+std::optional<ReplayStats> Replay(CaptureReader& reader, ReplayTarget& target) {
+    ReplayStats stats;
+    // Methods can be split across command lists, keep the decoding state of each channel
+    std::unordered_map<s32, MethodCounter> method_counters;
+
+    while (const std::optional<Record> record = reader.Next()) {
+        switch (record->type) {
+        case RecordType::AddressSpace:
+            if (!HasBody<AddressSpaceRecord>(*record)) {
+                return std::nullopt;
+            }
+            target.CreateAddressSpace(record->Read<AddressSpaceRecord>());
+            break;
+        case RecordType::Map:
+            if (!HasBody<MapRecord>(*record)) {
+                return std::nullopt;
+            }
+            target.Map(record->Read<MapRecord>());
+            break;
+        case RecordType::MapSparse:
+            if (!HasBody<MapSparseRecord>(*record)) {
+                return std::nullopt;
+            }
+            target.MapSparse(record->Read<MapSparseRecord>());
+            break;
+        case RecordType::Unmap:
+            if (!HasBody<UnmapRecord>(*record)) {
+                return std::nullopt;
+            }
+            target.Unmap(record->Read<UnmapRecord>());
+            break;
+        case RecordType::Memory: {
+            if (!HasBody<MemoryRecord>(*record)) {
+                return std::nullopt;
+            }
+            const auto memory = record->Read<MemoryRecord>();
+            const std::vector<u8> data =
+                Common::Compression::DecompressDataZSTD(record->Data<MemoryRecord>());
+            if (data.size() != memory.size) {
+                LOG_ERROR(HW_GPU, "Corrupted memory snapshot at 0x{:x}", memory.gpu_addr);
+                return std::nullopt;
+            }
+            target.WriteMemory(memory.as_id, memory.gpu_addr, data);
+            stats.snapshot_bytes += data.size();
+            break;
+        }
+        case RecordType::Submit: {
+            if (!HasBody<SubmitRecord>(*record)) {
+                return std::nullopt;
+            }
+            const auto submit = record->Read<SubmitRecord>();
+            std::span<const u8> data = record->Data<SubmitRecord>();
+            MethodCounter& method_counter = method_counters[submit.channel];
+            if (submit.is_prefetch) {
+                const size_t size = size_t{submit.num_entries} * sizeof(CommandHeader);
+                if (data.size() != size) {
+                    return std::nullopt;
+                }
+                boost::container::small_vector<CommandHeader, 512> words(submit.num_entries);
+                std::memcpy(words.data(), data.data(), size);
+                stats.methods += method_counter.Count(data);
+                stats.command_bytes += size;
+                target.Submit(submit.channel, submit.as_id, CommandList{std::move(words)});
+            } else {
+                CommandList command_list(submit.num_entries);
+                for (CommandListHeader& header : command_list.command_lists) {
+                    if (data.size() < sizeof(header)) {
+                        return std::nullopt;
+                    }
+                    std::memcpy(&header, data.data(), sizeof(header));
+                    const size_t size = header.size * sizeof(u32);
+                    if (data.size() < sizeof(header) + size) {
+                        return std::nullopt;
+                    }
+                    const std::span<const u8> words = data.subspan(sizeof(header), size);
+                    target.WriteMemory(submit.as_id, header.addr, words);
+                    stats.methods += method_counter.Count(words);
+                    stats.command_bytes += size;
+                    data = data.subspan(sizeof(header) + size);
+                }
+                stats.command_lists += submit.num_entries;
+                target.Submit(submit.channel, submit.as_id, std::move(command_list));
+            }
+            ++stats.submits;
+            break;
+        }
+        case RecordType::Frame:
+            target.EndFrame();
+            ++stats.frames;
+            break;
+        default:
+            LOG_ERROR(HW_GPU, "Unknown pushbuffer capture record type {}",
+                      static_cast<u32>(record->type));
+            return std::nullopt;
+        }
+    }
+    return stats;
+}
+
+} // namespace Tegra::Capture
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "common/common_types.h"
+#include "video_core/pushbuffer_capture.h"
+
+namespace Common {
+struct PageTable;
+}
+
+namespace Core {
+class System;
+namespace Memory {
+class Memory;
+}
+} // namespace Core
+
+namespace Tegra {
+struct CommandList;
+class GPU;
+class MemoryManager;
+namespace Control {
+struct ChannelState;
+}
+} // namespace Tegra
+
+namespace Tegra::Capture {
+
+/// Receives the events of a replayed capture
+class ReplayTarget {
+public:
+    virtual ~ReplayTarget() = default;
+
+    virtual void CreateAddressSpace(const AddressSpaceRecord& record) = 0;
+
+    virtual void Map(const MapRecord& record) = 0;
+
+    virtual void MapSparse(const MapSparseRecord& record) = 0;
+
+    virtual void Unmap(const UnmapRecord& record) = 0;
+
+    /// Writes to the memory of an address space, for snapshots and the words of command lists
+    virtual void WriteMemory(u32 as_id, GPUVAddr gpu_addr, std::span<const u8> data) = 0;
+
+    /// Submits a command list, its command words have been written to memory beforehand
+    virtual void Submit(s32 channel, u32 as_id, CommandList&& command_list) = 0;
+
+    /// Presents a frame
+    virtual void EndFrame() = 0;
+};
+
+struct ReplayStats {
+    u64 frames{};
+    u64 submits{};
+    u64 command_lists{};
+    u64 methods{};        ///< Method calls the submitted command words decode to
+    u64 command_bytes{};  ///< Size of the submitted command words
+    u64 snapshot_bytes{}; ///< Size of the decompressed memory snapshots
+};
+
+/**
+ * Replays a capture on the GPU of a system set up with Core::System::InitializeGPU.
+ *
+ * Each captured channel gets a channel of its own, whose DmaPusher executes the submitted command
+ * lists. Captured device addresses are backed with physical memory as they are mapped, through a
+ * page table owned by the target.
+ */
+class GpuReplayTarget final : public ReplayTarget {
+public:
+    explicit GpuReplayTarget(Core::System& system);
+    ~GpuReplayTarget() override;
+
+    GpuReplayTarget(const GpuReplayTarget&) = delete;
+    GpuReplayTarget& operator=(const GpuReplayTarget&) = delete;
+
+    void CreateAddressSpace(const AddressSpaceRecord& record) override;
+
+    void Map(const MapRecord& record) override;
+
+    void MapSparse(const MapSparseRecord& record) override;
+
+    void Unmap(const UnmapRecord& record) override;
+
+    void WriteMemory(u32 as_id, GPUVAddr gpu_addr, std::span<const u8> data) override;
+
+    void Submit(s32 channel, u32 as_id, CommandList&& command_list) override;
+
+    void EndFrame() override;
+
+    /// Returns a replayed address space, nullptr if the capture has not created it
+    [[nodiscard]] MemoryManager* GetAddressSpace(u32 as_id);
+
+    /// Returns a replayed channel, nullptr if nothing has been submitted to it yet
+    [[nodiscard]] Control::ChannelState* GetChannel(s32 channel);
+
+private:
+    /// Backs the pages of a device memory range that are not backed yet with physical memory
+    void BackDeviceMemory(DAddr dev_addr, u64 size);
+
+    Core::System& system;
+    GPU& gpu;
+    std::unique_ptr<Common::PageTable> page_table; ///< Maps device addresses to themselves
+    std::unique_ptr<Core::Memory::Memory> memory;
+    size_t asid{};
+    PAddr next_physical_address{};
+    PAddr physical_end{};
+    std::vector<bool> backed_pages;
+    std::unordered_map<u32, std::shared_ptr<MemoryManager>> address_spaces;
+    std::unordered_map<s32, std::shared_ptr<Control::ChannelState>> channels;
+};
+
+/**
+ * Replays the records of a capture into a target from its current position
+ * @returns Statistics of the replay, or std::nullopt if the capture is malformed
+ */
+[[nodiscard]] std::optional<ReplayStats> Replay(CaptureReader& reader, ReplayTarget& target);
+
+} // namespace Tegra::Capture
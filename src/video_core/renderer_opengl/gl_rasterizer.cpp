@@ -153,6 +153,7 @@ void RasterizerOpenGL::SyncVertexInstances() {
 void RasterizerOpenGL::LoadDiskResources(u64 title_id, std::stop_token stop_loading,
                                          const VideoCore::DiskResourceLoadCallback& callback) {
     shader_cache.LoadDiskResources(title_id, stop_loading, callback);
+    texture_cache.LoadDiskResources(title_id);
 }
 
 void RasterizerOpenGL::Clear(u32 layer_count) {
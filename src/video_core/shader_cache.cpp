@@ -112,17 +112,11 @@ void ShaderCache::GetGraphicsEnvironments(GraphicsEnvironments& result,
 }
 
 ShaderInfo* ShaderCache::TryGet(VAddr addr) const {
-    std::scoped_lock lock{lookup_mutex};
-
-    const auto it = lookup_cache.find(addr);
-    if (it == lookup_cache.end()) {
-        return nullptr;
-    }
-    return it->second->data;
+    return lookup_table.Find(addr);
 }
 
 void ShaderCache::Register(std::unique_ptr<ShaderInfo> data, VAddr addr, size_t size) {
-    std::scoped_lock lock{invalidation_mutex, lookup_mutex};
+    std::scoped_lock lock{invalidation_mutex};
 
     const VAddr addr_end = addr + size;
     Entry* const entry = NewEntry(addr, addr_end, data.get());
@@ -160,12 +154,12 @@ void ShaderCache::RemovePendingShaders() {
 
     boost::container::small_vector<ShaderInfo*, 16> removed_shaders;
 
-    std::scoped_lock lock{lookup_mutex};
     for (Entry* const entry : marked_for_removal) {
         removed_shaders.push_back(entry->data);
 
         const auto it = lookup_cache.find(entry->addr_start);
         ASSERT(it != lookup_cache.end());
+        lookup_table.Erase(entry->addr_start);
         lookup_cache.erase(it);
     }
     marked_for_removal.clear();
@@ -225,6 +219,7 @@ ShaderCache::Entry* ShaderCache::NewEntry(VAddr addr, VAddr addr_end, ShaderInfo
     auto entry = std::make_unique<Entry>(Entry{addr, addr_end, data});
     Entry* const entry_pointer = entry.get();
 
+    lookup_table.Insert(addr, data);
     lookup_cache.emplace(addr, std::move(entry));
     return entry_pointer;
 }
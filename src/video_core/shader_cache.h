@@ -17,6 +17,7 @@
 #include "video_core/host1x/gpu_device_memory_manager.h"
 #include "video_core/rasterizer_interface.h"
 #include "video_core/shader_environment.h"
+#include "video_core/shader_lookup_table.h"
 
 namespace Tegra {
 class MemoryManager;
@@ -99,6 +100,7 @@ protected:
 private:
     /// @brief Tries to obtain a cached shader starting in a given address
     /// @note Doesn't check for ranges, the given address has to be the start of the shader
+    /// @note Doesn't lock, it can run concurrently with invalidations
     /// @param addr Start address of the shader, this doesn't cache for region
     /// @return Pointer to a valid shader, nullptr when nothing is found
     ShaderInfo* TryGet(VAddr addr) const;
@@ -136,11 +138,10 @@ private:
     /// @brief Removes a vector of shaders from a list
     /// @param removed_shaders Shaders to be removed from the storage
     /// @pre invalidation_mutex is locked
-    /// @pre lookup_mutex is locked
     void RemoveShadersFromStorage(std::span<ShaderInfo*> removed_shaders);
 
     /// @brief Creates a new entry in the lookup cache and returns its pointer
-    /// @pre lookup_mutex is locked
+    /// @pre invalidation_mutex is locked
     Entry* NewEntry(VAddr addr, VAddr addr_end, ShaderInfo* data);
 
     /// @brief Create a new shader entry and register it
@@ -148,9 +149,9 @@ private:
 
     Tegra::MaxwellDeviceMemoryManager& device_memory;
 
-    mutable std::mutex lookup_mutex;
     std::mutex invalidation_mutex;
 
+    ShaderLookupTable lookup_table;
     std::unordered_map<u64, std::unique_ptr<Entry>> lookup_cache;
     std::unordered_map<u64, std::vector<Entry*>> invalidation_cache;
     std::vector<std::unique_ptr<ShaderInfo>> storage;
@@ -2,35 +2,48 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
 #include <optional>
+#include <sstream>
+#include <thread>
 #include <utility>
 
+#include <boost/container/static_vector.hpp>
+
 #include "common/assert.h"
 #include "common/cityhash.h"
 #include "common/common_types.h"
 #include "common/div_ceil.h"
 #include "common/fs/fs.h"
+#include "common/fs/mapped_file.h"
 #include "common/fs/path_util.h"
 #include "common/logging/log.h"
 #include "common/polyfill_ranges.h"
+#include "common/thread.h"
 #include "shader_recompiler/environment.h"
 #include "video_core/engines/kepler_compute.h"
 #include "video_core/memory_manager.h"
+#include "video_core/pipeline_cache_file.h"
 #include "video_core/shader_environment.h"
 #include "video_core/texture_cache/format_lookup_table.h"
 #include "video_core/textures/texture.h"
 
 namespace VideoCommon {
 
-constexpr std::array<char, 8> MAGIC_NUMBER{'y', 'u', 'z', 'u', 'c', 'a', 'c', 'h'};
-
 constexpr size_t INST_SIZE = sizeof(u64);
 
+// Legacy cache files start with an 8 byte magic number and the cache version
+constexpr size_t LEGACY_HEADER_SIZE = 8 + sizeof(u32);
+
 using Maxwell = Tegra::Engines::Maxwell3D::Regs;
 
+// Graphics pipelines have at most one environment per Maxwell program stage
+constexpr size_t MAX_PIPELINE_ENVS = Maxwell::MaxShaderProgram;
+
 static u64 MakeCbufKey(u32 index, u32 offset) {
     return (static_cast<u64>(index) << 32) | offset;
 }
@@ -193,7 +206,7 @@ void GenericEnvironment::Dump(u64 pipeline_hash, u64 shader_hash) {
     DumpImpl(pipeline_hash, shader_hash, code, read_highest, read_lowest, initial_offset, stage);
 }
 
-void GenericEnvironment::Serialize(std::ofstream& file) const {
+void GenericEnvironment::Serialize(std::ostream& file) const {
     const u64 code_size{static_cast<u64>(CachedSizeBytes())};
     const u64 num_texture_types{static_cast<u64>(texture_types.size())};
     const u64 num_texture_pixel_formats{static_cast<u64>(texture_pixel_formats.size())};
@@ -448,65 +461,110 @@ u32 ComputeEnvironment::ReadViewportTransformState() {
     return viewport_transform_state;
 }
 
-void FileEnvironment::Deserialize(std::ifstream& file) {
+std::optional<FileEnvironment::SerializedInfo> FileEnvironment::ReadSerializedInfo(
+    std::span<const u8> data) {
+    static constexpr size_t HEADER_SIZE = sizeof(u64) * 5 + sizeof(u32) * 6 + sizeof(Shader::Stage);
+    if (data.size() < HEADER_SIZE) {
+        return std::nullopt;
+    }
+    std::array<u64, 5> counts;
+    Shader::Stage stage;
+    std::memcpy(counts.data(), data.data(), sizeof(counts));
+    std::memcpy(&stage, data.data() + HEADER_SIZE - sizeof(stage), sizeof(stage));
+    if (std::ranges::any_of(counts, [&](u64 count) { return count > data.size(); })) {
+        return std::nullopt;
+    }
+    const auto [code_size, num_texture_types, num_texture_pixel_formats, num_cbuf_values,
+                num_cbuf_replacement_values] = counts;
+    u64 size = HEADER_SIZE + code_size;
+    size += num_texture_types * (sizeof(u32) + sizeof(Shader::TextureType));
+    size += num_texture_pixel_formats * (sizeof(u32) + sizeof(Shader::TexturePixelFormat));
+    size += num_cbuf_values * (sizeof(u64) + sizeof(u32));
+    size += num_cbuf_replacement_values * (sizeof(u64) + sizeof(Shader::ReplaceConstant));
+    if (stage == Shader::Stage::Compute) {
+        size += sizeof(workgroup_size) + sizeof(shared_memory_size);
+    } else {
+        size += sizeof(sph);
+        if (stage == Shader::Stage::Geometry) {
+            size += sizeof(gp_passthrough_mask);
+        }
+    }
+    if (size > data.size()) {
+        return std::nullopt;
+    }
+    return SerializedInfo{
+        .size = static_cast<size_t>(size),
+        .stage = stage,
+    };
+}
+
+void FileEnvironment::Deserialize(std::span<const u8> data) {
+    size_t offset = 0;
+    const auto read{[&](void* value, size_t size) {
+        ASSERT(offset + size <= data.size());
+        std::memcpy(value, data.data() + offset, size);
+        offset += size;
+    }};
     u64 code_size{};
     u64 num_texture_types{};
     u64 num_texture_pixel_formats{};
     u64 num_cbuf_values{};
     u64 num_cbuf_replacement_values{};
-    file.read(reinterpret_cast<char*>(&code_size), sizeof(code_size))
-        .read(reinterpret_cast<char*>(&num_texture_types), sizeof(num_texture_types))
-        .read(reinterpret_cast<char*>(&num_texture_pixel_formats),
-              sizeof(num_texture_pixel_formats))
-        .read(reinterpret_cast<char*>(&num_cbuf_values), sizeof(num_cbuf_values))
-        .read(reinterpret_cast<char*>(&num_cbuf_replacement_values),
-              sizeof(num_cbuf_replacement_values))
-        .read(reinterpret_cast<char*>(&local_memory_size), sizeof(local_memory_size))
-        .read(reinterpret_cast<char*>(&texture_bound), sizeof(texture_bound))
-        .read(reinterpret_cast<char*>(&start_address), sizeof(start_address))
-        .read(reinterpret_cast<char*>(&read_lowest), sizeof(read_lowest))
-        .read(reinterpret_cast<char*>(&read_highest), sizeof(read_highest))
-        .read(reinterpret_cast<char*>(&viewport_transform_state), sizeof(viewport_transform_state))
-        .read(reinterpret_cast<char*>(&stage), sizeof(stage));
+    read(&code_size, sizeof(code_size));
+    read(&num_texture_types, sizeof(num_texture_types));
+    read(&num_texture_pixel_formats, sizeof(num_texture_pixel_formats));
+    read(&num_cbuf_values, sizeof(num_cbuf_values));
+    read(&num_cbuf_replacement_values, sizeof(num_cbuf_replacement_values));
+    read(&local_memory_size, sizeof(local_memory_size));
+    read(&texture_bound, sizeof(texture_bound));
+    read(&start_address, sizeof(start_address));
+    read(&read_lowest, sizeof(read_lowest));
+    read(&read_highest, sizeof(read_highest));
+    read(&viewport_transform_state, sizeof(viewport_transform_state));
+    read(&stage, sizeof(stage));
     code.resize(Common::DivCeil(code_size, sizeof(u64)));
-    file.read(reinterpret_cast<char*>(code.data()), code_size);
+    read(code.data(), code_size);
+    texture_types.reserve(num_texture_types);
     for (size_t i = 0; i < num_texture_types; ++i) {
         u32 key;
         Shader::TextureType type;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&type), sizeof(type));
+        read(&key, sizeof(key));
+        read(&type, sizeof(type));
         texture_types.emplace(key, type);
     }
+    texture_pixel_formats.reserve(num_texture_pixel_formats);
     for (size_t i = 0; i < num_texture_pixel_formats; ++i) {
         u32 key;
         Shader::TexturePixelFormat format;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&format), sizeof(format));
+        read(&key, sizeof(key));
+        read(&format, sizeof(format));
         texture_pixel_formats.emplace(key, format);
     }
+    cbuf_values.reserve(num_cbuf_values);
     for (size_t i = 0; i < num_cbuf_values; ++i) {
         u64 key;
         u32 value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        read(&key, sizeof(key));
+        read(&value, sizeof(value));
         cbuf_values.emplace(key, value);
     }
+    cbuf_replacements.reserve(num_cbuf_replacement_values);
     for (size_t i = 0; i < num_cbuf_replacement_values; ++i) {
         u64 key;
         Shader::ReplaceConstant value;
-        file.read(reinterpret_cast<char*>(&key), sizeof(key))
-            .read(reinterpret_cast<char*>(&value), sizeof(value));
+        read(&key, sizeof(key));
+        read(&value, sizeof(value));
         cbuf_replacements.emplace(key, value);
     }
     if (stage == Shader::Stage::Compute) {
-        file.read(reinterpret_cast<char*>(&workgroup_size), sizeof(workgroup_size))
-            .read(reinterpret_cast<char*>(&shared_memory_size), sizeof(shared_memory_size));
+        read(&workgroup_size, sizeof(workgroup_size));
+        read(&shared_memory_size, sizeof(shared_memory_size));
         initial_offset = 0;
     } else {
-        file.read(reinterpret_cast<char*>(&sph), sizeof(sph));
+        read(&sph, sizeof(sph));
         initial_offset = sizeof(sph);
         if (stage == Shader::Stage::Geometry) {
-            file.read(reinterpret_cast<char*>(&gp_passthrough_mask), sizeof(gp_passthrough_mask));
+            read(&gp_passthrough_mask, sizeof(gp_passthrough_mask));
         }
     }
     is_proprietary_driver = texture_bound == 2;
@@ -583,61 +641,128 @@ std::optional<Shader::ReplaceConstant> FileEnvironment::GetReplaceConstBuffer(u3
 }
 
 void SerializePipeline(std::span<const char> key, std::span<const GenericEnvironment* const> envs,
-                       const std::filesystem::path& filename, u32 cache_version) try {
-    std::ofstream file(filename, std::ios::binary | std::ios::ate | std::ios::app);
-    file.exceptions(std::ifstream::failbit);
-    if (!file.is_open()) {
-        LOG_ERROR(Common_Filesystem, "Failed to open pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
-        return;
-    }
-    if (file.tellp() == 0) {
-        // Write header
-        file.write(MAGIC_NUMBER.data(), MAGIC_NUMBER.size())
-            .write(reinterpret_cast<const char*>(&cache_version), sizeof(cache_version));
-    }
+                       const std::filesystem::path& filename, u32 cache_version) {
     if (!std::ranges::all_of(envs, &GenericEnvironment::CanBeSerialized)) {
         return;
     }
+    std::ostringstream stream(std::ios::binary);
     const u32 num_envs{static_cast<u32>(envs.size())};
-    file.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
+    stream.write(reinterpret_cast<const char*>(&num_envs), sizeof(num_envs));
     for (const GenericEnvironment* const env : envs) {
-        env->Serialize(file);
+        env->Serialize(stream);
     }
-    file.write(key.data(), key.size_bytes());
+    stream.write(key.data(), key.size_bytes());
+
+    const std::string payload{std::move(stream).str()};
+    const u64 key_hash{Common::CityHash64(key.data(), key.size_bytes())};
+    AppendPipelineCacheEntry(
+        filename, cache_version, key_hash,
+        std::span(reinterpret_cast<const u8*>(payload.data()), payload.size()));
+}
+
+struct PipelineEntry {
+    boost::container::static_vector<std::span<const u8>, MAX_PIPELINE_ENVS> envs;
+    std::span<const u8> key;
+    bool is_compute;
+};
 
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
+static std::optional<PipelineEntry> ReadPipelineEntry(std::span<const u8> data, size_t& offset,
+                                                      size_t compute_key_size,
+                                                      size_t graphics_key_size) {
+    u32 num_envs{};
+    if (data.size() - offset < sizeof(num_envs)) {
+        return std::nullopt;
+    }
+    std::memcpy(&num_envs, data.data() + offset, sizeof(num_envs));
+    if (num_envs == 0 || num_envs > MAX_PIPELINE_ENVS) {
+        return std::nullopt;
+    }
+    size_t entry_offset{offset + sizeof(num_envs)};
+    PipelineEntry entry{};
+    for (u32 i = 0; i < num_envs; ++i) {
+        const auto info{FileEnvironment::ReadSerializedInfo(data.subspan(entry_offset))};
+        if (!info) {
+            return std::nullopt;
+        }
+        if (i == 0) {
+            entry.is_compute = info->stage == Shader::Stage::Compute;
+        }
+        entry.envs.push_back(data.subspan(entry_offset, info->size));
+        entry_offset += info->size;
+    }
+    const size_t key_size{entry.is_compute ? compute_key_size : graphics_key_size};
+    if (data.size() - entry_offset < key_size) {
+        return std::nullopt;
+    }
+    entry.key = data.subspan(entry_offset, key_size);
+    offset = entry_offset + key_size;
+    return entry;
+}
+
+/// Rewrite a cache file from the uncompressed legacy layout to the current container
+static bool ConvertLegacyPipelineCache(const std::filesystem::path& filename, u32 cache_version,
+                                       size_t compute_key_size, size_t graphics_key_size) {
+    std::filesystem::path temp_filename{filename};
+    temp_filename += ".tmp";
+    (void)Common::FS::RemoveFile(temp_filename);
+    {
+        const Common::FS::MappedFile file(filename);
+        const std::span<const u8> data{file.Data()};
+        size_t offset{LEGACY_HEADER_SIZE};
+        while (offset < data.size()) {
+            const size_t entry_offset{offset};
+            const std::optional<PipelineEntry> entry{
+                ReadPipelineEntry(data, offset, compute_key_size, graphics_key_size)};
+            if (!entry) {
+                // Keep what was complete, the rest of a truncated legacy file is lost anyway
+                break;
+            }
+            const u64 key_hash{Common::CityHash64(reinterpret_cast<const char*>(entry->key.data()),
+                                                  entry->key.size())};
+            AppendPipelineCacheEntry(temp_filename, cache_version, key_hash,
+                                     data.subspan(entry_offset, offset - entry_offset));
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_filename, filename, ec);
+    if (ec) {
+        LOG_ERROR(Common_Filesystem, "Failed to convert legacy pipeline cache file {}",
                   Common::FS::PathToUTF8String(filename));
+        (void)Common::FS::RemoveFile(temp_filename);
+        return false;
     }
+    LOG_INFO(Common_Filesystem, "Converted legacy pipeline cache file");
+    return true;
 }
 
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics) try {
-    std::ifstream file(filename, std::ios::binary | std::ios::ate);
-    if (!file.is_open()) {
-        return;
+    size_t compute_key_size, size_t graphics_key_size,
+    Common::UniqueFunction<void, std::span<const u8>, FileEnvironment> load_compute,
+    Common::UniqueFunction<void, std::span<const u8>, std::vector<FileEnvironment>> load_graphics) {
+    PipelineCacheReader reader;
+    PipelineCacheStatus status{reader.Open(filename, expected_cache_version)};
+    if (status == PipelineCacheStatus::Legacy) {
+        reader.Close();
+        if (ConvertLegacyPipelineCache(filename, expected_cache_version, compute_key_size,
+                                       graphics_key_size)) {
+            status = reader.Open(filename, expected_cache_version);
+        }
     }
-    file.exceptions(std::ifstream::failbit);
-    const auto end{file.tellg()};
-    file.seekg(0, std::ios::beg);
-
-    std::array<char, 8> magic_number;
-    u32 cache_version;
-    file.read(magic_number.data(), magic_number.size())
-        .read(reinterpret_cast<char*>(&cache_version), sizeof(cache_version));
-    if (magic_number != MAGIC_NUMBER || cache_version != expected_cache_version) {
-        file.close();
+    switch (status) {
+    case PipelineCacheStatus::Ok:
+        break;
+    case PipelineCacheStatus::NotFound:
+        return;
+    case PipelineCacheStatus::Invalid:
+    case PipelineCacheStatus::OldVersion:
+    case PipelineCacheStatus::Legacy:
+        reader.Close();
         if (Common::FS::RemoveFile(filename)) {
-            if (magic_number != MAGIC_NUMBER) {
-                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
-            }
-            if (cache_version != expected_cache_version) {
+            if (status == PipelineCacheStatus::OldVersion) {
                 LOG_INFO(Common_Filesystem, "Deleting old pipeline cache");
+            } else {
+                LOG_ERROR(Common_Filesystem, "Invalid pipeline cache file");
             }
         } else {
             LOG_ERROR(Common_Filesystem,
@@ -646,28 +771,103 @@ void LoadPipelines(
         }
         return;
     }
-    while (file.tellg() != end) {
+    const std::span<const PipelineCacheEntry> entries{reader.Entries()};
+
+    // Only the newest valid copy of a pipeline is loaded, older copies are removed by compaction
+    const std::vector<PipelineCacheCopies> pipelines{GroupPipelineCacheCopies(entries)};
+
+    struct DeserializedEntry {
+        std::vector<u8> payload;
+        std::vector<FileEnvironment> envs;
+        std::span<const u8> key;
+        bool is_compute{};
+        bool is_valid{};
+        std::atomic_bool ready;
+    };
+    std::vector<DeserializedEntry> deserialized(pipelines.size());
+    std::atomic_size_t next_entry{};
+    const auto deserialize_next{[&] {
+        const size_t index{next_entry.fetch_add(1, std::memory_order_relaxed)};
+        if (index >= pipelines.size()) {
+            return false;
+        }
+        DeserializedEntry& result{deserialized[index]};
+        for (const size_t entry_index : pipelines[index]) {
+            result.payload = reader.Decompress(entries[entry_index]);
+            if (!result.payload.empty()) {
+                break;
+            }
+        }
+
+        size_t offset{};
+        const std::optional<PipelineEntry> entry{
+            ReadPipelineEntry(result.payload, offset, compute_key_size, graphics_key_size)};
+        result.is_valid = entry.has_value() && offset == result.payload.size();
+        if (result.is_valid) {
+            result.envs.resize(entry->envs.size());
+            for (size_t i = 0; i < entry->envs.size(); ++i) {
+                result.envs[i].Deserialize(entry->envs[i]);
+            }
+            result.key = entry->key;
+            result.is_compute = entry->is_compute;
+        }
+        result.ready.store(true, std::memory_order_release);
+        result.ready.notify_one();
+        return true;
+    }};
+    const size_t num_threads{std::min<size_t>(
+        std::max(std::thread::hardware_concurrency(), 2U) / 2, pipelines.size())};
+    std::vector<std::jthread> threads;
+    threads.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&](std::stop_token stop_token) {
+            Common::SetCurrentThreadName("PipelineLoader");
+            while (!stop_token.stop_requested() && deserialize_next()) {
+            }
+        });
+    }
+
+    // Hand pipelines over in file order, as soon as each one is ready
+    size_t num_invalid{};
+    bool is_complete{true};
+    for (DeserializedEntry& result : deserialized) {
         if (stop_loading.stop_requested()) {
-            return;
+            is_complete = false;
+            break;
         }
-        u32 num_envs{};
-        file.read(reinterpret_cast<char*>(&num_envs), sizeof(num_envs));
-        std::vector<FileEnvironment> envs(num_envs);
-        for (FileEnvironment& env : envs) {
-            env.Deserialize(file);
+        while (!result.ready.load(std::memory_order_acquire)) {
+            // Help deserializing instead of waiting when there is work left
+            if (!deserialize_next()) {
+                result.ready.wait(false, std::memory_order_acquire);
+            }
         }
-        if (envs.front().ShaderStage() == Shader::Stage::Compute) {
-            load_compute(file, std::move(envs.front()));
+        if (!result.is_valid) {
+            ++num_invalid;
+        } else if (result.is_compute) {
+            load_compute(std::span<const u8>{result.key}, std::move(result.envs.front()));
         } else {
-            load_graphics(file, std::move(envs));
+            load_graphics(std::span<const u8>{result.key}, std::move(result.envs));
         }
+        result.payload = {};
     }
+    threads.clear();
 
-} catch (const std::ios_base::failure& e) {
-    LOG_ERROR(Common_Filesystem, "{}", e.what());
-    if (!Common::FS::RemoveFile(filename)) {
-        LOG_ERROR(Common_Filesystem, "Failed to delete pipeline cache file {}",
-                  Common::FS::PathToUTF8String(filename));
+    const size_t num_duplicates{entries.size() - pipelines.size()};
+    const bool has_index{reader.HasIndex()};
+    const u64 data_end{reader.DataEnd()};
+    const std::vector<PipelineCacheEntry> index(entries.begin(), entries.end());
+    reader.Close();
+    if (!is_complete) {
+        return;
+    }
+    if (num_invalid != 0 || num_duplicates != 0) {
+        if (num_invalid != 0) {
+            LOG_ERROR(Common_Filesystem, "Pipeline cache file has {} corrupted entries",
+                      num_invalid);
+        }
+        (void)CompactPipelineCache(filename, expected_cache_version);
+    } else if (!has_index) {
+        (void)WritePipelineCacheIndex(filename, data_end, index);
     }
 }
 
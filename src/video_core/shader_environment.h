@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <filesystem>
 #include <iosfwd>
 #include <limits>
@@ -60,7 +61,7 @@ public:
 
     void Dump(u64 pipeline_hash, u64 shader_hash) override;
 
-    void Serialize(std::ofstream& file) const;
+    void Serialize(std::ostream& file) const;
 
     bool HasHLEMacroState() const override {
         return has_hle_engine_state;
@@ -165,7 +166,17 @@ public:
     FileEnvironment& operator=(const FileEnvironment&) = delete;
     FileEnvironment(const FileEnvironment&) = delete;
 
-    void Deserialize(std::ifstream& file);
+    struct SerializedInfo {
+        size_t size;
+        Shader::Stage stage;
+    };
+
+    /// Returns the size and stage of the serialized environment at the start of data,
+    /// or std::nullopt when data is too small to hold it
+    [[nodiscard]] static std::optional<SerializedInfo> ReadSerializedInfo(
+        std::span<const u8> data);
+
+    void Deserialize(std::span<const u8> data);
 
     [[nodiscard]] u64 ReadInstruction(u32 address) override;
 
@@ -226,7 +237,29 @@ void SerializePipeline(const Key& key, const Envs& envs, const std::filesystem::
 
 void LoadPipelines(
     std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
-    Common::UniqueFunction<void, std::ifstream&, FileEnvironment> load_compute,
-    Common::UniqueFunction<void, std::ifstream&, std::vector<FileEnvironment>> load_graphics);
+    size_t compute_key_size, size_t graphics_key_size,
+    Common::UniqueFunction<void, std::span<const u8>, FileEnvironment> load_compute,
+    Common::UniqueFunction<void, std::span<const u8>, std::vector<FileEnvironment>> load_graphics);
+
+template <typename ComputeKey, typename GraphicsKey>
+void LoadPipelines(
+    std::stop_token stop_loading, const std::filesystem::path& filename, u32 expected_cache_version,
+    Common::UniqueFunction<void, const ComputeKey&, FileEnvironment> load_compute,
+    Common::UniqueFunction<void, const GraphicsKey&, std::vector<FileEnvironment>> load_graphics) {
+    static_assert(std::is_trivially_copyable_v<ComputeKey>);
+    static_assert(std::is_trivially_copyable_v<GraphicsKey>);
+    LoadPipelines(
+        stop_loading, filename, expected_cache_version, sizeof(ComputeKey), sizeof(GraphicsKey),
+        [&load_compute](std::span<const u8> key_data, FileEnvironment env) {
+            ComputeKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            load_compute(key, std::move(env));
+        },
+        [&load_graphics](std::span<const u8> key_data, std::vector<FileEnvironment> envs) {
+            GraphicsKey key;
+            std::memcpy(&key, key_data.data(), sizeof(key));
+            load_graphics(key, std::move(envs));
+        });
+}
 
 } // namespace VideoCommon
@@ -0,0 +1,136 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "video_core/shader_lookup_table.h"
+
+namespace VideoCommon {
+
+namespace {
+constexpr size_t INITIAL_CAPACITY = 1024;
+
+[[nodiscard]] size_t Hash(VAddr addr) noexcept {
+    // Shaders are aligned, mix the low bits with the rest of the address
+    return static_cast<size_t>((addr * 0x9E3779B97F4A7C15ULL) >> 32);
+}
+} // Anonymous namespace
+
+ShaderLookupTable::Table::Table(size_t capacity)
+    : slots{std::make_unique<Slot[]>(capacity)}, mask{capacity - 1} {}
+
+ShaderLookupTable::ShaderLookupTable()
+    : current_table{std::make_unique<Table>(INITIAL_CAPACITY)} {
+    table.store(current_table.get());
+}
+
+ShaderLookupTable::~ShaderLookupTable() = default;
+
+ShaderInfo* ShaderLookupTable::Find(VAddr addr) const noexcept {
+    // The reader count keeps the table alive while it is being probed, see ReclaimTables
+    num_readers.fetch_add(1, std::memory_order_seq_cst);
+    const Table& lookup_table{*table.load(std::memory_order_seq_cst)};
+
+    ShaderInfo* result{};
+    for (size_t index = Hash(addr);; ++index) {
+        const Slot& slot{lookup_table.slots[index & lookup_table.mask]};
+        const u64 key{slot.key.load(std::memory_order_acquire)};
+        if (key == EMPTY_KEY) {
+            break;
+        }
+        if (key != addr) {
+            continue;
+        }
+        ShaderInfo* const data{slot.data.load(std::memory_order_acquire)};
+        // If the slot was erased or reused while reading it, the address is no longer present
+        if (slot.key.load(std::memory_order_acquire) == addr) {
+            result = data;
+        }
+        break;
+    }
+    num_readers.fetch_sub(1, std::memory_order_seq_cst);
+    return result;
+}
+
+bool ShaderLookupTable::Insert(VAddr addr, ShaderInfo* data) {
+    if (!retired_tables.empty()) {
+        ReclaimTables();
+    }
+    const size_t capacity{current_table->mask + 1};
+    if ((num_used_slots + 1) * 4 > capacity * 3) {
+        // Grow if most slots are live, otherwise only clean up tombstones
+        Rehash(std::max(capacity, std::bit_ceil((num_entries + 1) * 2)));
+    }
+    Slot* const slot{FindSlot(*current_table, addr)};
+    const u64 key{slot->key.load(std::memory_order_relaxed)};
+    if (key == addr) {
+        return false;
+    }
+    if (key == EMPTY_KEY) {
+        ++num_used_slots;
+    }
+    slot->data.store(data, std::memory_order_release);
+    slot->key.store(addr, std::memory_order_release);
+    ++num_entries;
+    return true;
+}
+
+bool ShaderLookupTable::Erase(VAddr addr) {
+    Slot* const slot{FindSlot(*current_table, addr)};
+    if (slot->key.load(std::memory_order_relaxed) != addr) {
+        return false;
+    }
+    slot->data.store(nullptr, std::memory_order_release);
+    slot->key.store(TOMBSTONE_KEY, std::memory_order_release);
+    --num_entries;
+    return true;
+}
+
+ShaderLookupTable::Slot* ShaderLookupTable::FindSlot(Table& lookup_table,
+                                                     VAddr addr) const noexcept {
+    Slot* first_tombstone{};
+    for (size_t index = Hash(addr);; ++index) {
+        Slot& slot{lookup_table.slots[index & lookup_table.mask]};
+        const u64 key{slot.key.load(std::memory_order_relaxed)};
+        if (key == addr) {
+            return &slot;
+        }
+        if (key == EMPTY_KEY) {
+            return first_tombstone ? first_tombstone : &slot;
+        }
+        if (key == TOMBSTONE_KEY && !first_tombstone) {
+            first_tombstone = &slot;
+        }
+    }
+}
+
+void ShaderLookupTable::Rehash(size_t capacity) {
+    auto new_table{std::make_unique<Table>(capacity)};
+    const size_t old_capacity{current_table->mask + 1};
+    for (size_t index = 0; index < old_capacity; ++index) {
+        const Slot& slot{current_table->slots[index]};
+        const u64 key{slot.key.load(std::memory_order_relaxed)};
+        if (key == EMPTY_KEY || key == TOMBSTONE_KEY) {
+            continue;
+        }
+        Slot* const new_slot{FindSlot(*new_table, key)};
+        new_slot->data.store(slot.data.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        new_slot->key.store(key, std::memory_order_relaxed);
+    }
+    num_used_slots = num_entries;
+
+    table.store(new_table.get(), std::memory_order_seq_cst);
+    retired_tables.push_back(std::exchange(current_table, std::move(new_table)));
+    ReclaimTables();
+}
+
+void ShaderLookupTable::ReclaimTables() {
+    // Lookups that start after the new table was published can't see the retired ones
+    if (num_readers.load(std::memory_order_seq_cst) == 0) {
+        retired_tables.clear();
+    }
+}
+
+} // namespace VideoCommon
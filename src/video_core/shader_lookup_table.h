@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/common_types.h"
+
+namespace VideoCommon {
+
+struct ShaderInfo;
+
+/**
+ * Open addressing map from shader start addresses to shaders.
+ *
+ * Lookups never lock and can run concurrently with insertions and removals. Writers have to be
+ * serialized by the caller. Tables replaced when growing are freed once no lookup is in flight.
+ */
+class ShaderLookupTable {
+public:
+    ShaderLookupTable();
+    ~ShaderLookupTable();
+
+    ShaderLookupTable(const ShaderLookupTable&) = delete;
+    ShaderLookupTable& operator=(const ShaderLookupTable&) = delete;
+
+    /// @brief Finds the shader starting at the given address
+    /// @return Pointer to the shader, nullptr when nothing is found
+    [[nodiscard]] ShaderInfo* Find(VAddr addr) const noexcept;
+
+    /// @brief Inserts a shader, keeping the existing one if the address is already present
+    /// @pre Writers are serialized by the caller
+    /// @return True when the shader was inserted
+    bool Insert(VAddr addr, ShaderInfo* data);
+
+    /// @brief Removes the shader starting at the given address
+    /// @pre Writers are serialized by the caller
+    /// @return True when a shader was removed
+    bool Erase(VAddr addr);
+
+    /// @brief Returns the number of shaders in the table
+    [[nodiscard]] size_t Size() const noexcept {
+        return num_entries;
+    }
+
+private:
+    static constexpr u64 EMPTY_KEY = ~u64{0};
+    static constexpr u64 TOMBSTONE_KEY = ~u64{0} - 1;
+
+    struct Slot {
+        std::atomic<u64> key{EMPTY_KEY};
+        std::atomic<ShaderInfo*> data{};
+    };
+
+    struct Table {
+        explicit Table(size_t capacity);
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+    };
+
+    /// @brief Returns the slot of an address, or the slot where it would be inserted
+    Slot* FindSlot(Table& table, VAddr addr) const noexcept;
+
+    /// @brief Moves every entry to a new table of the given capacity
+    void Rehash(size_t capacity);
+
+    /// @brief Frees replaced tables if no lookup can be using them
+    void ReclaimTables();
+
+    std::atomic<Table*> table;
+    mutable std::atomic<u32> num_readers{};
+
+    std::unique_ptr<Table> current_table;
+    std::vector<std::unique_ptr<Table>> retired_tables;
+    size_t num_entries = 0;
+    size_t num_used_slots = 0;
+};
+
+} // namespace VideoCommon
@@ -142,6 +142,11 @@ void TextureCache<P>::RunGarbageCollector() {
     }
 }
 
+template <class P>
+void TextureCache<P>::LoadDiskResources(u64 title_id) {
+    transcode_cache.Open(title_id);
+}
+
 template <class P>
 void TextureCache<P>::TickFrame() {
     // If we can obtain the memory info, use it instead of the estimate.
@@ -1060,10 +1065,14 @@ void TextureCache<P>::RefreshContents(Image& image, ImageId image_id) {
         runtime.TransitionImageLayout(image);
         return;
     }
-    if (True(image.flags & ImageFlagBits::AsynchronousDecode)) {
+    if (True(image.flags & ImageFlagBits::AsynchronousDecode) &&
+        async_decodes.size() < MAX_PENDING_ASYNC_DECODES) {
         QueueAsyncDecode(image, image_id);
         return;
     }
+    if (RefreshTranscodedImage(image, image_id)) {
+        return;
+    }
     auto staging = runtime.UploadStagingBuffer(MapSizeBytes(image));
     UploadImageContents(image, staging);
     runtime.InsertUploadMemoryBarrier();
@@ -1090,7 +1099,7 @@ void TextureCache<P>::UploadImageContents(Image& image, StagingBuffer& staging)
         unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
         auto copies =
             UnswizzleImage(*gpu_memory, gpu_addr, image.info, swizzle_data, unswizzle_data_buffer);
-        ConvertImage(unswizzle_data_buffer, image.info, mapped_span, copies);
+        TranscodeImage(unswizzle_data_buffer, image.info, mapped_span, copies, true);
         image.UploadMemory(staging, copies);
     } else {
         const auto copies =
@@ -1281,12 +1290,6 @@ void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
     UNIMPLEMENTED_IF(False(image.flags & ImageFlagBits::Converted));
     LOG_INFO(HW_GPU, "Queuing async texture decode");
 
-    image.flags |= ImageFlagBits::IsDecoding;
-    auto decode = std::make_unique<AsyncDecodeContext>();
-    auto* decode_ptr = decode.get();
-    decode->image_id = image_id;
-    async_decodes.push_back(std::move(decode));
-
     static Common::ScratchBuffer<u8> local_unswizzle_data_buffer;
     local_unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
     Tegra::Memory::GpuGuestMemory<u8, Tegra::Memory::GuestMemoryFlags::UnsafeRead> swizzle_data(
@@ -1294,14 +1297,25 @@ void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id) {
 
     auto copies = UnswizzleImage(*gpu_memory, image.gpu_addr, image.info, swizzle_data,
                                  local_unswizzle_data_buffer);
+    QueueAsyncDecode(image, image_id, std::move(local_unswizzle_data_buffer), std::move(copies));
+}
+
+template <class P>
+void TextureCache<P>::QueueAsyncDecode(Image& image, ImageId image_id,
+                                       Common::ScratchBuffer<u8>&& input,
+                                       boost::container::small_vector<BufferImageCopy, 16> copies) {
+    image.flags |= ImageFlagBits::IsDecoding;
+    auto decode = std::make_unique<AsyncDecodeContext>();
+    auto* decode_ptr = decode.get();
+    decode->image_id = image_id;
+    async_decodes.push_back(std::move(decode));
+
     const size_t out_size = MapSizeBytes(image);
 
-    auto func = [out_size, copies, info = image.info,
-                 input = std::move(local_unswizzle_data_buffer),
-                 async_decode = decode_ptr]() mutable {
+    auto func = [this, out_size, copies = std::move(copies), info = image.info,
+                 input = std::move(input), async_decode = decode_ptr]() mutable {
         async_decode->decoded_data.resize_destructive(out_size);
-        std::span copies_span{copies.data(), copies.size()};
-        ConvertImage(input, info, async_decode->decoded_data, copies_span);
+        TranscodeImage(input, info, async_decode->decoded_data, copies, false);
 
         // TODO: Do we need this lock?
         std::unique_lock lock{async_decode->mutex};
@@ -1336,6 +1350,67 @@ void TextureCache<P>::TickAsyncDecode() {
     }
 }
 
+template <class P>
+bool TextureCache<P>::RefreshTranscodedImage(Image& image, ImageId image_id) {
+    if (False(image.flags & ImageFlagBits::Converted) ||
+        True(image.flags & ImageFlagBits::AcceleratedUpload) ||
+        !TranscodeCache::IsCacheable(image.info)) {
+        return false;
+    }
+    Tegra::Memory::GpuGuestMemory<u8, Tegra::Memory::GuestMemoryFlags::UnsafeRead> swizzle_data(
+        *gpu_memory, image.gpu_addr, image.guest_size_bytes, &swizzle_data_buffer);
+    unswizzle_data_buffer.resize_destructive(image.unswizzled_size_bytes);
+    auto copies = UnswizzleImage(*gpu_memory, image.gpu_addr, image.info, swizzle_data,
+                                 unswizzle_data_buffer);
+
+    // Recompressing is too slow to stall on, so a miss is transcoded on the decode thread whatever
+    // the decode mode. Only images already in the transcode cache follow the decode mode, loading
+    // them is as cheap as an uncompressed upload.
+    if (async_decodes.size() < MAX_PENDING_ASYNC_DECODES &&
+        !transcode_cache.Contains(TranscodeCache::MakeKey(unswizzle_data_buffer, image.info))) {
+        QueueAsyncDecode(image, image_id, std::move(unswizzle_data_buffer), std::move(copies));
+        return true;
+    }
+    auto staging = runtime.UploadStagingBuffer(MapSizeBytes(image));
+    TranscodeImage(unswizzle_data_buffer, image.info, staging.mapped_span, copies, true);
+    image.UploadMemory(staging, copies);
+    runtime.InsertUploadMemoryBarrier();
+    return true;
+}
+
+template <class P>
+void TextureCache<P>::TranscodeImage(std::span<const u8> input, const ImageInfo& info,
+                                     std::span<u8> output,
+                                     boost::container::small_vector<BufferImageCopy, 16>& copies,
+                                     bool output_is_staging) {
+    std::span copies_span{copies.data(), copies.size()};
+    if (!TranscodeCache::IsCacheable(info)) {
+        ConvertImage(input, info, output, copies_span);
+        return;
+    }
+    const TranscodeKey key = TranscodeCache::MakeKey(input, info);
+    if (transcode_cache.Load(key, output, copies)) {
+        return;
+    }
+    // Transcode into host memory, reading back from a staging buffer to store it can be slow
+    std::span<u8> transcoded = output;
+    if (output_is_staging) {
+        transcode_buffer.resize_destructive(output.size());
+        transcoded = std::span<u8>(transcode_buffer.data(), output.size());
+    }
+    ConvertImage(input, info, transcoded, copies_span);
+
+    size_t transcoded_size = 0;
+    for (const BufferImageCopy& copy : copies) {
+        transcoded_size = std::max(transcoded_size, copy.buffer_offset + copy.buffer_size);
+    }
+    const std::span<const u8> transcoded_span = transcoded.first(transcoded_size);
+    if (output_is_staging) {
+        std::ranges::copy(transcoded_span, output.begin());
+    }
+    transcode_cache.Store(key, transcoded_span, copies_span);
+}
+
 template <class P>
 bool TextureCache<P>::ScaleUp(Image& image) {
     const bool has_copy = image.HasScaled();
@@ -33,6 +33,7 @@
 #include "video_core/texture_cache/image_info.h"
 #include "video_core/texture_cache/image_view_base.h"
 #include "video_core/texture_cache/render_targets.h"
+#include "video_core/texture_cache/transcode_cache.h"
 #include "video_core/texture_cache/types.h"
 #include "video_core/textures/texture.h"
 
@@ -134,6 +135,9 @@ public:
     /// Notify the cache that a new frame has been queued
     void TickFrame();
 
+    /// Open the on-disk cache of recompressed ASTC images of a title
+    void LoadDiskResources(u64 title_id);
+
     /// Return a constant reference to the given image view id
     [[nodiscard]] const ImageView& GetImageView(ImageViewId id) const noexcept;
 
@@ -420,8 +424,20 @@ private:
     u64 GetScaledImageSizeBytes(const ImageBase& image);
 
     void QueueAsyncDecode(Image& image, ImageId image_id);
+    void QueueAsyncDecode(Image& image, ImageId image_id, Common::ScratchBuffer<u8>&& input,
+                          boost::container::small_vector<BufferImageCopy, 16> copies);
     void TickAsyncDecode();
 
+    /// Upload a recompressed image from the transcode cache, or queue its transcode on a miss
+    /// @retval False when the image isn't recompressed and has to be uploaded as usual
+    bool RefreshTranscodedImage(Image& image, ImageId image_id);
+
+    /// Convert an image to its host format, going through the transcode cache when possible.
+    /// Staging outputs are only written to, the image is transcoded in transcode_buffer first.
+    void TranscodeImage(std::span<const u8> input, const ImageInfo& info, std::span<u8> output,
+                        boost::container::small_vector<BufferImageCopy, 16>& copies,
+                        bool output_is_staging);
+
     Runtime& runtime;
 
     Tegra::MaxwellDeviceMemoryManager& device_memory;
@@ -485,10 +501,15 @@ private:
 
     Common::ScratchBuffer<u8> swizzle_data_buffer;
     Common::ScratchBuffer<u8> unswizzle_data_buffer;
+    Common::ScratchBuffer<u8> transcode_buffer; ///< Only used by uploads on the GPU thread
 
     u64 modification_tick = 0;
     u64 frame_tick = 0;
 
+    // Limit the number of images decoded in the background, the rest are decoded inline
+    static constexpr size_t MAX_PENDING_ASYNC_DECODES = 32;
+
+    TranscodeCache transcode_cache;
     Common::ThreadWorker texture_decode_worker{1, "TextureDecoder"};
     std::vector<std::unique_ptr<AsyncDecodeContext>> async_decodes;
 
@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+#include "common/cityhash.h"
+#include "common/fs/fs.h"
+#include "common/fs/fs_util.h"
+#include "common/fs/path_util.h"
+#include "common/literals.h"
+#include "common/logging/log.h"
+#include "common/settings.h"
+#include "video_core/surface.h"
+#include "video_core/texture_cache/image_info.h"
+#include "video_core/texture_cache/transcode_cache.h"
+
+namespace VideoCommon {
+
+namespace {
+
+using namespace Common::Literals;
+using VideoCore::Surface::IsPixelFormatASTC;
+
+constexpr std::array<char, 8> MAGIC_NUMBER{'s', 'u', 'y', 'u', 't', 'x', 'c', 'h'};
+
+// Bump when the ASTC decoder or the BCn encoders change their output
+constexpr u32 CACHE_VERSION = 1;
+
+// Stop appending entries past this size to keep the cache from growing without bounds
+constexpr u64 MAX_CACHE_SIZE = 4_GiB;
+
+constexpr u32 MAX_COPIES = 16;
+
+struct FileHeader {
+    std::array<char, 8> magic_number;
+    u32 cache_version;
+    u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<FileHeader>);
+
+struct EntryHeader {
+    TranscodeKey key;
+    u64 size;
+    u64 checksum;
+    u32 num_copies;
+    u32 reserved;
+};
+static_assert(std::is_trivially_copyable_v<EntryHeader>);
+
+[[nodiscard]] u64 EntrySize(u64 data_size, u32 num_copies) {
+    return sizeof(EntryHeader) + num_copies * sizeof(BufferImageCopy) + data_size;
+}
+
+[[nodiscard]] u64 Checksum(std::span<const u8> data) {
+    return Common::CityHash64(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+} // Anonymous namespace
+
+bool TranscodeCache::IsCacheable(const ImageInfo& info) {
+    return IsPixelFormatASTC(info.format) && Settings::values.astc_recompression.GetValue() !=
+                                                 Settings::AstcRecompression::Uncompressed;
+}
+
+TranscodeKey TranscodeCache::MakeKey(std::span<const u8> input, const ImageInfo& info) {
+    const std::array<u32, 8> params{
+        static_cast<u32>(info.format),
+        static_cast<u32>(info.type),
+        static_cast<u32>(info.resources.levels),
+        static_cast<u32>(info.resources.layers),
+        info.size.width,
+        info.size.height,
+        info.size.depth,
+        static_cast<u32>(Settings::values.astc_recompression.GetValue()),
+    };
+    return TranscodeKey{
+        .data_hash =
+            Common::CityHash128(reinterpret_cast<const char*>(input.data()), input.size()),
+        .info_hash = Common::CityHash64(reinterpret_cast<const char*>(params.data()),
+                                        params.size() * sizeof(u32)),
+    };
+}
+
+void TranscodeCache::Open(u64 title_id) {
+    if (title_id == 0) {
+        return;
+    }
+    const auto shader_dir{Common::FS::GetSuyuPath(Common::FS::SuyuPath::ShaderDir)};
+    const auto base_dir{shader_dir / fmt::format("{:016x}", title_id)};
+    if (!Common::FS::CreateDir(shader_dir) || !Common::FS::CreateDir(base_dir)) {
+        LOG_ERROR(Common_Filesystem, "Failed to create transcode cache directories");
+        return;
+    }
+    Open(base_dir / "astc_transcode.bin");
+}
+
+void TranscodeCache::Open(const std::filesystem::path& filename_) {
+    std::scoped_lock lock{mutex};
+    filename = filename_;
+    entries.clear();
+    file.Open(filename, Common::FS::FileAccessMode::ReadAppend);
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common_Filesystem, "Failed to open transcode cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+        return;
+    }
+    LoadIndex();
+}
+
+void TranscodeCache::Close() {
+    std::scoped_lock lock{mutex};
+    file.Close();
+    entries.clear();
+    file_size = 0;
+}
+
+bool TranscodeCache::IsOpen() const {
+    std::scoped_lock lock{mutex};
+    return file.IsOpen();
+}
+
+bool TranscodeCache::Contains(const TranscodeKey& key) const {
+    std::scoped_lock lock{mutex};
+    return entries.contains(key);
+}
+
+bool TranscodeCache::Load(const TranscodeKey& key, std::span<u8> output,
+                          boost::container::small_vector<BufferImageCopy, 16>& copies) {
+    std::scoped_lock lock{mutex};
+    const auto it = entries.find(key);
+    if (it == entries.end()) {
+        return false;
+    }
+    const Entry& entry = it->second;
+    if (entry.num_copies != copies.size() || entry.size > output.size()) {
+        return false;
+    }
+    std::array<BufferImageCopy, MAX_COPIES> stored_copies;
+    const std::span copies_span(stored_copies.data(), entry.num_copies);
+    const std::span data = output.first(entry.size);
+    if (!file.Seek(static_cast<s64>(entry.offset + sizeof(EntryHeader))) ||
+        file.ReadSpan(copies_span) != copies_span.size() ||
+        file.ReadSpan(data) != data.size() || Checksum(data) != entry.checksum) {
+        LOG_WARNING(Common_Filesystem, "Corrupted transcode cache entry at offset {}",
+                    entry.offset);
+        entries.erase(it);
+        return false;
+    }
+    std::ranges::copy(copies_span, copies.begin());
+    return true;
+}
+
+void TranscodeCache::Store(const TranscodeKey& key, std::span<const u8> data,
+                           std::span<const BufferImageCopy> copies) {
+    std::scoped_lock lock{mutex};
+    if (!file.IsOpen() || copies.size() > MAX_COPIES || entries.contains(key)) {
+        return;
+    }
+    const u32 num_copies = static_cast<u32>(copies.size());
+    const u64 entry_size = EntrySize(data.size(), num_copies);
+    if (file_size + entry_size > MAX_CACHE_SIZE) {
+        return;
+    }
+    const EntryHeader header{
+        .key = key,
+        .size = data.size(),
+        .checksum = Checksum(data),
+        .num_copies = num_copies,
+        .reserved = 0,
+    };
+    // Reads and writes on the same stream have to be separated by a seek
+    if (!file.Seek(0, Common::FS::SeekOrigin::End) || !file.WriteObject(header) ||
+        file.WriteSpan(copies) != copies.size() || file.WriteSpan(data) != data.size()) {
+        LOG_ERROR(Common_Filesystem, "Failed to write to transcode cache file {}",
+                  Common::FS::PathToUTF8String(filename));
+        // The partial entry is discarded the next time the cache is opened
+        file.Close();
+        entries.clear();
+        return;
+    }
+    entries.emplace(key, Entry{
+                             .offset = file_size,
+                             .size = header.size,
+                             .checksum = header.checksum,
+                             .num_copies = num_copies,
+                         });
+    file_size += entry_size;
+}
+
+void TranscodeCache::LoadIndex() {
+    static constexpr FileHeader EXPECTED_HEADER{
+        .magic_number = MAGIC_NUMBER,
+        .cache_version = CACHE_VERSION,
+        .reserved = 0,
+    };
+    file_size = file.GetSize();
+
+    FileHeader header{};
+    if (file_size != 0 && (!file.ReadObject(header) ||
+                           header.magic_number != EXPECTED_HEADER.magic_number ||
+                           header.cache_version != EXPECTED_HEADER.cache_version)) {
+        LOG_INFO(Common_Filesystem, "Deleting old transcode cache");
+        file_size = 0;
+        if (!file.SetSize(0)) {
+            file.Close();
+            return;
+        }
+    }
+    if (file_size == 0) {
+        if (!file.Seek(0, Common::FS::SeekOrigin::End) || !file.WriteObject(EXPECTED_HEADER)) {
+            LOG_ERROR(Common_Filesystem, "Failed to write transcode cache header");
+            file.Close();
+            return;
+        }
+        file_size = sizeof(FileHeader);
+        return;
+    }
+
+    u64 offset = sizeof(FileHeader);
+    while (offset + sizeof(EntryHeader) <= file_size) {
+        EntryHeader entry{};
+        if (!file.Seek(static_cast<s64>(offset)) || !file.ReadObject(entry) ||
+            entry.num_copies > MAX_COPIES) {
+            break;
+        }
+        const u64 entry_size = EntrySize(entry.size, entry.num_copies);
+        if (offset + entry_size > file_size) {
+            break;
+        }
+        entries.insert_or_assign(entry.key, Entry{
+                                                .offset = offset,
+                                                .size = entry.size,
+                                                .checksum = entry.checksum,
+                                                .num_copies = entry.num_copies,
+                                            });
+        offset += entry_size;
+    }
+    if (offset != file_size) {
+        // Drop the tail left behind by an interrupted write so new entries stay reachable
+        LOG_WARNING(Common_Filesystem, "Discarding {} bytes of truncated transcode cache entries",
+                    file_size - offset);
+        if (!file.SetSize(offset)) {
+            file.Close();
+            entries.clear();
+            return;
+        }
+        file_size = offset;
+    }
+    LOG_INFO(Common_Filesystem, "Loaded {} transcoded images from disk", entries.size());
+}
+
+} // namespace VideoCommon
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright 2024 suyu Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+#include <boost/container/small_vector.hpp>
+
+#include "common/common_types.h"
+#include "common/fs/file.h"
+#include "video_core/texture_cache/types.h"
+
+namespace VideoCommon {
+
+struct ImageInfo;
+
+/// Identifies a transcoded image by its unswizzled guest contents and its image parameters
+struct TranscodeKey {
+    u128 data_hash{};
+    u64 info_hash{};
+
+    [[nodiscard]] bool operator==(const TranscodeKey&) const noexcept = default;
+};
+
+} // namespace VideoCommon
+
+namespace std {
+template <>
+struct hash<VideoCommon::TranscodeKey> {
+    size_t operator()(const VideoCommon::TranscodeKey& key) const noexcept {
+        return static_cast<size_t>(key.data_hash[0] ^ key.data_hash[1] ^ key.info_hash);
+    }
+};
+} // namespace std
+
+namespace VideoCommon {
+
+/**
+ * Persistent cache of ASTC images that have been recompressed to BCn.
+ *
+ * Entries are appended to a single file and indexed in memory when the cache is opened, so a
+ * warm boot can upload a recompressed image without decoding or encoding it again. The cache is
+ * thread safe, lookups and stores can happen from the texture decode threads.
+ */
+class TranscodeCache {
+public:
+    /// Returns true when images with the given parameters are recompressed and can be cached
+    [[nodiscard]] static bool IsCacheable(const ImageInfo& info);
+
+    /// Build the key of an image from its unswizzled guest data
+    [[nodiscard]] static TranscodeKey MakeKey(std::span<const u8> input, const ImageInfo& info);
+
+    /// Open the cache file of a title in the shader cache directory
+    void Open(u64 title_id);
+
+    /// Open the cache file at the given path, creating it when it does not exist
+    void Open(const std::filesystem::path& filename);
+
+    /// Close the cache file and forget every indexed entry
+    void Close();
+
+    /// Returns true when the cache file is open
+    [[nodiscard]] bool IsOpen() const;
+
+    /// Returns true when an image with the given key has been stored
+    [[nodiscard]] bool Contains(const TranscodeKey& key) const;
+
+    /// Read a transcoded image into output and replace copies with the stored ones
+    /// @retval True on a cache hit, copies are left untouched on a miss
+    [[nodiscard]] bool Load(const TranscodeKey& key, std::span<u8> output,
+                            boost::container::small_vector<BufferImageCopy, 16>& copies);
+
+    /// Append a transcoded image and the copies describing its layout to the cache
+    void Store(const TranscodeKey& key, std::span<const u8> data,
+               std::span<const BufferImageCopy> copies);
+
+private:
+    struct Entry {
+        u64 offset;
+        u64 size;
+        u64 checksum;
+        u32 num_copies;
+    };
+
+    void LoadIndex();
+
+    mutable std::mutex mutex;
+    std::filesystem::path filename;
+    Common::FS::IOFile file;
+    std::unordered_map<TranscodeKey, Entry> entries;
+    u64 file_size = 0;
+};
+
+} // namespace VideoCommon
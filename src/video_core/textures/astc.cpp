@@ -5,14 +5,26 @@
 // <http://gamma.cs.unc.edu/FasTC/>
 
 #include <algorithm>
+#include <atomic>
 #include <bit>
 #include <cassert>
 #include <cstring>
+#include <memory>
 #include <span>
 #include <vector>
 
 #include <boost/container/static_vector.hpp>
 
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/polyfill_ranges.h"
@@ -21,42 +33,40 @@
 
 class InputBitStream {
 public:
-    constexpr explicit InputBitStream(std::span<const u8> data, size_t start_offset = 0)
-        : cur_byte{data.data()}, total_bits{data.size()}, next_bit{start_offset % 8} {}
+    constexpr explicit InputBitStream(std::span<const u8> data)
+        : cur_byte{data.data()}, total_bits{data.size() * 8} {}
 
     constexpr size_t GetBitsRead() const {
         return bits_read;
     }
 
     constexpr bool ReadBit() {
-        if (bits_read >= total_bits * 8) {
-            return 0;
-        }
-        const bool bit = ((*cur_byte >> next_bit) & 1) != 0;
-        ++next_bit;
-        while (next_bit >= 8) {
-            next_bit -= 8;
-            ++cur_byte;
-        }
-        ++bits_read;
-        return bit;
+        return ReadBits(1) != 0;
     }
 
     constexpr u32 ReadBits(std::size_t nBits) {
-        u32 ret = 0;
-        for (std::size_t i = 0; i < nBits; ++i) {
-            ret |= (ReadBit() & 1) << i;
+        // Gather all the requested bits from the bytes that hold them instead of one bit at a time.
+        // Bits past the end of the stream are read as zero.
+        const std::size_t num_bits = std::min(nBits, total_bits - bits_read);
+        const std::size_t num_bytes = (next_bit + num_bits + 7) / 8;
+        u64 window = 0;
+        for (std::size_t i = 0; i < num_bytes; ++i) {
+            window |= static_cast<u64>(cur_byte[i]) << (i * 8);
         }
+        const u64 mask = (u64{1} << num_bits) - 1;
+        const u32 ret = static_cast<u32>((window >> next_bit) & mask);
+
+        next_bit += num_bits;
+        cur_byte += next_bit / 8;
+        next_bit %= 8;
+        bits_read += num_bits;
         return ret;
     }
 
     template <std::size_t nBits>
     constexpr u32 ReadBits() {
-        u32 ret = 0;
-        for (std::size_t i = 0; i < nBits; ++i) {
-            ret |= (ReadBit() & 1) << i;
-        }
-        return ret;
+        static_assert(nBits <= 32);
+        return ReadBits(nBits);
     }
 
 private:
@@ -66,55 +76,6 @@ private:
     size_t bits_read = 0;
 };
 
-class OutputBitStream {
-public:
-    constexpr explicit OutputBitStream(u8* ptr, std::size_t bits = 0, std::size_t start_offset = 0)
-        : cur_byte{ptr}, num_bits{bits}, next_bit{start_offset % 8} {}
-
-    constexpr std::size_t GetBitsWritten() const {
-        return bits_written;
-    }
-
-    constexpr void WriteBitsR(u32 val, u32 nBits) {
-        for (u32 i = 0; i < nBits; i++) {
-            WriteBit((val >> (nBits - i - 1)) & 1);
-        }
-    }
-
-    constexpr void WriteBits(u32 val, u32 nBits) {
-        for (u32 i = 0; i < nBits; i++) {
-            WriteBit((val >> i) & 1);
-        }
-    }
-
-private:
-    constexpr void WriteBit(bool b) {
-        if (bits_written >= num_bits) {
-            return;
-        }
-
-        const u32 mask = 1 << next_bit++;
-
-        // clear the bit
-        *cur_byte &= static_cast<u8>(~mask);
-
-        // Write the bit, if necessary
-        if (b)
-            *cur_byte |= static_cast<u8>(mask);
-
-        // Next byte?
-        if (next_bit >= 8) {
-            cur_byte += 1;
-            next_bit = 0;
-        }
-    }
-
-    u8* cur_byte;
-    std::size_t num_bits;
-    std::size_t bits_written = 0;
-    std::size_t next_bit = 0;
-};
-
 template <typename IntType>
 class Bits {
 public:
@@ -621,11 +582,6 @@ static constexpr auto MakeReplicateTable() {
     return table;
 }
 
-static constexpr auto REPLICATE_BYTE_TO_16_TABLE = MakeReplicateTable<u32, 8, 16>();
-static constexpr u32 ReplicateByteTo16(std::size_t value) {
-    return REPLICATE_BYTE_TO_16_TABLE[value];
-}
-
 static constexpr auto REPLICATE_BIT_TO_7_TABLE = MakeReplicateTable<u32, 1, 7>();
 static constexpr u32 ReplicateBitTo7(std::size_t value) {
     return REPLICATE_BIT_TO_7_TABLE[value];
@@ -815,6 +771,160 @@ public:
     }
 };
 
+// Dequantizes a color value to the 0-255 range, this procedure is outlined in ASTC spec C.2.13
+static constexpr u32 UnquantizeColorValue(IntegerEncoding encoding, u32 bitlen, u32 D, u32 bitval) {
+    u32 B = 0, C = 0;
+    // A is just the lsb replicated 9 times.
+    const u32 A = ReplicateBitTo9(bitval & 1);
+
+    switch (encoding) {
+    // Replicate bits
+    case IntegerEncoding::JustBits:
+        return FastReplicateTo8(bitval, bitlen);
+
+    // Use algorithm in C.2.13
+    case IntegerEncoding::Trit: {
+        switch (bitlen) {
+        case 1: {
+            C = 204;
+        } break;
+
+        case 2: {
+            C = 93;
+            // B = b000b0bb0
+            u32 b = (bitval >> 1) & 1;
+            B = (b << 8) | (b << 4) | (b << 2) | (b << 1);
+        } break;
+
+        case 3: {
+            C = 44;
+            // B = cb000cbcb
+            u32 cb = (bitval >> 1) & 3;
+            B = (cb << 7) | (cb << 2) | cb;
+        } break;
+
+        case 4: {
+            C = 22;
+            // B = dcb000dcb
+            u32 dcb = (bitval >> 1) & 7;
+            B = (dcb << 6) | dcb;
+        } break;
+
+        case 5: {
+            C = 11;
+            // B = edcb000ed
+            u32 edcb = (bitval >> 1) & 0xF;
+            B = (edcb << 5) | (edcb >> 2);
+        } break;
+
+        case 6: {
+            C = 5;
+            // B = fedcb000f
+            u32 fedcb = (bitval >> 1) & 0x1F;
+            B = (fedcb << 4) | (fedcb >> 4);
+        } break;
+
+        default:
+            // Unsupported trit encoding for color values
+            break;
+        } // switch(bitlen)
+    }     // case IntegerEncoding::Trit
+    break;
+
+    case IntegerEncoding::Quint: {
+        switch (bitlen) {
+        case 1: {
+            C = 113;
+        } break;
+
+        case 2: {
+            C = 54;
+            // B = b0000bb00
+            u32 b = (bitval >> 1) & 1;
+            B = (b << 8) | (b << 3) | (b << 2);
+        } break;
+
+        case 3: {
+            C = 26;
+            // B = cb0000cbc
+            u32 cb = (bitval >> 1) & 3;
+            B = (cb << 7) | (cb << 1) | (cb >> 1);
+        } break;
+
+        case 4: {
+            C = 13;
+            // B = dcb0000dc
+            u32 dcb = (bitval >> 1) & 7;
+            B = (dcb << 6) | (dcb >> 1);
+        } break;
+
+        case 5: {
+            C = 6;
+            // B = edcb0000e
+            u32 edcb = (bitval >> 1) & 0xF;
+            B = (edcb << 5) | (edcb >> 3);
+        } break;
+
+        default:
+            // Unsupported quint encoding for color values
+            break;
+        } // switch(bitlen)
+    }     // case IntegerEncoding::Quint
+    break;
+    } // switch(encoding)
+
+    u32 T = D * C + B;
+    T ^= A;
+    T = (A & 0x80) | (T >> 2);
+    return T;
+}
+
+// Values are indexed by their encoding and bit length, and then by (D << bitlen) | bitval
+static constexpr std::size_t UNQUANTIZE_TABLE_MAX_BITS = 8;
+static constexpr std::size_t UnquantizeTableIndex(IntegerEncoding encoding, u32 bitlen) {
+    return static_cast<std::size_t>(encoding) * (UNQUANTIZE_TABLE_MAX_BITS + 1) + bitlen;
+}
+
+static constexpr u32 UnquantizeTableOffset(const IntegerEncodedValue& val) {
+    u32 D = 0;
+    if (val.encoding == IntegerEncoding::Trit) {
+        D = val.trit_value;
+    } else if (val.encoding == IntegerEncoding::Quint) {
+        D = val.quint_value;
+    }
+    return (D << val.num_bits) | val.bit_value;
+}
+
+static constexpr u32 NumEncodingStates(IntegerEncoding encoding) {
+    switch (encoding) {
+    case IntegerEncoding::Trit:
+        return 3;
+    case IntegerEncoding::Quint:
+        return 5;
+    default:
+        return 1;
+    }
+}
+
+static constexpr auto COLOR_UNQUANTIZE_TABLE = [] {
+    std::array<std::array<u8, 256>, 3 * (UNQUANTIZE_TABLE_MAX_BITS + 1)> table{};
+    for (const IntegerEncoding encoding :
+         {IntegerEncoding::JustBits, IntegerEncoding::Quint, IntegerEncoding::Trit}) {
+        for (u32 bitlen = 0; bitlen <= UNQUANTIZE_TABLE_MAX_BITS; ++bitlen) {
+            for (u32 value = 0; value < 256; ++value) {
+                const u32 D = value >> bitlen;
+                if (D >= NumEncodingStates(encoding)) {
+                    continue;
+                }
+                const u32 bitval = value & ((1U << bitlen) - 1);
+                table[UnquantizeTableIndex(encoding, bitlen)][value] =
+                    static_cast<u8>(UnquantizeColorValue(encoding, bitlen, D, bitval));
+            }
+        }
+    }
+    return table;
+}();
+
 static void DecodeColorValues(u32* out, std::span<u8> data, const u32* modes, const u32 nPartitions,
                               const u32 nBitsForColorData) {
     // First figure out how many color values we have
@@ -847,7 +957,7 @@ static void DecodeColorValues(u32* out, std::span<u8> data, const u32* modes, co
     // We now have enough to decode our integer sequence.
     IntegerEncodedVector decodedColorValues;
 
-    InputBitStream colorStream(data, 0);
+    InputBitStream colorStream(data);
     DecodeIntegerSequence(decodedColorValues, colorStream, range, nValues);
 
     // Once we have the decoded values, we need to dequantize them to the 0-255 range
@@ -860,147 +970,25 @@ static void DecodeColorValues(u32* out, std::span<u8> data, const u32* modes, co
         }
 
         const IntegerEncodedValue& val = *itr;
-        u32 bitlen = val.num_bits;
-        u32 bitval = val.bit_value;
-
-        assert(bitlen >= 1);
-
-        u32 A = 0, B = 0, C = 0, D = 0;
-        // A is just the lsb replicated 9 times.
-        A = ReplicateBitTo9(bitval & 1);
-
-        switch (val.encoding) {
-        // Replicate bits
-        case IntegerEncoding::JustBits:
-            out[outIdx++] = FastReplicateTo8(bitval, bitlen);
-            break;
-
-        // Use algorithm in C.2.13
-        case IntegerEncoding::Trit: {
-
-            D = val.trit_value;
-
-            switch (bitlen) {
-            case 1: {
-                C = 204;
-            } break;
-
-            case 2: {
-                C = 93;
-                // B = b000b0bb0
-                u32 b = (bitval >> 1) & 1;
-                B = (b << 8) | (b << 4) | (b << 2) | (b << 1);
-            } break;
-
-            case 3: {
-                C = 44;
-                // B = cb000cbcb
-                u32 cb = (bitval >> 1) & 3;
-                B = (cb << 7) | (cb << 2) | cb;
-            } break;
-
-            case 4: {
-                C = 22;
-                // B = dcb000dcb
-                u32 dcb = (bitval >> 1) & 7;
-                B = (dcb << 6) | dcb;
-            } break;
-
-            case 5: {
-                C = 11;
-                // B = edcb000ed
-                u32 edcb = (bitval >> 1) & 0xF;
-                B = (edcb << 5) | (edcb >> 2);
-            } break;
-
-            case 6: {
-                C = 5;
-                // B = fedcb000f
-                u32 fedcb = (bitval >> 1) & 0x1F;
-                B = (fedcb << 4) | (fedcb >> 4);
-            } break;
-
-            default:
-                assert(false && "Unsupported trit encoding for color values!");
-                break;
-            } // switch(bitlen)
-        }     // case IntegerEncoding::Trit
-        break;
-
-        case IntegerEncoding::Quint: {
-
-            D = val.quint_value;
-
-            switch (bitlen) {
-            case 1: {
-                C = 113;
-            } break;
-
-            case 2: {
-                C = 54;
-                // B = b0000bb00
-                u32 b = (bitval >> 1) & 1;
-                B = (b << 8) | (b << 3) | (b << 2);
-            } break;
-
-            case 3: {
-                C = 26;
-                // B = cb0000cbc
-                u32 cb = (bitval >> 1) & 3;
-                B = (cb << 7) | (cb << 1) | (cb >> 1);
-            } break;
-
-            case 4: {
-                C = 13;
-                // B = dcb0000dc
-                u32 dcb = (bitval >> 1) & 7;
-                B = (dcb << 6) | (dcb >> 1);
-            } break;
-
-            case 5: {
-                C = 6;
-                // B = edcb0000e
-                u32 edcb = (bitval >> 1) & 0xF;
-                B = (edcb << 5) | (edcb >> 3);
-            } break;
-
-            default:
-                assert(false && "Unsupported quint encoding for color values!");
-                break;
-            } // switch(bitlen)
-        }     // case IntegerEncoding::Quint
-        break;
-        } // switch(val.encoding)
+        assert(val.num_bits >= 1);
 
-        if (val.encoding != IntegerEncoding::JustBits) {
-            u32 T = D * C + B;
-            T ^= A;
-            T = (A & 0x80) | (T >> 2);
-            out[outIdx++] = T;
-        }
-    }
-
-    // Make sure that each of our values is in the proper range...
-    for (u32 i = 0; i < nValues; i++) {
-        assert(out[i] <= 255);
+        out[outIdx++] = COLOR_UNQUANTIZE_TABLE[UnquantizeTableIndex(val.encoding, val.num_bits)]
+                                              [UnquantizeTableOffset(val)];
     }
 }
 
-static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
-    u32 bitval = val.bit_value;
-    u32 bitlen = val.num_bits;
-
+static constexpr u32 UnquantizeTexelWeight(IntegerEncoding encoding, u32 bitlen, u32 D,
+                                           u32 bitval) {
     u32 A = ReplicateBitTo7(bitval & 1);
-    u32 B = 0, C = 0, D = 0;
+    u32 B = 0, C = 0;
 
     u32 result = 0;
-    switch (val.encoding) {
+    switch (encoding) {
     case IntegerEncoding::JustBits:
         result = FastReplicateTo6(bitval, bitlen);
         break;
 
     case IntegerEncoding::Trit: {
-        D = val.trit_value;
         assert(D < 3);
 
         switch (bitlen) {
@@ -1032,7 +1020,6 @@ static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
     } break;
 
     case IntegerEncoding::Quint: {
-        D = val.quint_value;
         assert(D < 5);
 
         switch (bitlen) {
@@ -1058,7 +1045,7 @@ static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
     } break;
     }
 
-    if (val.encoding != IntegerEncoding::JustBits && bitlen > 0) {
+    if (encoding != IntegerEncoding::JustBits && bitlen > 0) {
         // Decode the value...
         result = D * C + B;
         result ^= A;
@@ -1075,6 +1062,111 @@ static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
     return result;
 }
 
+// Largest bit length of each texel weight encoding, the weight range is at most 31
+static constexpr u32 MaxTexelWeightBits(IntegerEncoding encoding) {
+    switch (encoding) {
+    case IntegerEncoding::Trit:
+        return 3;
+    case IntegerEncoding::Quint:
+        return 2;
+    default:
+        return 5;
+    }
+}
+
+static constexpr auto TEXEL_WEIGHT_UNQUANTIZE_TABLE = [] {
+    std::array<std::array<u8, 64>, 3 * (UNQUANTIZE_TABLE_MAX_BITS + 1)> table{};
+    for (const IntegerEncoding encoding :
+         {IntegerEncoding::JustBits, IntegerEncoding::Quint, IntegerEncoding::Trit}) {
+        for (u32 bitlen = 0; bitlen <= MaxTexelWeightBits(encoding); ++bitlen) {
+            const u32 num_values = NumEncodingStates(encoding) << bitlen;
+            for (u32 value = 0; value < num_values; ++value) {
+                const u32 D = value >> bitlen;
+                const u32 bitval = value & ((1U << bitlen) - 1);
+                table[UnquantizeTableIndex(encoding, bitlen)][value] =
+                    static_cast<u8>(UnquantizeTexelWeight(encoding, bitlen, D, bitval));
+            }
+        }
+    }
+    return table;
+}();
+
+static u32 UnquantizeTexelWeight(const IntegerEncodedValue& val) {
+    return TEXEL_WEIGHT_UNQUANTIZE_TABLE[UnquantizeTableIndex(val.encoding, val.num_bits)]
+                                        [UnquantizeTableOffset(val)];
+}
+
+/// Bilinear infill of the texel weight grid (Section C.2.18) for a block footprint.
+struct WeightInfill {
+    u32 block_width = 0;
+    u32 block_height = 0;
+    u32 grid_width = 0;
+    u32 grid_height = 0;
+
+    /// Grid indices of the four weights contributing to each texel
+    std::array<std::array<u8, 4>, 12 * 12> indices;
+    /// Factors applied to each of the four weights, out of range weights have a factor of zero
+    std::array<std::array<u8, 4>, 12 * 12> factors;
+};
+
+static void ComputeWeightInfill(WeightInfill& infill) {
+    const u32 blockWidth = infill.block_width;
+    const u32 blockHeight = infill.block_height;
+    const u32 gridWidth = infill.grid_width;
+    const u32 gridSize = infill.grid_width * infill.grid_height;
+
+    u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
+    u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
+
+    for (u32 t = 0; t < blockHeight; t++) {
+        for (u32 s = 0; s < blockWidth; s++) {
+            u32 cs = Ds * s;
+            u32 ct = Dt * t;
+
+            u32 gs = (cs * (gridWidth - 1) + 32) >> 6;
+            u32 gt = (ct * (infill.grid_height - 1) + 32) >> 6;
+
+            u32 js = gs >> 4;
+            u32 fs = gs & 0xF;
+
+            u32 jt = gt >> 4;
+            u32 ft = gt & 0x0F;
+
+            u32 w11 = (fs * ft + 8) >> 4;
+            u32 w10 = ft - w11;
+            u32 w01 = fs - w11;
+            u32 w00 = 16 - fs - ft + w11;
+
+            u32 v0 = js + jt * gridWidth;
+
+            const std::array<u32, 4> texels{v0, v0 + 1, v0 + gridWidth, v0 + gridWidth + 1};
+            const std::array<u32, 4> weights{w00, w01, w10, w11};
+
+            const u32 texel = t * blockWidth + s;
+            for (u32 i = 0; i < 4; i++) {
+                const bool in_range = texels[i] < gridSize;
+                infill.indices[texel][i] = static_cast<u8>(in_range ? texels[i] : 0);
+                infill.factors[texel][i] = static_cast<u8>(in_range ? weights[i] : 0);
+            }
+        }
+    }
+}
+
+static const WeightInfill& GetWeightInfill(u32 blockWidth, u32 blockHeight,
+                                           const TexelWeightParams& params) {
+    // Neighbouring blocks tend to share their weight grid, keep the last one around
+    thread_local WeightInfill infill;
+    if (infill.block_width != blockWidth || infill.block_height != blockHeight ||
+        infill.grid_width != params.m_Width || infill.grid_height != params.m_Height) {
+        infill.block_width = blockWidth;
+        infill.block_height = blockHeight;
+        infill.grid_width = params.m_Width;
+        infill.grid_height = params.m_Height;
+        ComputeWeightInfill(infill);
+    }
+    return infill;
+}
+
 static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector& weights,
                                    const TexelWeightParams& params, const u32 blockWidth,
                                    const u32 blockHeight) {
@@ -1097,50 +1189,20 @@ static void UnquantizeTexelWeights(u32 out[2][144], const IntegerEncodedVector&
     }
 
     // Do infill if necessary (Section C.2.18) ...
-    u32 Ds = (1024 + (blockWidth / 2)) / (blockWidth - 1);
-    u32 Dt = (1024 + (blockHeight / 2)) / (blockHeight - 1);
-
+    const WeightInfill& infill = GetWeightInfill(blockWidth, blockHeight, params);
     const u32 kPlaneScale = params.m_bDualPlane ? 2U : 1U;
-    for (u32 plane = 0; plane < kPlaneScale; plane++)
-        for (u32 t = 0; t < blockHeight; t++)
-            for (u32 s = 0; s < blockWidth; s++) {
-                u32 cs = Ds * s;
-                u32 ct = Dt * t;
-
-                u32 gs = (cs * (params.m_Width - 1) + 32) >> 6;
-                u32 gt = (ct * (params.m_Height - 1) + 32) >> 6;
-
-                u32 js = gs >> 4;
-                u32 fs = gs & 0xF;
-
-                u32 jt = gt >> 4;
-                u32 ft = gt & 0x0F;
-
-                u32 w11 = (fs * ft + 8) >> 4;
-                u32 w10 = ft - w11;
-                u32 w01 = fs - w11;
-                u32 w00 = 16 - fs - ft + w11;
-
-                u32 v0 = js + jt * params.m_Width;
-
-#define FIND_TEXEL(tidx, bidx)                                                                     \
-    u32 p##bidx = 0;                                                                               \
-    do {                                                                                           \
-        if ((tidx) < (params.m_Width * params.m_Height)) {                                         \
-            p##bidx = unquantized[plane][(tidx)];                                                  \
-        }                                                                                          \
-    } while (0)
-
-                FIND_TEXEL(v0, 00);
-                FIND_TEXEL(v0 + 1, 01);
-                FIND_TEXEL(v0 + params.m_Width, 10);
-                FIND_TEXEL(v0 + params.m_Width + 1, 11);
-
-#undef FIND_TEXEL
-
-                out[plane][t * blockWidth + s] =
-                    (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
-            }
+    const u32 numTexels = blockWidth * blockHeight;
+    for (u32 plane = 0; plane < kPlaneScale; plane++) {
+        for (u32 texel = 0; texel < numTexels; texel++) {
+            const auto& index = infill.indices[texel];
+            const auto& factor = infill.factors[texel];
+            out[plane][texel] = (unquantized[plane][index[0]] * factor[0] +
+                                 unquantized[plane][index[1]] * factor[1] +
+                                 unquantized[plane][index[2]] * factor[2] +
+                                 unquantized[plane][index[3]] * factor[3] + 8) >>
+                                4;
+        }
+    }
 }
 
 // Transfers a bit as described in C.2.14
@@ -1419,6 +1481,58 @@ static void FillError(std::span<u32> outBuf, u32 blockWidth, u32 blockHeight) {
     }
 }
 
+// Interpolates the endpoints of a texel with its weights (Section C.2.19) and converts the
+// result to UNORM8. The endpoints are replicated to 16 bits before the interpolation, this is
+// folded into the multiplication by 257 and the conversion to 8 bits is done with integer math.
+#if defined(ARCHITECTURE_x86_64)
+static u32 InterpolateTexel(const std::array<u16, 8>& endpoints,
+                            const std::array<u32, 4>& planeMask, u32 weight, u32 dualPlaneWeight) {
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(planeMask.data()));
+    const __m128i w0 = _mm_set1_epi32(static_cast<int>(weight));
+    const __m128i w1 = _mm_set1_epi32(static_cast<int>(dualPlaneWeight));
+    const __m128i w = _mm_or_si128(_mm_andnot_si128(mask, w0), _mm_and_si128(mask, w1));
+    // Each lane holds the {64 - weight, weight} pair multiplied against the {low, high} endpoints
+    const __m128i factors =
+        _mm_or_si128(_mm_slli_epi32(w, 16), _mm_sub_epi32(_mm_set1_epi32(64), w));
+    const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(endpoints.data()));
+    const __m128i sum = _mm_madd_epi16(values, factors);
+    const __m128i c16 = _mm_srli_epi32(
+        _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(sum, 8), sum), _mm_set1_epi32(32)), 6);
+    const __m128i c8 = _mm_srli_epi32(
+        _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(c16, 8), c16), _mm_set1_epi32(32768)), 16);
+    const __m128i packed = _mm_packs_epi32(c8, c8);
+    return static_cast<u32>(_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed)));
+}
+#elif defined(ARCHITECTURE_arm64)
+static u32 InterpolateTexel(const std::array<u16, 8>& endpoints,
+                            const std::array<u32, 4>& planeMask, u32 weight, u32 dualPlaneWeight) {
+    const uint16x4x2_t values = vld2_u16(endpoints.data());
+    const uint32x4_t w =
+        vbslq_u32(vld1q_u32(planeMask.data()), vdupq_n_u32(dualPlaneWeight), vdupq_n_u32(weight));
+    const uint16x4_t high_factor = vmovn_u32(w);
+    const uint16x4_t low_factor = vsub_u16(vdup_n_u16(64), high_factor);
+    const uint32x4_t sum =
+        vmlal_u16(vmull_u16(values.val[0], low_factor), values.val[1], high_factor);
+    const uint32x4_t c16 = vshrq_n_u32(vmlaq_n_u32(vdupq_n_u32(32), sum, 257), 6);
+    const uint32x4_t c8 = vshrq_n_u32(vmlaq_n_u32(vdupq_n_u32(32768), c16, 255), 16);
+    const uint16x4_t narrow = vmovn_u32(c8);
+    return vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+}
+#else
+static u32 InterpolateTexel(const std::array<u16, 8>& endpoints,
+                            const std::array<u32, 4>& planeMask, u32 weight, u32 dualPlaneWeight) {
+    u32 result = 0;
+    for (u32 lane = 0; lane < 4; lane++) {
+        const u32 w = planeMask[lane] ? dualPlaneWeight : weight;
+        const u32 sum = endpoints[lane * 2] * (64 - w) + endpoints[lane * 2 + 1] * w;
+        const u32 c16 = (sum * 257 + 32) >> 6;
+        const u32 c8 = (c16 * 255 + 32768) >> 16;
+        result |= c8 << (lane * 8);
+    }
+    return result;
+}
+#endif
+
 static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
                             const u32 blockHeight, std::span<u32, 12 * 12> outBuf) {
     InputBitStream strm(inBuf);
@@ -1475,7 +1589,6 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     // Define color data.
     u8 colorEndpointData[16];
     memset(colorEndpointData, 0, sizeof(colorEndpointData));
-    OutputBitStream colorEndpointStream(colorEndpointData, 16 * 8, 0);
 
     // Read extra config data...
     u32 baseCEM = 0;
@@ -1521,10 +1634,9 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
 
     // Read color data...
     u32 colorDataBits = remainingBits;
-    while (remainingBits > 0) {
-        u32 nb = std::min(remainingBits, 8);
-        u32 b = strm.ReadBits(nb);
-        colorEndpointStream.WriteBits(b, nb);
+    for (u32 i = 0; remainingBits > 0; ++i) {
+        const u32 nb = std::min(remainingBits, 8);
+        colorEndpointData[i] = static_cast<u8>(strm.ReadBits(nb));
         remainingBits -= 8;
     }
 
@@ -1617,76 +1729,118 @@ static void DecompressBlock(std::span<const u8, 16> inBuf, const u32 blockWidth,
     u32 weights[2][144];
     UnquantizeTexelWeights(weights, texelWeightValues, weightParams, blockWidth, blockHeight);
 
+    // Replicate the endpoints to the channel layout of the output once per partition, the
+    // interpolation below expects them interleaved as {low, high} pairs in R, G, B, A order.
+    std::array<std::array<u16, 8>, 4> texelEndpoints;
+    for (u32 i = 0; i < nPartitions; i++) {
+        for (u32 lane = 0; lane < 4; lane++) {
+            const u32 c = (lane + 1) & 3;
+            texelEndpoints[i][lane * 2 + 0] = static_cast<u16>(endpoints[i][0].Component(c));
+            texelEndpoints[i][lane * 2 + 1] = static_cast<u16>(endpoints[i][1].Component(c));
+        }
+    }
+
+    // The channel selected by the plane index takes its weights from the second plane
+    std::array<u32, 4> planeMask{};
+    if (weightParams.m_bDualPlane) {
+        planeMask[planeIdx & 3] = 0xFFFFFFFF;
+    }
+
     // Now that we have endpoints and weights, we can interpolate and generate
     // the proper decoding...
-    for (u32 j = 0; j < blockHeight; j++)
+    const bool smallBlock = (blockHeight * blockWidth) < 32;
+    for (u32 j = 0; j < blockHeight; j++) {
         for (u32 i = 0; i < blockWidth; i++) {
-            u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions,
-                                              (blockHeight * blockWidth) < 32);
+            u32 partition = Select2DPartition(partitionIndex, i, j, nPartitions, smallBlock);
             assert(partition < nPartitions);
 
-            Pixel p;
-            for (u32 c = 0; c < 4; c++) {
-                u32 C0 = endpoints[partition][0].Component(c);
-                C0 = ReplicateByteTo16(C0);
-                u32 C1 = endpoints[partition][1].Component(c);
-                C1 = ReplicateByteTo16(C1);
+            const u32 texel = j * blockWidth + i;
+            const u32 weight = weights[0][texel];
+            const u32 dualPlaneWeight = weightParams.m_bDualPlane ? weights[1][texel] : weight;
+            outBuf[texel] =
+                InterpolateTexel(texelEndpoints[partition], planeMask, weight, dualPlaneWeight);
+        }
+    }
+}
 
-                u32 plane = 0;
-                if (weightParams.m_bDualPlane && (((planeIdx + 1) & 3) == c)) {
-                    plane = 1;
-                }
+static void DecompressBlocks(std::span<const u8> data, u32 width, u32 height, u32 block_width,
+                             u32 block_height, u32 rows, u32 cols, u32 first_block,
+                             u32 num_blocks, std::span<u8> output) {
+    for (u32 block_index = first_block; block_index < first_block + num_blocks; ++block_index) {
+        const u32 z = block_index / (rows * cols);
+        const u32 y_index = (block_index / cols) % rows;
+        const u32 x_index = block_index % cols;
+        const u32 x = x_index * block_width;
+        const u32 y = y_index * block_height;
 
-                u32 weight = weights[plane][j * blockWidth + i];
-                u32 C = (C0 * (64 - weight) + C1 * weight + 32) / 64;
-                if (C == 65535) {
-                    p.Component(c) = 255;
-                } else {
-                    double Cf = static_cast<double>(C);
-                    p.Component(c) = static_cast<u16>(255.0 * (Cf / 65536.0) + 0.5);
-                }
-            }
+        const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
+
+        // Blocks can be at most 12x12
+        std::array<u32, 12 * 12> uncompData;
+        DecompressBlock(blockPtr, block_width, block_height, uncompData);
 
-            outBuf[j * blockWidth + i] = p.Pack();
+        u32 decompWidth = std::min(block_width, width - x);
+        u32 decompHeight = std::min(block_height, height - y);
+
+        const u32 depth_offset = z * height * width * 4;
+        const std::span<u8> outRow = output.subspan(depth_offset + (y * width + x) * 4);
+        for (u32 h = 0; h < decompHeight; ++h) {
+            std::memcpy(outRow.data() + h * width * 4, uncompData.data() + h * block_width,
+                        decompWidth * 4);
         }
+    }
 }
 
 void Decompress(std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t depth,
                 uint32_t block_width, uint32_t block_height, std::span<uint8_t> output) {
     const u32 rows = Common::DivideUp(height, block_height);
     const u32 cols = Common::DivideUp(width, block_width);
+    const u32 num_blocks = rows * cols * depth;
 
-    Common::ThreadWorker& workers{GetThreadWorkers()};
+    // Split the texture in small jobs of consecutive blocks, regardless of its rows and slices, and
+    // let the workers and this thread pull them until none are left.
+    static constexpr u32 BLOCKS_PER_JOB = 64;
+    const u32 num_jobs = Common::DivideUp(num_blocks, BLOCKS_PER_JOB);
+    if (num_jobs == 0) {
+        return;
+    }
 
-    for (u32 z = 0; z < depth; ++z) {
-        const u32 depth_offset = z * height * width * 4;
-        for (u32 y_index = 0; y_index < rows; ++y_index) {
-            auto decompress_stride = [data, width, height, block_width, block_height, output, rows,
-                                      cols, z, depth_offset, y_index] {
-                const u32 y = y_index * block_height;
-                for (u32 x_index = 0; x_index < cols; ++x_index) {
-                    const u32 block_index = (z * rows * cols) + (y_index * cols) + x_index;
-                    const u32 x = x_index * block_width;
-
-                    const std::span<const u8, 16> blockPtr{data.subspan(block_index * 16, 16)};
-
-                    // Blocks can be at most 12x12
-                    std::array<u32, 12 * 12> uncompData;
-                    DecompressBlock(blockPtr, block_width, block_height, uncompData);
-
-                    u32 decompWidth = std::min(block_width, width - x);
-                    u32 decompHeight = std::min(block_height, height - y);
-
-                    const std::span<u8> outRow = output.subspan(depth_offset + (y * width + x) * 4);
-                    for (u32 h = 0; h < decompHeight; ++h) {
-                        std::memcpy(outRow.data() + h * width * 4,
-                                    uncompData.data() + h * block_width, decompWidth * 4);
-                    }
-                }
-            };
-            workers.QueueWork(std::move(decompress_stride));
+    struct JobCounters {
+        std::atomic<u32> next_job{};
+        std::atomic<u32> jobs_done{};
+    };
+    // Workers that start after all jobs have been claimed only touch the counters, which have to
+    // outlive this call.
+    const auto counters = std::make_shared<JobCounters>();
+    const auto run_jobs = [counters, data, width, height, block_width, block_height, rows, cols,
+                           num_blocks, num_jobs, output] {
+        u32 jobs_done = 0;
+        for (u32 job = counters->next_job.fetch_add(1, std::memory_order_relaxed); job < num_jobs;
+             job = counters->next_job.fetch_add(1, std::memory_order_relaxed)) {
+            const u32 first_block = job * BLOCKS_PER_JOB;
+            const u32 job_blocks = std::min(BLOCKS_PER_JOB, num_blocks - first_block);
+            DecompressBlocks(data, width, height, block_width, block_height, rows, cols,
+                             first_block, job_blocks, output);
+            ++jobs_done;
         }
-        workers.WaitForRequests();
+        if (jobs_done != 0 &&
+            counters->jobs_done.fetch_add(jobs_done, std::memory_order_acq_rel) + jobs_done ==
+                num_jobs) {
+            counters->jobs_done.notify_all();
+        }
+    };
+
+    Common::ThreadWorker& workers{GetThreadWorkers()};
+    const size_t num_helpers = std::min<size_t>(workers.NumWorkers(), num_jobs - 1);
+    for (size_t i = 0; i < num_helpers; ++i) {
+        auto helper = run_jobs;
+        workers.QueueWork(std::move(helper));
+    }
+    run_jobs();
+
+    for (u32 done = counters->jobs_done.load(std::memory_order_acquire); done != num_jobs;
+         done = counters->jobs_done.load(std::memory_order_acquire)) {
+        counters->jobs_done.wait(done, std::memory_order_acquire);
     }
 }
 
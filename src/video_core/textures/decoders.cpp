@@ -2,10 +2,22 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
 #include <cstring>
 #include <span>
 
+#if defined(ARCHITECTURE_x86_64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#elif defined(ARCHITECTURE_arm64)
+#include <arm_neon.h>
+#endif
+
 #include "common/alignment.h"
 #include "common/assert.h"
 #include "common/bit_util.h"
@@ -13,6 +25,16 @@
 #include "video_core/gpu.h"
 #include "video_core/textures/decoders.h"
 
+#if defined(ARCHITECTURE_x86_64)
+#include "common/x64/cpu_detect.h"
+#endif
+
+#if defined(ARCHITECTURE_x86_64) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
 namespace Tegra::Texture {
 namespace {
 template <u32 mask>
@@ -33,6 +55,226 @@ void incrpdep(u32& value) {
     value = ((value | ~mask) + swizzled_incr) & mask;
 }
 
+/*
+ * A linear row of 64 bytes inside a GOB is stored as four 16 byte sectors. The swizzled offsets
+ * of these sectors relative to the row are constant, so a whole GOB row can be copied with plain
+ * vector loads and stores without touching SWIZZLE_TABLE.
+ */
+constexpr std::array<u32, 4> GOB_ROW_SECTOR_OFFSETS{
+    pdep<SWIZZLE_X_BITS>(0),
+    pdep<SWIZZLE_X_BITS>(16),
+    pdep<SWIZZLE_X_BITS>(32),
+    pdep<SWIZZLE_X_BITS>(48),
+};
+static_assert(GOB_ROW_SECTOR_OFFSETS == std::array<u32, 4>{0, 32, 256, 288});
+
+/// Copies 'num_gobs' consecutive linear GOB rows into swizzled GOBs 'gob_stride' bytes apart.
+using GobRowSwizzleFn = void (*)(u8* swizzled, const u8* linear, u32 num_gobs, u32 gob_stride);
+
+/// Copies 'num_gobs' swizzled GOB rows 'gob_stride' bytes apart into consecutive linear memory.
+using GobRowUnswizzleFn = void (*)(u8* linear, const u8* swizzled, u32 num_gobs, u32 gob_stride);
+
+struct GobRowKernel {
+    GobRowSwizzleFn swizzle;
+    GobRowUnswizzleFn unswizzle;
+};
+
+#if defined(ARCHITECTURE_x86_64)
+void SwizzleGobRowsSSE41(u8* swizzled, const u8* linear, u32 num_gobs, u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        const __m128i sector0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + 0));
+        const __m128i sector1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + 16));
+        const __m128i sector2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + 32));
+        const __m128i sector3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(linear + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[0]), sector0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[1]), sector1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[2]), sector2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[3]), sector3);
+    }
+}
+
+void UnswizzleGobRowsSSE41(u8* linear, const u8* swizzled, u32 num_gobs, u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        const auto load = [swizzled](u32 offset) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(swizzled + offset));
+        };
+        const __m128i sector0 = load(GOB_ROW_SECTOR_OFFSETS[0]);
+        const __m128i sector1 = load(GOB_ROW_SECTOR_OFFSETS[1]);
+        const __m128i sector2 = load(GOB_ROW_SECTOR_OFFSETS[2]);
+        const __m128i sector3 = load(GOB_ROW_SECTOR_OFFSETS[3]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(linear + 0), sector0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(linear + 16), sector1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(linear + 32), sector2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(linear + 48), sector3);
+    }
+}
+
+TARGET_AVX2 void SwizzleGobRowsAVX2(u8* swizzled, const u8* linear, u32 num_gobs,
+                                    u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        // Load the whole 64 byte row in two registers and split each one in its two sectors
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(linear + 0));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(linear + 32));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[0]),
+                         _mm256_castsi256_si128(low));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[1]),
+                         _mm256_extracti128_si256(low, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[2]),
+                         _mm256_castsi256_si128(high));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(swizzled + GOB_ROW_SECTOR_OFFSETS[3]),
+                         _mm256_extracti128_si256(high, 1));
+    }
+}
+
+TARGET_AVX2 void UnswizzleGobRowsAVX2(u8* linear, const u8* swizzled, u32 num_gobs,
+                                      u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        const auto load = [swizzled](u32 offset) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(swizzled + offset));
+        };
+        // Merge pairs of sectors so the linear side is written with full 32 byte stores
+        const __m128i sector0 = load(GOB_ROW_SECTOR_OFFSETS[0]);
+        const __m128i sector1 = load(GOB_ROW_SECTOR_OFFSETS[1]);
+        const __m128i sector2 = load(GOB_ROW_SECTOR_OFFSETS[2]);
+        const __m128i sector3 = load(GOB_ROW_SECTOR_OFFSETS[3]);
+        const __m256i low = _mm256_inserti128_si256(_mm256_castsi128_si256(sector0), sector1, 1);
+        const __m256i high = _mm256_inserti128_si256(_mm256_castsi128_si256(sector2), sector3, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(linear + 0), low);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(linear + 32), high);
+    }
+}
+#elif defined(ARCHITECTURE_arm64)
+void SwizzleGobRowsNEON(u8* swizzled, const u8* linear, u32 num_gobs, u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        const uint8x16x4_t row = vld1q_u8_x4(linear);
+        vst1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[0], row.val[0]);
+        vst1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[1], row.val[1]);
+        vst1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[2], row.val[2]);
+        vst1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[3], row.val[3]);
+    }
+}
+
+void UnswizzleGobRowsNEON(u8* linear, const u8* swizzled, u32 num_gobs, u32 gob_stride) {
+    for (u32 gob = 0; gob < num_gobs; ++gob, swizzled += gob_stride, linear += GOB_SIZE_X) {
+        uint8x16x4_t row;
+        row.val[0] = vld1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[0]);
+        row.val[1] = vld1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[1]);
+        row.val[2] = vld1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[2]);
+        row.val[3] = vld1q_u8(swizzled + GOB_ROW_SECTOR_OFFSETS[3]);
+        vst1q_u8_x4(linear, row);
+    }
+}
+#endif
+
+SwizzleKernel DetectSwizzleKernel() {
+#if defined(ARCHITECTURE_x86_64)
+    const auto& caps = Common::GetCPUCaps();
+    if (caps.avx2) {
+        return SwizzleKernel::AVX2;
+    }
+    if (caps.sse4_1) {
+        return SwizzleKernel::SSE41;
+    }
+#elif defined(ARCHITECTURE_arm64)
+    return SwizzleKernel::NEON;
+#endif
+    return SwizzleKernel::Scalar;
+}
+
+std::atomic<SwizzleKernel> current_kernel{DetectSwizzleKernel()};
+
+/// Returns the GOB row kernel to use, or nullptr when the scalar path has to be taken.
+const GobRowKernel* GetGobRowKernel() {
+    switch (current_kernel.load(std::memory_order_relaxed)) {
+#if defined(ARCHITECTURE_x86_64)
+    case SwizzleKernel::SSE41: {
+        static constexpr GobRowKernel kernel{&SwizzleGobRowsSSE41, &UnswizzleGobRowsSSE41};
+        return &kernel;
+    }
+    case SwizzleKernel::AVX2: {
+        static constexpr GobRowKernel kernel{&SwizzleGobRowsAVX2, &UnswizzleGobRowsAVX2};
+        return &kernel;
+    }
+#elif defined(ARCHITECTURE_arm64)
+    case SwizzleKernel::NEON: {
+        static constexpr GobRowKernel kernel{&SwizzleGobRowsNEON, &UnswizzleGobRowsNEON};
+        return &kernel;
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+/// Copies the pixels in [column_begin, column_end) of a single line one at a time.
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleLineScalar(std::span<u8> output, std::span<const u8> input, u32 base_offset,
+                       u32 swizzled_y, u32 x_shift, u32 origin_x, u32 column_begin,
+                       u32 column_end, u32 unswizzled_line_offset) {
+    u32 swizzled_x = pdep<SWIZZLE_X_BITS>((column_begin + origin_x) * BYTES_PER_PIXEL);
+    for (u32 column = column_begin; column < column_end;
+         ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
+        const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
+        const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
+
+        const u32 base_swizzled_offset = base_offset + offset_x;
+        const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
+
+        const u32 unswizzled_offset = unswizzled_line_offset + column * BYTES_PER_PIXEL;
+
+        u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
+        const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
+
+        std::memcpy(dst, src, BYTES_PER_PIXEL);
+    }
+}
+
+/**
+ * Copies 'extent_x' pixels of a single line starting at 'origin_x'.
+ * The GOB aligned part of the line is handed to the vector kernel when there is one, the
+ * unaligned head and tail are copied by the scalar path.
+ */
+template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
+void SwizzleLine(const GobRowKernel* kernel, std::span<u8> output, std::span<const u8> input,
+                 u32 base_offset, u32 swizzled_y, u32 x_shift, u32 origin_x, u32 extent_x,
+                 u32 unswizzled_line_offset) {
+    // Pixels that are not a power of two in size may straddle sectors, keep those on the scalar
+    // path to preserve its exact behavior.
+    if constexpr (std::has_single_bit(BYTES_PER_PIXEL)) {
+        const u32 x_begin = origin_x * BYTES_PER_PIXEL;
+        const u32 x_end = x_begin + extent_x * BYTES_PER_PIXEL;
+        const u32 gobs_x_begin = Common::AlignUpLog2(x_begin, GOB_SIZE_X_SHIFT);
+        const u32 gobs_x_end = Common::AlignDown(x_end, GOB_SIZE_X);
+        if (kernel != nullptr && gobs_x_begin < gobs_x_end) {
+            const u32 head_end = (gobs_x_begin - x_begin) / BYTES_PER_PIXEL;
+            const u32 tail_begin = (gobs_x_end - x_begin) / BYTES_PER_PIXEL;
+            SwizzleLineScalar<TO_LINEAR, BYTES_PER_PIXEL>(output, input, base_offset, swizzled_y,
+                                                          x_shift, origin_x, 0, head_end,
+                                                          unswizzled_line_offset);
+
+            const u32 num_gobs = (gobs_x_end - gobs_x_begin) >> GOB_SIZE_X_SHIFT;
+            const u32 gob_stride = 1U << x_shift;
+            const u32 swizzled_offset =
+                base_offset + ((gobs_x_begin >> GOB_SIZE_X_SHIFT) << x_shift) + swizzled_y;
+            const u32 unswizzled_offset = unswizzled_line_offset + head_end * BYTES_PER_PIXEL;
+            if constexpr (TO_LINEAR) {
+                kernel->swizzle(&output[swizzled_offset], &input[unswizzled_offset], num_gobs,
+                                gob_stride);
+            } else {
+                kernel->unswizzle(&output[unswizzled_offset], &input[swizzled_offset], num_gobs,
+                                  gob_stride);
+            }
+
+            SwizzleLineScalar<TO_LINEAR, BYTES_PER_PIXEL>(output, input, base_offset, swizzled_y,
+                                                          x_shift, origin_x, tail_begin, extent_x,
+                                                          unswizzled_line_offset);
+            return;
+        }
+    }
+    SwizzleLineScalar<TO_LINEAR, BYTES_PER_PIXEL>(output, input, base_offset, swizzled_y, x_shift,
+                                                  origin_x, 0, extent_x, unswizzled_line_offset);
+}
+
 template <bool TO_LINEAR, u32 BYTES_PER_PIXEL>
 void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32 height, u32 depth,
                  u32 block_height, u32 block_depth, u32 stride) {
@@ -54,6 +296,7 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
     const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
+    const GobRowKernel* const kernel = GetGobRowKernel();
 
     for (u32 slice = 0; slice < depth; ++slice) {
         const u32 z = slice + origin_z;
@@ -67,23 +310,10 @@ void SwizzleImpl(std::span<u8> output, std::span<const u8> input, u32 width, u32
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < width;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
+            const u32 unswizzled_line_offset = slice * pitch * height + line * pitch;
+            SwizzleLine<TO_LINEAR, BYTES_PER_PIXEL>(kernel, output, input, offset_z + offset_y,
+                                                    swizzled_y, x_shift, origin_x, width,
+                                                    unswizzled_line_offset);
         }
     }
 }
@@ -109,6 +339,7 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
     const u32 block_height_mask = (1U << block_height) - 1;
     const u32 block_depth_mask = (1U << block_depth) - 1;
     const u32 x_shift = GOB_SIZE_SHIFT + block_height + block_depth;
+    const GobRowKernel* const kernel = GetGobRowKernel();
 
     u32 unprocessed_lines = num_lines;
     u32 extent_y = std::min(num_lines, height - origin_y);
@@ -126,23 +357,10 @@ void SwizzleSubrectImpl(std::span<u8> output, std::span<const u8> input, u32 wid
             const u32 offset_y = (block_y >> block_height) * block_size +
                                  ((block_y & block_height_mask) << GOB_SIZE_SHIFT);
 
-            u32 swizzled_x = pdep<SWIZZLE_X_BITS>(origin_x * BYTES_PER_PIXEL);
-            for (u32 column = 0; column < extent_x;
-                 ++column, incrpdep<SWIZZLE_X_BITS, BYTES_PER_PIXEL>(swizzled_x)) {
-                const u32 x = (column + origin_x) * BYTES_PER_PIXEL;
-                const u32 offset_x = (x >> GOB_SIZE_X_SHIFT) << x_shift;
-
-                const u32 base_swizzled_offset = offset_z + offset_y + offset_x;
-                const u32 swizzled_offset = base_swizzled_offset + (swizzled_x | swizzled_y);
-
-                const u32 unswizzled_offset =
-                    slice * pitch * height + line * pitch + column * BYTES_PER_PIXEL;
-
-                u8* const dst = &output[TO_LINEAR ? swizzled_offset : unswizzled_offset];
-                const u8* const src = &input[TO_LINEAR ? unswizzled_offset : swizzled_offset];
-
-                std::memcpy(dst, src, BYTES_PER_PIXEL);
-            }
+            const u32 unswizzled_line_offset = slice * pitch * height + line * pitch;
+            SwizzleLine<TO_LINEAR, BYTES_PER_PIXEL>(kernel, output, input, offset_z + offset_y,
+                                                    swizzled_y, x_shift, origin_x, extent_x,
+                                                    unswizzled_line_offset);
         }
         unprocessed_lines -= lines_in_y;
         if (unprocessed_lines == 0) {
@@ -272,4 +490,32 @@ u64 GetGOBOffset(u32 width, u32 height, u32 dst_x, u32 dst_y, u32 block_height,
     return base + (relative_y / GOB_SIZE_Y) * GOB_SIZE;
 }
 
+bool IsSwizzleKernelSupported(SwizzleKernel kernel) {
+    switch (kernel) {
+    case SwizzleKernel::Scalar:
+        return true;
+#if defined(ARCHITECTURE_x86_64)
+    case SwizzleKernel::SSE41:
+        return Common::GetCPUCaps().sse4_1;
+    case SwizzleKernel::AVX2:
+        return Common::GetCPUCaps().avx2;
+#elif defined(ARCHITECTURE_arm64)
+    case SwizzleKernel::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+SwizzleKernel GetSwizzleKernel() {
+    return current_kernel.load(std::memory_order_relaxed);
+}
+
+void SetSwizzleKernel(SwizzleKernel kernel) {
+    ASSERT_MSG(IsSwizzleKernelSupported(kernel), "Swizzle kernel {} is not supported",
+               static_cast<u32>(kernel));
+    current_kernel.store(kernel, std::memory_order_relaxed);
+}
+
 } // namespace Tegra::Texture
@@ -25,6 +25,14 @@ constexpr u32 SWIZZLE_Y_BITS = 0b011010000;
 
 using SwizzleTable = std::array<std::array<u32, GOB_SIZE_X>, GOB_SIZE_Y>;
 
+/// Implementations used to copy whole GOB rows when swizzling or unswizzling textures.
+enum class SwizzleKernel : u32 {
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON,
+};
+
 /**
  * This table represents the internal swizzle of a gob, in format 16 bytes x 2 sector packing.
  * Calculates the offset of an (x, y) position within a swizzled texture.
@@ -69,4 +77,13 @@ void UnswizzleSubrect(std::span<u8> output, std::span<const u8> input, u32 bytes
 u64 GetGOBOffset(u32 width, u32 height, u32 dst_x, u32 dst_y, u32 block_height,
                  u32 bytes_per_pixel);
 
+/// Returns true when the given swizzle kernel can run on the host CPU.
+bool IsSwizzleKernelSupported(SwizzleKernel kernel);
+
+/// Returns the swizzle kernel in use, by default the fastest one supported by the host CPU.
+SwizzleKernel GetSwizzleKernel();
+
+/// Selects the swizzle kernel used by the (un)swizzle functions, it must be supported by the host.
+void SetSwizzleKernel(SwizzleKernel kernel);
+
 } // namespace Tegra::Texture